@@ -29,15 +29,10 @@ SummitDemo::SummitDemo(SummitEngine& engine)
     
     auto& renderer = mEngine->GetRenderer();
     
+    // Matrices are written to renderer's uniform ring every frame, offset is updated by every write
     mUniformBuffer.offset = 0;
     mUniformBuffer.dataSize = 3 * sizeof(Matrix4);
     
-    BufferDesc mvpUboDesc;
-    mvpUboDesc.bufferSize = mUniformBuffer.dataSize;
-    mvpUboDesc.usage = BufferUsage::UniformBuffer;
-    mvpUboDesc.memoryUsage = MemoryType(MemoryType::HostVisible | MemoryType::HostCoherent);
-    renderer.CreateBuffer(mvpUboDesc, mUniformBuffer.deviceObject);
-    
     SetupRenderPass();
     
     mWindow = std::make_unique<Window>("SummitEngine", defaultViewWidth, defaultViewHeight);
@@ -48,7 +43,7 @@ SummitDemo::SummitDemo(SummitEngine& engine)
     
     depthPrePassPipeline.effect.AddModule(ModuleStage::Vertex, "/Users/tomaskubovcik/Dev/SummitEngine/depth_pre_pass.spv");
     depthPrePassPipeline.effect.AddAttribute(Format::R32G32B32F, 0);
-    depthPrePassPipeline.effect.AddUniformBuffer(ModuleStage::Vertex, 0, mUniformBuffer);
+    depthPrePassPipeline.effect.AddDynamicUniformBuffer(ModuleStage::Vertex, 0, mUniformBuffer);
     depthPrePassPipeline.depthTestEnabled = true;
     depthPrePassPipeline.depthWriteEnabled = true;
     renderer.CreatePipeline(depthPrePassPipeline, mAdvancedRenderPass.GetDeviceObject());
@@ -67,7 +62,7 @@ SummitDemo::SummitDemo(SummitEngine& engine)
     const auto depthAttachments = framebuffer.GetAttachment(AttachmentType::DepthStencil);
     if(!depthAttachments.empty())
     {
-        mQuadPipeline.effect.AddUniformBuffer(ModuleStage::Vertex, 0, mUniformBuffer);
+        mQuadPipeline.effect.AddDynamicUniformBuffer(ModuleStage::Vertex, 0, mUniformBuffer);
         mQuadPipeline.effect.AddTexture(ModuleStage::Fragment, 1, *depthAttachments.back());
 
         renderer.CreatePipeline(mQuadPipeline, mAdvancedRenderPass.GetDeviceObject());
@@ -96,7 +91,7 @@ void SummitDemo::PrepareCube()
     pipeline.effect.AddAttribute(Format::R32G32F, 2);
 
     // Setup uniforms
-    pipeline.effect.AddUniformBuffer(ModuleStage::Vertex, 0, mUniformBuffer);
+    pipeline.effect.AddDynamicUniformBuffer(ModuleStage::Vertex, 0, mUniformBuffer);
     pipeline.effect.AddTexture(ModuleStage::Fragment, 1, *mTexture.get());
 
     pipeline.depthTestEnabled = true;
@@ -122,7 +117,7 @@ void SummitDemo::PrepareChalet()
     pipeline.effect.AddAttribute(Format::R32G32F, 2);
     
     // Setup uniforms
-    pipeline.effect.AddUniformBuffer(ModuleStage::Vertex, 0, mUniformBuffer);
+    pipeline.effect.AddDynamicUniformBuffer(ModuleStage::Vertex, 0, mUniformBuffer);
     pipeline.effect.AddTexture(ModuleStage::Fragment, 1, *mTexture.get());
     
     pipeline.depthTestEnabled = true;
@@ -241,7 +236,7 @@ void SummitDemo::UpdateCamera()
     mvp.view = mCamera.GetViewMatrix();
     mvp.projection = mCamera.GetProjectionMatrix();
     
-    mEngine->GetRenderer().MapMemory(mUniformBuffer.deviceObject, mUniformBuffer.dataSize, &mvp);
+    mEngine->GetRenderer().WriteUniformData(mUniformBuffer, &mvp);
 }
 
 void SummitDemo::OnEarlyUpdate(const FrameData& data)
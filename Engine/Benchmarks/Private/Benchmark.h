@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace Benchmark
+{
+    // Every measurement repeats the kernel until it ran at least this long
+    constexpr double MIN_DURATION = 0.1;
+
+    /*!
+     @return Elements processed per second.
+     */
+    inline double Measure(size_t count, const std::function<void()>& kernel)
+    {
+        // Warm up caches & page in the arrays
+        kernel();
+
+        using Clock = std::chrono::steady_clock;
+
+        uint64_t iterations{ 0 };
+        const auto start = Clock::now();
+        std::chrono::duration<double> elapsed{ 0.0 };
+
+        do
+        {
+            kernel();
+            ++iterations;
+            elapsed = Clock::now() - start;
+        }
+        while(elapsed.count() < MIN_DURATION);
+
+        return static_cast<double>(count) * iterations / elapsed.count();
+    }
+}
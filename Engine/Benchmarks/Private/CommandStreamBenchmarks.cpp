@@ -0,0 +1,259 @@
+#include "CommandStreamBenchmarks.h"
+#include "Benchmark.h"
+
+#include <Vulkan/VulkanCommandStream.h>
+
+#include <array>
+#include <cstdio>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+using Benchmark::Measure;
+using Renderer::VulkanCommandStream;
+
+namespace
+{
+    constexpr uint32_t DRAW_COUNT = 100000;
+
+    // Draws sharing pipeline & mesh, their binds are elided by the renderer so only sets & the draw are recorded per draw
+    constexpr uint32_t DRAWS_PER_MATERIAL = 16;
+
+    // Stands for Vulkan entry points, counting calls keeps the replay from being optimized out
+#define NULL_DEVICE_FUNCTION(Name) \
+    template<typename... Args> void Name(Args&&...) const noexcept { ++callCount; }
+
+    struct NullDevice
+    {
+        NULL_DEVICE_FUNCTION(BeginCommandBuffer)
+        NULL_DEVICE_FUNCTION(EndCommandBuffer)
+        NULL_DEVICE_FUNCTION(BeginRenderPass)
+        NULL_DEVICE_FUNCTION(NextSubpass)
+        NULL_DEVICE_FUNCTION(EndRenderPass)
+        NULL_DEVICE_FUNCTION(BindPipeline)
+        NULL_DEVICE_FUNCTION(CmdExecuteCommands)
+        NULL_DEVICE_FUNCTION(CmdBindVertexBuffer)
+        NULL_DEVICE_FUNCTION(CmdBindIndexBuffer)
+        NULL_DEVICE_FUNCTION(CmdBindDescriptorSets)
+        NULL_DEVICE_FUNCTION(CmdPushConstants)
+        NULL_DEVICE_FUNCTION(CmdSetViewport)
+        NULL_DEVICE_FUNCTION(CmdSetScissor)
+        NULL_DEVICE_FUNCTION(CmdDrawIndexed)
+        NULL_DEVICE_FUNCTION(CmdDrawIndexedIndirect)
+        NULL_DEVICE_FUNCTION(CmdDrawIndexedIndirectCountKHR)
+        NULL_DEVICE_FUNCTION(CmdDispatch)
+        NULL_DEVICE_FUNCTION(CmdDispatchIndirect)
+        NULL_DEVICE_FUNCTION(CmdCopyBuffer)
+        NULL_DEVICE_FUNCTION(CmdFillBuffer)
+        NULL_DEVICE_FUNCTION(CmdPipelineBarrier)
+
+        mutable uint64_t callCount{ 0 };
+    };
+
+#undef NULL_DEVICE_FUNCTION
+
+    template<typename Handle>
+    Handle MakeHandle(uint64_t value)
+    {
+        return reinterpret_cast<Handle>(static_cast<uintptr_t>(value));
+    }
+
+    void Report(const char* name, size_t count, double drawsPerSecond, double bytesPerDraw)
+    {
+        std::printf("%-36s %10zu %14.2f %12.1f\n", name, count, drawsPerSecond / 1.0e6, bytesPerDraw);
+    }
+
+    void RecordFrame(VulkanCommandStream& commands)
+    {
+        const VkPipelineLayout layout = MakeHandle<VkPipelineLayout>(0x10);
+        const std::array<VkBuffer, 2> vertexBuffers{ MakeHandle<VkBuffer>(0x20), MakeHandle<VkBuffer>(0x21) };
+        const std::array<VkDeviceSize, 2> vertexOffsets{};
+
+        for(uint32_t draw = 0; draw < DRAW_COUNT; ++draw)
+        {
+            if(draw % DRAWS_PER_MATERIAL == 0)
+            {
+                commands.BindPipeline(MakeHandle<VkPipeline>(0x30 + draw), VK_PIPELINE_BIND_POINT_GRAPHICS);
+                commands.BindVertexBuffers(0, 2, vertexBuffers.data(), vertexOffsets.data());
+                commands.BindIndexBuffer(MakeHandle<VkBuffer>(0x22), 0, VK_INDEX_TYPE_UINT16);
+            }
+
+            // Object set differs per draw by its dynamic offset
+            const VkDescriptorSet set = MakeHandle<VkDescriptorSet>(0x40);
+            const uint32_t dynamicOffset = draw * 256;
+
+            commands.BindDescriptorSets(layout, VK_PIPELINE_BIND_POINT_GRAPHICS, 1, 1, &set, 1, &dynamicOffset);
+            commands.DrawIndexed(36, 1, 0, 0, 0);
+        }
+    }
+
+    /*!
+     @brief Type erased commands the stream replaced, 96 byte box per command executed by virtual call,
+            command buffer was looked up per command from its device object.
+     */
+    class CommandBufferSource
+    {
+    public:
+        explicit CommandBufferSource(VkCommandBuffer commandBuffer) : mCommandBuffer(commandBuffer) {}
+        virtual ~CommandBufferSource() = default;
+
+        virtual VkCommandBuffer Get() const { return mCommandBuffer; }
+
+    private:
+        VkCommandBuffer mCommandBuffer{ VK_NULL_HANDLE };
+    };
+
+    class IBoxedCommand
+    {
+    public:
+        virtual ~IBoxedCommand() = default;
+
+        virtual void Execute(const NullDevice& device, const CommandBufferSource& commandBuffer) const = 0;
+        virtual IBoxedCommand* Move(void* address) = 0;
+    };
+
+    template<typename T>
+    class BoxedCommandImpl final : public IBoxedCommand
+    {
+    public:
+        BoxedCommandImpl(T v) : data(v) {}
+
+        void Execute(const NullDevice& device, const CommandBufferSource& commandBuffer) const override { data.Execute(device, commandBuffer.Get()); }
+        IBoxedCommand* Move(void* address) override { return new (address) BoxedCommandImpl(data); }
+
+        T data;
+    };
+
+    class BoxedCommand
+    {
+        static constexpr size_t maxStorageSize = 96 - sizeof(IBoxedCommand*);
+
+    public:
+        template<typename T>
+        BoxedCommand(T command)
+        {
+            static_assert(sizeof(BoxedCommandImpl<T>) <= maxStorageSize, "Object too big");
+            mImpl = new (&mStorage) BoxedCommandImpl<T>(command);
+        }
+
+        BoxedCommand(BoxedCommand&& other) noexcept : mImpl(other.mImpl->Move(&mStorage)) {}
+
+        void Execute(const NullDevice& device, const CommandBufferSource& commandBuffer) const { mImpl->Execute(device, commandBuffer); }
+
+    private:
+        std::aligned_storage<maxStorageSize>::type mStorage;
+        IBoxedCommand* mImpl{ nullptr };
+    };
+
+    struct BoxedBindPipeline
+    {
+        void Execute(const NullDevice& device, VkCommandBuffer commandBuffer) const { device.BindPipeline(commandBuffer, bindPoint, pipeline); }
+
+        VkPipeline pipeline;
+        VkPipelineBindPoint bindPoint;
+    };
+
+    struct BoxedBindVertexBuffers
+    {
+        void Execute(const NullDevice& device, VkCommandBuffer commandBuffer) const { device.CmdBindVertexBuffer(commandBuffer, 0, 2, buffers.data(), offsets.data()); }
+
+        std::array<VkBuffer, 2> buffers;
+        std::array<VkDeviceSize, 2> offsets;
+    };
+
+    struct BoxedBindIndexBuffer
+    {
+        void Execute(const NullDevice& device, VkCommandBuffer commandBuffer) const { device.CmdBindIndexBuffer(commandBuffer, buffer, 0, indexType); }
+
+        VkBuffer buffer;
+        VkIndexType indexType;
+    };
+
+    struct BoxedBindDescriptorSets
+    {
+        void Execute(const NullDevice& device, VkCommandBuffer commandBuffer) const
+        {
+            device.CmdBindDescriptorSets(commandBuffer, bindPoint, layout, firstSet, setCount, sets.data(), dynamicOffsetCount, dynamicOffsets.data());
+        }
+
+        VkPipelineLayout layout;
+        VkPipelineBindPoint bindPoint;
+        std::array<VkDescriptorSet, 4> sets;
+        uint32_t firstSet;
+        uint32_t setCount;
+        std::array<uint32_t, 4> dynamicOffsets;
+        uint32_t dynamicOffsetCount;
+    };
+
+    struct BoxedDrawIndexed
+    {
+        void Execute(const NullDevice& device, VkCommandBuffer commandBuffer) const
+        {
+            device.CmdDrawIndexed(commandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+        }
+
+        uint32_t indexCount;
+        uint32_t instanceCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+        uint32_t firstInstance;
+    };
+
+    void RecordFrame(std::vector<BoxedCommand>& commands)
+    {
+        const VkPipelineLayout layout = MakeHandle<VkPipelineLayout>(0x10);
+
+        for(uint32_t draw = 0; draw < DRAW_COUNT; ++draw)
+        {
+            if(draw % DRAWS_PER_MATERIAL == 0)
+            {
+                commands.emplace_back(BoxedBindPipeline{ MakeHandle<VkPipeline>(0x30 + draw), VK_PIPELINE_BIND_POINT_GRAPHICS });
+                commands.emplace_back(BoxedBindVertexBuffers{ { MakeHandle<VkBuffer>(0x20), MakeHandle<VkBuffer>(0x21) }, {} });
+                commands.emplace_back(BoxedBindIndexBuffer{ MakeHandle<VkBuffer>(0x22), VK_INDEX_TYPE_UINT16 });
+            }
+
+            commands.emplace_back(BoxedBindDescriptorSets{ layout, VK_PIPELINE_BIND_POINT_GRAPHICS, { MakeHandle<VkDescriptorSet>(0x40) }, 1, 1, { draw * 256 }, 1 });
+            commands.emplace_back(BoxedDrawIndexed{ 36, 1, 0, 0, 0 });
+        }
+    }
+}
+
+void RunCommandStreamBenchmarks()
+{
+    std::printf("Command stream: %u draws per frame, %u draws per material, null device\n", DRAW_COUNT, DRAWS_PER_MATERIAL);
+    std::printf("%-36s %10s %14s %12s\n", "Benchmark", "Draws", "M draws/s", "Bytes/draw");
+
+    const NullDevice device;
+    const VkCommandBuffer commandBuffer = MakeHandle<VkCommandBuffer>(0x1);
+
+    // Arena keeps its memory between frames as the renderer's does
+    VulkanCommandStream stream;
+    const double streamRecord = Measure(DRAW_COUNT, [&](){
+        stream.Clear();
+        RecordFrame(stream);
+    });
+
+    const double streamBytes = static_cast<double>(stream.GetSize()) / DRAW_COUNT;
+    Report("VulkanCommandStream::Record", DRAW_COUNT, streamRecord, streamBytes);
+    Report("VulkanCommandStream::Replay", DRAW_COUNT, Measure(DRAW_COUNT, [&](){
+        stream.Replay(device, commandBuffer);
+    }), streamBytes);
+
+    std::vector<BoxedCommand> boxed;
+    const double boxedRecord = Measure(DRAW_COUNT, [&](){
+        boxed.clear();
+        RecordFrame(boxed);
+    });
+
+    const CommandBufferSource commandBufferSource(commandBuffer);
+    const double boxedBytes = static_cast<double>(boxed.size() * sizeof(BoxedCommand)) / DRAW_COUNT;
+    Report("Type erased commands::Record", DRAW_COUNT, boxedRecord, boxedBytes);
+    Report("Type erased commands::Replay", DRAW_COUNT, Measure(DRAW_COUNT, [&](){
+        for(const auto& command : boxed)
+        {
+            command.Execute(device, commandBufferSource);
+        }
+    }), boxedBytes);
+
+    std::printf("Null device calls: %llu\n", static_cast<unsigned long long>(device.callCount));
+}
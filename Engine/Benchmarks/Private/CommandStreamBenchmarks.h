@@ -0,0 +1,7 @@
+#pragma once
+
+/*!
+ @brief Records & replays frame of draws into renderer's command stream against null device, prints draws per second
+        & bytes recorded per draw next to the type erased commands the stream replaced.
+ */
+void RunCommandStreamBenchmarks();
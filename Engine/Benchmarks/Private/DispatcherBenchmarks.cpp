@@ -0,0 +1,155 @@
+#include "DispatcherBenchmarks.h"
+#include "Benchmark.h"
+
+#include <Dispatcher/InlineTask.h>
+#include <Dispatcher/MPMCQueue.h>
+#include <Dispatcher/Queue.h>
+#include <Dispatcher/SummitDispatcher.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using Benchmark::Measure;
+
+namespace
+{
+    constexpr uint32_t TASK_COUNT = 1 << 16;
+
+    // Same capacity as the dispatcher strand
+    constexpr size_t RING_CAPACITY = 1024;
+
+    void Report(const char* name, uint32_t producers, double tasksPerSecond)
+    {
+        std::printf("%-36s %10u %14.2f\n", name, producers, tasksPerSecond / 1.0e6);
+    }
+
+    /*!
+     @brief Starts producers each posting its share of TASK_COUNT tasks, consumer runs on the calling thread.
+     */
+    template<typename Produce, typename Consume>
+    void RunProducers(uint32_t producerCount, Produce&& produce, Consume&& consume)
+    {
+        std::vector<std::thread> producers;
+        producers.reserve(producerCount);
+
+        for(uint32_t i = 0; i < producerCount; ++i)
+        {
+            const uint32_t count = TASK_COUNT / producerCount + (i < TASK_COUNT % producerCount ? 1 : 0);
+            producers.emplace_back([&produce, count](){ produce(count); });
+        }
+
+        consume();
+
+        for(auto& producer : producers)
+        {
+            producer.join();
+        }
+    }
+
+    // Path of the original dispatcher, every post allocates the shared callable & takes the queue lock
+    double MeasureSharedFunctionQueue(uint32_t producerCount)
+    {
+        Core::Queue<std::shared_ptr<std::function<void()>>> queue;
+        uint32_t executed{ 0 };
+
+        return Measure(TASK_COUNT, [&](){
+            executed = 0;
+
+            RunProducers(producerCount, [&](uint32_t count){
+                for(uint32_t i = 0; i < count; ++i)
+                {
+                    queue.Push(std::make_shared<std::function<void()>>([&executed](){ ++executed; }));
+                }
+            }, [&](){
+                while(executed < TASK_COUNT)
+                {
+                    if(auto task = queue.Pop())
+                    {
+                        (*task)();
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        });
+    }
+
+    double MeasureInlineTaskRing(uint32_t producerCount)
+    {
+        auto queue = std::make_unique<Core::MPMCQueue<Core::InlineTask, RING_CAPACITY>>();
+        uint32_t executed{ 0 };
+
+        return Measure(TASK_COUNT, [&](){
+            executed = 0;
+
+            RunProducers(producerCount, [&](uint32_t count){
+                for(uint32_t i = 0; i < count; ++i)
+                {
+                    Core::InlineTask task([&executed](){ ++executed; });
+
+                    while(!queue->TryPush(std::move(task)))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            }, [&](){
+                Core::InlineTask task;
+
+                while(executed < TASK_COUNT)
+                {
+                    if(queue->TryPop(task))
+                    {
+                        task();
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        });
+    }
+
+    // End to end through the strand, consumer is whichever job system worker drains it
+    double MeasureDispatcherPost(Core::SummitDispatcher& dispatcher, uint32_t producerCount)
+    {
+        std::atomic<uint32_t> executed{ 0 };
+
+        return Measure(TASK_COUNT, [&](){
+            executed.store(0, std::memory_order_relaxed);
+
+            RunProducers(producerCount, [&](uint32_t count){
+                for(uint32_t i = 0; i < count; ++i)
+                {
+                    dispatcher.Post([&executed](){ executed.fetch_add(1, std::memory_order_relaxed); });
+                }
+            }, [](){});
+
+            dispatcher.WaitIdle();
+        });
+    }
+}
+
+void RunDispatcherBenchmarks()
+{
+    const uint32_t maxProducers = std::max(1u, std::thread::hardware_concurrency());
+
+    Core::SummitDispatcher dispatcher;
+
+    std::printf("Dispatcher: %u tasks per run\n", TASK_COUNT);
+    std::printf("%-36s %10s %14s\n", "Path", "Producers", "M tasks/s");
+
+    for(uint32_t producers = 1; producers <= maxProducers; ++producers)
+    {
+        Report("shared std::function + locked deque", producers, MeasureSharedFunctionQueue(producers));
+        Report("InlineTask + MPMCQueue", producers, MeasureInlineTaskRing(producers));
+        Report("SummitDispatcher::Post", producers, MeasureDispatcherPost(dispatcher, producers));
+    }
+}
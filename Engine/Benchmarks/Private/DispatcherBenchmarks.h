@@ -0,0 +1,7 @@
+#pragma once
+
+/*!
+ @brief Posts tasks from growing number of producer threads to a single consumer, prints tasks per second of the
+        shared std::function & locked deque path the dispatcher used before next to the inline task ring.
+ */
+void RunDispatcherBenchmarks();
@@ -0,0 +1,155 @@
+#include "MathBenchmarks.h"
+#include "Benchmark.h"
+
+#include <Dispatcher/JobSystem.h>
+#include <Math/BatchKernels.h>
+#include <Math/MatrixKernels.h>
+#include <Math/Simd.h>
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using Benchmark::Measure;
+
+namespace
+{
+    constexpr size_t COUNTS[] = { 1 << 10, 1 << 13, 1 << 16, 1 << 20 };
+
+    // Elements per job system batch
+    constexpr uint32_t PARALLEL_BATCH_SIZE = 4096;
+
+    const char* GetInstructionSetName()
+    {
+#if defined(MATH_SIMD_AVX2)
+        return "AVX2";
+#elif defined(MATH_SIMD_SSE)
+        return "SSE";
+#elif defined(MATH_SIMD_NEON)
+        return "NEON";
+#else
+        return "Scalar";
+#endif
+    }
+
+    void Report(const char* name, size_t count, double elementsPerSecond)
+    {
+        std::printf("%-36s %10zu %14.2f\n", name, count, elementsPerSecond / 1.0e6);
+    }
+
+    struct TransformData
+    {
+        explicit TransformData(size_t count)
+        {
+            std::mt19937 generator(count);
+            std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+            std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+            std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+            for(auto* component : { &positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &scaleX, &scaleY, &scaleZ, &extentX, &extentY, &extentZ })
+            {
+                component->resize(count);
+            }
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                positionX[i] = position(generator);
+                positionY[i] = position(generator);
+                positionZ[i] = position(generator);
+                rotationX[i] = angle(generator);
+                rotationY[i] = angle(generator);
+                rotationZ[i] = angle(generator);
+                scaleX[i] = scale(generator);
+                scaleY[i] = scale(generator);
+                scaleZ[i] = scale(generator);
+                extentX[i] = scale(generator);
+                extentY[i] = scale(generator);
+                extentZ[i] = scale(generator);
+            }
+        }
+
+        Math::TransformStreams GetStreams(size_t first) const
+        {
+            Math::TransformStreams streams;
+            streams.positionX = { positionX.data() + first };
+            streams.positionY = { positionY.data() + first };
+            streams.positionZ = { positionZ.data() + first };
+            streams.rotationX = { rotationX.data() + first };
+            streams.rotationY = { rotationY.data() + first };
+            streams.rotationZ = { rotationZ.data() + first };
+            streams.scaleX = { scaleX.data() + first };
+            streams.scaleY = { scaleY.data() + first };
+            streams.scaleZ = { scaleZ.data() + first };
+            return streams;
+        }
+
+        std::vector<float> positionX, positionY, positionZ;
+        std::vector<float> rotationX, rotationY, rotationZ;
+        std::vector<float> scaleX, scaleY, scaleZ;
+        std::vector<float> extentX, extentY, extentZ;
+    };
+}
+
+void RunMathBenchmarks(Core::JobSystem& jobSystem)
+{
+    std::printf("Math kernels: %s, %u workers\n", GetInstructionSetName(), jobSystem.GetWorkerCount());
+    std::printf("%-36s %10s %14s\n", "Kernel", "Count", "M elements/s");
+
+    for(const size_t count : COUNTS)
+    {
+        const TransformData data(count);
+
+        std::vector<Matrix4> world(count);
+        std::vector<Matrix4> result(count);
+        std::vector<float> centerX(count), centerY(count), centerZ(count);
+        std::vector<float> extentX(count), extentY(count), extentZ(count);
+
+        Math::Batch::ComposeTransforms(data.GetStreams(0), world.data(), count);
+
+        Matrix4 viewProjection = Matrix4::MakePerspective(1.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+
+        Report("Reference::MultiplyMatrices", count, Measure(count, [&](){
+            Math::Reference::MultiplyMatrices(world.data()->GetData(), world.data()->GetData(), result.data()->GetData(), count);
+        }));
+
+        Report("Batch::MultiplyMatrices", count, Measure(count, [&](){
+            Math::Batch::MultiplyMatrices(world.data(), world.data(), result.data(), count);
+        }));
+
+        Report("Batch::MultiplyMatrices (shared b)", count, Measure(count, [&](){
+            Math::Batch::MultiplyMatrices(world.data(), viewProjection, result.data(), count);
+        }));
+
+        Report("Batch::TransformPoints", count, Measure(count, [&](){
+            Math::Batch::TransformPoints(viewProjection,
+                                         { data.positionX.data(), data.positionY.data(), data.positionZ.data() },
+                                         { centerX.data(), centerY.data(), centerZ.data() },
+                                         count);
+        }));
+
+        Report("Batch::ComposeTransforms", count, Measure(count, [&](){
+            Math::Batch::ComposeTransforms(data.GetStreams(0), result.data(), count);
+        }));
+
+        Report("Batch::TransformBoundingBoxes", count, Measure(count, [&](){
+            Math::Batch::TransformBoundingBoxes(world.data(),
+                                                { data.positionX.data(), data.positionY.data(), data.positionZ.data() },
+                                                { data.extentX.data(), data.extentY.data(), data.extentZ.data() },
+                                                { centerX.data(), centerY.data(), centerZ.data() },
+                                                { extentX.data(), extentY.data(), extentZ.data() },
+                                                count);
+        }));
+
+        Report("Batch::ComposeTransforms (jobs)", count, Measure(count, [&](){
+            jobSystem.ParallelFor(static_cast<uint32_t>(count), PARALLEL_BATCH_SIZE, [&](uint32_t begin, uint32_t end){
+                Math::Batch::ComposeTransforms(data.GetStreams(begin), result.data() + begin, end - begin);
+            });
+        }));
+
+        Report("Batch::MultiplyMatrices (jobs)", count, Measure(count, [&](){
+            jobSystem.ParallelFor(static_cast<uint32_t>(count), PARALLEL_BATCH_SIZE, [&](uint32_t begin, uint32_t end){
+                Math::Batch::MultiplyMatrices(world.data() + begin, viewProjection, result.data() + begin, end - begin);
+            });
+        }));
+    }
+}
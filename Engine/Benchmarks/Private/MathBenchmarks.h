@@ -0,0 +1,11 @@
+#pragma once
+
+namespace Core
+{
+    class JobSystem;
+}
+
+/*!
+ @brief Measures throughput of batched math kernels for growing element counts & prints matrices per second.
+ */
+void RunMathBenchmarks(Core::JobSystem& jobSystem);
@@ -0,0 +1,16 @@
+#include "MathBenchmarks.h"
+#include "CommandStreamBenchmarks.h"
+#include "DispatcherBenchmarks.h"
+
+#include <Dispatcher/JobSystem.h>
+
+int main(int argc, char** argv)
+{
+    Core::JobSystem jobSystem;
+
+    RunMathBenchmarks(jobSystem);
+    RunCommandStreamBenchmarks();
+    RunDispatcherBenchmarks();
+
+    return 0;
+}
@@ -0,0 +1,308 @@
+#include <Dispatcher/JobSystem.h>
+#include <Core/Thread.h>
+#include <Logging/LoggingService.h>
+
+#include <microprofile/microprofile.h>
+
+#include <algorithm>
+#include <string>
+
+#ifdef LOG_MODULE_ID
+#undef LOG_MODULE_ID
+#endif
+
+#define LOG_MODULE_ID LOG_MODULE_4BYTE('J','O','B','S')
+
+namespace
+{
+    thread_local Core::JobSystem* tJobSystem{ nullptr };
+    thread_local int32_t tWorkerIndex{ -1 };
+}
+
+namespace Core
+{
+    Job::Job(InlineTask&& task, JobCounter* counter)
+        : mTask(std::move(task))
+        , mCounter(counter)
+    {
+    }
+
+    bool Job::AddContinuation(const JobHandle& job)
+    {
+        std::lock_guard<std::mutex> lock(mContinuationMutex);
+
+        if(mFinished.load(std::memory_order_acquire))
+            return false;
+
+        mContinuations.push_back(job);
+        return true;
+    }
+
+    JobSystem::JobSystem(uint32_t workerCount)
+    {
+        if(workerCount == 0)
+        {
+            workerCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        mWorkers.reserve(workerCount);
+
+        for(uint32_t i = 0; i < workerCount; ++i)
+        {
+            mWorkers.push_back(std::make_unique<Worker>());
+        }
+
+        // Start threads once all deques exist so workers can steal right away
+        for(uint32_t i = 0; i < workerCount; ++i)
+        {
+            mWorkers[i]->thread = std::thread([this, i](){
+                const std::string name = "SummitWorker" + std::to_string(i);
+                SetCurrentThreadName(name.c_str());
+                MicroProfileOnThreadCreate(name.c_str());
+                WorkerLoop(i);
+            });
+        }
+
+        LOG(Information) << "Job system started with " << workerCount << " workers";
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+            mIsRunning.store(false);
+        }
+
+        mWakeCondition.notify_all();
+
+        for(auto& worker : mWorkers)
+        {
+            if(worker->thread.joinable())
+                worker->thread.join();
+        }
+    }
+
+    JobHandle JobSystem::Run(InlineTask&& task, std::initializer_list<JobHandle> dependencies, JobCounter* counter)
+    {
+        return Submit(std::move(task), dependencies, counter);
+    }
+
+    JobHandle JobSystem::Run(InlineTask&& task, const std::vector<JobHandle>& dependencies, JobCounter* counter)
+    {
+        return Submit(std::move(task), dependencies, counter);
+    }
+
+    void JobSystem::Post(InlineTask&& task)
+    {
+        mPendingJobs.fetch_add(1, std::memory_order_release);
+
+        while(!mTaskQueue.TryPush(std::move(task)))
+        {
+            if(!TryRunOne())
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        WakeWorker();
+    }
+
+    template<typename Container>
+    JobHandle JobSystem::Submit(InlineTask&& task, const Container& dependencies, JobCounter* counter)
+    {
+        auto job = std::make_shared<Job>(std::move(task), counter);
+
+        if(counter)
+        {
+            counter->mValue.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // One extra dependency guards against the job being released while continuations are registered
+        job->mPendingDependencies.store(static_cast<uint32_t>(dependencies.size()) + 1, std::memory_order_relaxed);
+
+        uint32_t resolved = 1;
+        for(const auto& dependency : dependencies)
+        {
+            if(!dependency || !dependency->AddContinuation(job))
+            {
+                ++resolved;
+            }
+        }
+
+        if(job->mPendingDependencies.fetch_sub(resolved, std::memory_order_acq_rel) == resolved)
+        {
+            Enqueue(job);
+        }
+
+        return job;
+    }
+
+    void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t, uint32_t)>& func)
+    {
+        if(count == 0)
+            return;
+
+        batchSize = std::max(1u, batchSize);
+
+        JobCounter counter;
+        for(uint32_t begin = 0; begin < count; begin += batchSize)
+        {
+            const uint32_t end = std::min(count, begin + batchSize);
+            Run([&func, begin, end](){ func(begin, end); }, {}, &counter);
+        }
+
+        Wait(counter);
+    }
+
+    void JobSystem::Wait(const JobHandle& job)
+    {
+        if(!job)
+            return;
+
+        while(!job->IsFinished())
+        {
+            if(!TryRunOne())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::Wait(const JobCounter& counter)
+    {
+        while(!counter.IsDone())
+        {
+            if(!TryRunOne())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    int32_t JobSystem::GetCurrentWorkerIndex() const noexcept
+    {
+        return tJobSystem == this ? tWorkerIndex : -1;
+    }
+
+    void JobSystem::Enqueue(const JobHandle& job)
+    {
+        job->mSelf = job;
+        mPendingJobs.fetch_add(1, std::memory_order_release);
+
+        const int32_t workerIndex = GetCurrentWorkerIndex();
+        if(workerIndex < 0 || !mWorkers[workerIndex]->queue.Push(job.get()))
+        {
+            mInjectionQueue.Push(job.get());
+        }
+
+        WakeWorker();
+    }
+
+    void JobSystem::WakeWorker()
+    {
+        {
+            // Empty critical section closes the window between predicate check and wait in sleeping workers
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+        }
+
+        mWakeCondition.notify_one();
+    }
+
+    void JobSystem::Execute(Job* job)
+    {
+        JobHandle self = std::move(job->mSelf);
+
+        job->mTask();
+        job->mTask.Reset();
+
+        std::vector<JobHandle> continuations;
+        {
+            std::lock_guard<std::mutex> lock(job->mContinuationMutex);
+            job->mFinished.store(true, std::memory_order_release);
+            continuations.swap(job->mContinuations);
+        }
+
+        for(const auto& continuation : continuations)
+        {
+            if(continuation->mPendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                Enqueue(continuation);
+            }
+        }
+
+        if(job->mCounter)
+        {
+            job->mCounter->mValue.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    Job* JobSystem::StealJob(int32_t workerIndex)
+    {
+        if(Job* job = mInjectionQueue.Pop())
+            return job;
+
+        // Start stealing from the neighbour so workers don't all hammer the same victim
+        const uint32_t workerCount = GetWorkerCount();
+        const uint32_t start = workerIndex >= 0 ? static_cast<uint32_t>(workerIndex) + 1 : 0;
+
+        for(uint32_t i = 0; i < workerCount; ++i)
+        {
+            const uint32_t victim = (start + i) % workerCount;
+            if(static_cast<int32_t>(victim) == workerIndex)
+                continue;
+
+            if(Job* job = mWorkers[victim]->queue.Steal())
+                return job;
+        }
+
+        return nullptr;
+    }
+
+    bool JobSystem::TryRunOne()
+    {
+        const int32_t workerIndex = GetCurrentWorkerIndex();
+
+        Job* job = workerIndex >= 0 ? mWorkers[workerIndex]->queue.Pop() : nullptr;
+
+        if(!job)
+        {
+            InlineTask task;
+            if(mTaskQueue.TryPop(task))
+            {
+                mPendingJobs.fetch_sub(1, std::memory_order_acq_rel);
+                task();
+                return true;
+            }
+
+            job = StealJob(workerIndex);
+        }
+
+        if(!job)
+            return false;
+
+        mPendingJobs.fetch_sub(1, std::memory_order_acq_rel);
+        Execute(job);
+
+        return true;
+    }
+
+    void JobSystem::WorkerLoop(uint32_t index)
+    {
+        tJobSystem = this;
+        tWorkerIndex = static_cast<int32_t>(index);
+
+        while(mIsRunning.load(std::memory_order_acquire))
+        {
+            if(TryRunOne())
+                continue;
+
+            std::unique_lock<std::mutex> lock(mSleepMutex);
+            mWakeCondition.wait(lock, [this](){
+                return mPendingJobs.load(std::memory_order_acquire) > 0 || !mIsRunning.load(std::memory_order_acquire);
+            });
+        }
+
+        tJobSystem = nullptr;
+        tWorkerIndex = -1;
+    }
+}
@@ -1,10 +1,14 @@
 #include <Dispatcher/SummitDispatcher.h>
+#include <Core/Thread.h>
+#include <Core/Assert.h>
 #include <Logging/LoggingService.h>
 
 #include <microprofile/microprofile.h>
 
-#include <unordered_map>
-#include <pthread.h>
+namespace
+{
+    thread_local bool tInsideStrand{ false };
+}
 
 namespace Core
 {
@@ -16,65 +20,234 @@ namespace Core
     }
     
     SummitDispatcher::SummitDispatcher()
+        : mStartTime(std::chrono::steady_clock::now())
     {
+        mTimerThread = std::thread([this](){
+            SetCurrentThreadName("SummitDispatcher");
+            MicroProfileOnThreadCreate("Dispatcher");
+            TimerLoop();
+        });
     }
     
     SummitDispatcher::~SummitDispatcher()
     {
-        mIsRunning = false;
-        mThread.join();
+        {
+            std::lock_guard<std::mutex> lock(mTimerMutex);
+            mIsRunning = false;
+        }
+        
+        mTimerCondition.notify_one();
+        mTimerThread.join();
+        
+        // Let the workers finish whatever is left in the strand
+        while(mStrandPending.load(std::memory_order_acquire) > 0)
+        {
+            std::this_thread::yield();
+        }
     }
     
-    uint32_t SummitDispatcher::Schedule(uint32_t deltaTime, std::function<void()>&& f, bool repeat)
+    uint64_t SummitDispatcher::GetCurrentTick() const
     {
-        if(!mIsRunning)
+        return static_cast<uint64_t>((std::chrono::steady_clock::now() - mStartTime) / TimerTickDuration);
+    }
+    
+    TimerId SummitDispatcher::Schedule(uint32_t deltaTime, InlineTask&& task, bool repeat)
+    {
+        const uint64_t ticks = (deltaTime + TimerTickDuration.count() - 1) / TimerTickDuration.count();
+        
+        TimerId id = InvalidTimerId;
         {
-            CreateThread();
+            std::lock_guard<std::mutex> lock(mTimerMutex);
+            
+            // Wheel only turns when the timer thread wakes up, measure delay from real time
+            const uint64_t now = GetCurrentTick();
+            const uint64_t lag = now > mTimerWheel.GetCurrentTick() ? now - mTimerWheel.GetCurrentTick() : 0;
+            
+            id = mTimerWheel.Add(lag + ticks, repeat ? std::max<uint64_t>(ticks, 1) : 0, std::move(task));
         }
         
-        mFunc = f;
-        return 0;
+        mTimerCondition.notify_one();
+        
+        return id;
     }
     
-    void SummitDispatcher::Post(std::function<void()>&& f)
+    bool SummitDispatcher::Cancel(TimerId id)
     {
-        auto taskPtr = std::make_shared<std::function<void()>>(std::move(f));
-        mQueue.Push(std::move(taskPtr));
+        std::lock_guard<std::mutex> lock(mTimerMutex);
+        return mTimerWheel.Cancel(id);
     }
     
-    void SummitDispatcher::CreateThread()
+    void SummitDispatcher::Post(InlineTask&& task)
     {
-        mIsRunning = true;
+        while(true)
+        {
+            // Overflowed tasks were posted earlier than anything still to come, keep appending behind them
+            if(mOverflowCount.load(std::memory_order_acquire) > 0)
+            {
+                std::lock_guard<std::mutex> lock(mOverflowMutex);
+                
+                if(!mOverflowQueue.empty())
+                {
+                    mOverflowQueue.push_back(std::move(task));
+                    mOverflowCount.fetch_add(1, std::memory_order_release);
+                    break;
+                }
+            }
+            
+            if(mStrandQueue.TryPush(std::move(task)))
+                break;
+            
+            // Strand is the only consumer, waiting for space from within it would never end
+            if(tInsideStrand)
+            {
+                std::lock_guard<std::mutex> lock(mOverflowMutex);
+                
+                if(mOverflowQueue.empty())
+                {
+                    LOG(Warning) << "Dispatcher strand queue full, posted tasks overflow to the heap";
+                }
+                
+                mOverflowQueue.push_back(std::move(task));
+                mOverflowCount.fetch_add(1, std::memory_order_release);
+                break;
+            }
+            
+            std::this_thread::yield();
+        }
         
-        mThread = std::thread([this](){
-            pthread_setname_np("SummitDispatcher");
-            MicroProfileOnThreadCreate("Dispatcher");
-            Worker();
-        });
+        // First pending task starts the drain job, the rest is picked up by the running one
+        if(mStrandPending.fetch_add(1, std::memory_order_acq_rel) == 0)
+        {
+            mJobSystem.Post([this](){ DrainStrand(); });
+        }
     }
     
-    void SummitDispatcher::Worker()
+    bool SummitDispatcher::PopStrandTask(InlineTask& task)
     {
-        uint32_t mCnt{ 0 };
+        if(mStrandQueue.TryPop(task))
+            return true;
         
-        while(mIsRunning)
+        // Ring is drained, overflow holds the tasks posted after it filled up
+        if(mOverflowCount.load(std::memory_order_acquire) == 0)
+            return false;
+        
+        std::lock_guard<std::mutex> lock(mOverflowMutex);
+        
+        if(mOverflowQueue.empty())
+            return false;
+        
+        task = std::move(mOverflowQueue.front());
+        mOverflowQueue.pop_front();
+        mOverflowCount.fetch_sub(1, std::memory_order_release);
+        
+        return true;
+    }
+    
+    void SummitDispatcher::WaitIdle()
+    {
+        _ASSERT(!tInsideStrand && "Strand can't wait for itself");
+        
+        {
+            // Expired callbacks are fired outside the lock, cancelled timer may be firing right now
+            std::unique_lock<std::mutex> lock(mTimerMutex);
+            mFiringCondition.wait(lock, [this]{ return !mFiring; });
+        }
+        
+        while(mStrandPending.load(std::memory_order_acquire) > 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+    
+    void SummitDispatcher::DrainStrand()
+    {
+        tInsideStrand = true;
+        
+        for(uint32_t budget = StrandBatchSize; budget > 0; --budget)
         {
-            mCnt++;
+            InlineTask task;
+            
+            // Counter is bumped after push, but the slot may still be in flight from a concurrent producer
+            while(!PopStrandTask(task))
+            {
+                std::this_thread::yield();
+            }
             
-            //if(mQueue.Size() > 0)
-            //    LOG(Debug) << "Queue Size: " << mQueue.Size();
+            task();
+            
+            if(mStrandPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                tInsideStrand = false;
+                return;
+            }
+        }
+        
+        tInsideStrand = false;
+        
+        // Give other jobs a chance before continuing with the rest of the strand
+        mJobSystem.Post([this](){ DrainStrand(); });
+    }
+    
+    void SummitDispatcher::RunRepeatingTimer(TimerId id)
+    {
+        InlineTask task;
+        {
+            std::lock_guard<std::mutex> lock(mTimerMutex);
+            task = mTimerWheel.TakeTask(id);
+        }
+        
+        // Cancelled while waiting in the strand
+        if(!task)
+            return;
+        
+        task();
+        
+        std::lock_guard<std::mutex> lock(mTimerMutex);
+        mTimerWheel.ReturnTask(id, task);
+    }
+    
+    void SummitDispatcher::TimerLoop()
+    {
+        std::vector<TimerWheel::Expired> expired;
+        std::unique_lock<std::mutex> lock(mTimerMutex);
+        
+        while(mIsRunning)
+        {
+            mTimerWheel.Advance(GetCurrentTick(), expired);
             
-            auto funcPtr = mQueue.Pop();
-            if(funcPtr)
+            if(!expired.empty())
             {
-                auto func = *funcPtr.get();
-                func();
+                mFiring = true;
+                lock.unlock();
+                
+                for(auto& timer : expired)
+                {
+                    if(timer.task)
+                    {
+                        Post(std::move(timer.task));
+                    }
+                    else
+                    {
+                        const TimerId id = timer.id;
+                        Post([this, id](){ RunRepeatingTimer(id); });
+                    }
+                }
+                
+                expired.clear();
+                lock.lock();
+                
+                mFiring = false;
+                mFiringCondition.notify_all();
+                continue;
             }
             
-            if(mCnt % 1000000 == 0)
+            if(const auto wakeTick = mTimerWheel.GetNextWakeTick())
+            {
+                mTimerCondition.wait_until(lock, mStartTime + TimerTickDuration * (*wakeTick));
+            }
+            else
             {
-                mFunc();
-                mCnt = 0;
+                mTimerCondition.wait(lock);
             }
         }
     }
@@ -0,0 +1,277 @@
+#include <Dispatcher/TimerWheel.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Core
+{
+    TimerWheel::TimerWheel()
+    {
+        for(auto& level : mSlots)
+        {
+            level.fill(InvalidIndex);
+        }
+    }
+
+    TimerId TimerWheel::MakeId(uint32_t index) const noexcept
+    {
+        return ((mNodes[index].generation & GenerationMask) << IndexBits) | index;
+    }
+
+    TimerId TimerWheel::Add(uint64_t delay, uint64_t period, InlineTask&& task)
+    {
+        uint32_t index = InvalidIndex;
+
+        if(!mFreeNodes.empty())
+        {
+            index = mFreeNodes.back();
+            mFreeNodes.pop_back();
+        }
+        else
+        {
+            if(mNodes.size() > IndexMask)
+            {
+                throw std::runtime_error("TimerWheel capacity exceeded");
+            }
+
+            index = static_cast<uint32_t>(mNodes.size());
+            mNodes.emplace_back();
+        }
+
+        constexpr uint64_t maxDelay = (uint64_t(1) << (SlotBits * LevelCount)) - 1;
+
+        Node& node = mNodes[index];
+        node.task = std::move(task);
+        node.pending = false;
+        node.deadline = mCurrentTick + std::clamp<uint64_t>(delay, 1, maxDelay);
+        node.period = std::min(period, maxDelay);
+        node.active = true;
+
+        Link(index);
+        ++mActiveCount;
+
+        return MakeId(index);
+    }
+
+    TimerWheel::Node* TimerWheel::FindActive(TimerId id)
+    {
+        const uint32_t index = id & IndexMask;
+
+        if(id == InvalidTimerId || index >= mNodes.size())
+            return nullptr;
+
+        Node& node = mNodes[index];
+        if(!node.active || MakeId(index) != id)
+            return nullptr;
+
+        return &node;
+    }
+
+    bool TimerWheel::Cancel(TimerId id)
+    {
+        if(!FindActive(id))
+            return false;
+
+        const uint32_t index = id & IndexMask;
+
+        Unlink(index);
+        Release(index);
+
+        return true;
+    }
+
+    InlineTask TimerWheel::TakeTask(TimerId id)
+    {
+        Node* node = FindActive(id);
+
+        if(!node)
+            return {};
+
+        return std::move(node->task);
+    }
+
+    void TimerWheel::ReturnTask(TimerId id, InlineTask& task)
+    {
+        if(Node* node = FindActive(id))
+        {
+            node->task = std::move(task);
+            node->pending = false;
+        }
+    }
+
+    void TimerWheel::Link(uint32_t index)
+    {
+        Node& node = mNodes[index];
+
+        // Level is given by the most significant slot group in which deadline differs from the current tick
+        uint32_t level = 0;
+        while(level + 1 < LevelCount && (node.deadline >> (SlotBits * (level + 1))) != (mCurrentTick >> (SlotBits * (level + 1))))
+        {
+            ++level;
+        }
+
+        node.level = static_cast<uint16_t>(level);
+        node.slot = static_cast<uint16_t>((node.deadline >> (SlotBits * level)) & SlotMask);
+        node.prev = InvalidIndex;
+        node.next = mSlots[level][node.slot];
+
+        if(node.next != InvalidIndex)
+        {
+            mNodes[node.next].prev = index;
+        }
+
+        mSlots[level][node.slot] = index;
+    }
+
+    void TimerWheel::Unlink(uint32_t index)
+    {
+        Node& node = mNodes[index];
+
+        if(node.prev != InvalidIndex)
+        {
+            mNodes[node.prev].next = node.next;
+        }
+        else
+        {
+            mSlots[node.level][node.slot] = node.next;
+        }
+
+        if(node.next != InvalidIndex)
+        {
+            mNodes[node.next].prev = node.prev;
+        }
+
+        node.prev = InvalidIndex;
+        node.next = InvalidIndex;
+    }
+
+    void TimerWheel::Release(uint32_t index)
+    {
+        Node& node = mNodes[index];
+        node.task.Reset();
+        node.active = false;
+        node.pending = false;
+
+        // Generation zero is skipped so the id can never collide with InvalidTimerId
+        node.generation = (node.generation + 1) & GenerationMask;
+        if(node.generation == 0)
+        {
+            node.generation = 1;
+        }
+
+        mFreeNodes.push_back(index);
+        --mActiveCount;
+    }
+
+    void TimerWheel::Cascade(uint32_t level)
+    {
+        const uint32_t slot = (mCurrentTick >> (SlotBits * level)) & SlotMask;
+
+        uint32_t index = mSlots[level][slot];
+        mSlots[level][slot] = InvalidIndex;
+
+        while(index != InvalidIndex)
+        {
+            const uint32_t next = mNodes[index].next;
+            Link(index);
+            index = next;
+        }
+    }
+
+    void TimerWheel::Tick(std::vector<Expired>& expired)
+    {
+        ++mCurrentTick;
+
+        // Cascade from the highest level whose slot group rolled over so timers trickle down in order
+        uint32_t rolledLevels = 0;
+        while(rolledLevels + 1 < LevelCount && ((mCurrentTick >> (SlotBits * (rolledLevels + 1))) << (SlotBits * (rolledLevels + 1))) == mCurrentTick)
+        {
+            ++rolledLevels;
+        }
+
+        for(uint32_t level = rolledLevels; level > 0; --level)
+        {
+            Cascade(level);
+        }
+
+        const uint32_t slot = mCurrentTick & SlotMask;
+        uint32_t index = mSlots[0][slot];
+        mSlots[0][slot] = InvalidIndex;
+
+        while(index != InvalidIndex)
+        {
+            Node& node = mNodes[index];
+            const uint32_t next = node.next;
+
+            if(node.period > 0)
+            {
+                // Previous expiration is still being handled, skip this one instead of queueing a backlog
+                if(!node.pending)
+                {
+                    node.pending = true;
+                    expired.push_back({ MakeId(index), InlineTask() });
+                }
+
+                node.deadline += node.period;
+
+                // Skip missed periods but keep the phase of the original schedule
+                if(node.deadline <= mCurrentTick)
+                {
+                    const uint64_t missed = (mCurrentTick - node.deadline) / node.period + 1;
+                    node.deadline += missed * node.period;
+                }
+
+                Link(index);
+            }
+            else
+            {
+                expired.push_back({ MakeId(index), std::move(node.task) });
+
+                node.prev = InvalidIndex;
+                node.next = InvalidIndex;
+                Release(index);
+            }
+
+            index = next;
+        }
+    }
+
+    void TimerWheel::Advance(uint64_t tick, std::vector<Expired>& expired)
+    {
+        if(mActiveCount == 0)
+        {
+            mCurrentTick = std::max(mCurrentTick, tick);
+            return;
+        }
+
+        while(mCurrentTick < tick)
+        {
+            Tick(expired);
+        }
+    }
+
+    std::optional<uint64_t> TimerWheel::GetNextWakeTick() const
+    {
+        if(mActiveCount == 0)
+            return std::nullopt;
+
+        // Any pending slot on a lower level is always due before the next cascade of a higher one
+        for(uint32_t level = 0; level < LevelCount; ++level)
+        {
+            const uint32_t shift = SlotBits * level;
+            const uint32_t currentSlot = (mCurrentTick >> shift) & SlotMask;
+
+            // Slots at or below the current one on this level belong to the next revolution, which is
+            // always announced by a cascade of the level above
+            for(uint32_t slot = currentSlot + 1; slot < SlotCount; ++slot)
+            {
+                if(mSlots[level][slot] == InvalidIndex)
+                    continue;
+
+                return ((mCurrentTick >> shift) + (slot - currentSlot)) << shift;
+            }
+        }
+
+        return std::nullopt;
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <pthread.h>
+
+namespace Core
+{
+    /*!
+     @brief Names calling thread so it is recognizable in debugger and profiler.
+     */
+    inline void SetCurrentThreadName(const char* name)
+    {
+#ifdef __APPLE__
+        pthread_setname_np(name);
+#else
+        pthread_setname_np(pthread_self(), name);
+#endif
+    }
+}
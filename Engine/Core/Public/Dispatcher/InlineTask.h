@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Core
+{
+    class ITaskImpl
+    {
+    public:
+        virtual ~ITaskImpl() = default;
+        
+        virtual void Invoke() = 0;
+        virtual ITaskImpl* Move(void* address) = 0;
+    };
+    
+    template<typename T>
+    class TaskImpl final : public ITaskImpl
+    {
+    public:
+        TaskImpl(T v) : data(std::move(v)) {}
+        
+        ITaskImpl* Move(void* addr) override
+        {
+            return new (addr) TaskImpl(std::move(*this));
+        }
+        
+        void Invoke() override { data(); }
+        
+    public:
+        T data;
+    };
+    
+    /*!
+     @brief Move-only callable with fixed inline storage, never allocates.
+     
+     Same layout as Renderer::Command, whole object takes 96 bytes. Callables which don't fit are rejected at compile time.
+     */
+    class InlineTask
+    {
+        static constexpr std::size_t maxStorageSize = 96 - sizeof(ITaskImpl*);
+        
+    public:
+        InlineTask() = default;
+        
+        template<   typename T,
+                    typename = std::enable_if_t<!std::is_same<std::decay_t<T>, InlineTask>::value>>
+        InlineTask(T&& func) noexcept
+        {
+            static_assert(sizeof(TaskImpl<std::decay_t<T>>) <= maxStorageSize, "Task too big");
+            static_assert(alignof(TaskImpl<std::decay_t<T>>) <= alignof(ITaskImpl*), "Task over-aligned");
+            mImpl = new (&mStorage) TaskImpl<std::decay_t<T>>(std::forward<T>(func));
+        }
+        
+        InlineTask(InlineTask&& other) noexcept
+        {
+            if(other.mImpl)
+            {
+                mImpl = other.mImpl->Move(&mStorage);
+                other.Reset();
+            }
+        }
+        
+        InlineTask& operator=(InlineTask&& other) noexcept
+        {
+            if(this != &other)
+            {
+                Reset();
+                
+                if(other.mImpl)
+                {
+                    mImpl = other.mImpl->Move(&mStorage);
+                    other.Reset();
+                }
+            }
+            
+            return *this;
+        }
+        
+        InlineTask(const InlineTask& other) = delete;
+        InlineTask& operator=(const InlineTask& other) = delete;
+        
+        ~InlineTask()
+        {
+            Reset();
+        }
+        
+        void operator()()
+        {
+            mImpl->Invoke();
+        }
+        
+        explicit operator bool() const noexcept
+        {
+            return mImpl != nullptr;
+        }
+        
+        void Reset() noexcept
+        {
+            if(mImpl)
+            {
+                mImpl->~ITaskImpl();
+                mImpl = nullptr;
+            }
+        }
+        
+    private:
+        std::aligned_storage<maxStorageSize, alignof(ITaskImpl*)>::type mStorage;
+        ITaskImpl* mImpl{ nullptr };
+    };
+    
+    static_assert(sizeof(InlineTask) == 96, "InlineTask is expected to fill 96 bytes");
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <CoreBase.h>
+#include <Core/Platform.h>
+#include <Dispatcher/Queue.h>
+#include <Dispatcher/InlineTask.h>
+#include <Dispatcher/MPMCQueue.h>
+#include <Dispatcher/WorkStealingQueue.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Core
+{
+    class Job;
+    class JobSystem;
+
+    using JobHandle = std::shared_ptr<Job>;
+
+    /*!
+     @brief Counts unfinished jobs associated with it, can be waited on via JobSystem::Wait.
+     */
+    class CORE_API JobCounter
+    {
+        friend class JobSystem;
+
+    public:
+        NO_DISCARD bool IsDone() const noexcept { return mValue.load(std::memory_order_acquire) == 0; }
+        NO_DISCARD uint32_t GetValue() const noexcept { return mValue.load(std::memory_order_acquire); }
+
+    private:
+        std::atomic<uint32_t> mValue{ 0 };
+    };
+
+    class CORE_API Job
+    {
+        friend class JobSystem;
+
+    public:
+        Job(InlineTask&& task, JobCounter* counter);
+        DECLARE_NOCOPY_NOMOVE(Job)
+
+        NO_DISCARD bool IsFinished() const noexcept { return mFinished.load(std::memory_order_acquire); }
+
+    private:
+        /*!
+         @brief Registers job which will be released once this job finishes.
+         @return False if this job has already finished.
+         */
+        bool AddContinuation(const JobHandle& job);
+
+    private:
+        InlineTask mTask;
+        JobCounter* mCounter{ nullptr };
+
+        std::atomic<uint32_t> mPendingDependencies{ 1 };
+        std::atomic<bool> mFinished{ false };
+
+        std::mutex mContinuationMutex;
+        std::vector<JobHandle> mContinuations;
+
+        // Keeps job alive while it sits in one of the run queues
+        JobHandle mSelf;
+    };
+
+    /*!
+     @brief Work stealing job system, spawns one worker per hardware thread.
+
+     Every worker owns a Chase-Lev deque. Jobs spawned from workers are pushed to the local deque,
+     jobs submitted from foreign threads go through the shared injection queue. Idle workers steal from
+     each other and park on a condition variable when there is no work left.
+     Fire-and-forget tasks submitted through Post bypass job bookkeeping and travel through a bounded
+     lock-free ring, so they cost no heap allocation.
+     */
+    class CORE_API JobSystem
+    {
+    public:
+        explicit JobSystem(uint32_t workerCount = 0);
+        ~JobSystem();
+        DECLARE_NOCOPY_NOMOVE(JobSystem)
+
+        /*!
+         @brief Submits job for execution.
+         @param task Function to execute.
+         @param dependencies Jobs which have to finish before the task may start. Empty handles are ignored.
+         @param counter Optional counter incremented now and decremented once the job finishes.
+         @return Handle of the submitted job.
+         */
+        JobHandle Run(InlineTask&& task, std::initializer_list<JobHandle> dependencies = {}, JobCounter* counter = nullptr);
+        JobHandle Run(InlineTask&& task, const std::vector<JobHandle>& dependencies, JobCounter* counter = nullptr);
+
+        /*!
+         @brief Submits task without handle or dependencies. Blocks (helping with pending work) while the ring is full.
+         */
+        void Post(InlineTask&& task);
+
+        /*!
+         @brief Splits range [0, count) into batches and runs them in parallel, blocks until all are done.
+         */
+        void ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t begin, uint32_t end)>& func);
+
+        /*!
+         @brief Blocks until the job finishes, calling thread executes pending jobs meanwhile.
+         */
+        void Wait(const JobHandle& job);
+
+        /*!
+         @brief Blocks until the counter drops to zero, calling thread executes pending jobs meanwhile.
+         */
+        void Wait(const JobCounter& counter);
+
+        NO_DISCARD uint32_t GetWorkerCount() const noexcept { return static_cast<uint32_t>(mWorkers.size()); }
+
+        /*!
+         @brief Returns index of the calling worker thread or -1 if called from thread not owned by this job system.
+         */
+        NO_DISCARD int32_t GetCurrentWorkerIndex() const noexcept;
+
+    private:
+        struct Worker
+        {
+            std::thread thread;
+            WorkStealingQueue<Job> queue;
+        };
+
+        template<typename Container>
+        JobHandle Submit(InlineTask&& task, const Container& dependencies, JobCounter* counter);
+
+        void Enqueue(const JobHandle& job);
+        void Execute(Job* job);
+        void WakeWorker();
+        bool TryRunOne();
+        Job* StealJob(int32_t workerIndex);
+        void WorkerLoop(uint32_t index);
+
+    private:
+        static constexpr size_t TaskQueueCapacity = 4096;
+
+        std::vector<std::unique_ptr<Worker>> mWorkers;
+        Queue<Job*> mInjectionQueue;
+        MPMCQueue<InlineTask, TaskQueueCapacity> mTaskQueue;
+
+        std::atomic<uint32_t> mPendingJobs{ 0 };
+        std::atomic<bool> mIsRunning{ true };
+
+        std::mutex mSleepMutex;
+        std::condition_variable mWakeCondition;
+    };
+}
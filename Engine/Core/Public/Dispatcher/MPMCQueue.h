@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace Core
+{
+    /*!
+     @brief Bounded lock-free multi-producer multi-consumer ring buffer.
+     
+     Every cell carries a sequence number which tells producers and consumers whether the cell is free
+     or holds published data (D. Vyukov's bounded MPMC queue). Items are stored inline, nothing is allocated
+     after construction.
+     */
+    template<typename T, size_t Capacity>
+    class MPMCQueue
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity has to be power of two");
+        
+    public:
+        MPMCQueue()
+        {
+            for(size_t i = 0; i < Capacity; ++i)
+            {
+                mCells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+        
+        MPMCQueue(const MPMCQueue&) = delete;
+        MPMCQueue& operator=(const MPMCQueue&) = delete;
+        
+        /*!
+         @brief Pushes item to the queue, item is left untouched if the queue is full.
+         @return False if the queue is full.
+         */
+        bool TryPush(T&& item)
+        {
+            Cell* cell = nullptr;
+            size_t position = mEnqueuePosition.load(std::memory_order_relaxed);
+            
+            while(true)
+            {
+                cell = &mCells[position & Mask];
+                const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                
+                if(diff == 0)
+                {
+                    if(mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if(diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = mEnqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+            
+            cell->data = std::move(item);
+            cell->sequence.store(position + 1, std::memory_order_release);
+            
+            return true;
+        }
+        
+        /*!
+         @brief Pops item from the queue.
+         @return False if the queue is empty or the oldest item is not published yet.
+         */
+        bool TryPop(T& item)
+        {
+            Cell* cell = nullptr;
+            size_t position = mDequeuePosition.load(std::memory_order_relaxed);
+            
+            while(true)
+            {
+                cell = &mCells[position & Mask];
+                const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+                
+                if(diff == 0)
+                {
+                    if(mDequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if(diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = mDequeuePosition.load(std::memory_order_relaxed);
+                }
+            }
+            
+            item = std::move(cell->data);
+            cell->sequence.store(position + Mask + 1, std::memory_order_release);
+            
+            return true;
+        }
+        
+    private:
+        static constexpr size_t Mask = Capacity - 1;
+        
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            T data;
+        };
+        
+        alignas(64) std::array<Cell, Capacity> mCells;
+        alignas(64) std::atomic<size_t> mEnqueuePosition{ 0 };
+        alignas(64) std::atomic<size_t> mDequeuePosition{ 0 };
+    };
+}
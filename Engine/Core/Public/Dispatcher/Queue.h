@@ -0,0 +1,41 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+
+namespace Core
+{
+    template<typename T>
+    class Queue
+    {
+    public:
+        void Push(T&& item)
+        {
+            std::unique_lock lock(mMutex);
+            mQueue.push_back(std::move(item));
+        }
+
+        T Pop()
+        {
+            std::unique_lock lock(mMutex);
+
+            if(mQueue.empty())
+                return nullptr;
+
+            T result = std::move(mQueue.front());
+            mQueue.pop_front();
+
+            return result;
+        }
+
+        uint32_t Size()
+        {
+            std::unique_lock lock(mMutex);
+            return static_cast<uint32_t>(mQueue.size());
+        }
+
+    private:
+        std::deque<T> mQueue;
+        std::mutex mMutex;
+    };
+}
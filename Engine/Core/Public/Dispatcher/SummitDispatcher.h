@@ -1,71 +1,95 @@
 #pragma once
 
 #include <CoreBase.h>
+#include <Core/Platform.h>
+#include <Dispatcher/JobSystem.h>
+#include <Dispatcher/TimerWheel.h>
 
 #include <memory>
-#include <functional>
-#include <thread>
 #include <deque>
-#include <mutex>
-#include <algorithm>
 #include <functional>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+#include <stdexcept>
 
 namespace Core
 {
-    using Task = std::function<void()>;
-    
-    template<typename T>
-    class Queue
-    {
-    public:
-        void Push(T&& item)
-        {
-            std::unique_lock lock(mMutex);
-            mQueue.push_back(std::move(item));
-        }
-        
-        T Pop()
-        {
-            std::unique_lock lock(mMutex);
-            
-            if(mQueue.empty())
-                return nullptr;
-            
-            T result = std::move(mQueue.front());
-            mQueue.pop_front();
-            
-            return result;
-        }
-        
-        uint32_t Size()
-        {
-            return mQueue.size();
-        }
-        
-    private:
-        std::deque<T> mQueue;
-        std::mutex mMutex;
-        bool mIsRunning{ true };
-    };
-    
+    /*!
+     @brief Engine dispatcher built on top of the work stealing JobSystem.
+
+     Posted and scheduled tasks go through a single serial strand, so they keep running one after another
+     in submission order, but on whichever worker is free. The strand is a lock-free ring of inline tasks
+     drained by a job which exists only while the ring is non-empty, posting never allocates. Parallel work is submitted through GetJobSystem().
+     Task posted from within the strand while the ring is full goes to an overflow list, which is drained after the ring.
+     Until the list is empty every post goes there too, so the strand never reorders tasks.
+     Scheduled tasks are kept in a timer wheel serviced by a timer thread which sleeps until the next deadline.
+     */
     class CORE_API SummitDispatcher
     {
     public:
         SummitDispatcher();
         ~SummitDispatcher();
-        uint32_t Schedule(uint32_t deltaTime, std::function<void()>&& f, bool repeat);
-        void Post(std::function<void()>&& f);
+        DECLARE_NOCOPY_NOMOVE(SummitDispatcher)
+        
+        /*!
+         @brief Schedules task to be posted to the strand after the given delay.
+         @param deltaTime Delay (and period for repeating tasks) in microseconds.
+         @param task Task to execute, kept inline in the timer wheel.
+         @param repeat Re-arm the task after each expiration. An occurrence is skipped when the previous one
+                       is still waiting in the strand or running, so slow tasks don't pile up.
+         @return Id which can be passed to Cancel.
+         */
+        TimerId Schedule(uint32_t deltaTime, InlineTask&& task, bool repeat);
+        
+        /*!
+         @brief Cancels scheduled task. Occurrence of repeating task waiting in the strand is dropped,
+         expired one-shot task and occurrence which is already running still finish.
+         @return False if the timer is not active anymore.
+         */
+        bool Cancel(TimerId id);
+        
+        void Post(InlineTask&& task);
+        
+        /*!
+         @brief Blocks until timer callbacks being fired returned and the strand ran all posted tasks.
+         Cancel timers first, otherwise they keep posting. Can't be called from within the strand.
+         */
+        void WaitIdle();
+        
+        NO_DISCARD JobSystem& GetJobSystem() noexcept { return mJobSystem; }
         
     private:
-        void CreateThread();
-        void Worker();
+        void TimerLoop();
+        void RunRepeatingTimer(TimerId id);
+        void DrainStrand();
+        NO_DISCARD bool PopStrandTask(InlineTask& task);
+        NO_DISCARD uint64_t GetCurrentTick() const;
             
     private:
-        std::thread mThread;
-        std::function<void()> mFunc;
-        bool mIsRunning{ false };
+        static constexpr std::chrono::microseconds TimerTickDuration{ 100 };
+        static constexpr size_t StrandCapacity = 1024;
+        static constexpr uint32_t StrandBatchSize = 64;
+        
+        JobSystem mJobSystem;
+        std::atomic<bool> mIsRunning{ true };
+        
+        MPMCQueue<InlineTask, StrandCapacity> mStrandQueue;
+        std::atomic<uint32_t> mStrandPending{ 0 };
+        
+        std::mutex mOverflowMutex;
+        std::deque<InlineTask> mOverflowQueue;
+        std::atomic<uint32_t> mOverflowCount{ 0 };
         
-        Queue<std::shared_ptr<Task>> mQueue;
+        std::thread mTimerThread;
+        std::mutex mTimerMutex;
+        std::condition_variable mTimerCondition;
+        std::condition_variable mFiringCondition;
+        bool mFiring{ false };
+        TimerWheel mTimerWheel;
+        const std::chrono::steady_clock::time_point mStartTime;
     };
     
     CORE_API std::unique_ptr<SummitDispatcher> CreateSummitDispatcher();
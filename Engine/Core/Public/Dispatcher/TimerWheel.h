@@ -0,0 +1,130 @@
+#pragma once
+
+#include <CoreBase.h>
+#include <Core/Platform.h>
+#include <Dispatcher/InlineTask.h>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Core
+{
+    using TimerId = uint32_t;
+    constexpr TimerId InvalidTimerId = 0;
+
+    /*!
+     @brief Hierarchical hashed timer wheel operating on abstract ticks.
+
+     Five levels of 256 slots cover 2^40 ticks. Insertion and cancellation are O(1), timers are cascaded
+     to lower levels as the wheel turns. The wheel is not thread safe, owner has to synchronize access.
+     Tasks are stored inline in the timer nodes, nothing is allocated once the node pool grew to the number of timers.
+     */
+    class CORE_API TimerWheel
+    {
+    public:
+        struct Expired
+        {
+            TimerId id{ InvalidTimerId };
+
+            /*!
+             @brief Task of one-shot timer, empty for repeating timers. Task of repeating timer stays in the wheel
+             and is lent out by TakeTask.
+             */
+            InlineTask task;
+        };
+
+    public:
+        TimerWheel();
+        DECLARE_NOCOPY_NOMOVE(TimerWheel)
+
+        /*!
+         @brief Adds timer to the wheel.
+         @param delay Ticks from the current tick until first expiration, at least one tick is used.
+         @param period Ticks between repeated expirations, zero for one-shot timer.
+         @param task Task handed out on expiration.
+         @return Id which can be used to cancel the timer.
+         */
+        TimerId Add(uint64_t delay, uint64_t period, InlineTask&& task);
+
+        /*!
+         @brief Cancels timer.
+         @return False if the timer already expired (one-shot) or was cancelled before.
+         */
+        bool Cancel(TimerId id);
+
+        /*!
+         @brief Lends out task of expired repeating timer, so it can run outside of the owner's lock.
+         Expirations of the timer are not reported until the task is returned.
+         @return Empty task if the timer was cancelled or the task is already lent out.
+         */
+        InlineTask TakeTask(TimerId id);
+
+        /*!
+         @brief Returns task taken by TakeTask, its expirations are reported again.
+         Task of timer cancelled in the meantime is left in the argument.
+         */
+        void ReturnTask(TimerId id, InlineTask& task);
+
+        /*!
+         @brief Turns the wheel up to the given tick, expired timers are appended to the output.
+         Repeating timers are re-armed relative to their previous deadline so they do not drift.
+         */
+        void Advance(uint64_t tick, std::vector<Expired>& expired);
+
+        /*!
+         @brief Returns tick at which the wheel has to be advanced next, either because a timer expires
+         or because a higher level slot has to be cascaded. Empty if there are no timers.
+         */
+        NO_DISCARD std::optional<uint64_t> GetNextWakeTick() const;
+
+        NO_DISCARD uint64_t GetCurrentTick() const noexcept { return mCurrentTick; }
+        NO_DISCARD uint32_t GetActiveCount() const noexcept { return mActiveCount; }
+
+    private:
+        static constexpr uint32_t LevelCount = 5;
+        static constexpr uint32_t SlotBits = 8;
+        static constexpr uint32_t SlotCount = 1u << SlotBits;
+        static constexpr uint32_t SlotMask = SlotCount - 1;
+        static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+        static constexpr uint32_t IndexBits = 20;
+        static constexpr uint32_t IndexMask = (1u << IndexBits) - 1;
+        static constexpr uint32_t GenerationMask = (1u << (32 - IndexBits)) - 1;
+
+        struct Node
+        {
+            InlineTask task;
+            uint64_t deadline{ 0 };
+            uint64_t period{ 0 };
+            uint32_t prev{ InvalidIndex };
+            uint32_t next{ InvalidIndex };
+            uint32_t generation{ 1 };
+            uint16_t level{ 0 };
+            uint16_t slot{ 0 };
+            bool active{ false };
+
+            // Expiration was reported and its task wasn't returned yet
+            bool pending{ false };
+        };
+
+        NO_DISCARD Node* FindActive(TimerId id);
+
+        void Link(uint32_t index);
+        void Unlink(uint32_t index);
+        void Release(uint32_t index);
+        void Cascade(uint32_t level);
+        void Tick(std::vector<Expired>& expired);
+
+        NO_DISCARD TimerId MakeId(uint32_t index) const noexcept;
+
+    private:
+        std::vector<Node> mNodes;
+        std::vector<uint32_t> mFreeNodes;
+        std::array<std::array<uint32_t, SlotCount>, LevelCount> mSlots;
+
+        uint64_t mCurrentTick{ 0 };
+        uint32_t mActiveCount{ 0 };
+    };
+}
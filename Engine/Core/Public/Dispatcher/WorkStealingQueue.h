@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace Core
+{
+    /*!
+     @brief Fixed capacity Chase-Lev work stealing deque.
+
+     Owner thread pushes and pops at the bottom (LIFO), any other thread may steal from the top (FIFO).
+     Implementation follows "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al., 2013).
+     */
+    template<typename T, size_t Capacity = 4096>
+    class WorkStealingQueue
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity has to be power of two");
+
+    public:
+        /*!
+         @brief Pushes item to the bottom of the queue. Owner thread only.
+         @return False if the queue is full.
+         */
+        bool Push(T* item)
+        {
+            const int64_t bottom = mBottom.load(std::memory_order_relaxed);
+            const int64_t top = mTop.load(std::memory_order_acquire);
+
+            if(bottom - top >= static_cast<int64_t>(Capacity))
+                return false;
+
+            mBuffer[bottom & Mask].store(item, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+
+            return true;
+        }
+
+        /*!
+         @brief Pops item from the bottom of the queue. Owner thread only.
+         @return nullptr if queue is empty or the last item was stolen.
+         */
+        T* Pop()
+        {
+            const int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+            mBottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = mTop.load(std::memory_order_relaxed);
+
+            if(top > bottom)
+            {
+                mBottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            T* item = mBuffer[bottom & Mask].load(std::memory_order_relaxed);
+
+            if(top == bottom)
+            {
+                // Last item, race against stealers
+                if(!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    item = nullptr;
+                }
+
+                mBottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            return item;
+        }
+
+        /*!
+         @brief Steals item from the top of the queue. Safe to call from any thread.
+         @return nullptr if queue is empty or another thread won the race.
+         */
+        T* Steal()
+        {
+            int64_t top = mTop.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = mBottom.load(std::memory_order_acquire);
+
+            if(top >= bottom)
+                return nullptr;
+
+            T* item = mBuffer[top & Mask].load(std::memory_order_relaxed);
+
+            if(!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;
+
+            return item;
+        }
+
+        bool Empty() const
+        {
+            return mBottom.load(std::memory_order_relaxed) <= mTop.load(std::memory_order_relaxed);
+        }
+
+    private:
+        static constexpr int64_t Mask = static_cast<int64_t>(Capacity) - 1;
+
+        alignas(64) std::atomic<int64_t> mTop{ 0 };
+        alignas(64) std::atomic<int64_t> mBottom{ 0 };
+        alignas(64) std::array<std::atomic<T*>, Capacity> mBuffer{};
+    };
+}
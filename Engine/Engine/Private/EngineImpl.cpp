@@ -26,6 +26,12 @@
 
 MICROPROFILE_DEFINE(MAIN, "MAIN", "Main", 0xff0000);
 
+namespace
+{
+    /// Fixed update rate of the engine loop in microseconds
+    constexpr uint32_t FixedUpdateInterval = 1000000 / 60;
+}
+
 using namespace Summit;
 using namespace Renderer;
 using namespace Logging;
@@ -73,7 +79,16 @@ void SummitEngine::StartFrame()
     
     mActiveSwapChain->AcquireImage();
     
-    mFrameData.deltaTime = 0.001f;
+    const auto now = std::chrono::steady_clock::now();
+    if(mFrameId > 0)
+    {
+        mFrameData.deltaTime = std::chrono::duration<float, std::milli>(now - mLastFrameTime).count();
+    }
+    mLastFrameTime = now;
+    
+    mFrameData.fenceWaitTime = mRenderer->GetFrameStatistics().fenceWaitTime;
+    mFrameData.memoryStatistics = mRenderer->GetMemoryStatistics();
+    
     mFrameData.width = mActiveSwapChain->GetActiveFramebuffer().GetWidth();
     mFrameData.height = mActiveSwapChain->GetActiveFramebuffer().GetHeight();
     
@@ -92,13 +107,10 @@ void SummitEngine::Update()
     
     //mGui->FinishFrame();
     
-    for(auto* renderPass : mRenderPasses)
-    {
-        renderPass->EarlyBeginEmitter();
-        mRenderer->BeginRenderPass(*renderPass);
-        renderPass->BeginEmitter();
-        mRenderer->EndRenderPass();
-    }
+    if(!mFrameGraph.IsCompiled())
+        mFrameGraph.Compile(*mRenderer);
+    
+    mFrameGraph.Execute(*mRenderer);
     
     mRenderer->EndCommandRecording(mActiveSwapChain);
     // --------- END OF RENDER PHASE -------------
@@ -114,7 +126,15 @@ void SummitEngine::EndFrame()
 
 void SummitEngine::DeInitialize()
 {
-    // Destroy default render pass
+    // Update runs on job system workers, it must not race with the teardown below
+    auto& dispatcher = Core::DispatcherService::Service();
+    dispatcher.Cancel(mUpdateTimer);
+    dispatcher.WaitIdle();
+    mUpdateTimer = Core::InvalidTimerId;
+    
+    // Frame graph objects may still be used by frames in flight
+    mRenderer->WaitIdle();
+    mFrameGraph.Destroy(*mRenderer);
     
     Renderer::RendererLocator::GetRenderer().Deinitialize();
     //Core::DispatcherService::Provide(nullptr);
@@ -130,7 +150,19 @@ void SummitEngine::SetActiveSwapChain(Renderer::SwapChainBase* swapChain)
 
 void SummitEngine::RegisterRenderPass(Renderer::RenderPass& renderPass)
 {
-    return mRenderPasses.push_back(&renderPass);
+    auto execute = [&renderPass](Renderer::IRenderer& renderer){
+        renderPass.EarlyBeginEmitter();
+        renderer.BeginRenderPass(renderPass);
+        renderPass.BeginEmitter();
+        renderer.EndRenderPass();
+    };
+    
+    // Render passes carry no name, registration order tells passes apart in graph statistics & profiles
+    const std::string name = "RegisteredRenderPass" + std::to_string(mRegisteredPassCount++);
+    
+    mFrameGraph.AddPass(name, Renderer::FrameGraphPassType::External, [](Renderer::FrameGraphBuilder& builder){
+        builder.SetSideEffects();
+    }, std::move(execute));
 }
 
 void SummitEngine::RenderObject(Object3d& object, Renderer::Pipeline& pipeline)
@@ -142,7 +174,7 @@ void SummitEngine::RenderObject(Object3d& object, Renderer::Pipeline& pipeline)
 
 void SummitEngine::Run()
 {
-    Core::DispatcherService::Service().Schedule(10000, [this]{ Update(); }, true);
+    mUpdateTimer = Core::DispatcherService::Service().Schedule(FixedUpdateInterval, [this]{ Update(); }, true);
 }
 
 void SummitEngine::SetMainView(Renderer::View* view)
@@ -6,9 +6,14 @@
 
 #include <Renderer/View.h>
 #include <Renderer/RenderPass.h>
+#include <Renderer/FrameGraph.h>
 
 #include <Renderer/DeviceObject.h>
 
+#include <Dispatcher/TimerWheel.h>
+
+#include <chrono>
+
 namespace Renderer
 {
     class View;
@@ -29,6 +34,16 @@ namespace Summit
          */
         float deltaTime{ 0.0f };
         
+        /*!
+         * @brief Time in miliseconds the frame waited for GPU to release its frame in flight slot.
+         */
+        float fenceWaitTime{ 0.0f };
+        
+        /*!
+         * @brief Device memory usage at the start of the frame.
+         */
+        Renderer::MemoryStatistics memoryStatistics;
+        
         /*!
          * @brief Current view width in pixels.
          */
@@ -54,6 +69,11 @@ namespace Summit
         void Initialize();
         void DeInitialize();
         
+        /*!
+         * @brief Adds render pass recording its own commands as pass of the frame graph, the pass is never culled.
+         *        Attachments of the render pass aren't declared to the graph, so graph doesn't synchronize them,
+         *        layouts & dependencies of the render pass do. Graph only keeps the pass in registration order.
+         */
         void RegisterRenderPass(Renderer::RenderPass& renderPass);
         
         void RenderObject(Renderer::Object3d& object, Renderer::Pipeline& pipeline);
@@ -65,6 +85,11 @@ namespace Summit
         
         Renderer::IRenderer& GetRenderer() const { return *mRenderer; }
         
+        /*!
+         * @brief Returns graph of passes recorded every frame, it's compiled before the first frame once passes are added.
+         */
+        Renderer::FrameGraph& GetFrameGraph() { return mFrameGraph; }
+        
     public:
         sigslot::signal<const FrameData&> EarlyUpdate;
         sigslot::signal<const FrameData&> Updatee;
@@ -77,6 +102,8 @@ namespace Summit
         
     private:
         uint32_t mFrameId{ 0 };
+        Core::TimerId mUpdateTimer{ Core::InvalidTimerId };
+        std::chrono::steady_clock::time_point mLastFrameTime;
         
         Renderer::IRenderer* mRenderer{ nullptr };
         Renderer::SwapChainBase* mActiveSwapChain{ nullptr };
@@ -85,7 +112,8 @@ namespace Summit
         
         FrameData mFrameData;
         
-        std::vector<Renderer::RenderPass*> mRenderPasses;
+        Renderer::FrameGraph mFrameGraph;
+        uint32_t mRegisteredPassCount{ 0 };
     };
 
     ENGINE_API std::shared_ptr<SummitEngine> CreateEngineService();
@@ -0,0 +1,227 @@
+#include <Math/BatchKernels.h>
+#include <Math/MatrixKernels.h>
+
+#include "Lanes.h"
+
+#include <algorithm>
+
+using namespace Math;
+using namespace Math::Lanes;
+
+namespace
+{
+    // Loads up to Width elements of a stream, lanes past the count are zero
+    MATH_INLINE Lane LoadStream(const float* data, size_t stride, size_t count)
+    {
+        if(count == Width)
+            return Gather(data, stride);
+
+        float padded[Width]{};
+        for(size_t i = 0; i < count; ++i)
+        {
+            padded[i] = data[i * stride];
+        }
+
+        return Load(padded);
+    }
+
+    MATH_INLINE Lane LoadStream(const FloatStream& stream, size_t first, size_t count)
+    {
+        return LoadStream(stream.data + first * stream.stride, stream.stride, count);
+    }
+
+    MATH_INLINE void StoreStream(float* data, Lane v, size_t count)
+    {
+        if(count == Width)
+        {
+            Store(data, v);
+            return;
+        }
+
+        float padded[Width];
+        Store(padded, v);
+        std::copy_n(padded, count, data);
+    }
+
+    /*!
+     @brief Rows of matrices of consecutive elements, element (row, column) of lane i belongs to matrices[i].
+     */
+    struct MatrixLanes
+    {
+        Lane m[4][3];
+
+        MATH_INLINE MatrixLanes(const Matrix4* matrices, size_t count)
+        {
+            constexpr size_t matrixStride = sizeof(Matrix4) / sizeof(float);
+            const float* data = matrices->GetData();
+
+            for(size_t row = 0; row < 4; ++row)
+            {
+                for(size_t column = 0; column < 3; ++column)
+                {
+                    m[row][column] = LoadStream(data + row * 4 + column, matrixStride, count);
+                }
+            }
+        }
+
+        // Point (w = 1) transformed by matrix of its lane
+        MATH_INLINE void TransformPoint(Lane x, Lane y, Lane z, Lane& outX, Lane& outY, Lane& outZ) const
+        {
+            outX = MulAdd(x, m[0][0], MulAdd(y, m[1][0], MulAdd(z, m[2][0], m[3][0])));
+            outY = MulAdd(x, m[0][1], MulAdd(y, m[1][1], MulAdd(z, m[2][1], m[3][1])));
+            outZ = MulAdd(x, m[0][2], MulAdd(y, m[1][2], MulAdd(z, m[2][2], m[3][2])));
+        }
+    };
+}
+
+void Batch::MultiplyMatrices(const Matrix4* a, const Matrix4* b, Matrix4* result, size_t count)
+{
+    if(count == 0)
+        return;
+
+    Kernels::MultiplyMatrices(a->GetData(), b->GetData(), result->GetData(), count);
+}
+
+void Batch::MultiplyMatrices(const Matrix4* a, const Matrix4& b, Matrix4* result, size_t count)
+{
+    if(count == 0)
+        return;
+
+    // Rows of all left matrices are one contiguous array of vectors transformed by b
+    Kernels::TransformVectors(b.GetData(), a->GetData(), result->GetData(), count * 4);
+}
+
+void Batch::TransformPoints(const Matrix4& m, Vector3Streams<const float> points, Vector3Streams<float> result, size_t count)
+{
+    const float* data = m.GetData();
+
+    const Lane m00 = Splat(data[0]), m01 = Splat(data[1]), m02 = Splat(data[2]);
+    const Lane m10 = Splat(data[4]), m11 = Splat(data[5]), m12 = Splat(data[6]);
+    const Lane m20 = Splat(data[8]), m21 = Splat(data[9]), m22 = Splat(data[10]);
+    const Lane m30 = Splat(data[12]), m31 = Splat(data[13]), m32 = Splat(data[14]);
+
+    for(size_t i = 0; i < count; i += Width)
+    {
+        const size_t n = std::min(Width, count - i);
+
+        const Lane x = LoadStream(points.x + i, 1, n);
+        const Lane y = LoadStream(points.y + i, 1, n);
+        const Lane z = LoadStream(points.z + i, 1, n);
+
+        StoreStream(result.x + i, MulAdd(x, m00, MulAdd(y, m10, MulAdd(z, m20, m30))), n);
+        StoreStream(result.y + i, MulAdd(x, m01, MulAdd(y, m11, MulAdd(z, m21, m31))), n);
+        StoreStream(result.z + i, MulAdd(x, m02, MulAdd(y, m12, MulAdd(z, m22, m32))), n);
+    }
+}
+
+void Batch::ComposeTransforms(const TransformStreams& transforms, Matrix4* result, size_t count)
+{
+    for(size_t i = 0; i < count; i += Width)
+    {
+        const size_t n = std::min(Width, count - i);
+
+        Lane sx, cx, sy, cy, sz, cz;
+        SinCos(LoadStream(transforms.rotationX, i, n), sx, cx);
+        SinCos(LoadStream(transforms.rotationY, i, n), sy, cy);
+        SinCos(LoadStream(transforms.rotationZ, i, n), sz, cz);
+
+        const Lane scaleX = LoadStream(transforms.scaleX, i, n);
+        const Lane scaleY = LoadStream(transforms.scaleY, i, n);
+        const Lane scaleZ = LoadStream(transforms.scaleZ, i, n);
+
+        // S * Rx * Ry * Rz, translation goes to the last row
+        const Lane sxsy = Mul(sx, sy);
+        const Lane cxsy = Mul(cx, sy);
+
+        float elements[16][Width];
+
+        Store(elements[0], Mul(scaleX, Mul(cy, cz)));
+        Store(elements[1], Mul(scaleX, Mul(cy, sz)));
+        Store(elements[2], Mul(scaleX, sy));
+
+        Store(elements[4], Mul(scaleY, Sub(Splat(0.0f), MulAdd(sxsy, cz, Mul(cx, sz)))));
+        Store(elements[5], Mul(scaleY, Sub(Mul(cx, cz), Mul(sxsy, sz))));
+        Store(elements[6], Mul(scaleY, Mul(sx, cy)));
+
+        Store(elements[8], Mul(scaleZ, Sub(Mul(sx, sz), Mul(cxsy, cz))));
+        Store(elements[9], Mul(scaleZ, Sub(Splat(0.0f), MulAdd(cxsy, sz, Mul(sx, cz)))));
+        Store(elements[10], Mul(scaleZ, Mul(cx, cy)));
+
+        Store(elements[12], LoadStream(transforms.positionX, i, n));
+        Store(elements[13], LoadStream(transforms.positionY, i, n));
+        Store(elements[14], LoadStream(transforms.positionZ, i, n));
+
+        for(size_t lane = 0; lane < n; ++lane)
+        {
+            float* out = result[i + lane].GetData();
+
+            out[0] = elements[0][lane];  out[1] = elements[1][lane];  out[2] = elements[2][lane];  out[3] = 0.0f;
+            out[4] = elements[4][lane];  out[5] = elements[5][lane];  out[6] = elements[6][lane];  out[7] = 0.0f;
+            out[8] = elements[8][lane];  out[9] = elements[9][lane];  out[10] = elements[10][lane]; out[11] = 0.0f;
+            out[12] = elements[12][lane]; out[13] = elements[13][lane]; out[14] = elements[14][lane]; out[15] = 1.0f;
+        }
+    }
+}
+
+void Batch::TransformBoundingSpheres(const Matrix4* matrices,
+                                     Vector3Streams<const float> centers, const float* radii,
+                                     Vector3Streams<float> resultCenters, float* resultRadii,
+                                     size_t count)
+{
+    for(size_t i = 0; i < count; i += Width)
+    {
+        const size_t n = std::min(Width, count - i);
+        const MatrixLanes m(matrices + i, n);
+
+        Lane x, y, z;
+        m.TransformPoint(LoadStream(centers.x + i, 1, n), LoadStream(centers.y + i, 1, n), LoadStream(centers.z + i, 1, n), x, y, z);
+
+        // Squared lengths of basis rows are squared scales along the axes
+        Lane maxScaleSquared = Splat(0.0f);
+        for(size_t row = 0; row < 3; ++row)
+        {
+            const Lane scaleSquared = MulAdd(m.m[row][0], m.m[row][0], MulAdd(m.m[row][1], m.m[row][1], Mul(m.m[row][2], m.m[row][2])));
+            maxScaleSquared = Max(maxScaleSquared, scaleSquared);
+        }
+
+        const Lane radius = Mul(LoadStream(radii + i, 1, n), Sqrt(maxScaleSquared));
+
+        StoreStream(resultCenters.x + i, x, n);
+        StoreStream(resultCenters.y + i, y, n);
+        StoreStream(resultCenters.z + i, z, n);
+        StoreStream(resultRadii + i, radius, n);
+    }
+}
+
+void Batch::TransformBoundingBoxes(const Matrix4* matrices,
+                                   Vector3Streams<const float> centers, Vector3Streams<const float> extents,
+                                   Vector3Streams<float> resultCenters, Vector3Streams<float> resultExtents,
+                                   size_t count)
+{
+    for(size_t i = 0; i < count; i += Width)
+    {
+        const size_t n = std::min(Width, count - i);
+        const MatrixLanes m(matrices + i, n);
+
+        Lane x, y, z;
+        m.TransformPoint(LoadStream(centers.x + i, 1, n), LoadStream(centers.y + i, 1, n), LoadStream(centers.z + i, 1, n), x, y, z);
+
+        const Lane ex = LoadStream(extents.x + i, 1, n);
+        const Lane ey = LoadStream(extents.y + i, 1, n);
+        const Lane ez = LoadStream(extents.z + i, 1, n);
+
+        // Extent along every world axis is the sum of projected local extents
+        Lane worldExtents[3];
+        for(size_t column = 0; column < 3; ++column)
+        {
+            worldExtents[column] = MulAdd(Abs(m.m[0][column]), ex, MulAdd(Abs(m.m[1][column]), ey, Mul(Abs(m.m[2][column]), ez)));
+        }
+
+        StoreStream(resultCenters.x + i, x, n);
+        StoreStream(resultCenters.y + i, y, n);
+        StoreStream(resultCenters.z + i, z, n);
+        StoreStream(resultExtents.x + i, worldExtents[0], n);
+        StoreStream(resultExtents.y + i, worldExtents[1], n);
+        StoreStream(resultExtents.z + i, worldExtents[2], n);
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <Math/Simd.h>
+
+#include <cstddef>
+
+/*
+ * Widest register available for structure of arrays kernels, every lane processes different element.
+ * 8 lanes with AVX2, 4 lanes otherwise.
+ */
+namespace Math::Lanes
+{
+#if defined(MATH_SIMD_AVX2)
+    using Lane = __m256;
+    constexpr size_t Width = 8;
+
+    MATH_INLINE Lane Load(const float* data) { return _mm256_loadu_ps(data); }
+    MATH_INLINE void Store(float* data, Lane v) { _mm256_storeu_ps(data, v); }
+    MATH_INLINE Lane Splat(float value) { return _mm256_set1_ps(value); }
+
+    MATH_INLINE Lane Add(Lane a, Lane b) { return _mm256_add_ps(a, b); }
+    MATH_INLINE Lane Sub(Lane a, Lane b) { return _mm256_sub_ps(a, b); }
+    MATH_INLINE Lane Mul(Lane a, Lane b) { return _mm256_mul_ps(a, b); }
+    MATH_INLINE Lane Min(Lane a, Lane b) { return _mm256_min_ps(a, b); }
+    MATH_INLINE Lane Max(Lane a, Lane b) { return _mm256_max_ps(a, b); }
+    MATH_INLINE Lane Sqrt(Lane v) { return _mm256_sqrt_ps(v); }
+    MATH_INLINE Lane Abs(Lane v) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v); }
+
+    MATH_INLINE Lane MulAdd(Lane a, Lane b, Lane c)
+    {
+#if defined(__FMA__)
+        return _mm256_fmadd_ps(a, b, c);
+#else
+        return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+    }
+
+    /*!
+     @brief Loads lane i from data[i * stride].
+     */
+    MATH_INLINE Lane Gather(const float* data, size_t stride)
+    {
+        if(stride == 1)
+            return Load(data);
+
+        const int s = static_cast<int>(stride);
+        const __m256i indices = _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+        return _mm256_i32gather_ps(data, indices, sizeof(float));
+    }
+#else
+    // Wrapped so calls don't resolve to Math::Simd overloads through argument dependent lookup
+    struct Lane
+    {
+        Simd::Float4 value;
+    };
+
+    constexpr size_t Width = 4;
+
+    MATH_INLINE Lane Load(const float* data) { return { Simd::Load(data) }; }
+    MATH_INLINE void Store(float* data, Lane v) { Simd::Store(data, v.value); }
+    MATH_INLINE Lane Splat(float value) { return { Simd::Splat(value) }; }
+
+    MATH_INLINE Lane Add(Lane a, Lane b) { return { Simd::Add(a.value, b.value) }; }
+    MATH_INLINE Lane Sub(Lane a, Lane b) { return { Simd::Sub(a.value, b.value) }; }
+    MATH_INLINE Lane Mul(Lane a, Lane b) { return { Simd::Mul(a.value, b.value) }; }
+    MATH_INLINE Lane Min(Lane a, Lane b) { return { Simd::Min(a.value, b.value) }; }
+    MATH_INLINE Lane Max(Lane a, Lane b) { return { Simd::Max(a.value, b.value) }; }
+    MATH_INLINE Lane Sqrt(Lane v) { return { Simd::Sqrt(v.value) }; }
+    MATH_INLINE Lane Abs(Lane v) { return { Simd::Abs(v.value) }; }
+    MATH_INLINE Lane MulAdd(Lane a, Lane b, Lane c) { return { Simd::MulAdd(a.value, b.value, c.value) }; }
+
+    MATH_INLINE Lane Gather(const float* data, size_t stride)
+    {
+        if(stride == 1)
+            return Load(data);
+
+        return { Simd::Set(data[0], data[stride], data[2 * stride], data[3 * stride]) };
+    }
+#endif
+
+    /*!
+     @brief Rounds to nearest integer, exact for values below 2^22.
+     */
+    MATH_INLINE Lane Round(Lane v)
+    {
+        // Adding 1.5 * 2^23 pushes fraction bits out of the mantissa
+        const Lane magic = Splat(12582912.0f);
+        return Sub(Add(v, magic), magic);
+    }
+
+    /*!
+     @brief Sine & cosine of every lane, absolute error stays below 1e-6 for angles within +-8192.
+     */
+    MATH_INLINE void SinCos(Lane x, Lane& sines, Lane& cosines)
+    {
+        // Reduce to [-pi/4, pi/4] around nearest multiple of pi/2, pi/2 is split to 3 parts to keep precision
+        const Lane quadrant = Round(Mul(x, Splat(0.636619772f)));
+
+        Lane r = MulAdd(quadrant, Splat(-1.5703125f), x);
+        r = MulAdd(quadrant, Splat(-4.837512969970703125e-4f), r);
+        r = MulAdd(quadrant, Splat(-7.54978995489188216e-8f), r);
+
+        const Lane r2 = Mul(r, r);
+
+        // Minimax polynomials of the reduced range
+        Lane s = MulAdd(r2, Splat(-1.9515295891e-4f), Splat(8.3321608736e-3f));
+        s = MulAdd(r2, s, Splat(-1.6666654611e-1f));
+        s = MulAdd(Mul(r2, r), s, r);
+
+        Lane c = MulAdd(r2, Splat(2.443315711809948e-5f), Splat(-1.388731625493765e-3f));
+        c = MulAdd(r2, c, Splat(4.166664568298827e-2f));
+        c = MulAdd(Mul(r2, r2), c, MulAdd(r2, Splat(-0.5f), Splat(1.0f)));
+
+        // Quadrant modulo 4 split to bits, odd quadrants swap sine & cosine, upper two negate sine
+        const Lane wrapped = Sub(quadrant, Mul(Splat(4.0f), Round(MulAdd(quadrant, Splat(0.25f), Splat(-0.375f)))));
+        const Lane high = Round(MulAdd(wrapped, Splat(0.5f), Splat(-0.25f)));
+        const Lane odd = MulAdd(high, Splat(-2.0f), wrapped);
+
+        const Lane sineBase = MulAdd(odd, Sub(c, s), s);
+        const Lane cosineBase = MulAdd(odd, Sub(s, c), c);
+
+        // Cosine is negative in quadrants 1 & 2, that is when exactly one of the bits is set
+        const Lane cosineNegative = Sub(Add(high, odd), Mul(Splat(2.0f), Mul(high, odd)));
+
+        sines = Mul(sineBase, MulAdd(high, Splat(-2.0f), Splat(1.0f)));
+        cosines = Mul(cosineBase, MulAdd(cosineNegative, Splat(-2.0f), Splat(1.0f)));
+    }
+}
@@ -1,5 +1,6 @@
 #include <Math/Math.h>
 #include <Math/Matrix4.h>
+#include <Math/MatrixKernels.h>
 
 #include <algorithm>
 #include <iomanip>
@@ -224,42 +225,59 @@ Vector4f Matrix4::GetColumn(uint8_t idx) const noexcept
 
 void Matrix4::Transpose()
 {
-    std::swap(mData[1], mData[4]);
-    std::swap(mData[2], mData[8]);
-    std::swap(mData[3], mData[12]);
-    std::swap(mData[6], mData[9]);
-    std::swap(mData[7], mData[13]);
-    std::swap(mData[11], mData[14]);
+    Math::Kernels::TransposeMatrix(mData.data(), mData.data());
+}
+
+Matrix4 Matrix4::GetTransposed() const
+{
+    Matrix4 result(*this);
+    result.Transpose();
+    return result;
+}
+
+bool Matrix4::Invert()
+{
+    return Math::Kernels::InvertMatrix(mData.data(), mData.data());
+}
+
+Matrix4 Matrix4::GetInverse() const
+{
+    Matrix4 result(*this);
+    result.Invert();
+    return result;
+}
+
+Vector4f Matrix4::Transform(const Vector4f& v) const
+{
+    Vector4f result;
+    Math::Kernels::TransformVectors(mData.data(), &v.x, &result.x, 1);
+    return result;
+}
+
+Vector3f Matrix4::TransformPoint(const Vector3f& point) const
+{
+    return Transform(Vector4f(point.x, point.y, point.z, 1.0f)).GetXYZ();
+}
+
+Vector3f Matrix4::TransformDirection(const Vector3f& direction) const
+{
+    return Transform(Vector4f(direction.x, direction.y, direction.z, 0.0f)).GetXYZ();
 }
 
 Matrix4& Matrix4::operator*=(const Matrix4& other)
 {
-    Matrix4 result;
-    
-    result.m._11 = m._11 * other.m._11 + m._12 * other.m._21 + m._13 * other.m._31 + m._14 * other.m._41;
-    result.m._12 = m._11 * other.m._12 + m._12 * other.m._22 + m._13 * other.m._32 + m._14 * other.m._42;
-    result.m._13 = m._11 * other.m._13 + m._12 * other.m._23 + m._13 * other.m._33 + m._14 * other.m._43;
-    result.m._14 = m._11 * other.m._14 + m._12 * other.m._24 + m._13 * other.m._34 + m._14 * other.m._44;
-    
-    result.m._21 = m._21 * other.m._11 + m._22 * other.m._21 + m._23 * other.m._31 + m._24 * other.m._41;
-    result.m._22 = m._21 * other.m._12 + m._22 * other.m._22 + m._23 * other.m._32 + m._24 * other.m._42;
-    result.m._23 = m._21 * other.m._13 + m._22 * other.m._23 + m._23 * other.m._33 + m._24 * other.m._43;
-    result.m._24 = m._21 * other.m._14 + m._22 * other.m._24 + m._23 * other.m._34 + m._24 * other.m._44;
-    
-    result.m._31 = m._31 * other.m._11 + m._32 * other.m._21 + m._33 * other.m._31 + m._34 * other.m._41;
-    result.m._32 = m._31 * other.m._12 + m._32 * other.m._22 + m._33 * other.m._32 + m._34 * other.m._42;
-    result.m._33 = m._31 * other.m._13 + m._32 * other.m._23 + m._33 * other.m._33 + m._34 * other.m._43;
-    result.m._34 = m._31 * other.m._14 + m._32 * other.m._24 + m._33 * other.m._34 + m._34 * other.m._44;
-    
-    result.m._41 = m._41 * other.m._11 + m._42 * other.m._21 + m._43 * other.m._31 + m._44 * other.m._41;
-    result.m._42 = m._41 * other.m._12 + m._42 * other.m._22 + m._43 * other.m._32 + m._44 * other.m._42;
-    result.m._43 = m._41 * other.m._13 + m._42 * other.m._23 + m._43 * other.m._33 + m._44 * other.m._43;
-    result.m._44 = m._41 * other.m._14 + m._42 * other.m._24 + m._43 * other.m._34 + m._44 * other.m._44;
-    
-    *this = result;
+    // Kernel loads all inputs before storing, product is written in place
+    Math::Kernels::MultiplyMatrix(mData.data(), other.mData.data(), mData.data());
     return *this;
 }
 
+Matrix4 Matrix4::operator*(const Matrix4& other) const
+{
+    Matrix4 result(*this);
+    result *= other;
+    return result;
+}
+
 std::ostream& operator<<(std::ostream& s, const Matrix4& m)
 {
     for(uint8_t i{ 0 } ; i < 4; ++i)
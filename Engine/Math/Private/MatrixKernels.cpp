@@ -0,0 +1,165 @@
+#include <Math/MatrixKernels.h>
+#include <Math/Simd.h>
+
+using namespace Math::Simd;
+
+namespace
+{
+    // 2x2 matrices packed row by row into single register, used by blockwise inverse
+    MATH_INLINE Float4 Mat2Mul(Float4 a, Float4 b)
+    {
+        return MulAdd(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b), Mul(a, Swizzle<0, 3, 0, 3>(b)));
+    }
+
+    // adj(a) * b
+    MATH_INLINE Float4 Mat2AdjMul(Float4 a, Float4 b)
+    {
+        return NegMulAdd(Swizzle<1, 1, 2, 2>(a), Swizzle<2, 3, 0, 1>(b), Mul(Swizzle<3, 3, 0, 0>(a), b));
+    }
+
+    // a * adj(b)
+    MATH_INLINE Float4 Mat2MulAdj(Float4 a, Float4 b)
+    {
+        return NegMulAdd(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b), Mul(a, Swizzle<3, 0, 3, 0>(b)));
+    }
+
+    MATH_INLINE Float4 TransformVector(Float4 v, Float4 row0, Float4 row1, Float4 row2, Float4 row3)
+    {
+        Float4 result = Mul(SplatLane<0>(v), row0);
+        result = MulAdd(SplatLane<1>(v), row1, result);
+        result = MulAdd(SplatLane<2>(v), row2, result);
+        return MulAdd(SplatLane<3>(v), row3, result);
+    }
+
+#if defined(MATH_SIMD_AVX2)
+    MATH_INLINE __m256 MulAdd8(__m256 a, __m256 b, __m256 c)
+    {
+#if defined(__FMA__)
+        return _mm256_fmadd_ps(a, b, c);
+#else
+        return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+    }
+
+    // Transforms two vectors at once, each 128 bit lane holds one vector & copy of matrix rows
+    MATH_INLINE __m256 TransformVectorPair(__m256 v, __m256 row0, __m256 row1, __m256 row2, __m256 row3)
+    {
+        __m256 result = _mm256_mul_ps(_mm256_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), row0);
+        result = MulAdd8(_mm256_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), row1, result);
+        result = MulAdd8(_mm256_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), row2, result);
+        return MulAdd8(_mm256_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), row3, result);
+    }
+#endif
+}
+
+void Math::Kernels::MultiplyMatrix(const float* a, const float* b, float* result)
+{
+    // Every row of the product is the row of a transformed by b
+    TransformVectors(b, a, result, 4);
+}
+
+void Math::Kernels::MultiplyMatrices(const float* a, const float* b, float* result, size_t count)
+{
+    for(size_t i = 0; i < count; ++i)
+    {
+        TransformVectors(b + i * 16, a + i * 16, result + i * 16, 4);
+    }
+}
+
+void Math::Kernels::TransposeMatrix(const float* m, float* result)
+{
+    const Float4 row0 = Load(m);
+    const Float4 row1 = Load(m + 4);
+    const Float4 row2 = Load(m + 8);
+    const Float4 row3 = Load(m + 12);
+
+    const Float4 t0 = Shuffle<0, 1, 0, 1>(row0, row1);     // 00 01 10 11
+    const Float4 t1 = Shuffle<2, 3, 2, 3>(row0, row1);     // 02 03 12 13
+    const Float4 t2 = Shuffle<0, 1, 0, 1>(row2, row3);     // 20 21 30 31
+    const Float4 t3 = Shuffle<2, 3, 2, 3>(row2, row3);     // 22 23 32 33
+
+    Store(result, Shuffle<0, 2, 0, 2>(t0, t2));
+    Store(result + 4, Shuffle<1, 3, 1, 3>(t0, t2));
+    Store(result + 8, Shuffle<0, 2, 0, 2>(t1, t3));
+    Store(result + 12, Shuffle<1, 3, 1, 3>(t1, t3));
+}
+
+bool Math::Kernels::InvertMatrix(const float* m, float* result)
+{
+    // Blockwise inversion, matrix is split to 2x2 blocks A B / C D
+    const Float4 row0 = Load(m);
+    const Float4 row1 = Load(m + 4);
+    const Float4 row2 = Load(m + 8);
+    const Float4 row3 = Load(m + 12);
+
+    const Float4 A = Shuffle<0, 1, 0, 1>(row0, row1);
+    const Float4 B = Shuffle<2, 3, 2, 3>(row0, row1);
+    const Float4 C = Shuffle<0, 1, 0, 1>(row2, row3);
+    const Float4 D = Shuffle<2, 3, 2, 3>(row2, row3);
+
+    // Determinants of all blocks at once: |A| |B| |C| |D|
+    const Float4 detSub = NegMulAdd(Shuffle<1, 3, 1, 3>(row0, row2), Shuffle<0, 2, 0, 2>(row1, row3),
+                                    Mul(Shuffle<0, 2, 0, 2>(row0, row2), Shuffle<1, 3, 1, 3>(row1, row3)));
+
+    const Float4 detA = SplatLane<0>(detSub);
+    const Float4 detB = SplatLane<1>(detSub);
+    const Float4 detC = SplatLane<2>(detSub);
+    const Float4 detD = SplatLane<3>(detSub);
+
+    const Float4 D_C = Mat2AdjMul(D, C);
+    const Float4 A_B = Mat2AdjMul(A, B);
+
+    Float4 X = Sub(Mul(detD, A), Mat2Mul(B, D_C));
+    Float4 W = Sub(Mul(detA, D), Mat2Mul(C, A_B));
+    Float4 Y = Sub(Mul(detB, C), Mat2MulAdj(D, A_B));
+    Float4 Z = Sub(Mul(detC, B), Mat2MulAdj(A, D_C));
+
+    const Float4 trace = HorizontalSum(Mul(A_B, Swizzle<0, 2, 1, 3>(D_C)));
+    const Float4 det = Sub(MulAdd(detB, detC, Mul(detA, detD)), trace);
+
+    if(GetX(det) == 0.0f)
+        return false;
+
+    const Float4 invDet = Div(Set(1.0f, -1.0f, -1.0f, 1.0f), det);
+
+    X = Mul(X, invDet);
+    Y = Mul(Y, invDet);
+    Z = Mul(Z, invDet);
+    W = Mul(W, invDet);
+
+    Store(result, Shuffle<3, 1, 3, 1>(X, Y));
+    Store(result + 4, Shuffle<2, 0, 2, 0>(X, Y));
+    Store(result + 8, Shuffle<3, 1, 3, 1>(Z, W));
+    Store(result + 12, Shuffle<2, 0, 2, 0>(Z, W));
+
+    return true;
+}
+
+void Math::Kernels::TransformVectors(const float* m, const float* vectors, float* result, size_t count)
+{
+    // Rows are loaded before anything is stored, result may alias the matrix
+    const Float4 row0 = Load(m);
+    const Float4 row1 = Load(m + 4);
+    const Float4 row2 = Load(m + 8);
+    const Float4 row3 = Load(m + 12);
+
+    size_t i = 0;
+
+#if defined(MATH_SIMD_AVX2)
+    const __m256 row0x2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m));
+    const __m256 row1x2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 4));
+    const __m256 row2x2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 8));
+    const __m256 row3x2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 12));
+
+    for(; i + 2 <= count; i += 2)
+    {
+        const __m256 v = _mm256_loadu_ps(vectors + i * 4);
+        _mm256_storeu_ps(result + i * 4, TransformVectorPair(v, row0x2, row1x2, row2x2, row3x2));
+    }
+#endif
+
+    for(; i < count; ++i)
+    {
+        Store(result + i * 4, TransformVector(Load(vectors + i * 4), row0, row1, row2, row3));
+    }
+}
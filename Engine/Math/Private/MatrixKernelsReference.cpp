@@ -0,0 +1,101 @@
+#include <Math/MatrixKernels.h>
+
+#include <algorithm>
+
+void Math::Reference::MultiplyMatrix(const float* a, const float* b, float* result)
+{
+    float product[16];
+
+    for(int row = 0; row < 4; ++row)
+    {
+        for(int column = 0; column < 4; ++column)
+        {
+            float sum = 0.0f;
+
+            for(int k = 0; k < 4; ++k)
+            {
+                sum += a[row * 4 + k] * b[k * 4 + column];
+            }
+
+            product[row * 4 + column] = sum;
+        }
+    }
+
+    std::copy_n(product, 16, result);
+}
+
+void Math::Reference::MultiplyMatrices(const float* a, const float* b, float* result, size_t count)
+{
+    for(size_t i = 0; i < count; ++i)
+    {
+        MultiplyMatrix(a + i * 16, b + i * 16, result + i * 16);
+    }
+}
+
+void Math::Reference::TransposeMatrix(const float* m, float* result)
+{
+    float transposed[16];
+
+    for(int row = 0; row < 4; ++row)
+    {
+        for(int column = 0; column < 4; ++column)
+        {
+            transposed[column * 4 + row] = m[row * 4 + column];
+        }
+    }
+
+    std::copy_n(transposed, 16, result);
+}
+
+bool Math::Reference::InvertMatrix(const float* m, float* result)
+{
+    // Cofactor expansion, adjugate is computed element by element
+    float inv[16];
+
+    inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+    inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+    inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+    inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+    inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+    inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+    inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+    inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+    const float det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+
+    if(det == 0.0f)
+        return false;
+
+    const float invDet = 1.0f / det;
+
+    for(int i = 0; i < 16; ++i)
+    {
+        result[i] = inv[i] * invDet;
+    }
+
+    return true;
+}
+
+void Math::Reference::TransformVectors(const float* m, const float* vectors, float* result, size_t count)
+{
+    for(size_t i = 0; i < count; ++i)
+    {
+        const float* v = vectors + i * 4;
+        float transformed[4];
+
+        for(int column = 0; column < 4; ++column)
+        {
+            transformed[column] = v[0] * m[column] + v[1] * m[4 + column] + v[2] * m[8 + column] + v[3] * m[12 + column];
+        }
+
+        std::copy_n(transformed, 4, result + i * 4);
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <Math/MathBase.h>
+#include <Math/Matrix4.h>
+
+#include <cstddef>
+
+/*
+ * Bulk kernels over arrays of elements. Inputs are read as structure of arrays, one register lane per element,
+ * so the widest vector unit (8 lanes with AVX2) is fully used.
+ * Elements are independent, callers may split ranges across JobSystem::ParallelFor batches. Results may
+ * alias inputs of the same element.
+ */
+namespace Math
+{
+    /*!
+     @brief Strided view of floats, stride is in floats. Plain array has stride 1, member of array of structs has stride of the struct.
+     */
+    struct FloatStream
+    {
+        const float* data{ nullptr };
+        size_t stride{ 1 };
+    };
+
+    template<typename T>
+    struct Vector3Streams
+    {
+        T* x{ nullptr };
+        T* y{ nullptr };
+        T* z{ nullptr };
+    };
+
+    /*!
+     @brief Components of translation, rotation & scale of transforms.
+     */
+    struct TransformStreams
+    {
+        FloatStream positionX;
+        FloatStream positionY;
+        FloatStream positionZ;
+
+        /*!
+         @brief Euler angles in radians, applied in X, Y, Z order.
+         */
+        FloatStream rotationX;
+        FloatStream rotationY;
+        FloatStream rotationZ;
+
+        FloatStream scaleX;
+        FloatStream scaleY;
+        FloatStream scaleZ;
+    };
+
+    namespace Batch
+    {
+        /*!
+         @brief result[i] = a[i] * b[i]
+         */
+        MATH_API void MultiplyMatrices(const Matrix4* a, const Matrix4* b, Matrix4* result, size_t count);
+
+        /*!
+         @brief result[i] = a[i] * b, e.g. world matrices to world view projection.
+         */
+        MATH_API void MultiplyMatrices(const Matrix4* a, const Matrix4& b, Matrix4* result, size_t count);
+
+        /*!
+         @brief Transforms points (w = 1) by single matrix.
+         */
+        MATH_API void TransformPoints(const Matrix4& m, Vector3Streams<const float> points, Vector3Streams<float> result, size_t count);
+
+        /*!
+         @brief Builds matrices scaling, rotating around X, Y & Z and then translating,
+                same as MakeScale followed by RotateX, RotateY, RotateZ & SetTranslation.
+         */
+        MATH_API void ComposeTransforms(const TransformStreams& transforms, Matrix4* result, size_t count);
+
+        /*!
+         @brief Moves bounding spheres to space of their matrices, radius grows by the largest axis scale.
+         */
+        MATH_API void TransformBoundingSpheres(const Matrix4* matrices,
+                                               Vector3Streams<const float> centers, const float* radii,
+                                               Vector3Streams<float> resultCenters, float* resultRadii,
+                                               size_t count);
+
+        /*!
+         @brief Moves axis aligned boxes given by center & half extents to space of their matrices, result encloses the transformed box.
+         */
+        MATH_API void TransformBoundingBoxes(const Matrix4* matrices,
+                                             Vector3Streams<const float> centers, Vector3Streams<const float> extents,
+                                             Vector3Streams<float> resultCenters, Vector3Streams<float> resultExtents,
+                                             size_t count);
+    }
+}
@@ -7,6 +7,10 @@
 #include <array>
 #include <ostream>
 
+/*!
+ @brief Row major 4x4 matrix, vectors are rows multiplied from the left, translation is in the last row.
+        Arithmetic runs through SIMD kernels of Math/MatrixKernels.h.
+ */
 class MATH_API Matrix4
 {
 public:
@@ -44,8 +48,23 @@ public:
     [[nodiscard]] Vector4f GetColumn(uint8_t idx) const noexcept;
     
     void Transpose();
+    [[nodiscard]] Matrix4 GetTransposed() const;
+    
+    /*!
+     @return False if matrix is singular & stays unchanged.
+     */
+    bool Invert();
+    [[nodiscard]] Matrix4 GetInverse() const;
+    
+    [[nodiscard]] Vector4f Transform(const Vector4f& v) const;
+    [[nodiscard]] Vector3f TransformPoint(const Vector3f& point) const;
+    [[nodiscard]] Vector3f TransformDirection(const Vector3f& direction) const;
+    
+    [[nodiscard]] const float* GetData() const noexcept { return mData.data(); }
+    [[nodiscard]] float* GetData() noexcept { return mData.data(); }
     
     Matrix4& operator*=(const Matrix4& other);
+    [[nodiscard]] Matrix4 operator*(const Matrix4& other) const;
     
     MATH_API friend std::ostream& operator<<(std::ostream& s, const Matrix4& m);
     
@@ -58,11 +77,15 @@ private:
         float _41, _42, _43, _44;
     };
     
+    // Alignment is given by the member, alignas can't follow export attribute of the class on every compiler
     union
     {
         Data m;
         std::array<Vector4f, 4> mVectorData;
-        std::array<float, 16> mData;
+        alignas(16) std::array<float, 16> mData;
     };
 };
 
+static_assert(sizeof(Matrix4) == 16 * sizeof(float), "Matrix4 is copied to uniform buffers as is");
+static_assert(alignof(Matrix4) == 16, "Rows of Matrix4 are kept on 16 byte boundaries for SIMD loads");
+
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <Math/MathBase.h>
+
+#include <cstddef>
+
+/*
+ * Kernels operate on raw float arrays so they can be run over packed arrays of transforms.
+ * Matrices are 16 floats stored row by row, vectors are rows multiplied by matrix from the left (v * M),
+ * same convention as Matrix4. Result may alias any of the inputs.
+ */
+namespace Math
+{
+    /*!
+     @brief Kernels using the instruction set selected in Math/Simd.h.
+     */
+    namespace Kernels
+    {
+        /*!
+         @brief result = a * b
+         */
+        MATH_API void MultiplyMatrix(const float* a, const float* b, float* result);
+
+        /*!
+         @brief result[i] = a[i] * b[i] for count matrices.
+         */
+        MATH_API void MultiplyMatrices(const float* a, const float* b, float* result, size_t count);
+
+        MATH_API void TransposeMatrix(const float* m, float* result);
+
+        /*!
+         @return False if matrix is singular, result is left untouched then.
+         */
+        MATH_API bool InvertMatrix(const float* m, float* result);
+
+        /*!
+         @brief result[i] = vectors[i] * m for count 4 component vectors.
+         */
+        MATH_API void TransformVectors(const float* m, const float* vectors, float* result, size_t count);
+    }
+
+    /*!
+     @brief Plain scalar implementation of the kernels, reference for correctness checks of the SIMD paths.
+     */
+    namespace Reference
+    {
+        MATH_API void MultiplyMatrix(const float* a, const float* b, float* result);
+        MATH_API void MultiplyMatrices(const float* a, const float* b, float* result, size_t count);
+        MATH_API void TransposeMatrix(const float* m, float* result);
+        MATH_API bool InvertMatrix(const float* m, float* result);
+        MATH_API void TransformVectors(const float* m, const float* vectors, float* result, size_t count);
+    }
+}
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <Math/MathBase.h>
+
+#include <cmath>
+
+/*
+ * Instruction set is picked at compile time from compiler target flags, define MATH_FORCE_SCALAR to build
+ * the portable path on any target.
+ *
+ * MATH_SIMD_AVX2   AVX2 (+ FMA when available), implies MATH_SIMD_SSE
+ * MATH_SIMD_SSE    SSE2 baseline of x86-64, SSE4.1 instructions are used when enabled
+ * MATH_SIMD_NEON   ARMv7 NEON / AArch64 ASIMD
+ * MATH_SIMD_SCALAR No vector instructions
+ */
+#if defined(MATH_FORCE_SCALAR)
+#   define MATH_SIMD_SCALAR 1
+#elif defined(__AVX2__)
+#   define MATH_SIMD_AVX2 1
+#   define MATH_SIMD_SSE 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define MATH_SIMD_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   define MATH_SIMD_NEON 1
+#else
+#   define MATH_SIMD_SCALAR 1
+#endif
+
+#if defined(MATH_SIMD_AVX2)
+#   include <immintrin.h>
+#elif defined(MATH_SIMD_SSE)
+#   if defined(__SSE4_1__)
+#       include <smmintrin.h>
+#   else
+#       include <emmintrin.h>
+#   endif
+#elif defined(MATH_SIMD_NEON)
+#   include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#   define MATH_INLINE __forceinline
+#else
+#   define MATH_INLINE inline __attribute__((always_inline))
+#endif
+
+/*!
+ @brief Thin layer over 4-wide float registers, math kernels are written once against it.
+ */
+namespace Math::Simd
+{
+#if defined(MATH_SIMD_SSE)
+    using Float4 = __m128;
+#elif defined(MATH_SIMD_NEON)
+    using Float4 = float32x4_t;
+#else
+    struct Float4
+    {
+        float v[4];
+    };
+#endif
+
+    /*!
+     @brief Loads 4 floats, address doesn't have to be aligned.
+     */
+    MATH_INLINE Float4 Load(const float* data)
+    {
+#if defined(MATH_SIMD_SSE)
+        return _mm_loadu_ps(data);
+#elif defined(MATH_SIMD_NEON)
+        return vld1q_f32(data);
+#else
+        return Float4{ { data[0], data[1], data[2], data[3] } };
+#endif
+    }
+
+    MATH_INLINE void Store(float* data, Float4 v)
+    {
+#if defined(MATH_SIMD_SSE)
+        _mm_storeu_ps(data, v);
+#elif defined(MATH_SIMD_NEON)
+        vst1q_f32(data, v);
+#else
+        data[0] = v.v[0]; data[1] = v.v[1]; data[2] = v.v[2]; data[3] = v.v[3];
+#endif
+    }
+
+    MATH_INLINE Float4 Set(float x, float y, float z, float w)
+    {
+#if defined(MATH_SIMD_SSE)
+        return _mm_setr_ps(x, y, z, w);
+#elif defined(MATH_SIMD_NEON)
+        const float data[4]{ x, y, z, w };
+        return vld1q_f32(data);
+#else
+        return Float4{ { x, y, z, w } };
+#endif
+    }
+
+    MATH_INLINE Float4 Splat(float value)
+    {
+#if defined(MATH_SIMD_SSE)
+        return _mm_set1_ps(value);
+#elif defined(MATH_SIMD_NEON)
+        return vdupq_n_f32(value);
+#else
+        return Float4{ { value, value, value, value } };
+#endif
+    }
+
+    MATH_INLINE float GetX(Float4 v)
+    {
+#if defined(MATH_SIMD_SSE)
+        return _mm_cvtss_f32(v);
+#elif defined(MATH_SIMD_NEON)
+        return vgetq_lane_f32(v, 0);
+#else
+        return v.v[0];
+#endif
+    }
+
+    /*!
+     @brief Result is (a[X], a[Y], b[Z], b[W]), same as _mm_shuffle_ps.
+     */
+    template<int X, int Y, int Z, int W>
+    MATH_INLINE Float4 Shuffle(Float4 a, Float4 b)
+    {
+        static_assert(X >= 0 && X < 4 && Y >= 0 && Y < 4 && Z >= 0 && Z < 4 && W >= 0 && W < 4, "Lane index out of range");
+
+#if defined(MATH_SIMD_SSE)
+        return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+#elif defined(MATH_SIMD_NEON)
+        return __builtin_shufflevector(a, b, X, Y, Z + 4, W + 4);
+#else
+        return Float4{ { a.v[X], a.v[Y], b.v[Z], b.v[W] } };
+#endif
+    }
+
+    template<int X, int Y, int Z, int W>
+    MATH_INLINE Float4 Swizzle(Float4 v)
+    {
+        return Shuffle<X, Y, Z, W>(v, v);
+    }
+
+    template<int Lane>
+    MATH_INLINE Float4 SplatLane(Float4 v)
+    {
+#if defined(MATH_SIMD_NEON) && defined(__aarch64__)
+        return vdupq_laneq_f32(v, Lane);
+#else
+        return Swizzle<Lane, Lane, Lane, Lane>(v);
+#endif
+    }
+
+    MATH_INLINE Float4 Add(Float4 a, Float4 b)
+    {
+#if defined(MATH_SIMD_SSE)
+        return _mm_add_ps(a, b);
+#elif defined(MATH_SIMD_NEON)
+        return vaddq_f32(a, b);
+#else
+        return Float4{ { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } };
+#endif
+    }
+
+    MATH_INLINE Float4 Sub(Float4 a, Float4 b)
+    {
+#if defined(MATH_SIMD_SSE)
+        return _mm_sub_ps(a, b);
+#elif defined(MATH_SIMD_NEON)
+        return vsubq_f32(a, b);
+#else
+        return Float4{ { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } };
+#endif
+    }
+
+    MATH_INLINE Float4 Mul(Float4 a, Float4 b)
+    {
+#if defined(MATH_SIMD_SSE)
+        return _mm_mul_ps(a, b);
+#elif defined(MATH_SIMD_NEON)
+        return vmulq_f32(a, b);
+#else
+        return Float4{ { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } };
+#endif
+    }
+
+    /*!
+     @brief Returns a * b + c, fused where the target has FMA.
+     */
+    MATH_INLINE Float4 MulAdd(Float4 a, Float4 b, Float4 c)
+    {
+#if defined(MATH_SIMD_AVX2) && defined(__FMA__)
+        return _mm_fmadd_ps(a, b, c);
+#elif defined(MATH_SIMD_SSE)
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+#elif defined(MATH_SIMD_NEON) && defined(__aarch64__)
+        return vfmaq_f32(c, a, b);
+#elif defined(MATH_SIMD_NEON)
+        return vmlaq_f32(c, a, b);
+#else
+        return Add(Mul(a, b), c);
+#endif
+    }
+
+    /*!
+     @brief Returns c - a * b.
+     */
+    MATH_INLINE Float4 NegMulAdd(Float4 a, Float4 b, Float4 c)
+    {
+#if defined(MATH_SIMD_AVX2) && defined(__FMA__)
+        return _mm_fnmadd_ps(a, b, c);
+#elif defined(MATH_SIMD_NEON) && defined(__aarch64__)
+        return vfmsq_f32(c, a, b);
+#elif defined(MATH_SIMD_NEON)
+        return vmlsq_f32(c, a, b);
+#else
+        return Sub(c, Mul(a, b));
+#endif
+    }
+
+    /*!
+     @brief Horizontal sum broadcast to all lanes.
+     */
+    MATH_INLINE Float4 HorizontalSum(Float4 v)
+    {
+        const Float4 pairs = Add(v, Swizzle<1, 0, 3, 2>(v));
+        return Add(pairs, Swizzle<2, 3, 0, 1>(pairs));
+    }
+
+    /*!
+     @brief Dot product of all 4 lanes broadcast to all lanes.
+     */
+    MATH_INLINE Float4 Dot4(Float4 a, Float4 b)
+    {
+#if defined(MATH_SIMD_SSE) && defined(__SSE4_1__)
+        return _mm_dp_ps(a, b, 0xFF);
+#else
+        return HorizontalSum(Mul(a, b));
+#endif
+    }
+
+    /*!
+     @brief Dot product of xyz lanes broadcast to all lanes.
+     */
+    MATH_INLINE Float4 Dot3(Float4 a, Float4 b)
+    {
+#if defined(MATH_SIMD_SSE) && defined(__SSE4_1__)
+        return _mm_dp_ps(a, b, 0x7F);
+#else
+        const Float4 product = Mul(a, b);
+        const Float4 xy = Add(SplatLane<0>(product), SplatLane<1>(product));
+        return Add(xy, SplatLane<2>(product));
+#endif
+    }
+
+    /*!
+     @brief Cross product of xyz lanes, w of the result is 0 for finite inputs.
+     */
+    MATH_INLINE Float4 Cross3(Float4 a, Float4 b)
+    {
+        const Float4 aYZX = Swizzle<1, 2, 0, 3>(a);
+        const Float4 bYZX = Swizzle<1, 2, 0, 3>(b);
+        const Float4 c = NegMulAdd(aYZX, b, Mul(a, bYZX));
+        return Swizzle<1, 2, 0, 3>(c);
+    }
+
+    MATH_INLINE Float4 Min(Float4 a, Float4 b)
+    {
+#if defined(MATH_SIMD_SSE)
+        return _mm_min_ps(a, b);
+#elif defined(MATH_SIMD_NEON)
+        return vminq_f32(a, b);
+#else
+        return Float4{ { std::fmin(a.v[0], b.v[0]), std::fmin(a.v[1], b.v[1]), std::fmin(a.v[2], b.v[2]), std::fmin(a.v[3], b.v[3]) } };
+#endif
+    }
+
+    MATH_INLINE Float4 Max(Float4 a, Float4 b)
+    {
+#if defined(MATH_SIMD_SSE)
+        return _mm_max_ps(a, b);
+#elif defined(MATH_SIMD_NEON)
+        return vmaxq_f32(a, b);
+#else
+        return Float4{ { std::fmax(a.v[0], b.v[0]), std::fmax(a.v[1], b.v[1]), std::fmax(a.v[2], b.v[2]), std::fmax(a.v[3], b.v[3]) } };
+#endif
+    }
+
+    MATH_INLINE Float4 Abs(Float4 v)
+    {
+#if defined(MATH_SIMD_SSE)
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+#elif defined(MATH_SIMD_NEON)
+        return vabsq_f32(v);
+#else
+        return Float4{ { std::fabs(v.v[0]), std::fabs(v.v[1]), std::fabs(v.v[2]), std::fabs(v.v[3]) } };
+#endif
+    }
+
+    MATH_INLINE Float4 Sqrt(Float4 v)
+    {
+#if defined(MATH_SIMD_SSE)
+        return _mm_sqrt_ps(v);
+#elif defined(MATH_SIMD_NEON) && defined(__aarch64__)
+        return vsqrtq_f32(v);
+#elif defined(MATH_SIMD_NEON)
+        float data[4];
+        vst1q_f32(data, v);
+        return Set(std::sqrt(data[0]), std::sqrt(data[1]), std::sqrt(data[2]), std::sqrt(data[3]));
+#else
+        return Float4{ { std::sqrt(v.v[0]), std::sqrt(v.v[1]), std::sqrt(v.v[2]), std::sqrt(v.v[3]) } };
+#endif
+    }
+
+    /*!
+     @brief Exact division, reciprocal estimates are not precise enough for inverse & normalization.
+     */
+    MATH_INLINE Float4 Div(Float4 a, Float4 b)
+    {
+#if defined(MATH_SIMD_SSE)
+        return _mm_div_ps(a, b);
+#elif defined(MATH_SIMD_NEON) && defined(__aarch64__)
+        return vdivq_f32(a, b);
+#elif defined(MATH_SIMD_NEON)
+        float da[4], db[4];
+        vst1q_f32(da, a);
+        vst1q_f32(db, b);
+        return Set(da[0] / db[0], da[1] / db[1], da[2] / db[2], da[3] / db[3]);
+#else
+        return Float4{ { a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] } };
+#endif
+    }
+
+    /*!
+     @brief Scales xyz lanes to unit length keeping w, zero length vector is returned unchanged.
+     */
+    MATH_INLINE Float4 Normalize3(Float4 v)
+    {
+        const Float4 lengthSquared = Dot3(v, v);
+
+        if(GetX(lengthSquared) == 0.0f)
+            return v;
+
+        const Float4 normalized = Div(v, Sqrt(lengthSquared));
+        const Float4 zw = Shuffle<2, 2, 3, 3>(normalized, v);
+        return Shuffle<0, 1, 0, 2>(normalized, zw);
+    }
+}
@@ -3,6 +3,8 @@
 #include <Math/MathBase.h>
 #include <Core/TupleHash.h>
 
+#include <cmath>
+
 template<typename T>
 class Vector3
 {
@@ -17,7 +19,43 @@ public:
         : x(x_), y(y_), z(z_)
     {}
     
-    Vector3<T> operator*(const float s)
+    constexpr Vector3<T> operator+(const Vector3<T>& other) const
+    {
+        return Vector3<T>(x + other.x, y + other.y, z + other.z);
+    }
+    
+    constexpr Vector3<T> operator-(const Vector3<T>& other) const
+    {
+        return Vector3<T>(x - other.x, y - other.y, z - other.z);
+    }
+    
+    constexpr Vector3<T> operator*(const T s) const
+    {
+        return Vector3<T>(x * s, y * s, z * s);
+    }
+    
+    constexpr Vector3<T> operator-() const
+    {
+        return Vector3<T>(-x, -y, -z);
+    }
+    
+    Vector3<T>& operator+=(const Vector3<T>& other)
+    {
+        x += other.x;
+        y += other.y;
+        z += other.z;
+        return *this;
+    }
+    
+    Vector3<T>& operator-=(const Vector3<T>& other)
+    {
+        x -= other.x;
+        y -= other.y;
+        z -= other.z;
+        return *this;
+    }
+    
+    Vector3<T>& operator*=(const T s)
     {
         x *= s;
         y *= s;
@@ -25,12 +63,36 @@ public:
         return *this;
     }
     
-    Vector3<T> operator-()
+    constexpr T Dot(const Vector3<T>& other) const
     {
-        x *= -1.0f;
-        y *= -1.0f;
-        z *= -1.0f;
-        return *this;
+        return x * other.x + y * other.y + z * other.z;
+    }
+    
+    constexpr Vector3<T> Cross(const Vector3<T>& other) const
+    {
+        return Vector3<T>(y * other.z - z * other.y, z * other.x - x * other.z, x * other.y - y * other.x);
+    }
+    
+    T Length() const
+    {
+        return std::sqrt(Dot(*this));
+    }
+    
+    void Normalize()
+    {
+        const T lengthSquared = Dot(*this);
+        
+        if (lengthSquared == 0)
+            return;
+        
+        *this *= 1 / std::sqrt(lengthSquared);
+    }
+    
+    Vector3<T> GetNormalized() const
+    {
+        Vector3<T> result(*this);
+        result.Normalize();
+        return result;
     }
     
 public:
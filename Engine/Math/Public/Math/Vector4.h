@@ -2,7 +2,10 @@
 
 #include <Math/MathBase.h>
 #include <Math/Vector3.h>
+#include <Math/Simd.h>
+
 #include <cmath>
+#include <type_traits>
 
 template<typename T>
 class Vector4
@@ -18,17 +21,27 @@ public:
     : x(x_), y(y_), z(z_), w(w_)
     {}
     
+    /*!
+     @brief Scales xyz to unit length, w is kept.
+     */
     void Normalize()
     {
-        const float lengthSquared = x * x + y * y + z * z;
-        
-        if (lengthSquared == 0.0f)
-            return;
-        
-        float inv = 1.0f / std::sqrt(lengthSquared);
-        x *= inv;
-        y *= inv;
-        z *= inv;
+        if constexpr (std::is_same_v<T, float>)
+        {
+            Math::Simd::Store(&x, Math::Simd::Normalize3(Math::Simd::Load(&x)));
+        }
+        else
+        {
+            const T lengthSquared = x * x + y * y + z * z;
+            
+            if (lengthSquared == 0)
+                return;
+            
+            const T inv = 1 / std::sqrt(lengthSquared);
+            x *= inv;
+            y *= inv;
+            z *= inv;
+        }
     }
     
     const Vector4<T> GetNormalized() const
@@ -38,6 +51,41 @@ public:
         return result;
     }
     
+    T Dot(const Vector4<T>& other) const
+    {
+        if constexpr (std::is_same_v<T, float>)
+        {
+            return Math::Simd::GetX(Math::Simd::Dot4(Math::Simd::Load(&x), Math::Simd::Load(&other.x)));
+        }
+        else
+        {
+            return x * other.x + y * other.y + z * other.z + w * other.w;
+        }
+    }
+    
+    /*!
+     @brief Cross product of xyz, w of the result is 0.
+     */
+    Vector4<T> Cross(const Vector4<T>& other) const
+    {
+        return Vector4<T>(y * other.z - z * other.y, z * other.x - x * other.z, x * other.y - y * other.x, 0);
+    }
+    
+    constexpr Vector4<T> operator+(const Vector4<T>& other) const
+    {
+        return Vector4<T>(x + other.x, y + other.y, z + other.z, w + other.w);
+    }
+    
+    constexpr Vector4<T> operator-(const Vector4<T>& other) const
+    {
+        return Vector4<T>(x - other.x, y - other.y, z - other.z, w - other.w);
+    }
+    
+    constexpr Vector4<T> operator*(const T s) const
+    {
+        return Vector4<T>(x * s, y * s, z * s, w * s);
+    }
+    
     Vector3<T> GetXYZ() const
     {
         return Vector3<T>(x, y, z);
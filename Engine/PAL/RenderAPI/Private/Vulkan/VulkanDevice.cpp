@@ -12,6 +12,7 @@ namespace PAL::RenderAPI
 		, mLogicalDevice(deviceData.logicalDevice)
 		, mDeviceProperties(deviceData.deviceProperties)
 		, mDeviceFeatures(deviceData.deviceFeatures)
+		, mDescriptorIndexingFeatures(deviceData.descriptorIndexingFeatures)
 		, mDeviceExtensions(std::move(deviceData.deviceExtensions))
 	{
 		LoadFunctions(deviceData.deviceProcAddrFunc);
@@ -27,6 +28,20 @@ namespace PAL::RenderAPI
         if(f == DeviceFeature::AnisotropicFiltering)
             return mDeviceFeatures.samplerAnisotropy;
         
+        if(f == DeviceFeature::DescriptorIndexing)
+        {
+            return mDeviceFeatures.shaderSampledImageArrayDynamicIndexing &&
+                   mDescriptorIndexingFeatures.runtimeDescriptorArray &&
+                   mDescriptorIndexingFeatures.descriptorBindingPartiallyBound &&
+                   mDescriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind;
+        }
+        
+        if(f == DeviceFeature::MultiDrawIndirect)
+            return mDeviceFeatures.multiDrawIndirect && mDeviceFeatures.drawIndirectFirstInstance;
+        
+        if(f == DeviceFeature::DrawIndirectCount)
+            return vkCmdDrawIndexedIndirectCountKHR != nullptr;
+        
         return false;
     }
 
@@ -88,11 +103,41 @@ namespace PAL::RenderAPI
         VK_CHECK_RESULT(vkCreateGraphicsPipelines(mLogicalDevice, pipelineCache, createInfoCount, pCreateInfos, pAllocator, pPipelines));
     }
     
+    void VulkanDevice::CreateComputePipeline(VkPipelineCache pipelineCache, uint32_t createInfoCount, const VkComputePipelineCreateInfo* pCreateInfos, const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines) const
+    {
+        VK_CHECK_RESULT(vkCreateComputePipelines(mLogicalDevice, pipelineCache, createInfoCount, pCreateInfos, pAllocator, pPipelines));
+    }
+    
     void VulkanDevice::DestroyPipeline(VkPipeline pipeline, const VkAllocationCallbacks* pAllocator) const
     {
         vkDestroyPipeline(mLogicalDevice, pipeline, pAllocator);
     }
     
+    void VulkanDevice::CreatePipelineCache(const VkPipelineCacheCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkPipelineCache* pPipelineCache) const
+    {
+        VK_CHECK_RESULT(vkCreatePipelineCache(mLogicalDevice, pCreateInfo, pAllocator, pPipelineCache));
+    }
+    
+    void VulkanDevice::DestroyPipelineCache(VkPipelineCache pipelineCache, const VkAllocationCallbacks* pAllocator) const
+    {
+        vkDestroyPipelineCache(mLogicalDevice, pipelineCache, pAllocator);
+    }
+    
+    std::vector<uint8_t> VulkanDevice::GetPipelineCacheData(VkPipelineCache pipelineCache) const
+    {
+        size_t dataSize{ 0 };
+        VK_CHECK_RESULT(vkGetPipelineCacheData(mLogicalDevice, pipelineCache, &dataSize, nullptr));
+        
+        std::vector<uint8_t> data(dataSize);
+        if(dataSize > 0)
+        {
+            VK_CHECK_RESULT(vkGetPipelineCacheData(mLogicalDevice, pipelineCache, &dataSize, data.data()));
+            data.resize(dataSize);
+        }
+        
+        return data;
+    }
+    
     void VulkanDevice::CreateRenderPass(const VkRenderPassCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkRenderPass* pRenderPass) const
     {
         VK_CHECK_RESULT(vkCreateRenderPass(mLogicalDevice, pCreateInfo, pAllocator, pRenderPass));
@@ -243,6 +288,17 @@ namespace PAL::RenderAPI
         return result;
     }
     
+    VkResult VulkanDevice::GetFenceStatus(VkFence fence) const
+    {
+        // VK_NOT_READY is a regular answer, only errors are reported
+        const auto result = vkGetFenceStatus(mLogicalDevice, fence);
+        if(result < 0)
+        {
+            VK_CHECK_RESULT(result);
+        }
+        return result;
+    }
+    
     void VulkanDevice::DestroyFence(VkFence fence, const VkAllocationCallbacks* pAllocator) const
     {
         vkDestroyFence(mLogicalDevice, fence, pAllocator);
@@ -372,6 +428,36 @@ namespace PAL::RenderAPI
         vkCmdPushConstants(commandBuffer, layout, stageFlags, offset, size, pValues);
     }
     
+    void VulkanDevice::CmdExecuteCommands(VkCommandBuffer commandBuffer, uint32_t commandBufferCount, const VkCommandBuffer* pCommandBuffers) const
+    {
+        vkCmdExecuteCommands(commandBuffer, commandBufferCount, pCommandBuffers);
+    }
+    
+    void VulkanDevice::CmdFillBuffer(VkCommandBuffer commandBuffer, VkBuffer dstBuffer, VkDeviceSize dstOffset, VkDeviceSize size, uint32_t data) const
+    {
+        vkCmdFillBuffer(commandBuffer, dstBuffer, dstOffset, size, data);
+    }
+    
+    void VulkanDevice::CmdDispatch(VkCommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) const
+    {
+        vkCmdDispatch(commandBuffer, groupCountX, groupCountY, groupCountZ);
+    }
+    
+    void VulkanDevice::CmdDispatchIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset) const
+    {
+        vkCmdDispatchIndirect(commandBuffer, buffer, offset);
+    }
+    
+    void VulkanDevice::CmdDrawIndexedIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride) const
+    {
+        vkCmdDrawIndexedIndirect(commandBuffer, buffer, offset, drawCount, stride);
+    }
+    
+    void VulkanDevice::CmdDrawIndexedIndirectCountKHR(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride) const
+    {
+        vkCmdDrawIndexedIndirectCountKHR(commandBuffer, buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride);
+    }
+    
     VkResult VulkanDevice::CreateDescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDescriptorSetLayout* pSetLayout) const
     {
         const auto result = vkCreateDescriptorSetLayout(mLogicalDevice, pCreateInfo, pAllocator, pSetLayout);
@@ -396,6 +482,11 @@ namespace PAL::RenderAPI
         vkDestroyDescriptorPool(mLogicalDevice, descriptorPool, pAllocator);
     }
     
+    void VulkanDevice::ResetDescriptorPool(VkDescriptorPool descriptorPool, VkDescriptorPoolResetFlags flags) const
+    {
+        VK_CHECK_RESULT(vkResetDescriptorPool(mLogicalDevice, descriptorPool, flags));
+    }
+    
     VkResult VulkanDevice::AllocateDescriptorSets(const VkDescriptorSetAllocateInfo* pAllocateInfo, VkDescriptorSet* pDescriptorSets) const
     {
         const auto result = vkAllocateDescriptorSets(mLogicalDevice, pAllocateInfo, pDescriptorSets);
@@ -471,7 +562,11 @@ namespace PAL::RenderAPI
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCreatePipelineLayout);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkDestroyPipelineLayout);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCreateGraphicsPipelines);
+        LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCreateComputePipelines);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkDestroyPipeline);
+        LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCreatePipelineCache);
+        LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkDestroyPipelineCache);
+        LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkGetPipelineCacheData);
         
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCreateRenderPass);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkDestroyRenderPass);
@@ -490,17 +585,23 @@ namespace PAL::RenderAPI
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCmdDraw);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCmdBindIndexBuffer);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCmdDrawIndexed);
+        LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCmdDrawIndexedIndirect);
+        LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCmdDispatch);
+        LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCmdDispatchIndirect);
+        LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCmdFillBuffer);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCmdBindDescriptorSets);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCmdPipelineBarrier);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCmdSetViewport);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCmdSetScissor);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCmdPushConstants);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCmdNextSubpass);
+        LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCmdExecuteCommands);
         
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCreateDescriptorSetLayout);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkDestroyDescriptorSetLayout);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCreateDescriptorPool);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkDestroyDescriptorPool);
+        LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkResetDescriptorPool);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkAllocateDescriptorSets);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkUpdateDescriptorSets);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkFreeDescriptorSets);
@@ -534,6 +635,7 @@ namespace PAL::RenderAPI
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkCreateFence);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkWaitForFences);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkResetFences);
+        LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkGetFenceStatus);
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkDestroyFence);
         
         LOAD_VK_DEVICE_LEVEL_FUNCTION(mLogicalDevice, loadFunc, vkQueueWaitIdle);
@@ -550,6 +652,12 @@ namespace PAL::RenderAPI
 		{
 			LOG(Warning) << "Device Extension: " << VK_KHR_SWAPCHAIN_EXTENSION_NAME << " not available.";
 		}
+        
+        // Renderer enables the extension whenever it's available, indirect draws fall back to fixed count without it
+        if (IsExtensionSupported(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME))
+        {
+            LOAD_VK_DEVICE_LEVEL_FUNCTION_EXT(mLogicalDevice, loadFunc, vkCmdDrawIndexedIndirectCountKHR);
+        }
 	}
     
     void VulkanDevice::WaitIdle() const
@@ -239,6 +239,24 @@ namespace PAL::RenderAPI
 		return features;
 	}
 
+	VkPhysicalDeviceDescriptorIndexingFeaturesEXT VulkanRenderAPI::GetPhysicalDeviceDescriptorIndexingFeatures(const VkPhysicalDevice& physicalDevice) const
+	{
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures{};
+		indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+		if(!vkGetPhysicalDeviceFeatures2KHR)
+			return indexingFeatures;
+
+		VkPhysicalDeviceFeatures2KHR features{};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+		features.pNext = &indexingFeatures;
+
+		vkGetPhysicalDeviceFeatures2KHR(physicalDevice, &features);
+
+		indexingFeatures.pNext = nullptr;
+		return indexingFeatures;
+	}
+
 	VkPhysicalDeviceProperties VulkanRenderAPI::GetPhysicalDeviceProperties(const VkPhysicalDevice& physicalDevice) const
 	{
 		VkPhysicalDeviceProperties properties{ VK_NULL_HANDLE };
@@ -288,6 +306,16 @@ namespace PAL::RenderAPI
     {
 		PlatformLoadInstanceExtensions();
 
+        // VK_KHR_get_physical_device_properties2
+        if(IsExtensionEnabled(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+        {
+            LOAD_VK_INSTANCE_LEVEL_FUNCTION_EXT(mInstance.Get(), vkGetPhysicalDeviceFeatures2KHR);
+        }
+        else
+        {
+            LOG(Warning) << "Extension: " << VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME << " not available.";
+        }
+        
         // VK_EXT_debug_utils
         if(IsExtensionEnabled(VK_EXT_DEBUG_UTILS_EXTENSION_NAME))
         {
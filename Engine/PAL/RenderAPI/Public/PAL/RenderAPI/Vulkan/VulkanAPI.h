@@ -90,6 +90,13 @@ namespace PAL::RenderAPI
          */
 		NO_DISCARD VkPhysicalDeviceFeatures GetPhysicalDeviceFeatures(const VkPhysicalDevice& physicalDevice) const;
         
+        /*!
+         @brief Query descriptor indexing features of physical device, requires VK_KHR_get_physical_device_properties2 instance extension.
+         @param device Physical device.
+         @return Descriptor indexing features, all features are disabled if the instance extension is not enabled.
+         */
+        NO_DISCARD VkPhysicalDeviceDescriptorIndexingFeaturesEXT GetPhysicalDeviceDescriptorIndexingFeatures(const VkPhysicalDevice& physicalDevice) const;
+        
         /*!
          @brief Query physical device properties.
          @param device Physical device.
@@ -161,6 +168,9 @@ namespace PAL::RenderAPI
 		PFN_vkGetPhysicalDeviceFeatures vkGetPhysicalDeviceFeatures{ nullptr };
         PFN_vkGetPhysicalDeviceMemoryProperties vkGetPhysicalDeviceMemoryProperties{ nullptr };
 
+		// VK_KHR_get_physical_device_properties2
+		PFN_vkGetPhysicalDeviceFeatures2KHR vkGetPhysicalDeviceFeatures2KHR{ nullptr };
+
 		// VK_EXT_debug_utils
 		PFN_vkCreateDebugUtilsMessengerEXT vkCreateDebugUtilsMessengerEXT{ nullptr };
 		PFN_vkDestroyDebugUtilsMessengerEXT vkDestroyDebugUtilsMessengerEXT{ nullptr };
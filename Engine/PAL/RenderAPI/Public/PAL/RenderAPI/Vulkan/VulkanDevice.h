@@ -27,6 +27,7 @@ namespace PAL::RenderAPI
 		VkDevice logicalDevice{ VK_NULL_HANDLE };
 		VkPhysicalDeviceFeatures deviceFeatures{ VK_NULL_HANDLE };
 		VkPhysicalDeviceProperties deviceProperties{ VK_NULL_HANDLE };
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures{};    // Enabled features, all disabled without the extension
 		std::vector<VkExtensionProperties> deviceExtensions;
 		PFN_vkGetDeviceProcAddr deviceProcAddrFunc{ nullptr };
 	};
@@ -34,7 +35,22 @@ namespace PAL::RenderAPI
     enum class DeviceFeature
     {
         None = 0x00000000,
-        AnisotropicFiltering = 0x00000001
+        AnisotropicFiltering = 0x00000001,
+        
+        /*!
+         @brief Partially bound, update after bind arrays of sampled images & samplers indexed by dynamically uniform index.
+         */
+        DescriptorIndexing = 0x00000002,
+        
+        /*!
+         @brief Indirect draws of many commands by single call, commands may start at non-zero instance.
+         */
+        MultiDrawIndirect = 0x00000004,
+        
+        /*!
+         @brief Number of indirect draws is read from device buffer, VK_KHR_draw_indirect_count.
+         */
+        DrawIndirectCount = 0x00000008
     };
     
     class RENDERAPI_API VulkanDevice : public std::enable_shared_from_this<VulkanDevice>
@@ -45,6 +61,7 @@ namespace PAL::RenderAPI
         
         const VkPhysicalDevice& GetPhysicalDevice() const { return mPhysicalDevice; }
         const VkDevice& GetDevice() const { return mLogicalDevice; }
+        const VkPhysicalDeviceProperties& GetProperties() const { return mDeviceProperties; }
         
         bool IsFeatureSupported(DeviceFeature f) const;
 
@@ -59,7 +76,11 @@ namespace PAL::RenderAPI
         void CreatePipelineLayout(const VkPipelineLayoutCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkPipelineLayout* pPipelineLayout) const;
         void DestroyPipelineLayout(VkPipelineLayout pipelineLayout, const VkAllocationCallbacks* pAllocator) const;
         void CreateGraphicsPipeline(VkPipelineCache pipelineCache, uint32_t createInfoCount, const VkGraphicsPipelineCreateInfo* pCreateInfos, const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines) const;
+        void CreateComputePipeline(VkPipelineCache pipelineCache, uint32_t createInfoCount, const VkComputePipelineCreateInfo* pCreateInfos, const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines) const;
         void DestroyPipeline(VkPipeline pipeline, const VkAllocationCallbacks* pAllocator) const;
+        void CreatePipelineCache(const VkPipelineCacheCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkPipelineCache* pPipelineCache) const;
+        void DestroyPipelineCache(VkPipelineCache pipelineCache, const VkAllocationCallbacks* pAllocator) const;
+        std::vector<uint8_t> GetPipelineCacheData(VkPipelineCache pipelineCache) const;
         
         void CreateRenderPass(const VkRenderPassCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkRenderPass* pRenderPass) const;
         void DestroyRenderPass(VkRenderPass renderPass, const VkAllocationCallbacks* pAllocator) const;
@@ -98,6 +119,7 @@ namespace PAL::RenderAPI
         VkResult CreateFence(const VkFenceCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkFence* pFence) const;
         VkResult WaitForFences(uint32_t fenceCount, const VkFence* pFences, VkBool32 waitAll, uint64_t timeout) const;
         VkResult ResetFences(uint32_t fenceCount, const VkFence* pFences) const;
+        VkResult GetFenceStatus(VkFence fence) const;
         void DestroyFence(VkFence fence, const VkAllocationCallbacks* pAllocator) const;
         
         VkResult CreateBuffer(const VkBufferCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkBuffer* pBuffer) const;
@@ -128,12 +150,19 @@ namespace PAL::RenderAPI
         void CmdSetViewport(VkCommandBuffer commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const VkViewport* pViewports) const;
         void CmdSetScissor(VkCommandBuffer commandBuffer, uint32_t firstScissor, uint32_t scissorCount, const VkRect2D* pScissors) const;
         void CmdPushConstants(VkCommandBuffer commandBuffer, VkPipelineLayout layout, VkShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* pValues) const;
+        void CmdExecuteCommands(VkCommandBuffer commandBuffer, uint32_t commandBufferCount, const VkCommandBuffer* pCommandBuffers) const;
+        void CmdFillBuffer(VkCommandBuffer commandBuffer, VkBuffer dstBuffer, VkDeviceSize dstOffset, VkDeviceSize size, uint32_t data) const;
+        void CmdDispatch(VkCommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) const;
+        void CmdDispatchIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset) const;
+        void CmdDrawIndexedIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride) const;
+        void CmdDrawIndexedIndirectCountKHR(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride) const;
         
         // Descriptors        
         VkResult CreateDescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDescriptorSetLayout* pSetLayout) const;
         void DestroyDescriptorSetLayout(VkDescriptorSetLayout descriptorSetLayout, const VkAllocationCallbacks* pAllocator) const;
         VkResult CreateDescriptorPool(const VkDescriptorPoolCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDescriptorPool* pDescriptorPool) const;
         void DestroyDescriptorPool(VkDescriptorPool descriptorPool, const VkAllocationCallbacks* pAllocator) const;
+        void ResetDescriptorPool(VkDescriptorPool descriptorPool, VkDescriptorPoolResetFlags flags) const;
         VkResult AllocateDescriptorSets(const VkDescriptorSetAllocateInfo* pAllocateInfo, VkDescriptorSet* pDescriptorSets) const;
         void UpdateDescriptorSets(uint32_t descriptorWriteCount, const VkWriteDescriptorSet* pDescriptorWrites, uint32_t descriptorCopyCount, const VkCopyDescriptorSet* pDescriptorCopies) const;
         VkResult FreeDescriptorSets(VkDevice device, VkDescriptorPool descriptorPool, uint32_t descriptorSetCount, const VkDescriptorSet* pDescriptorSets) const;
@@ -152,6 +181,7 @@ namespace PAL::RenderAPI
 		VkDevice mLogicalDevice{ VK_NULL_HANDLE };
 		VkPhysicalDeviceProperties mDeviceProperties{ VK_NULL_HANDLE };
 		VkPhysicalDeviceFeatures mDeviceFeatures{ VK_NULL_HANDLE };
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT mDescriptorIndexingFeatures{};
         
 		std::vector<VkExtensionProperties> mDeviceExtensions;
         
@@ -160,7 +190,11 @@ namespace PAL::RenderAPI
         PFN_vkCreatePipelineLayout vkCreatePipelineLayout{ nullptr };
         PFN_vkDestroyPipelineLayout vkDestroyPipelineLayout{ nullptr };
         PFN_vkCreateGraphicsPipelines vkCreateGraphicsPipelines{ nullptr };
+        PFN_vkCreateComputePipelines vkCreateComputePipelines{ nullptr };
         PFN_vkDestroyPipeline vkDestroyPipeline{ nullptr };
+        PFN_vkCreatePipelineCache vkCreatePipelineCache{ nullptr };
+        PFN_vkDestroyPipelineCache vkDestroyPipelineCache{ nullptr };
+        PFN_vkGetPipelineCacheData vkGetPipelineCacheData{ nullptr };
         
         PFN_vkGetDeviceQueue vkGetDeviceQueue{ nullptr };
         PFN_vkCreateRenderPass vkCreateRenderPass{ nullptr };
@@ -171,6 +205,7 @@ namespace PAL::RenderAPI
         PFN_vkCmdDraw vkCmdDraw{ nullptr };
         PFN_vkCmdPushConstants vkCmdPushConstants{ nullptr };
         PFN_vkCmdNextSubpass vkCmdNextSubpass{ nullptr };
+        PFN_vkCmdExecuteCommands vkCmdExecuteCommands{ nullptr };
         
         PFN_vkCreateFramebuffer vkCreateFramebuffer{ nullptr };
         PFN_vkDestroyFramebuffer vkDestroyFramebuffer{ nullptr };
@@ -193,6 +228,10 @@ namespace PAL::RenderAPI
         PFN_vkCmdBindDescriptorSets vkCmdBindDescriptorSets{ nullptr };
         PFN_vkCmdBindIndexBuffer vkCmdBindIndexBuffer{ nullptr };
         PFN_vkCmdDrawIndexed vkCmdDrawIndexed{ nullptr };
+        PFN_vkCmdDrawIndexedIndirect vkCmdDrawIndexedIndirect{ nullptr };
+        PFN_vkCmdDispatch vkCmdDispatch{ nullptr };
+        PFN_vkCmdDispatchIndirect vkCmdDispatchIndirect{ nullptr };
+        PFN_vkCmdFillBuffer vkCmdFillBuffer{ nullptr };
         
 		PFN_vkDestroyDevice vkDestroyDevice{ nullptr };
         PFN_vkDeviceWaitIdle vkDeviceWaitIdle{ nullptr };
@@ -212,6 +251,7 @@ namespace PAL::RenderAPI
         PFN_vkDestroyDescriptorSetLayout vkDestroyDescriptorSetLayout{ nullptr };
         PFN_vkCreateDescriptorPool vkCreateDescriptorPool{ nullptr };
         PFN_vkDestroyDescriptorPool vkDestroyDescriptorPool{ nullptr };
+        PFN_vkResetDescriptorPool vkResetDescriptorPool{ nullptr };
         PFN_vkAllocateDescriptorSets vkAllocateDescriptorSets{ nullptr };
         PFN_vkUpdateDescriptorSets vkUpdateDescriptorSets{ nullptr };
         PFN_vkFreeDescriptorSets vkFreeDescriptorSets{ nullptr };
@@ -242,6 +282,7 @@ namespace PAL::RenderAPI
         PFN_vkDestroyFence vkDestroyFence{ nullptr };
         PFN_vkWaitForFences vkWaitForFences{ nullptr };
         PFN_vkResetFences vkResetFences{ nullptr };
+        PFN_vkGetFenceStatus vkGetFenceStatus{ nullptr };
 
 		// VK_KHR_swapchain extension
 		PFN_vkCreateSwapchainKHR vkCreateSwapchainKHR{ nullptr };
@@ -249,5 +290,8 @@ namespace PAL::RenderAPI
         PFN_vkGetSwapchainImagesKHR vkGetSwapchainImagesKHR{ nullptr };
         PFN_vkAcquireNextImageKHR vkAcquireNextImageKHR{ nullptr };
         PFN_vkQueuePresentKHR vkQueuePresentKHR{ nullptr };
+        
+        // VK_KHR_draw_indirect_count extension
+        PFN_vkCmdDrawIndexedIndirectCountKHR vkCmdDrawIndexedIndirectCountKHR{ nullptr };
 	};
 }
@@ -32,7 +32,7 @@ void Camera::Update(uint32_t w, uint32_t h)
     
     mLeftUnit = -mRightUnit;
     mDownUnit = -mUpUnit;
-    mBackwardUnit = mBackwardUnit;
+    mBackwardUnit = -mForwardUnit;
 }
 
 const Vector3f& Camera::GetForward() const noexcept
@@ -1,54 +1,24 @@
 #include <Renderer/DeviceObject.h>
+#include <Core/Assert.h>
 
 using namespace Renderer;
 
-namespace Renderer
+DeviceObject::DeviceObject(DeviceObjectType type, uint32_t index, uint32_t generation)
+    : mHandle((static_cast<uint32_t>(type) << (IndexBits + GenerationBits)) | ((generation & GenerationMask) << IndexBits) | index)
 {
-    class EmptyDeviceObject final : public IDeviceObjectImpl
-    {
-        IDeviceObjectImpl* Move(void* addr) override
-        {
-            return new (addr) EmptyDeviceObject(std::move(*this));
-        }
-        
-        void Accept(IDeviceObjectVisitor& visitor) const override
-        {
-            throw std::invalid_argument("Bad function call");
-        }
-        
-        void Accept(IMutableDeviceObjectVisitor& visitor) override
-        {
-            throw std::invalid_argument("Bad function call");
-        }
-    };
+    _ASSERT(type != DeviceObjectType::None && "Handle of object has to have its type");
+    _ASSERT(index <= MaxIndex && "Too many objects of the type");
 }
 
-DeviceObject::DeviceObject()
-    : mImpl(new (&mStorage) EmptyDeviceObject)
-{}
-
 DeviceObject::DeviceObject(DeviceObject&& other) noexcept
-    : mImpl(other.mImpl->Move(&mStorage))
-{}
-
-DeviceObject::~DeviceObject()
+    : mHandle(other.mHandle)
 {
-    mImpl->~IDeviceObjectImpl();
+    other.mHandle = 0;
 }
 
 DeviceObject& DeviceObject::operator=(DeviceObject&& other) noexcept
 {
-    mImpl->~IDeviceObjectImpl();
-    mImpl = other.mImpl->Move(&mStorage);
+    mHandle = other.mHandle;
+    other.mHandle = 0;
     return *this;
 }
-
-void DeviceObject::Accept(IDeviceObjectVisitor& visitor) const
-{
-    mImpl->Accept(visitor);
-}
-
-void DeviceObject::Accept(IMutableDeviceObjectVisitor& visitor)
-{
-    mImpl->Accept(visitor);
-}
@@ -2,7 +2,9 @@
 #include <Renderer/Resources/Buffer.h>
 #include <Logging/LoggingService.h>
 
+#include <algorithm>
 #include <exception>
+#include <tuple>
 
 using namespace Renderer;
 
@@ -21,12 +23,14 @@ void Effect::AddAttribute(const Format f, const uint32_t binding)
     mAttribBindings[binding].push_back(f);
 }
 
-void Effect::AddUniform(const UniformType type, const ModuleStage stage, const uint32_t binding, const uint32_t count)
+void Effect::AddUniform(const UniformType type, const ModuleStage stage, const uint32_t binding, const uint32_t count, const DescriptorFrequency frequency)
 {
-    if(binding >= mUniformBindings.capacity())
-        mUniformBindings.resize(binding + 1);
+    auto& setBindings = mUniformBindings[static_cast<uint32_t>(frequency)];
     
-    mUniformBindings[binding].push_back({ type, stage, count });
+    if(binding >= setBindings.size())
+        setBindings.resize(binding + 1);
+    
+    setBindings[binding].push_back({ type, stage, count });
 }
 
 void Effect::AddConstantRange(ModuleStage stage, const uint32_t offset, const uint32_t size)
@@ -34,18 +38,66 @@ void Effect::AddConstantRange(ModuleStage stage, const uint32_t offset, const ui
     mConstantRanges.push_back({ stage, offset, size });
 }
 
-void Effect::AddUniformBuffer(ModuleStage stage, uint32_t binding, const Buffer& buffer)
+void Effect::AddUniformBuffer(ModuleStage stage, uint32_t binding, const Buffer& buffer, DescriptorFrequency frequency)
+{
+    AddUniform(UniformType::Buffer, stage, binding, 1, frequency);
+    
+    mUniformBuffers.push_back({ frequency, binding, &buffer });
+}
+
+void Effect::AddDynamicUniformBuffer(ModuleStage stage, uint32_t binding, const Buffer& buffer, DescriptorFrequency frequency)
+{
+    if(mDynamicUniformBuffers.size() == MaxDynamicUniformBuffers)
+    {
+        throw std::runtime_error("Effect::AddDynamicUniformBuffer: Too many dynamic uniform buffers!");
+    }
+    
+    AddUniform(UniformType::DynamicBuffer, stage, binding, 1, frequency);
+    
+    const DynamicBufferBinding newBinding{ frequency, binding, &buffer };
+    
+    // Dynamic offsets are supplied in set order, within a set in binding order
+    const auto it = std::upper_bound(mDynamicUniformBuffers.begin(), mDynamicUniformBuffers.end(), newBinding, [](const DynamicBufferBinding& a, const DynamicBufferBinding& b) {
+        return std::tie(a.frequency, a.binding) < std::tie(b.frequency, b.binding);
+    });
+    
+    mDynamicUniformBuffers.insert(it, newBinding);
+}
+
+void Effect::AddTexture(ModuleStage stage, uint32_t binding, const Attachable& image, DescriptorFrequency frequency)
+{
+    AddUniform(UniformType::Sampler, stage, binding, 1, frequency);
+    
+    mTextures.push_back({ frequency, binding, &image });
+}
+
+void Effect::AddStorageBuffer(ModuleStage stage, uint32_t binding, const Buffer& buffer, DescriptorFrequency frequency)
+{
+    AddUniform(UniformType::StorageBuffer, stage, binding, 1, frequency);
+    
+    mStorageBuffers.push_back({ frequency, binding, &buffer });
+}
+
+void Effect::AddStorageImage(ModuleStage stage, uint32_t binding, const Attachable& image, DescriptorFrequency frequency)
 {
-    AddUniform(UniformType::Buffer, stage, binding, 1);
+    AddUniform(UniformType::StorageImage, stage, binding, 1, frequency);
     
-    mUniformBuffers.push_back(&buffer);
+    mStorageImages.push_back({ frequency, binding, &image });
 }
 
-void Effect::AddTexture(ModuleStage stage, uint32_t binding, const Attachable& image)
+void Effect::AddBindlessTexture(ModuleStage stage, const Attachable& image)
 {
-    AddUniform(UniformType::Sampler, stage, binding, 1);
+    if(mBindlessTextures.size() == MaxBindlessTextures)
+    {
+        throw std::runtime_error("Effect::AddBindlessTexture: Too many bindless textures!");
+    }
     
-    mTextures.push_back(&image);
+    mBindlessTextures.push_back({ stage, &image });
+}
+
+void Effect::EnableInstancing(uint32_t firstLocation)
+{
+    mInstanceLocation = firstLocation;
 }
 
 uint8_t Effect::GetBindingCount() const
@@ -69,7 +121,33 @@ const std::vector<Effect::ModuleDescriptor>& Effect::GetModuleDescriptors() cons
     return mModuleDescriptors;
 }
 
-const std::vector<Effect::UniformBindingDesc>& Effect::GetUniformBindings() const
+const std::vector<Effect::UniformBindingDesc>& Effect::GetUniformBindings(DescriptorFrequency frequency) const
+{
+    return mUniformBindings[static_cast<uint32_t>(frequency)];
+}
+
+uint32_t Effect::GetDescriptorSetCount() const
 {
-    return mUniformBindings;
+    if(UsesBindless())
+        return DescriptorSetCount;
+    
+    for(uint32_t setCount = FrequencyCount; setCount > 0; --setCount)
+    {
+        if(!mUniformBindings[setCount - 1].empty())
+            return setCount;
+    }
+    
+    return 0;
+}
+
+uint32_t Effect::GetBindlessConstantOffset() const
+{
+    uint32_t offset{ 0 };
+    for(const auto& range : mConstantRanges)
+    {
+        offset = std::max(offset, range.offset + range.size);
+    }
+    
+    // Push constant block has std430 layout, uvec2 is aligned to 8 bytes
+    return (offset + 7) & ~7u;
 }
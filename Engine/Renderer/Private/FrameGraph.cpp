@@ -0,0 +1,750 @@
+#include <Renderer/FrameGraph.h>
+
+#include <Core/Assert.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace Renderer;
+
+namespace
+{
+    /*!
+     @brief Layout, pipeline stages & memory accesses implied by access of pass.
+     */
+    struct AccessInfo
+    {
+        ImageLayout layout{ ImageLayout::Undefined };
+        StageMask stages{ StageMask::Undefined };
+        AccessMask access{ AccessMask::Undefined };
+        ImageUsage usage{ ImageUsage::Undefined };
+    };
+
+    AccessInfo GetAccessInfo(FrameGraphAccess access)
+    {
+        switch(access)
+        {
+            case FrameGraphAccess::ColorAttachment:
+                return { ImageLayout::ColorAttachment, StageMask::ColorAttachment, AccessMask::ColorWrite, ImageUsage::ColorAttachment };
+            case FrameGraphAccess::DepthAttachment:
+                return { ImageLayout::DepthAttachment, StageMask::EarlyFragmentTest | StageMask::LateFragmentTest,
+                         AccessMask::DepthStencilRead | AccessMask::DepthStencilWrite, ImageUsage::DepthStencilAttachment };
+            case FrameGraphAccess::DepthRead:
+                return { ImageLayout::DepthStencilReadOnly, StageMask::EarlyFragmentTest | StageMask::LateFragmentTest,
+                         AccessMask::DepthStencilRead, ImageUsage::DepthStencilAttachment };
+            case FrameGraphAccess::FragmentSampled:
+                return { ImageLayout::ShaderReadOnly, StageMask::FragmentShader, AccessMask::ShaderRead, ImageUsage::Sampled };
+            case FrameGraphAccess::ComputeSampled:
+                return { ImageLayout::ShaderReadOnly, StageMask::ComputeShader, AccessMask::ShaderRead, ImageUsage::Sampled };
+            case FrameGraphAccess::ComputeStorage:
+                return { ImageLayout::General, StageMask::ComputeShader, AccessMask::ShaderRead | AccessMask::ShaderWrite, ImageUsage::Storage };
+        }
+
+        throw std::runtime_error("Unknown frame graph access!");
+    }
+
+    bool IsWritingAccess(FrameGraphAccess access)
+    {
+        return access == FrameGraphAccess::ColorAttachment || access == FrameGraphAccess::DepthAttachment || access == FrameGraphAccess::ComputeStorage;
+    }
+
+    bool IsReadingAccess(FrameGraphAccess access)
+    {
+        return access != FrameGraphAccess::ColorAttachment && access != FrameGraphAccess::DepthAttachment;
+    }
+
+    bool IsAttachmentAccess(FrameGraphAccess access)
+    {
+        return access == FrameGraphAccess::ColorAttachment || access == FrameGraphAccess::DepthAttachment || access == FrameGraphAccess::DepthRead;
+    }
+
+    /*!
+     @brief Accesses of image since its last write, reads in readStages already wait for the write.
+     */
+    struct ImageState
+    {
+        ImageLayout layout{ ImageLayout::Undefined };
+        StageMask writeStages{ StageMask::Undefined };
+        AccessMask writeAccess{ AccessMask::Undefined };
+        StageMask readStages{ StageMask::Undefined };
+    };
+
+    // Barrier without any earlier access waits for nothing
+    StageMask GetSourceStages(StageMask stages)
+    {
+        return stages == StageMask::Undefined ? StageMask::TopOfPipe : stages;
+    }
+
+    /*!
+     @brief Transient images sharing memory range, their lifetimes follow each other.
+     */
+    struct AliasingBucket
+    {
+        uint64_t size{ 0 };
+        uint64_t alignment{ 1 };
+        std::vector<FrameGraphResource> images;
+    };
+
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+FrameGraphResource FrameGraphBuilder::CreateImage(const std::string& name, const AttachableDescriptor& desc)
+{
+    FrameGraph::ResourceNode resource;
+    resource.name = name;
+    resource.desc = desc;
+
+    mGraph.mResources.push_back(std::move(resource));
+    return static_cast<FrameGraphResource>(mGraph.mResources.size() - 1);
+}
+
+FrameGraphResource FrameGraphBuilder::Read(FrameGraphResource resource, FrameGraphAccess access)
+{
+    if(!IsReadingAccess(access))
+        throw std::runtime_error("Access doesn't read the image!");
+
+    mGraph.AddAccess(mPass, resource, access, false);
+    return resource;
+}
+
+FrameGraphResource FrameGraphBuilder::Write(FrameGraphResource resource, FrameGraphAccess access)
+{
+    if(!IsWritingAccess(access))
+        throw std::runtime_error("Access doesn't write the image!");
+
+    mGraph.AddAccess(mPass, resource, access, true);
+    return resource;
+}
+
+void FrameGraphBuilder::SetSideEffects() noexcept
+{
+    mGraph.mPasses[mPass].sideEffects = true;
+}
+
+FrameGraphPass FrameGraph::AddPass(const std::string& name, FrameGraphPassType type, const FrameGraphSetup& setup, FrameGraphExecute execute)
+{
+    const auto index = static_cast<FrameGraphPass>(mPasses.size());
+
+    PassNode pass;
+    pass.name = name;
+    pass.type = type;
+    pass.execute = std::move(execute);
+    mPasses.push_back(std::move(pass));
+
+    // Passes of compiled graph stay, graph is compiled again with the new one
+    mCompiled = false;
+
+    FrameGraphBuilder builder(*this, index);
+    setup(builder);
+
+    return index;
+}
+
+FrameGraphResource FrameGraph::Import(const std::string& name, Attachment& image, ImageLayout initialLayout, ImageLayout finalLayout)
+{
+    ResourceNode resource;
+    resource.name = name;
+    resource.desc.width = image.GetWidth();
+    resource.desc.height = image.GetHeight();
+    resource.desc.format = image.GetFormat();
+    resource.desc.usage = image.GetUsage();
+    resource.importedImage = &image;
+    resource.initialLayout = initialLayout;
+    resource.finalLayout = finalLayout;
+
+    mResources.push_back(std::move(resource));
+    mCompiled = false;
+
+    return static_cast<FrameGraphResource>(mResources.size() - 1);
+}
+
+void FrameGraph::SetImportedImage(FrameGraphResource resource, Attachment& image)
+{
+    _ASSERT(resource < mResources.size() && "Unknown frame graph image");
+
+    auto& node = mResources[resource];
+    _ASSERT(node.importedImage && "Transient image can't be replaced");
+    _ASSERT(image.GetWidth() == node.desc.width && image.GetHeight() == node.desc.height && "Imported image has to keep its size");
+    _ASSERT(image.GetFormat() == node.desc.format && "Imported image has to keep its format");
+
+    node.importedImage = &image;
+}
+
+void FrameGraph::AddAccess(FrameGraphPass pass, FrameGraphResource resource, FrameGraphAccess access, bool write)
+{
+    _ASSERT(resource < mResources.size() && "Unknown frame graph image");
+
+    auto& node = mPasses[pass];
+    _ASSERT((node.type != FrameGraphPassType::Compute || !IsAttachmentAccess(access)) && "Compute pass has no attachments");
+
+    // Read & write of the same image by one pass is single access, e.g. storage image modified in place
+    for(auto& existing : node.accesses)
+    {
+        if(existing.resource == resource)
+        {
+            if(existing.access != access)
+                throw std::runtime_error("Pass accesses image in two layouts!");
+
+            existing.read = existing.read || !write;
+            existing.write = existing.write || write;
+            return;
+        }
+    }
+
+    ResourceAccess resourceAccess;
+    resourceAccess.resource = resource;
+    resourceAccess.access = access;
+    resourceAccess.read = !write;
+    resourceAccess.write = write;
+    node.accesses.push_back(resourceAccess);
+}
+
+void FrameGraph::Compile(IRenderer& renderer)
+{
+    DestroyDeviceObjects(renderer);
+
+    mStatistics = FrameGraphStatistics{};
+
+    CullPasses();
+    AllocateTransientImages(renderer);
+    CreateRenderPasses(renderer);
+    PlanBarriers();
+
+    mStatistics.passCount = static_cast<uint32_t>(mOrder.size());
+    mStatistics.culledPassCount = static_cast<uint32_t>(mPasses.size() - mOrder.size());
+
+    mCompiled = true;
+}
+
+void FrameGraph::CullPasses()
+{
+    for(auto& resource : mResources)
+        resource.refCount = 0;
+
+    for(auto& pass : mPasses)
+    {
+        pass.culled = false;
+        pass.refCount = 0;
+
+        for(const auto& access : pass.accesses)
+        {
+            if(access.write)
+                ++pass.refCount;
+            if(access.read)
+                ++mResources[access.resource].refCount;
+        }
+    }
+
+    // Images nobody reads release their writers, writers left without read results release images they read
+    std::vector<FrameGraphResource> unreferenced;
+    for(FrameGraphResource i = 0; i < mResources.size(); ++i)
+    {
+        if(mResources[i].refCount == 0 && !mResources[i].importedImage)
+            unreferenced.push_back(i);
+    }
+
+    while(!unreferenced.empty())
+    {
+        const FrameGraphResource resource = unreferenced.back();
+        unreferenced.pop_back();
+
+        for(auto& pass : mPasses)
+        {
+            if(pass.culled || pass.sideEffects)
+                continue;
+
+            const auto written = std::find_if(pass.accesses.begin(), pass.accesses.end(), [resource](const ResourceAccess& access){
+                return access.resource == resource && access.write;
+            });
+
+            if(written == pass.accesses.end() || --pass.refCount > 0)
+                continue;
+
+            pass.culled = true;
+            for(const auto& access : pass.accesses)
+            {
+                auto& read = mResources[access.resource];
+                if(access.read && --read.refCount == 0 && !read.importedImage)
+                    unreferenced.push_back(access.resource);
+            }
+        }
+    }
+
+    // Lifetimes of images are positions of their first & last live pass
+    mOrder.clear();
+    for(auto& resource : mResources)
+    {
+        resource.firstUse = InvalidFrameGraphIndex;
+        resource.lastUse = 0;
+    }
+
+    for(FrameGraphPass i = 0; i < mPasses.size(); ++i)
+    {
+        const auto& pass = mPasses[i];
+        if(pass.culled)
+            continue;
+
+        const auto position = static_cast<uint32_t>(mOrder.size());
+        mOrder.push_back(i);
+
+        for(const auto& access : pass.accesses)
+        {
+            auto& resource = mResources[access.resource];
+            if(resource.firstUse == InvalidFrameGraphIndex)
+            {
+                if(!resource.importedImage && access.read)
+                    throw std::runtime_error("Transient image " + resource.name + " is read by " + pass.name + " before it's written!");
+
+                resource.firstUse = position;
+            }
+
+            resource.lastUse = position;
+        }
+    }
+}
+
+void FrameGraph::AllocateTransientImages(IRenderer& renderer)
+{
+    std::vector<FrameGraphResource> transients;
+    for(FrameGraphResource i = 0; i < mResources.size(); ++i)
+    {
+        auto& resource = mResources[i];
+        if(resource.importedImage || resource.firstUse == InvalidFrameGraphIndex)
+            continue;
+
+        // Image is created with usage of all its accesses
+        for(const FrameGraphPass index : mOrder)
+        {
+            for(const auto& access : mPasses[index].accesses)
+            {
+                if(access.resource == i)
+                    resource.desc.usage = resource.desc.usage | GetAccessInfo(access.access).usage;
+            }
+        }
+
+        transients.push_back(i);
+    }
+
+    if(transients.empty())
+        return;
+
+    std::stable_sort(transients.begin(), transients.end(), [this](FrameGraphResource lhs, FrameGraphResource rhs){
+        return mResources[lhs].firstUse < mResources[rhs].firstUse;
+    });
+
+    // Image takes memory of the first bucket whose images are dead by its first use, greedy placement in order of first use
+    std::vector<AliasingBucket> buckets;
+    uint32_t memoryTypeBits = ~0u;
+
+    for(const FrameGraphResource index : transients)
+    {
+        const MemoryRequirements requirements = renderer.GetAttachmentMemoryRequirements(mResources[index].desc);
+        memoryTypeBits &= requirements.memoryTypeBits;
+        mStatistics.transientBytes += requirements.size;
+
+        auto bucket = std::find_if(buckets.begin(), buckets.end(), [this, index](const AliasingBucket& b){
+            return mResources[b.images.back()].lastUse < mResources[index].firstUse;
+        });
+
+        if(bucket == buckets.end())
+            bucket = buckets.insert(buckets.end(), AliasingBucket{});
+
+        bucket->size = std::max(bucket->size, requirements.size);
+        bucket->alignment = std::max(bucket->alignment, requirements.alignment);
+        bucket->images.push_back(index);
+    }
+
+    if(memoryTypeBits == 0)
+        throw std::runtime_error("Transient images have no common memory type!");
+
+    MemoryRequirements heapRequirements;
+    heapRequirements.memoryTypeBits = memoryTypeBits;
+
+    for(const auto& bucket : buckets)
+    {
+        const uint64_t offset = AlignUp(heapRequirements.size, bucket.alignment);
+        heapRequirements.size = offset + bucket.size;
+        heapRequirements.alignment = std::max(heapRequirements.alignment, bucket.alignment);
+
+        for(size_t i = 0; i < bucket.images.size(); ++i)
+        {
+            auto& resource = mResources[bucket.images[i]];
+            resource.heapOffset = offset;
+
+            // The first image follows the last one of the previous frame
+            resource.aliasedResource = bucket.images[i == 0 ? bucket.images.size() - 1 : i - 1];
+        }
+    }
+
+    mHeap = renderer.CreateMemoryHeap(heapRequirements);
+    mStatistics.heapBytes = heapRequirements.size;
+
+    for(const FrameGraphResource index : transients)
+    {
+        auto& resource = mResources[index];
+        const bool isDepth = Detail::IsDepthFormat(resource.desc.format);
+
+        resource.image = std::make_shared<Attachment>(resource.desc,
+                                                      isDepth ? Graphics::ClearValueDepthStencil : Graphics::ColorBlack,
+                                                      renderer.CreatePlacedAttachment(resource.desc, mHeap, resource.heapOffset));
+    }
+}
+
+void FrameGraph::CreateRenderPasses(IRenderer& renderer)
+{
+    for(uint32_t position = 0; position < mOrder.size(); ++position)
+    {
+        auto& pass = mPasses[mOrder[position]];
+        if(pass.type != FrameGraphPassType::Graphics)
+            continue;
+
+        pass.renderPass = std::make_unique<RenderPass>();
+        Subpass& subpass = pass.renderPass->CreateSubpass();
+
+        for(const auto& access : pass.accesses)
+        {
+            if(!IsAttachmentAccess(access.access))
+                continue;
+
+            const auto& resource = mResources[access.resource];
+            const ImageLayout layout = GetAccessInfo(access.access).layout;
+
+            // Barriers move images to the layout of the pass, render pass keeps it
+            AttachmentDesc attachmentDesc;
+            attachmentDesc.format = resource.desc.format;
+            attachmentDesc.initialLayout = layout;
+            attachmentDesc.finalLayout = layout;
+
+            // The first write of the frame clears the image unless imported contents are kept
+            const bool discarded = !resource.importedImage || resource.initialLayout == ImageLayout::Undefined;
+            attachmentDesc.loadOperation = resource.firstUse == position && discarded ? LoadOperation::Clear : LoadOperation::Load;
+
+            const AttachmentId id = pass.renderPass->AddAttachment(attachmentDesc);
+            subpass.AddAttachmentRef(access.access == FrameGraphAccess::ColorAttachment ? AttachmentType::Color : AttachmentType::DepthStencil, id, layout);
+        }
+
+        _ASSERT(subpass.GetAttachments(AttachmentType::Color).size() + subpass.GetAttachments(AttachmentType::DepthStencil).size() > 0 && "Graphics pass has no attachments");
+        _ASSERT(subpass.GetAttachments(AttachmentType::DepthStencil).size() <= 1 && "Graphics pass has more depth attachments");
+
+        renderer.CreateRenderPass(*pass.renderPass);
+    }
+}
+
+void FrameGraph::PlanBarriers()
+{
+    std::vector<ImageState> states(mResources.size());
+
+    for(FrameGraphResource i = 0; i < mResources.size(); ++i)
+    {
+        const auto& resource = mResources[i];
+        auto& state = states[i];
+
+        if(resource.importedImage)
+        {
+            // All commands submitted before, the first barrier chains with semaphore the frame waits for
+            state.layout = resource.initialLayout;
+            state.writeStages = StageMask::BottomOfPipe;
+        }
+        else if(resource.aliasedResource != InvalidFrameGraphIndex)
+        {
+            // Contents are discarded, yet image has to wait for the last access of the previous image in its memory
+            const auto& aliased = mResources[resource.aliasedResource];
+            const FrameGraphPass lastPass = mOrder[aliased.lastUse];
+
+            for(const auto& access : mPasses[lastPass].accesses)
+            {
+                if(access.resource != resource.aliasedResource)
+                    continue;
+
+                const AccessInfo info = GetAccessInfo(access.access);
+                state.writeStages = info.stages;
+                state.writeAccess = access.write ? info.access : AccessMask::Undefined;
+            }
+        }
+    }
+
+    mBarriers.clear();
+
+    for(const FrameGraphPass index : mOrder)
+    {
+        auto& pass = mPasses[index];
+        pass.firstBarrier = static_cast<uint32_t>(mBarriers.size());
+
+        for(const auto& access : pass.accesses)
+        {
+            const AccessInfo info = GetAccessInfo(access.access);
+            auto& state = states[access.resource];
+
+            Barrier barrier;
+            barrier.resource = access.resource;
+            barrier.oldLayout = state.layout;
+            barrier.newLayout = info.layout;
+            barrier.barrier.dstStageMask = info.stages;
+            barrier.barrier.dstAccessMask = info.access;
+
+            const bool transition = state.layout != info.layout;
+            const bool unsynchronizedRead = state.writeStages != StageMask::Undefined && static_cast<StageMask>(state.readStages | info.stages) != state.readStages;
+
+            if(transition || access.write)
+            {
+                // Layout transition & write wait for all accesses since the last write
+                barrier.barrier.srcStageMask = GetSourceStages(state.writeStages | state.readStages);
+                barrier.barrier.srcAccessMask = state.writeAccess;
+                mBarriers.push_back(barrier);
+            }
+            else if(unsynchronizedRead)
+            {
+                barrier.barrier.srcStageMask = state.writeStages;
+                barrier.barrier.srcAccessMask = state.writeAccess;
+                mBarriers.push_back(barrier);
+            }
+
+            state.layout = info.layout;
+            if(access.write)
+            {
+                state.writeStages = info.stages;
+                state.writeAccess = info.access;
+                state.readStages = StageMask::Undefined;
+            }
+            else if(transition)
+            {
+                // Transition is write of the image made visible to the stages of this read only
+                state.writeStages = info.stages;
+                state.writeAccess = AccessMask::Undefined;
+                state.readStages = info.stages;
+            }
+            else
+            {
+                state.readStages = state.readStages | info.stages;
+            }
+        }
+
+        pass.barrierCount = static_cast<uint32_t>(mBarriers.size()) - pass.firstBarrier;
+        mStatistics.barrierBatchCount += pass.barrierCount > 0 ? 1 : 0;
+    }
+
+    // Imported images leave the frame in their final layouts
+    mFinalBarrier = static_cast<uint32_t>(mBarriers.size());
+
+    for(FrameGraphResource i = 0; i < mResources.size(); ++i)
+    {
+        const auto& resource = mResources[i];
+        const auto& state = states[i];
+
+        if(!resource.importedImage || resource.finalLayout == ImageLayout::Undefined || resource.finalLayout == state.layout)
+            continue;
+
+        Barrier barrier;
+        barrier.resource = i;
+        barrier.oldLayout = state.layout;
+        barrier.newLayout = resource.finalLayout;
+        barrier.barrier.srcStageMask = GetSourceStages(state.writeStages | state.readStages);
+        barrier.barrier.srcAccessMask = state.writeAccess;
+        barrier.barrier.dstStageMask = StageMask::BottomOfPipe;
+        barrier.barrier.dstAccessMask = AccessMask::Undefined;
+        mBarriers.push_back(barrier);
+    }
+
+    mStatistics.barrierBatchCount += mBarriers.size() > mFinalBarrier ? 1 : 0;
+    mStatistics.imageBarrierCount = static_cast<uint32_t>(mBarriers.size());
+}
+
+void FrameGraph::Execute(IRenderer& renderer)
+{
+    _ASSERT(mCompiled && "Frame graph has to be compiled before execution");
+
+    for(const FrameGraphPass index : mOrder)
+    {
+        auto& pass = mPasses[index];
+
+        RecordBarriers(renderer, pass.firstBarrier, pass.barrierCount);
+
+        if(pass.type != FrameGraphPassType::Graphics)
+        {
+            if(pass.execute)
+                pass.execute(renderer);
+
+            continue;
+        }
+
+        const Framebuffer& framebuffer = GetFramebuffer(renderer, pass);
+        pass.renderPass->SetActiveFramebuffer(framebuffer);
+
+        renderer.BeginRenderPass(*pass.renderPass);
+        renderer.SetViewport(Rectangle<float>(static_cast<float>(framebuffer.GetWidth()), static_cast<float>(framebuffer.GetHeight())));
+        renderer.SetScissor(Rectangle<uint32_t>(framebuffer.GetWidth(), framebuffer.GetHeight()));
+
+        if(pass.execute)
+            pass.execute(renderer);
+
+        renderer.EndRenderPass();
+    }
+
+    RecordBarriers(renderer, mFinalBarrier, static_cast<uint32_t>(mBarriers.size()) - mFinalBarrier);
+}
+
+void FrameGraph::RecordBarriers(IRenderer& renderer, uint32_t firstBarrier, uint32_t barrierCount)
+{
+    if(barrierCount == 0)
+        return;
+
+    mBarrierScratch.clear();
+
+    for(uint32_t i = firstBarrier; i < firstBarrier + barrierCount; ++i)
+    {
+        mBarrierScratch.push_back(MakeImageBarrier(mBarriers[i]));
+    }
+
+    renderer.ImageBarriers(mBarrierScratch.data(), barrierCount);
+}
+
+ImageBarrierDesc FrameGraph::MakeImageBarrier(const Barrier& barrier) const noexcept
+{
+    ImageBarrierDesc desc;
+    desc.image = &GetPhysicalImage(mResources[barrier.resource]);
+    desc.oldLayout = barrier.oldLayout;
+    desc.newLayout = barrier.newLayout;
+    desc.barrier = barrier.barrier;
+
+    return desc;
+}
+
+Framebuffer& FrameGraph::GetFramebuffer(IRenderer& renderer, PassNode& pass)
+{
+    // Framebuffers differ by imported images only, e.g. one per swap chain image
+    mHandleScratch.clear();
+    for(const auto& access : pass.accesses)
+    {
+        const auto& resource = mResources[access.resource];
+        if(IsAttachmentAccess(access.access) && resource.importedImage)
+            mHandleScratch.push_back(resource.importedImage->GetDeviceObject().GetHandle());
+    }
+
+    for(auto& cached : pass.framebuffers)
+    {
+        if(cached.importedHandles == mHandleScratch)
+            return cached.framebuffer;
+    }
+
+    CachedFramebuffer cached;
+    cached.importedHandles = mHandleScratch;
+
+    for(const auto& access : pass.accesses)
+    {
+        if(!IsAttachmentAccess(access.access))
+            continue;
+
+        const auto& resource = mResources[access.resource];
+        if(cached.framebuffer.GetWidth() == 0)
+            cached.framebuffer.Resize(resource.desc.width, resource.desc.height);
+
+        _ASSERT(resource.desc.width == cached.framebuffer.GetWidth() && resource.desc.height == cached.framebuffer.GetHeight() && "Attachments of pass differ in size");
+
+        // Imported images are owned by the application, framebuffer only refers to them
+        cached.framebuffer.AddAttachment(resource.importedImage ? std::shared_ptr<Attachment>(std::shared_ptr<Attachment>{}, resource.importedImage) : resource.image);
+    }
+
+    renderer.CreateFramebuffer(cached.framebuffer, *pass.renderPass);
+
+    pass.framebuffers.push_back(std::move(cached));
+    return pass.framebuffers.back().framebuffer;
+}
+
+const Attachment& FrameGraph::GetPhysicalImage(const ResourceNode& resource) const noexcept
+{
+    return resource.importedImage ? *resource.importedImage : *resource.image;
+}
+
+const Attachment& FrameGraph::GetImage(FrameGraphResource resource) const
+{
+    _ASSERT(resource < mResources.size() && "Unknown frame graph image");
+
+    const auto& node = mResources[resource];
+    if(!node.importedImage && !node.image)
+        throw std::runtime_error("Transient image " + node.name + " exists once the graph is compiled!");
+
+    return GetPhysicalImage(node);
+}
+
+bool FrameGraph::IsPassCulled(FrameGraphPass pass) const
+{
+    _ASSERT(pass < mPasses.size() && "Unknown frame graph pass");
+    _ASSERT(mCompiled && "Frame graph has to be compiled to cull passes");
+
+    return mPasses[pass].culled;
+}
+
+std::vector<ImageBarrierDesc> FrameGraph::GetPassBarriers(FrameGraphPass pass) const
+{
+    _ASSERT(pass < mPasses.size() && "Unknown frame graph pass");
+    _ASSERT(mCompiled && "Frame graph has to be compiled to plan barriers");
+
+    const auto& node = mPasses[pass];
+    if(node.culled)
+        return {};
+
+    std::vector<ImageBarrierDesc> barriers;
+    for(uint32_t i = node.firstBarrier; i < node.firstBarrier + node.barrierCount; ++i)
+    {
+        barriers.push_back(MakeImageBarrier(mBarriers[i]));
+    }
+
+    return barriers;
+}
+
+const RenderPass& FrameGraph::GetRenderPass(FrameGraphPass pass) const
+{
+    _ASSERT(pass < mPasses.size() && "Unknown frame graph pass");
+
+    const auto& node = mPasses[pass];
+    if(!node.renderPass)
+        throw std::runtime_error("Pass " + node.name + " has no render pass!");
+
+    return *node.renderPass;
+}
+
+void FrameGraph::DestroyDeviceObjects(IRenderer& renderer)
+{
+    for(auto& pass : mPasses)
+    {
+        for(auto& cached : pass.framebuffers)
+            renderer.DestroyDeviceObject(cached.framebuffer.GetDeviceObject());
+
+        pass.framebuffers.clear();
+
+        if(pass.renderPass)
+        {
+            renderer.DestroyDeviceObject(pass.renderPass->GetDeviceObject());
+            pass.renderPass.reset();
+        }
+    }
+
+    // Placed images go first, the heap owns their memory
+    for(auto& resource : mResources)
+    {
+        if(resource.image)
+        {
+            renderer.DestroyDeviceObject(resource.image->GetDeviceObject());
+            resource.image.reset();
+        }
+    }
+
+    renderer.DestroyDeviceObject(mHeap);
+
+    mOrder.clear();
+    mBarriers.clear();
+    mFinalBarrier = 0;
+    mCompiled = false;
+}
+
+void FrameGraph::Destroy(IRenderer& renderer)
+{
+    DestroyDeviceObjects(renderer);
+
+    mPasses.clear();
+    mResources.clear();
+    mStatistics = FrameGraphStatistics{};
+}
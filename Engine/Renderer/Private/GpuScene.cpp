@@ -0,0 +1,97 @@
+#include <Renderer/GpuScene.h>
+
+#include <Math/BatchKernels.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace Renderer;
+
+namespace
+{
+    // Plane of clip space inequality given by column of the matrix, transformed row vector component j is dot(p, column j)
+    Vector4f GetColumn(const Matrix4& m, uint16_t column)
+    {
+        return Vector4f(m(1, column), m(2, column), m(3, column), m(4, column));
+    }
+
+    Vector4f NormalizePlane(const Vector4f& plane)
+    {
+        const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        return plane * (1.0f / length);
+    }
+}
+
+FrustumPlanes FrustumPlanes::FromViewProjection(const Matrix4& viewProjection)
+{
+    const Vector4f x = GetColumn(viewProjection, 1);
+    const Vector4f y = GetColumn(viewProjection, 2);
+    const Vector4f z = GetColumn(viewProjection, 3);
+    const Vector4f w = GetColumn(viewProjection, 4);
+
+    // -w <= x <= w, -w <= y <= w, 0 <= z <= w
+    FrustumPlanes frustum;
+    frustum.planes[0] = NormalizePlane(w + x);
+    frustum.planes[1] = NormalizePlane(w - x);
+    frustum.planes[2] = NormalizePlane(w + y);
+    frustum.planes[3] = NormalizePlane(w - y);
+    frustum.planes[4] = NormalizePlane(z);
+    frustum.planes[5] = NormalizePlane(w - z);
+
+    return frustum;
+}
+
+bool FrustumPlanes::IntersectsSphere(const Vector3f& center, float radius) const
+{
+    for(const auto& plane : planes)
+    {
+        if(plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+            return false;
+    }
+
+    return true;
+}
+
+uint32_t Renderer::CullObjects(const GpuObject* objects, uint32_t count, const FrustumPlanes& frustum, DrawIndexedIndirectCommand* commands)
+{
+    // Spheres are moved to world space by the same kernel math as cull.comp does
+    std::vector<Matrix4> matrices(count);
+    std::vector<float> spheres(count * 8);
+
+    float* centerX = spheres.data();
+    float* centerY = centerX + count;
+    float* centerZ = centerY + count;
+    float* radii = centerZ + count;
+
+    for(uint32_t i = 0; i < count; ++i)
+    {
+        matrices[i] = objects[i].world;
+        centerX[i] = objects[i].boundingSphere.x;
+        centerY[i] = objects[i].boundingSphere.y;
+        centerZ[i] = objects[i].boundingSphere.z;
+        radii[i] = objects[i].boundingSphere.w;
+    }
+
+    float* worldX = radii + count;
+    float* worldY = worldX + count;
+    float* worldZ = worldY + count;
+    float* worldRadii = worldZ + count;
+
+    Math::Batch::TransformBoundingSpheres(matrices.data(), { centerX, centerY, centerZ }, radii, { worldX, worldY, worldZ }, worldRadii, count);
+
+    uint32_t drawCount{ 0 };
+    for(uint32_t i = 0; i < count; ++i)
+    {
+        if(!frustum.IntersectsSphere(Vector3f(worldX[i], worldY[i], worldZ[i]), worldRadii[i]))
+            continue;
+
+        auto& command = commands[drawCount++];
+        command.indexCount = objects[i].indexCount;
+        command.instanceCount = 1;
+        command.firstIndex = objects[i].firstIndex;
+        command.vertexOffset = objects[i].vertexOffset;
+        command.firstInstance = i;
+    }
+
+    return drawCount;
+}
@@ -0,0 +1,101 @@
+#include <Renderer/ShaderBundle.h>
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace Renderer;
+
+namespace
+{
+    constexpr uint32_t BUNDLE_MAGIC = 0x4e425353;     // "SSBN"
+    constexpr uint32_t BUNDLE_VERSION = 1;
+    constexpr size_t HEADER_SIZE = 3 * sizeof(uint32_t);
+    constexpr size_t ENTRY_HEADER_SIZE = 2 * sizeof(uint32_t);
+
+    uint32_t ReadWord(const std::vector<uint8_t>& data, size_t offset)
+    {
+        uint32_t value{ 0 };
+        std::memcpy(&value, data.data() + offset, sizeof(value));
+        return value;
+    }
+
+    void WriteWord(std::vector<uint8_t>& data, size_t offset, uint32_t value)
+    {
+        std::memcpy(data.data() + offset, &value, sizeof(value));
+    }
+
+    size_t AlignCode(size_t offset)
+    {
+        return (offset + 3) & ~size_t(3);
+    }
+}
+
+ShaderBundle::ShaderBundle()
+    : mData(HEADER_SIZE)
+{
+    WriteWord(mData, 0, BUNDLE_MAGIC);
+    WriteWord(mData, 4, BUNDLE_VERSION);
+    WriteWord(mData, 8, 0);
+}
+
+ShaderBundle ShaderBundle::FromData(std::vector<uint8_t> data)
+{
+    if(data.size() < HEADER_SIZE || ReadWord(data, 0) != BUNDLE_MAGIC || ReadWord(data, 4) != BUNDLE_VERSION)
+    {
+        throw std::runtime_error("Invalid shader bundle!");
+    }
+
+    ShaderBundle bundle;
+    const uint32_t entryCount = ReadWord(data, 8);
+    bundle.mEntries.reserve(entryCount);
+
+    size_t offset = HEADER_SIZE;
+    for(uint32_t i = 0; i < entryCount; ++i)
+    {
+        if(offset + ENTRY_HEADER_SIZE > data.size())
+        {
+            throw std::runtime_error("Shader bundle is truncated!");
+        }
+
+        const uint32_t pathSize = ReadWord(data, offset);
+        const uint32_t codeSize = ReadWord(data, offset + 4);
+
+        const size_t pathOffset = offset + ENTRY_HEADER_SIZE;
+        const size_t codeOffset = AlignCode(pathOffset + pathSize);
+
+        if(codeOffset + codeSize > data.size())
+        {
+            throw std::runtime_error("Shader bundle is truncated!");
+        }
+
+        Entry entry;
+        entry.path.assign(reinterpret_cast<const char*>(data.data() + pathOffset), pathSize);
+        entry.offset = static_cast<uint32_t>(codeOffset);
+        entry.size = codeSize;
+
+        bundle.mEntries.push_back(std::move(entry));
+
+        offset = AlignCode(codeOffset + codeSize);
+    }
+
+    bundle.mData = std::move(data);
+
+    return bundle;
+}
+
+void ShaderBundle::Add(const std::string& path, const std::vector<uint8_t>& code)
+{
+    const size_t entryOffset = mData.size();
+    const size_t pathOffset = entryOffset + ENTRY_HEADER_SIZE;
+    const size_t codeOffset = AlignCode(pathOffset + path.size());
+
+    mData.resize(AlignCode(codeOffset + code.size()));
+
+    WriteWord(mData, entryOffset, static_cast<uint32_t>(path.size()));
+    WriteWord(mData, entryOffset + 4, static_cast<uint32_t>(code.size()));
+    std::memcpy(mData.data() + pathOffset, path.data(), path.size());
+    std::memcpy(mData.data() + codeOffset, code.data(), code.size());
+
+    mEntries.push_back({ path, static_cast<uint32_t>(codeOffset), static_cast<uint32_t>(code.size()) });
+    WriteWord(mData, 8, static_cast<uint32_t>(mEntries.size()));
+}
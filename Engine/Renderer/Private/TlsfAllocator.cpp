@@ -0,0 +1,316 @@
+#include "TlsfAllocator.h"
+
+#include <Core/Assert.h>
+
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace Renderer;
+
+namespace
+{
+    uint32_t BitScanForward(uint64_t value)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+    }
+
+    uint32_t BitScanReverse(uint64_t value)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(63 - __builtin_clzll(value));
+#endif
+    }
+
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+TlsfAllocator::TlsfAllocator(uint64_t size)
+    : mSize(size)
+{
+    for(auto& heads : mFreeHeads)
+    {
+        heads.fill(InvalidNode);
+    }
+
+    mFirstNode = CreateNode();
+
+    auto& node = mNodes[mFirstNode];
+    node.offset = 0;
+    node.size = size;
+    node.free = true;
+
+    InsertFree(mFirstNode);
+}
+
+void TlsfAllocator::Mapping(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel)
+{
+    if(size < (uint64_t(1) << SmallSizeLog2))
+    {
+        firstLevel = 0;
+        secondLevel = static_cast<uint32_t>(size >> (SmallSizeLog2 - SecondLevelLog2));
+    }
+    else
+    {
+        const uint32_t log2 = BitScanReverse(size);
+        firstLevel = log2 - SmallSizeLog2 + 1;
+        secondLevel = static_cast<uint32_t>(size >> (log2 - SecondLevelLog2)) ^ SecondLevelCount;
+    }
+}
+
+uint64_t TlsfAllocator::RoundUpToClass(uint64_t size)
+{
+    // Any range of the rounded class is at least as big as requested size
+    if(size < (uint64_t(1) << SmallSizeLog2))
+        return size + (uint64_t(1) << (SmallSizeLog2 - SecondLevelLog2)) - 1;
+
+    return size + (uint64_t(1) << (BitScanReverse(size) - SecondLevelLog2)) - 1;
+}
+
+TlsfAllocator::NodeIndex TlsfAllocator::FindFree(uint64_t size) const
+{
+    uint32_t firstLevel, secondLevel;
+    Mapping(RoundUpToClass(size), firstLevel, secondLevel);
+
+    if(firstLevel >= FirstLevelCount)
+        return InvalidNode;
+
+    uint32_t secondLevelMap = mSecondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+    if(secondLevelMap == 0)
+    {
+        const uint64_t firstLevelMap = (firstLevel + 1 < 64) ? mFirstLevelBitmap & (~uint64_t(0) << (firstLevel + 1)) : 0;
+        if(firstLevelMap == 0)
+            return InvalidNode;
+
+        firstLevel = BitScanForward(firstLevelMap);
+        secondLevelMap = mSecondLevelBitmaps[firstLevel];
+    }
+
+    return mFreeHeads[firstLevel][BitScanForward(secondLevelMap)];
+}
+
+TlsfAllocator::NodeIndex TlsfAllocator::Allocate(uint64_t size, uint64_t alignment, void* userData)
+{
+    size = std::max<uint64_t>(size, 1);
+    alignment = std::max<uint64_t>(alignment, 1);
+
+    const auto fits = [this, size, alignment](NodeIndex node) {
+        return node != InvalidNode && AlignUp(mNodes[node].offset, alignment) + size <= mNodes[node].offset + mNodes[node].size;
+    };
+
+    NodeIndex node = FindFree(size);
+
+    // Range big enough for the size may still be too small once its offset is aligned
+    if(!fits(node))
+    {
+        node = FindFree(size + alignment - 1);
+        if(!fits(node))
+            return InvalidNode;
+    }
+
+    RemoveFree(node);
+
+    const uint64_t offset = mNodes[node].offset;
+    const uint64_t alignedOffset = AlignUp(offset, alignment);
+    const uint64_t padding = alignedOffset - offset;
+
+    if(padding > 0)
+    {
+        const NodeIndex prev = mNodes[node].prevPhysical;
+
+        // Padding is given to the previous range when possible, so it doesn't end as tiny free range
+        if(prev != InvalidNode && mNodes[prev].free)
+        {
+            RemoveFree(prev);
+            mNodes[prev].size += padding;
+            InsertFree(prev);
+        }
+        else
+        {
+            const NodeIndex paddingNode = CreateNode();
+
+            auto& paddingRange = mNodes[paddingNode];
+            paddingRange.offset = offset;
+            paddingRange.size = padding;
+            paddingRange.free = true;
+            paddingRange.prevPhysical = prev;
+            paddingRange.nextPhysical = node;
+
+            if(prev != InvalidNode)
+                mNodes[prev].nextPhysical = paddingNode;
+            else
+                mFirstNode = paddingNode;
+
+            mNodes[node].prevPhysical = paddingNode;
+
+            InsertFree(paddingNode);
+        }
+
+        mNodes[node].offset = alignedOffset;
+        mNodes[node].size -= padding;
+    }
+
+    if(mNodes[node].size > size)
+    {
+        const NodeIndex remainderNode = CreateNode();
+
+        auto& remainder = mNodes[remainderNode];
+        remainder.offset = alignedOffset + size;
+        remainder.size = mNodes[node].size - size;
+        remainder.free = true;
+        remainder.prevPhysical = node;
+        remainder.nextPhysical = mNodes[node].nextPhysical;
+
+        if(remainder.nextPhysical != InvalidNode)
+            mNodes[remainder.nextPhysical].prevPhysical = remainderNode;
+
+        mNodes[node].nextPhysical = remainderNode;
+        mNodes[node].size = size;
+
+        InsertFree(remainderNode);
+    }
+
+    auto& allocated = mNodes[node];
+    allocated.free = false;
+    allocated.alignment = alignment;
+    allocated.userData = userData;
+
+    mUsedSize += allocated.size;
+    ++mAllocationCount;
+
+    return node;
+}
+
+void TlsfAllocator::Free(NodeIndex node)
+{
+    _ASSERT(node < mNodes.size() && !mNodes[node].free && "Range isn't allocated");
+
+    mUsedSize -= mNodes[node].size;
+    --mAllocationCount;
+
+    mNodes[node].free = true;
+    mNodes[node].userData = nullptr;
+
+    // Previous free range absorbs the released one
+    const NodeIndex prev = mNodes[node].prevPhysical;
+    if(prev != InvalidNode && mNodes[prev].free)
+    {
+        RemoveFree(prev);
+
+        mNodes[prev].size += mNodes[node].size;
+        mNodes[prev].nextPhysical = mNodes[node].nextPhysical;
+
+        if(mNodes[node].nextPhysical != InvalidNode)
+            mNodes[mNodes[node].nextPhysical].prevPhysical = prev;
+
+        ReleaseNode(node);
+        node = prev;
+    }
+
+    const NodeIndex next = mNodes[node].nextPhysical;
+    if(next != InvalidNode && mNodes[next].free)
+    {
+        RemoveFree(next);
+
+        mNodes[node].size += mNodes[next].size;
+        mNodes[node].nextPhysical = mNodes[next].nextPhysical;
+
+        if(mNodes[next].nextPhysical != InvalidNode)
+            mNodes[mNodes[next].nextPhysical].prevPhysical = node;
+
+        ReleaseNode(next);
+    }
+
+    InsertFree(node);
+}
+
+void TlsfAllocator::InsertFree(NodeIndex node)
+{
+    uint32_t firstLevel, secondLevel;
+    Mapping(mNodes[node].size, firstLevel, secondLevel);
+
+    auto& head = mFreeHeads[firstLevel][secondLevel];
+
+    mNodes[node].prevFree = InvalidNode;
+    mNodes[node].nextFree = head;
+
+    if(head != InvalidNode)
+        mNodes[head].prevFree = node;
+
+    head = node;
+
+    mFirstLevelBitmap |= uint64_t(1) << firstLevel;
+    mSecondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+
+    ++mFreeRangeCount;
+}
+
+void TlsfAllocator::RemoveFree(NodeIndex node)
+{
+    uint32_t firstLevel, secondLevel;
+    Mapping(mNodes[node].size, firstLevel, secondLevel);
+
+    const NodeIndex prev = mNodes[node].prevFree;
+    const NodeIndex next = mNodes[node].nextFree;
+
+    if(prev != InvalidNode)
+        mNodes[prev].nextFree = next;
+
+    if(next != InvalidNode)
+        mNodes[next].prevFree = prev;
+
+    auto& head = mFreeHeads[firstLevel][secondLevel];
+    if(head == node)
+    {
+        head = next;
+
+        if(head == InvalidNode)
+        {
+            mSecondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+
+            if(mSecondLevelBitmaps[firstLevel] == 0)
+                mFirstLevelBitmap &= ~(uint64_t(1) << firstLevel);
+        }
+    }
+
+    mNodes[node].prevFree = InvalidNode;
+    mNodes[node].nextFree = InvalidNode;
+
+    --mFreeRangeCount;
+}
+
+TlsfAllocator::NodeIndex TlsfAllocator::CreateNode()
+{
+    if(!mUnusedNodes.empty())
+    {
+        const NodeIndex node = mUnusedNodes.back();
+        mUnusedNodes.pop_back();
+
+        mNodes[node] = Node{};
+        return node;
+    }
+
+    mNodes.emplace_back();
+    return static_cast<NodeIndex>(mNodes.size() - 1);
+}
+
+void TlsfAllocator::ReleaseNode(NodeIndex node)
+{
+    mNodes[node] = Node{};
+    mUnusedNodes.push_back(node);
+}
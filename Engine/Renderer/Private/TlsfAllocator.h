@@ -0,0 +1,106 @@
+#pragma once
+
+#include <Core/Platform.h>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Renderer
+{
+    /*!
+     @brief Two level segregated fit allocator of offsets within fixed size range.
+
+     Free ranges are kept in lists indexed by power of two (first level) & linear subdivision of it (second level),
+     bitmaps of non-empty lists make both allocation & release constant time. Neighbouring free ranges are merged on release.
+     Allocator only manages offsets, memory itself is owned by the caller.
+     */
+    class TlsfAllocator
+    {
+    public:
+        using NodeIndex = uint32_t;
+        static constexpr NodeIndex InvalidNode = std::numeric_limits<NodeIndex>::max();
+
+        explicit TlsfAllocator(uint64_t size);
+
+        /*!
+         @return Node of allocated range or InvalidNode if no free range fits.
+         */
+        NO_DISCARD NodeIndex Allocate(uint64_t size, uint64_t alignment, void* userData = nullptr);
+        void Free(NodeIndex node);
+
+        NO_DISCARD uint64_t GetOffset(NodeIndex node) const noexcept { return mNodes[node].offset; }
+        NO_DISCARD uint64_t GetSize(NodeIndex node) const noexcept { return mNodes[node].size; }
+        NO_DISCARD uint64_t GetAlignment(NodeIndex node) const noexcept { return mNodes[node].alignment; }
+        NO_DISCARD void* GetUserData(NodeIndex node) const noexcept { return mNodes[node].userData; }
+
+        NO_DISCARD uint64_t GetSize() const noexcept { return mSize; }
+        NO_DISCARD uint64_t GetUsedSize() const noexcept { return mUsedSize; }
+        NO_DISCARD uint32_t GetAllocationCount() const noexcept { return mAllocationCount; }
+        NO_DISCARD uint32_t GetFreeRangeCount() const noexcept { return mFreeRangeCount; }
+        NO_DISCARD bool IsEmpty() const noexcept { return mAllocationCount == 0; }
+
+        /*!
+         @brief Calls function with node of every allocated range in order of offsets.
+         */
+        template<typename Function>
+        void ForEachAllocation(Function&& function) const
+        {
+            for(NodeIndex node = mFirstNode; node != InvalidNode; node = mNodes[node].nextPhysical)
+            {
+                if(!mNodes[node].free)
+                {
+                    function(node);
+                }
+            }
+        }
+
+    private:
+        static constexpr uint32_t SecondLevelLog2 = 5;
+        static constexpr uint32_t SecondLevelCount = 1u << SecondLevelLog2;
+
+        // Sizes below this share the first level, second level splits them linearly
+        static constexpr uint32_t SmallSizeLog2 = 8;
+        static constexpr uint32_t FirstLevelCount = 64 - SmallSizeLog2 + 1;
+
+        struct Node
+        {
+            uint64_t offset{ 0 };
+            uint64_t size{ 0 };
+            uint64_t alignment{ 1 };
+            void* userData{ nullptr };
+
+            NodeIndex prevPhysical{ InvalidNode };
+            NodeIndex nextPhysical{ InvalidNode };
+            NodeIndex prevFree{ InvalidNode };
+            NodeIndex nextFree{ InvalidNode };
+
+            bool free{ false };
+        };
+
+        static void Mapping(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel);
+        static uint64_t RoundUpToClass(uint64_t size);
+
+        NodeIndex FindFree(uint64_t size) const;
+        void InsertFree(NodeIndex node);
+        void RemoveFree(NodeIndex node);
+
+        NodeIndex CreateNode();
+        void ReleaseNode(NodeIndex node);
+
+    private:
+        uint64_t mSize{ 0 };
+        uint64_t mUsedSize{ 0 };
+        uint32_t mAllocationCount{ 0 };
+        uint32_t mFreeRangeCount{ 0 };
+
+        std::vector<Node> mNodes;
+        std::vector<NodeIndex> mUnusedNodes;
+        NodeIndex mFirstNode{ InvalidNode };
+
+        uint64_t mFirstLevelBitmap{ 0 };
+        std::array<uint32_t, FirstLevelCount> mSecondLevelBitmaps{};
+        std::array<std::array<NodeIndex, SecondLevelCount>, FirstLevelCount> mFreeHeads;
+    };
+}
@@ -0,0 +1,153 @@
+#include "VulkanAsyncCompute.h"
+
+#include <Logging/LoggingService.h>
+#include <Core/Assert.h>
+
+#include <algorithm>
+
+#ifdef LOG_MODULE_ID
+#undef LOG_MODULE_ID
+#endif
+
+#define LOG_MODULE_ID LOG_MODULE_4BYTE('V','K','A','C')
+
+using namespace Renderer;
+using namespace PAL::RenderAPI;
+
+namespace
+{
+    // Compute work reads data written by graphics in copies or shaders, stages have to be supported by compute queue
+    constexpr VkPipelineStageFlags GRAPHICS_WAIT_STAGES = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+}
+
+VulkanAsyncCompute::VulkanAsyncCompute(std::shared_ptr<VulkanDevice> device, VkQueue queue, uint32_t queueFamilyIndex, uint32_t framesInFlight)
+    : mDevice(std::move(device))
+    , mQueue(queue)
+    , mQueueFamilyIndex(queueFamilyIndex)
+{
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = mQueueFamilyIndex;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+    mFrames.resize(std::max(1u, framesInFlight));
+
+    for(auto& frame : mFrames)
+    {
+        mDevice->CreateCommandPool(&poolInfo, nullptr, &frame.commandPool);
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = frame.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        mDevice->AllocateCommandBuffers(&allocInfo, &frame.commandBuffer);
+    }
+
+    LOG(Information) << "Compute work runs on dedicated queue of family " << mQueueFamilyIndex;
+}
+
+VulkanAsyncCompute::~VulkanAsyncCompute()
+{
+    // Device is idle, signaled semaphore nobody waited for can be destroyed
+    if(mPendingWait != VK_NULL_HANDLE)
+    {
+        mDevice->DestroySemaphore(mPendingWait, nullptr);
+    }
+
+    for(const auto semaphore : mFreeSemaphores)
+    {
+        mDevice->DestroySemaphore(semaphore, nullptr);
+    }
+
+    for(auto& frame : mFrames)
+    {
+        mDevice->DestroyCommandPool(frame.commandPool, nullptr);
+    }
+}
+
+void VulkanAsyncCompute::BeginFrame(uint32_t frameIndex)
+{
+    _ASSERT(!HasCommands() && "Compute commands of previous frame weren't submitted");
+
+    mFrameIndex = frameIndex;
+    mDevice->ResetCommandPool(mFrames[mFrameIndex].commandPool, 0);
+}
+
+VulkanCommandStream& VulkanAsyncCompute::GetCommandStream()
+{
+    if(mCommands.IsEmpty())
+        mCommands.BeginCommandBuffer(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+    return mCommands;
+}
+
+VkSemaphore VulkanAsyncCompute::Submit(std::vector<VkSemaphore>& frameSemaphores)
+{
+    if(!HasCommands())
+        return VK_NULL_HANDLE;
+
+    const VkCommandBuffer commandBuffer = mFrames[mFrameIndex].commandBuffer;
+
+    mCommands.EndCommandBuffer();
+    mCommands.Replay(*mDevice, commandBuffer);
+    mCommands.Clear();
+
+    const VkSemaphore signalSemaphore = AcquireSemaphore();
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.waitSemaphoreCount = mPendingWait != VK_NULL_HANDLE ? 1 : 0;
+    submitInfo.pWaitSemaphores = &mPendingWait;
+    submitInfo.pWaitDstStageMask = &GRAPHICS_WAIT_STAGES;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &signalSemaphore;
+
+    mDevice->QueueSubmit(mQueue, 1, &submitInfo, VK_NULL_HANDLE);
+
+    // Graphics submission of the frame waits for the compute one, its fence covers both
+    if(mPendingWait != VK_NULL_HANDLE)
+        frameSemaphores.push_back(mPendingWait);
+
+    frameSemaphores.push_back(signalSemaphore);
+    mPendingWait = VK_NULL_HANDLE;
+
+    return signalSemaphore;
+}
+
+VkSemaphore VulkanAsyncCompute::SignalFromGraphics(VkSemaphore& staleSemaphore)
+{
+    // Binary semaphore can't be signaled again until it's waited for, graphics unsignals the one compute skipped
+    staleSemaphore = mPendingWait;
+    mPendingWait = AcquireSemaphore();
+
+    return mPendingWait;
+}
+
+void VulkanAsyncCompute::RecycleSemaphores(std::vector<VkSemaphore>& semaphores)
+{
+    mFreeSemaphores.insert(mFreeSemaphores.end(), semaphores.begin(), semaphores.end());
+    semaphores.clear();
+}
+
+VkSemaphore VulkanAsyncCompute::AcquireSemaphore()
+{
+    if(mFreeSemaphores.empty())
+    {
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        VkSemaphore semaphore{ VK_NULL_HANDLE };
+        mDevice->CreateSemaphore(&semaphoreInfo, nullptr, &semaphore);
+
+        return semaphore;
+    }
+
+    const VkSemaphore semaphore = mFreeSemaphores.back();
+    mFreeSemaphores.pop_back();
+
+    return semaphore;
+}
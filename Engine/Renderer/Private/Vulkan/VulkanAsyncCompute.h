@@ -0,0 +1,89 @@
+#pragma once
+
+#include <PAL/RenderAPI/Vulkan/VulkanDevice.h>
+#include <Core/Platform.h>
+
+#include "VulkanCommandStream.h"
+
+#include <memory>
+#include <vector>
+
+namespace Renderer
+{
+    /*!
+     @brief Records compute work of the frame into dedicated compute queue, so it overlaps graphics work of previous frames.
+
+     Commands of the frame are submitted right before the graphics submission, which waits for them by semaphore.
+     Graphics submission touching data shared with compute signals semaphore the next compute submission waits for,
+     so compute never overwrites data graphics queue still reads. Signal covers all earlier graphics submissions,
+     compute waits for the latest one only. Resources shared by both queues are created with concurrent sharing,
+     they're never transferred between queue families.
+     Command pool of frame slot is reset once graphics submission of the slot finished, graphics waits for compute.
+     Not thread safe, compute work is recorded by the thread owning the renderer.
+     */
+    class VulkanAsyncCompute
+    {
+    public:
+        VulkanAsyncCompute(std::shared_ptr<PAL::RenderAPI::VulkanDevice> device, VkQueue queue, uint32_t queueFamilyIndex, uint32_t framesInFlight);
+        ~VulkanAsyncCompute();
+
+        DECLARE_NOCOPY_NOMOVE(VulkanAsyncCompute)
+
+        /*!
+         @brief Resets command pool of frame slot, has to be called once GPU released the slot.
+         */
+        void BeginFrame(uint32_t frameIndex);
+
+        /*!
+         @return Commands submitted to compute queue with the frame, command buffer is begun by the first call.
+         */
+        NO_DISCARD VulkanCommandStream& GetCommandStream();
+
+        NO_DISCARD bool HasCommands() const noexcept { return !mCommands.IsEmpty(); }
+
+        /*!
+         @brief Submits commands recorded for the frame, waits for the last graphics submission which signaled.
+         @param frameSemaphores Semaphores of the frame slot, recycled once graphics submission of the frame finished.
+         @return Semaphore graphics submission has to wait for, null handle if nothing was recorded.
+         */
+        VkSemaphore Submit(std::vector<VkSemaphore>& frameSemaphores);
+
+        /*!
+         @param staleSemaphore Receives earlier signal no compute submission waited for, null handle if there is none.
+                Graphics submission has to wait for it to unsignal it, it's recycled with the frame slot.
+         @return Semaphore graphics submission has to signal, the next compute submission waits for it.
+         */
+        NO_DISCARD VkSemaphore SignalFromGraphics(VkSemaphore& staleSemaphore);
+
+        /*!
+         @brief Returns semaphores waited by finished submissions back to the pool, clears the vector.
+         */
+        void RecycleSemaphores(std::vector<VkSemaphore>& semaphores);
+
+        NO_DISCARD uint32_t GetQueueFamilyIndex() const noexcept { return mQueueFamilyIndex; }
+
+    private:
+        struct Frame
+        {
+            VkCommandPool commandPool{ VK_NULL_HANDLE };
+            VkCommandBuffer commandBuffer{ VK_NULL_HANDLE };
+        };
+
+        VkSemaphore AcquireSemaphore();
+
+    private:
+        std::shared_ptr<PAL::RenderAPI::VulkanDevice> mDevice;
+
+        VkQueue mQueue{ VK_NULL_HANDLE };
+        uint32_t mQueueFamilyIndex{ 0 };
+
+        std::vector<Frame> mFrames;
+        uint32_t mFrameIndex{ 0 };
+
+        VulkanCommandStream mCommands;
+
+        // Signaled by the last graphics submission, waiting for the next compute submission
+        VkSemaphore mPendingWait{ VK_NULL_HANDLE };
+        std::vector<VkSemaphore> mFreeSemaphores;
+    };
+}
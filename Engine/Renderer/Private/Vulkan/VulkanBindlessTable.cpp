@@ -0,0 +1,199 @@
+#include "VulkanBindlessTable.h"
+
+#include <Logging/LoggingService.h>
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#ifdef LOG_MODULE_ID
+#undef LOG_MODULE_ID
+#endif
+
+#define LOG_MODULE_ID LOG_MODULE_4BYTE('V','K','B','T')
+
+using namespace Renderer;
+using namespace PAL::RenderAPI;
+
+namespace
+{
+    // Upper bounds of the table, clamped by device limits. Update after bind limits are never lower than the regular ones
+    constexpr uint32_t BINDLESS_TEXTURE_COUNT = 16 * 1024;
+    constexpr uint32_t BINDLESS_SAMPLER_COUNT = 64;
+
+    constexpr VkShaderStageFlags BINDLESS_STAGES = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+}
+
+VulkanBindlessTable::VulkanBindlessTable(std::shared_ptr<VulkanDevice> device, uint32_t framesInFlight)
+    : mDevice(std::move(device))
+    , mFramesInFlight(std::max(1u, framesInFlight))
+{
+    const auto& limits = mDevice->GetProperties().limits;
+
+    mTextureCapacity = std::min({ BINDLESS_TEXTURE_COUNT, limits.maxPerStageDescriptorSampledImages, limits.maxDescriptorSetSampledImages });
+    mSamplerCapacity = std::min({ BINDLESS_SAMPLER_COUNT, limits.maxPerStageDescriptorSamplers, limits.maxDescriptorSetSamplers });
+
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    bindings[0].binding = TextureBinding;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    bindings[0].descriptorCount = mTextureCapacity;
+    bindings[0].stageFlags = BINDLESS_STAGES;
+
+    bindings[1].binding = SamplerBinding;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+    bindings[1].descriptorCount = mSamplerCapacity;
+    bindings[1].stageFlags = BINDLESS_STAGES;
+
+    // Unused slots are never written, slots are written while frames in flight still bind the set
+    const std::array<VkDescriptorBindingFlagsEXT, 2> bindingFlags{
+        VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT,
+        VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT
+    };
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo{};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+    bindingFlagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+    bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &bindingFlagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    mDevice->CreateDescriptorSetLayout(&layoutInfo, nullptr, &mLayout);
+
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    poolSizes[0].descriptorCount = mTextureCapacity;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_SAMPLER;
+    poolSizes[1].descriptorCount = mSamplerCapacity;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+
+    mDevice->CreateDescriptorPool(&poolInfo, nullptr, &mPool);
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = mPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &mLayout;
+
+    auto set = std::make_shared<VulkanDescriptorSet>();
+    set->layout = mLayout;
+
+    if(mDevice->AllocateDescriptorSets(&allocInfo, &set->set) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to allocate bindless descriptor set!");
+    }
+
+    mSet = std::move(set);
+
+    LOG(Information) << "Bindless table: " << mTextureCapacity << " textures, " << mSamplerCapacity << " samplers";
+}
+
+VulkanBindlessTable::~VulkanBindlessTable()
+{
+    LOG(Information) << "Bindless table: " << mTextureSlotCount - mFreeTextures.size() - mReleasedTextures.size() << " textures, "
+                     << mSamplers.size() << " samplers, " << mTextureSlotCount << " slots used at peak";
+
+    // Destroying pool frees the set
+    mDevice->DestroyDescriptorPool(mPool, nullptr);
+    mDevice->DestroyDescriptorSetLayout(mLayout, nullptr);
+}
+
+uint32_t VulkanBindlessTable::AddTexture(VkImageView imageView)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    uint32_t index{ 0 };
+    if(!mFreeTextures.empty())
+    {
+        index = mFreeTextures.back();
+        mFreeTextures.pop_back();
+    }
+    else if(mTextureSlotCount < mTextureCapacity)
+    {
+        index = mTextureSlotCount++;
+    }
+    else
+    {
+        throw std::runtime_error("Bindless texture table is full!");
+    }
+
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.imageView = imageView;
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    Write(TextureBinding, index, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, imageInfo);
+
+    return index;
+}
+
+void VulkanBindlessTable::ReleaseTexture(uint32_t index, uint64_t frameNumber)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    _ASSERT(index < mTextureSlotCount && "Texture slot wasn't allocated by the table");
+    mReleasedTextures.push_back({ index, frameNumber });
+}
+
+uint32_t VulkanBindlessTable::AddSampler(VkSampler sampler)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    const auto it = mSamplers.find(sampler);
+    if(it != mSamplers.end())
+        return it->second;
+
+    if(mSamplers.size() == mSamplerCapacity)
+    {
+        throw std::runtime_error("Bindless sampler table is full!");
+    }
+
+    const auto index = static_cast<uint32_t>(mSamplers.size());
+
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.sampler = sampler;
+
+    Write(SamplerBinding, index, VK_DESCRIPTOR_TYPE_SAMPLER, imageInfo);
+    mSamplers.emplace(sampler, index);
+
+    return index;
+}
+
+void VulkanBindlessTable::Collect(uint64_t frameNumber)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // Released slot is left as it is, partially bound set never reads slots shaders don't index
+    const auto releasedEnd = std::remove_if(mReleasedTextures.begin(), mReleasedTextures.end(), [this, frameNumber](const ReleasedSlot& released){
+        if(frameNumber - released.releaseFrame < mFramesInFlight)
+            return false;
+
+        mFreeTextures.push_back(released.index);
+        return true;
+    });
+
+    mReleasedTextures.erase(releasedEnd, mReleasedTextures.end());
+}
+
+void VulkanBindlessTable::Write(uint32_t binding, uint32_t index, VkDescriptorType type, const VkDescriptorImageInfo& imageInfo) const
+{
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = mSet->set;
+    write.dstBinding = binding;
+    write.dstArrayElement = index;
+    write.descriptorType = type;
+    write.descriptorCount = 1;
+    write.pImageInfo = &imageInfo;
+
+    mDevice->UpdateDescriptorSets(1, &write, 0, nullptr);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <PAL/RenderAPI/Vulkan/VulkanDevice.h>
+#include <Core/Platform.h>
+
+#include "VulkanDeviceObjects.h"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Renderer
+{
+    /*!
+     @brief Single descriptor set of all textures & samplers, shaders index both arrays by dynamically uniform index.
+
+     Set is partially bound & updated after bind, so textures are written into free slots while frames in flight still
+     bind the set and drawing objects of any material never switches it. Slot of released texture is reused once all frames
+     which could still sample it are finished. Requires DeviceFeature::DescriptorIndexing, table is thread safe.
+     */
+    class VulkanBindlessTable
+    {
+    public:
+        // Bindings of the set, textures are sampled images combined with samplers in the shader
+        static constexpr uint32_t TextureBinding = 0;
+        static constexpr uint32_t SamplerBinding = 1;
+
+        VulkanBindlessTable(std::shared_ptr<PAL::RenderAPI::VulkanDevice> device, uint32_t framesInFlight);
+        ~VulkanBindlessTable();
+
+        DECLARE_NOCOPY_NOMOVE(VulkanBindlessTable)
+
+        /*!
+         @brief Writes image view in shader read only layout into free texture slot.
+         @return Index of the texture in the table.
+         */
+        NO_DISCARD uint32_t AddTexture(VkImageView imageView);
+
+        /*!
+         @brief Frees texture slot, slot is reused once frames in flight started until frameNumber are finished.
+         */
+        void ReleaseTexture(uint32_t index, uint64_t frameNumber);
+
+        /*!
+         @brief Writes sampler into sampler table, equal sampler handles share one slot. Samplers stay in the table as long as it lives.
+         @return Index of the sampler in the table.
+         */
+        NO_DISCARD uint32_t AddSampler(VkSampler sampler);
+
+        /*!
+         @brief Returns slots of finished frames to the free list, has to be called once GPU released the frame slot.
+         @param frameNumber Number of the frame being started.
+         */
+        void Collect(uint64_t frameNumber);
+
+        NO_DISCARD VkDescriptorSetLayout GetLayout() const { return mLayout; }
+        NO_DISCARD const std::shared_ptr<const VulkanDescriptorSet>& GetSet() const { return mSet; }
+
+    private:
+        struct ReleasedSlot
+        {
+            uint32_t index{ 0 };
+            uint64_t releaseFrame{ 0 };
+        };
+
+        void Write(uint32_t binding, uint32_t index, VkDescriptorType type, const VkDescriptorImageInfo& imageInfo) const;
+
+    private:
+        std::shared_ptr<PAL::RenderAPI::VulkanDevice> mDevice;
+        uint32_t mFramesInFlight{ 1 };
+
+        uint32_t mTextureCapacity{ 0 };
+        uint32_t mSamplerCapacity{ 0 };
+
+        VkDescriptorPool mPool{ VK_NULL_HANDLE };
+        VkDescriptorSetLayout mLayout{ VK_NULL_HANDLE };
+        std::shared_ptr<const VulkanDescriptorSet> mSet;
+
+        mutable std::mutex mMutex;
+
+        uint32_t mTextureSlotCount{ 0 };      // Slots ever written, free slots below it are reused first
+        std::vector<uint32_t> mFreeTextures;
+        std::vector<ReleasedSlot> mReleasedTextures;
+
+        std::unordered_map<VkSampler, uint32_t> mSamplers;
+    };
+}
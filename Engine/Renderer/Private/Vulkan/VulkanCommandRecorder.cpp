@@ -0,0 +1,287 @@
+#include "VulkanCommandRecorder.h"
+
+#include <Dispatcher/SummitDispatcher.h>
+
+#include <algorithm>
+
+using namespace Renderer;
+
+namespace
+{
+    // Secondary buffers are allocated in small groups so pools grow without per-frame allocations
+    constexpr uint32_t SECONDARY_ALLOCATION_COUNT = 8;
+
+    // Fewer batches than this are not worth the cost of a job and a vkCmdExecuteCommands entry
+    constexpr uint32_t MIN_BATCHES_PER_BUFFER = 128;
+}
+
+SubpassRecording::SubpassRecording(VkRenderPass renderPass, VkFramebuffer framebuffer, uint32_t subpass)
+    : mRenderPass(renderPass)
+    , mFramebuffer(framebuffer)
+    , mSubpass(subpass)
+{
+    mStateCommands.fill(-1);
+    mSetCommands.fill(-1);
+}
+
+void SubpassRecording::BeginBatch()
+{
+    const uint32_t offset = mCommands.GetSize();
+    mBatches.push_back({ offset, offset, mViewport, mScissor, mStateCommands, mSetCommands });
+}
+
+void SubpassRecording::Push(uint32_t command)
+{
+    if(mBatches.empty())
+    {
+        mBatches.push_back({ command, command, mViewport, mScissor, mStateCommands, mSetCommands });
+    }
+
+    mBatches.back().end = mCommands.GetSize();
+}
+
+void SubpassRecording::PushViewport(uint32_t command)
+{
+    Push(command);
+    mViewport = static_cast<int32_t>(command);
+}
+
+void SubpassRecording::PushScissor(uint32_t command)
+{
+    Push(command);
+    mScissor = static_cast<int32_t>(command);
+}
+
+void SubpassRecording::PushState(BoundState state, uint32_t command, const StateKey& binding)
+{
+    Push(command);
+    
+    const auto slot = static_cast<uint32_t>(state);
+    mStateBindings[slot] = binding;
+    mStateCommands[slot] = static_cast<int32_t>(command);
+    
+    // Pipeline of layout incompatible with the one constants were pushed with disturbs them
+    if(state == BoundState::Pipeline)
+    {
+        const auto constantsSlot = static_cast<uint32_t>(BoundState::PushConstants);
+        mStateBindings[constantsSlot].Clear();
+        mStateCommands[constantsSlot] = -1;
+    }
+}
+
+bool SubpassRecording::IsBound(BoundState state, const StateKey& binding) const
+{
+    const auto slot = static_cast<uint32_t>(state);
+    return mStateCommands[slot] >= 0 && mStateBindings[slot] == binding;
+}
+
+void SubpassRecording::PushDescriptorSets(uint32_t command, const StateKey* bindings, uint32_t firstSet, uint32_t setCount)
+{
+    Push(command);
+    const auto index = static_cast<int32_t>(command);
+
+    for(uint32_t set = firstSet; set < setCount; ++set)
+    {
+        mSetBindings[set] = bindings[set];
+        mSetCommands[set] = index;
+    }
+
+    // Sets bound with layout incompatible with the new one may be disturbed
+    for(uint32_t set = setCount; set < Effect::DescriptorSetCount; ++set)
+    {
+        mSetBindings[set].Clear();
+        mSetCommands[set] = -1;
+    }
+}
+
+uint32_t SubpassRecording::GetBoundSetCount(const StateKey* bindings, uint32_t setCount) const
+{
+    uint32_t boundCount{ 0 };
+    while(boundCount < setCount && mSetCommands[boundCount] >= 0 && mSetBindings[boundCount] == bindings[boundCount])
+    {
+        ++boundCount;
+    }
+
+    return boundCount;
+}
+
+VulkanCommandRecorder::VulkanCommandRecorder(std::shared_ptr<PAL::RenderAPI::VulkanDevice> device, uint32_t queueFamilyIndex)
+    : mDevice(std::move(device))
+{
+    uint32_t workerCount{ 0 };
+
+    if(Core::DispatcherService::Available())
+    {
+        mJobSystem = &Core::DispatcherService::Service().GetJobSystem();
+        workerCount = mJobSystem->GetWorkerCount();
+    }
+
+    // Last pool is shared by threads not owned by the job system
+    mThreadPools.resize(workerCount + 1);
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = queueFamilyIndex;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+    for(auto& threadPool : mThreadPools)
+    {
+        mDevice->CreateCommandPool(&poolInfo, nullptr, &threadPool.pool);
+    }
+}
+
+VulkanCommandRecorder::~VulkanCommandRecorder()
+{
+    // Destroying pool frees all buffers allocated from it
+    for(auto& threadPool : mThreadPools)
+    {
+        mDevice->DestroyCommandPool(threadPool.pool, nullptr);
+    }
+}
+
+void VulkanCommandRecorder::Reset()
+{
+    mSubpasses.clear();
+
+    for(auto& threadPool : mThreadPools)
+    {
+        if(threadPool.usedCount == 0)
+            continue;
+
+        mDevice->ResetCommandPool(threadPool.pool, 0);
+        threadPool.usedCount = 0;
+    }
+}
+
+SubpassRecording& VulkanCommandRecorder::AddSubpass(VkRenderPass renderPass, VkFramebuffer framebuffer, uint32_t subpass)
+{
+    mSubpasses.push_back(std::make_unique<SubpassRecording>(renderPass, framebuffer, subpass));
+    return *mSubpasses.back();
+}
+
+VkCommandBuffer VulkanCommandRecorder::AcquireSecondary()
+{
+    const int32_t workerIndex = mJobSystem ? mJobSystem->GetCurrentWorkerIndex() : -1;
+    auto& threadPool = workerIndex >= 0 ? mThreadPools[workerIndex] : mThreadPools.back();
+
+    if(threadPool.usedCount == threadPool.buffers.size())
+    {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = threadPool.pool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = SECONDARY_ALLOCATION_COUNT;
+
+        threadPool.buffers.resize(threadPool.buffers.size() + SECONDARY_ALLOCATION_COUNT);
+        mDevice->AllocateCommandBuffers(&allocInfo, &threadPool.buffers[threadPool.usedCount]);
+    }
+
+    return threadPool.buffers[threadPool.usedCount++];
+}
+
+void VulkanCommandRecorder::RecordChunk(SubpassRecording& subpass, uint32_t firstBatch, uint32_t lastBatch, uint32_t slot)
+{
+    const VkCommandBuffer commandBuffer = AcquireSecondary();
+
+    VkCommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.renderPass = subpass.mRenderPass;
+    inheritanceInfo.subpass = subpass.mSubpass;
+    inheritanceInfo.framebuffer = subpass.mFramebuffer;
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    mDevice->BeginCommandBuffer(commandBuffer, &beginInfo);
+
+    const auto& commands = subpass.mCommands;
+    const auto& batch = subpass.mBatches[firstBatch];
+
+    // Dynamic state is not inherited from the primary buffer nor from the previous secondary one
+    if(batch.viewport >= 0)
+    {
+        commands.ReplayCommand(*mDevice, commandBuffer, batch.viewport);
+    }
+
+    if(batch.scissor >= 0)
+    {
+        commands.ReplayCommand(*mDevice, commandBuffer, batch.scissor);
+    }
+
+    // State & sets bound before the batch were elided from it, they are rebound in the order they were bound originally
+    std::array<int32_t, BoundStateCount + Effect::DescriptorSetCount> bindCommands{};
+    std::copy(batch.states.begin(), batch.states.end(), bindCommands.begin());
+    std::copy(batch.descriptorSets.begin(), batch.descriptorSets.end(), bindCommands.begin() + BoundStateCount);
+    std::sort(bindCommands.begin(), bindCommands.end());
+
+    const auto bindCommandsEnd = std::unique(bindCommands.begin(), bindCommands.end());
+    for(auto it = bindCommands.begin(); it != bindCommandsEnd; ++it)
+    {
+        if(*it >= 0)
+        {
+            commands.ReplayCommand(*mDevice, commandBuffer, *it);
+        }
+    }
+
+    commands.Replay(*mDevice, commandBuffer, batch.begin, subpass.mBatches[lastBatch - 1].end);
+
+    mDevice->EndCommandBuffer(commandBuffer);
+
+    subpass.mSecondaryBuffers[slot] = commandBuffer;
+}
+
+void VulkanCommandRecorder::Record()
+{
+    struct Chunk
+    {
+        SubpassRecording* subpass;
+        uint32_t firstBatch;
+        uint32_t lastBatch;
+        uint32_t slot;
+    };
+
+    const uint32_t maxChunkCount = mJobSystem ? std::max(1u, mJobSystem->GetWorkerCount()) : 1;
+
+    std::vector<Chunk> chunks;
+    for(auto& subpassPtr : mSubpasses)
+    {
+        auto& subpass = *subpassPtr;
+        const auto batchCount = static_cast<uint32_t>(subpass.mBatches.size());
+
+        if(batchCount == 0)
+            continue;
+
+        const uint32_t chunkCount = std::clamp((batchCount + MIN_BATCHES_PER_BUFFER - 1) / MIN_BATCHES_PER_BUFFER, 1u, maxChunkCount);
+        subpass.mSecondaryBuffers.resize(chunkCount, VK_NULL_HANDLE);
+
+        // Chunks keep submission order, secondary buffers are executed in slot order
+        for(uint32_t slot = 0; slot < chunkCount; ++slot)
+        {
+            const uint32_t first = static_cast<uint32_t>(uint64_t(batchCount) * slot / chunkCount);
+            const uint32_t last = static_cast<uint32_t>(uint64_t(batchCount) * (slot + 1) / chunkCount);
+            chunks.push_back({ &subpass, first, last, slot });
+        }
+    }
+
+    if(!mJobSystem || chunks.size() <= 1)
+    {
+        for(const auto& chunk : chunks)
+        {
+            RecordChunk(*chunk.subpass, chunk.firstBatch, chunk.lastBatch, chunk.slot);
+        }
+
+        return;
+    }
+
+    Core::JobCounter counter;
+    for(const auto& chunk : chunks)
+    {
+        mJobSystem->Run([this, chunk](){
+            RecordChunk(*chunk.subpass, chunk.firstBatch, chunk.lastBatch, chunk.slot);
+        }, {}, &counter);
+    }
+
+    mJobSystem->Wait(counter);
+}
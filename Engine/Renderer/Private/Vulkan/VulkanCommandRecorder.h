@@ -0,0 +1,171 @@
+#pragma once
+
+#include <PAL/RenderAPI/Vulkan/VulkanDevice.h>
+#include <Renderer/Effect.h>
+#include <Core/Platform.h>
+
+#include "VulkanCommandStream.h"
+#include "VulkanStateKey.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace Core
+{
+    class JobSystem;
+}
+
+namespace Renderer
+{
+    /*!
+     @brief State bound by commands of subpass which is tracked so redundant binds are elided.
+     */
+    enum class BoundState : uint32_t
+    {
+        Pipeline,
+        VertexBuffer,
+        IndexBuffer,
+        PushConstants,
+        Count
+    };
+    
+    constexpr uint32_t BoundStateCount = static_cast<uint32_t>(BoundState::Count);
+    
+    /*!
+     @brief Range of commands which can be recorded on its own once the last viewport, scissor, bound state & descriptor sets are restored.
+
+     Commands are addressed by their offsets in the subpass command stream, -1 stands for none.
+     */
+    struct RecordedBatch
+    {
+        uint32_t begin{ 0 };
+        uint32_t end{ 0 };
+        int32_t viewport{ -1 };
+        int32_t scissor{ -1 };
+        
+        // Commands which bound the state & sets still bound at the beginning of the batch
+        std::array<int32_t, BoundStateCount> states{};
+        std::array<int32_t, Effect::DescriptorSetCount> descriptorSets{};
+    };
+
+    /*!
+     @brief Commands of single subpass, replayed into one or more secondary command buffers.
+     */
+    class SubpassRecording
+    {
+        friend class VulkanCommandRecorder;
+
+    public:
+        SubpassRecording(VkRenderPass renderPass, VkFramebuffer framebuffer, uint32_t subpass);
+
+        DECLARE_NOCOPY_NOMOVE(SubpassRecording)
+
+        /*!
+         @brief Stream commands of the subpass are recorded into, every recorded command has to be pushed right after it.
+         */
+        NO_DISCARD VulkanCommandStream& GetCommands() noexcept { return mCommands; }
+
+        /*!
+         @brief Starts new batch, commands pushed from now on may be recorded into a different secondary buffer than the previous ones.
+         */
+        void BeginBatch();
+
+        /*!
+         @param command Offset of the command just recorded into GetCommands.
+         */
+        void Push(uint32_t command);
+        void PushViewport(uint32_t command);
+        void PushScissor(uint32_t command);
+        
+        /*!
+         @brief Pushes command binding the state, binding pipeline disturbs pushed constants.
+         @param binding Exact identity of the bound state, equal identities bind equal state. Its words are copied.
+         */
+        void PushState(BoundState state, uint32_t command, const StateKey& binding);
+        
+        /*!
+         @return True if the state was last bound with equal identity, such bind doesn't have to be recorded again.
+         */
+        NO_DISCARD bool IsBound(BoundState state, const StateKey& binding) const;
+        
+        /*!
+         @brief Pushes command binding sets from firstSet up to setCount, sets above setCount are treated as disturbed.
+         @param bindings Layout compatibility, set & dynamic offsets for every set up to setCount.
+         */
+        void PushDescriptorSets(uint32_t command, const StateKey* bindings, uint32_t firstSet, uint32_t setCount);
+        
+        /*!
+         @return Number of leading sets bound with equal identities, those don't have to be bound again.
+         */
+        NO_DISCARD uint32_t GetBoundSetCount(const StateKey* bindings, uint32_t setCount) const;
+
+        NO_DISCARD const std::vector<VkCommandBuffer>& GetSecondaryBuffers() const noexcept { return mSecondaryBuffers; }
+
+    private:
+        VkRenderPass mRenderPass{ VK_NULL_HANDLE };
+        VkFramebuffer mFramebuffer{ VK_NULL_HANDLE };
+        uint32_t mSubpass{ 0 };
+
+        VulkanCommandStream mCommands;
+        std::vector<RecordedBatch> mBatches;
+        std::vector<VkCommandBuffer> mSecondaryBuffers;
+
+        int32_t mViewport{ -1 };
+        int32_t mScissor{ -1 };
+        
+        std::array<StateKey, BoundStateCount> mStateBindings;
+        std::array<int32_t, BoundStateCount> mStateCommands{};
+        
+        std::array<StateKey, Effect::DescriptorSetCount> mSetBindings;
+        std::array<int32_t, Effect::DescriptorSetCount> mSetCommands{};
+    };
+
+    /*!
+     @brief Records subpasses into secondary command buffers in parallel on the job system.
+
+     Every job system worker owns its command pool, threads not owned by the job system share one extra pool,
+     so only one such thread may record at a time. Pools are reset as a whole once the frame using them finished.
+     */
+    class VulkanCommandRecorder
+    {
+    public:
+        VulkanCommandRecorder(std::shared_ptr<PAL::RenderAPI::VulkanDevice> device, uint32_t queueFamilyIndex);
+        ~VulkanCommandRecorder();
+
+        DECLARE_NOCOPY_NOMOVE(VulkanCommandRecorder)
+
+        /*!
+         @brief Drops recorded subpasses and resets all thread pools. GPU must not use buffers recorded before anymore.
+         */
+        void Reset();
+
+        /*!
+         @brief Opens recording of new subpass. Reference stays valid until Reset.
+         */
+        SubpassRecording& AddSubpass(VkRenderPass renderPass, VkFramebuffer framebuffer, uint32_t subpass);
+
+        /*!
+         @brief Records all subpasses into secondary buffers, blocks until recording is finished.
+         */
+        void Record();
+
+    private:
+        struct alignas(64) ThreadPool
+        {
+            VkCommandPool pool{ VK_NULL_HANDLE };
+            std::vector<VkCommandBuffer> buffers;
+            uint32_t usedCount{ 0 };
+        };
+
+        VkCommandBuffer AcquireSecondary();
+        void RecordChunk(SubpassRecording& subpass, uint32_t firstBatch, uint32_t lastBatch, uint32_t slot);
+
+    private:
+        std::shared_ptr<PAL::RenderAPI::VulkanDevice> mDevice;
+        Core::JobSystem* mJobSystem{ nullptr };
+
+        std::vector<ThreadPool> mThreadPools;
+        std::vector<std::unique_ptr<SubpassRecording>> mSubpasses;
+    };
+}
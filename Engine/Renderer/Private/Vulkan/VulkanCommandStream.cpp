@@ -0,0 +1,284 @@
+#include "VulkanCommandStream.h"
+
+#include <Core/Assert.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Renderer;
+
+namespace
+{
+    // First allocation fits a few thousand draws, arena doubles from there & keeps its memory between frames
+    constexpr size_t INITIAL_CAPACITY = 64 * 1024;
+}
+
+void VulkanCommandStream::Grow(size_t requiredSize)
+{
+    size_t capacity = std::max<size_t>(mCapacity, INITIAL_CAPACITY);
+    while(capacity < requiredSize)
+    {
+        capacity *= 2;
+    }
+
+    _ASSERT(capacity <= UINT32_MAX && "Commands are addressed by 32 bit offsets");
+
+    // Packets are plain data, moving them to new memory is a copy
+    auto data = std::make_unique<uint8_t[]>(capacity);
+    if(mSize > 0)
+    {
+        std::memcpy(data.get(), mData.get(), mSize);
+    }
+
+    mData = std::move(data);
+    mCapacity = static_cast<uint32_t>(capacity);
+}
+
+uint32_t VulkanCommandStream::BeginCommandBuffer(VkCommandBufferUsageFlags flags)
+{
+    auto& packet = Allocate<CommandPackets::BeginCommandBuffer>();
+    packet.flags = flags;
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::EndCommandBuffer()
+{
+    return GetOffset(Allocate<CommandPackets::EndCommandBuffer>());
+}
+
+uint32_t VulkanCommandStream::BeginRenderPass(VkRenderPass renderPass, VkFramebuffer framebuffer, const VkRect2D& renderArea, const VkClearValue* clearValues, uint32_t clearValueCount, VkSubpassContents contents)
+{
+    auto& packet = Allocate<CommandPackets::BeginRenderPass>(clearValueCount * sizeof(VkClearValue));
+    packet.renderPass = renderPass;
+    packet.framebuffer = framebuffer;
+    packet.renderArea = renderArea;
+    packet.contents = contents;
+    packet.clearValueCount = clearValueCount;
+
+    std::copy(clearValues, clearValues + clearValueCount, GetTrailing<VkClearValue>(packet));
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::NextSubpass(VkSubpassContents contents)
+{
+    auto& packet = Allocate<CommandPackets::NextSubpass>();
+    packet.contents = contents;
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::EndRenderPass()
+{
+    return GetOffset(Allocate<CommandPackets::EndRenderPass>());
+}
+
+uint32_t VulkanCommandStream::ExecuteCommands(const std::vector<VkCommandBuffer>& secondaryBuffers)
+{
+    auto& packet = Allocate<CommandPackets::ExecuteCommands>();
+    packet.secondaryBuffers = &secondaryBuffers;
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::BindPipeline(VkPipeline pipeline, VkPipelineBindPoint bindPoint)
+{
+    auto& packet = Allocate<CommandPackets::BindPipeline>();
+    packet.pipeline = pipeline;
+    packet.bindPoint = bindPoint;
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::BindVertexBuffers(uint32_t firstBinding, uint32_t bindingCount, const VkBuffer* buffers, const VkDeviceSize* offsets)
+{
+    auto& packet = Allocate<CommandPackets::BindVertexBuffers>(bindingCount * (sizeof(VkBuffer) + sizeof(VkDeviceSize)));
+    packet.firstBinding = firstBinding;
+    packet.bindingCount = bindingCount;
+
+    std::copy(buffers, buffers + bindingCount, GetTrailing<VkBuffer>(packet));
+    std::copy(offsets, offsets + bindingCount, GetTrailing<VkDeviceSize>(packet, bindingCount * sizeof(VkBuffer)));
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::BindIndexBuffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType)
+{
+    auto& packet = Allocate<CommandPackets::BindIndexBuffer>();
+    packet.buffer = buffer;
+    packet.offset = offset;
+    packet.indexType = indexType;
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::BindDescriptorSets(VkPipelineLayout layout, VkPipelineBindPoint bindPoint, uint32_t firstSet, uint32_t setCount, const VkDescriptorSet* descriptorSets, uint32_t dynamicOffsetCount, const uint32_t* dynamicOffsets)
+{
+    auto& packet = Allocate<CommandPackets::BindDescriptorSets>(setCount * sizeof(VkDescriptorSet) + dynamicOffsetCount * sizeof(uint32_t));
+    packet.layout = layout;
+    packet.bindPoint = bindPoint;
+    packet.firstSet = firstSet;
+    packet.setCount = setCount;
+    packet.dynamicOffsetCount = dynamicOffsetCount;
+
+    std::copy(descriptorSets, descriptorSets + setCount, GetTrailing<VkDescriptorSet>(packet));
+    std::copy(dynamicOffsets, dynamicOffsets + dynamicOffsetCount, GetTrailing<uint32_t>(packet, setCount * sizeof(VkDescriptorSet)));
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::PushConstants(VkPipelineLayout layout, VkShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* values)
+{
+    auto& packet = Allocate<CommandPackets::PushConstants>(size);
+    packet.layout = layout;
+    packet.stageFlags = stageFlags;
+    packet.offset = offset;
+    packet.size = size;
+
+    std::memcpy(GetTrailing<uint8_t>(packet), values, size);
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::SetViewport(const VkViewport& viewport)
+{
+    auto& packet = Allocate<CommandPackets::SetViewport>();
+    packet.viewport = viewport;
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::SetScissor(const VkRect2D& scissor)
+{
+    auto& packet = Allocate<CommandPackets::SetScissor>();
+    packet.scissor = scissor;
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
+{
+    auto& packet = Allocate<CommandPackets::DrawIndexed>();
+    packet.indexCount = indexCount;
+    packet.instanceCount = instanceCount;
+    packet.firstIndex = firstIndex;
+    packet.vertexOffset = vertexOffset;
+    packet.firstInstance = firstInstance;
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::DrawIndexedIndirect(VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride)
+{
+    auto& packet = Allocate<CommandPackets::DrawIndexedIndirect>();
+    packet.buffer = buffer;
+    packet.offset = offset;
+    packet.drawCount = drawCount;
+    packet.stride = stride;
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::DrawIndexedIndirectCount(VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countOffset, uint32_t maxDrawCount, uint32_t stride)
+{
+    auto& packet = Allocate<CommandPackets::DrawIndexedIndirectCount>();
+    packet.buffer = buffer;
+    packet.offset = offset;
+    packet.countBuffer = countBuffer;
+    packet.countOffset = countOffset;
+    packet.maxDrawCount = maxDrawCount;
+    packet.stride = stride;
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+{
+    auto& packet = Allocate<CommandPackets::Dispatch>();
+    packet.groupCountX = groupCountX;
+    packet.groupCountY = groupCountY;
+    packet.groupCountZ = groupCountZ;
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::DispatchIndirect(VkBuffer buffer, VkDeviceSize offset)
+{
+    auto& packet = Allocate<CommandPackets::DispatchIndirect>();
+    packet.buffer = buffer;
+    packet.offset = offset;
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, const VkBufferCopy& region)
+{
+    auto& packet = Allocate<CommandPackets::CopyBuffer>();
+    packet.srcBuffer = srcBuffer;
+    packet.dstBuffer = dstBuffer;
+    packet.region = region;
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::FillBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, uint32_t data)
+{
+    auto& packet = Allocate<CommandPackets::FillBuffer>();
+    packet.buffer = buffer;
+    packet.offset = offset;
+    packet.size = size;
+    packet.data = data;
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::PipelineBarrier(VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask)
+{
+    auto& packet = Allocate<CommandPackets::PipelineBarrier>();
+    packet.srcStageMask = srcStageMask;
+    packet.dstStageMask = dstStageMask;
+    packet.barrier = {};
+    packet.barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    packet.barrier.srcAccessMask = srcAccessMask;
+    packet.barrier.dstAccessMask = dstAccessMask;
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::BufferBarrier(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask)
+{
+    auto& packet = Allocate<CommandPackets::BufferBarrier>();
+    packet.srcStageMask = srcStageMask;
+    packet.dstStageMask = dstStageMask;
+    packet.barrier = {};
+    packet.barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    packet.barrier.srcAccessMask = srcAccessMask;
+    packet.barrier.dstAccessMask = dstAccessMask;
+    packet.barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    packet.barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    packet.barrier.buffer = buffer;
+    packet.barrier.offset = offset;
+    packet.barrier.size = size;
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::ImageBarrier(VkImage image, VkImageAspectFlags aspectMask, VkImageLayout oldLayout, VkImageLayout newLayout, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask)
+{
+    auto& packet = Allocate<CommandPackets::ImageBarrier>();
+    packet.srcStageMask = srcStageMask;
+    packet.dstStageMask = dstStageMask;
+    packet.barrier = MakeImageBarrier(image, aspectMask, oldLayout, newLayout, srcAccessMask, dstAccessMask);
+    return GetOffset(packet);
+}
+
+uint32_t VulkanCommandStream::ImageBarriers(VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, const VkImageMemoryBarrier* barriers, uint32_t barrierCount)
+{
+    auto& packet = Allocate<CommandPackets::ImageBarriers>(barrierCount * sizeof(VkImageMemoryBarrier));
+    packet.srcStageMask = srcStageMask;
+    packet.dstStageMask = dstStageMask;
+    packet.barrierCount = barrierCount;
+
+    std::copy(barriers, barriers + barrierCount, GetTrailing<VkImageMemoryBarrier>(packet));
+    return GetOffset(packet);
+}
+
+VkImageMemoryBarrier VulkanCommandStream::MakeImageBarrier(VkImage image, VkImageAspectFlags aspectMask, VkImageLayout oldLayout, VkImageLayout newLayout, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask) noexcept
+{
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccessMask;
+    barrier.dstAccessMask = dstAccessMask;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = aspectMask;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+    return barrier;
+}
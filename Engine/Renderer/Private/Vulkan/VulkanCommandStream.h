@@ -0,0 +1,616 @@
+#pragma once
+
+#include <PAL/RenderAPI/Vulkan/VulkanAPI.h>
+#include <Core/Platform.h>
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace Renderer
+{
+    enum class CommandType : uint32_t
+    {
+        BeginCommandBuffer,
+        EndCommandBuffer,
+        BeginRenderPass,
+        NextSubpass,
+        EndRenderPass,
+        ExecuteCommands,
+        BindPipeline,
+        BindVertexBuffers,
+        BindIndexBuffer,
+        BindDescriptorSets,
+        PushConstants,
+        SetViewport,
+        SetScissor,
+        DrawIndexed,
+        DrawIndexedIndirect,
+        DrawIndexedIndirectCount,
+        Dispatch,
+        DispatchIndirect,
+        CopyBuffer,
+        FillBuffer,
+        PipelineBarrier,
+        BufferBarrier,
+        ImageBarrier,
+        ImageBarriers
+    };
+
+    /*!
+     @brief Leads every packet of the stream, size covers the packet with its trailing arrays & is multiple of CommandAlignment.
+     */
+    struct CommandHeader
+    {
+        CommandType type;
+        uint32_t size;
+    };
+
+    constexpr uint32_t CommandAlignment = 8;
+
+    // Packets hold resolved handles & plain values only, so they are written & read in place without construction
+    namespace CommandPackets
+    {
+        struct BeginCommandBuffer
+        {
+            static constexpr CommandType Type = CommandType::BeginCommandBuffer;
+            CommandHeader header;
+            VkCommandBufferUsageFlags flags;
+        };
+
+        struct EndCommandBuffer
+        {
+            static constexpr CommandType Type = CommandType::EndCommandBuffer;
+            CommandHeader header;
+        };
+
+        // Followed by clearValueCount VkClearValue
+        struct BeginRenderPass
+        {
+            static constexpr CommandType Type = CommandType::BeginRenderPass;
+            CommandHeader header;
+            VkRenderPass renderPass;
+            VkFramebuffer framebuffer;
+            VkRect2D renderArea;
+            VkSubpassContents contents;
+            uint32_t clearValueCount;
+        };
+
+        struct NextSubpass
+        {
+            static constexpr CommandType Type = CommandType::NextSubpass;
+            CommandHeader header;
+            VkSubpassContents contents;
+        };
+
+        struct EndRenderPass
+        {
+            static constexpr CommandType Type = CommandType::EndRenderPass;
+            CommandHeader header;
+        };
+
+        // Vector is read at replay, so it may be filled after the packet is recorded
+        struct ExecuteCommands
+        {
+            static constexpr CommandType Type = CommandType::ExecuteCommands;
+            CommandHeader header;
+            const std::vector<VkCommandBuffer>* secondaryBuffers;
+        };
+
+        struct BindPipeline
+        {
+            static constexpr CommandType Type = CommandType::BindPipeline;
+            CommandHeader header;
+            VkPipeline pipeline;
+            VkPipelineBindPoint bindPoint;
+        };
+
+        // Followed by bindingCount VkBuffer & bindingCount VkDeviceSize
+        struct BindVertexBuffers
+        {
+            static constexpr CommandType Type = CommandType::BindVertexBuffers;
+            CommandHeader header;
+            uint32_t firstBinding;
+            uint32_t bindingCount;
+        };
+
+        struct BindIndexBuffer
+        {
+            static constexpr CommandType Type = CommandType::BindIndexBuffer;
+            CommandHeader header;
+            VkBuffer buffer;
+            VkDeviceSize offset;
+            VkIndexType indexType;
+        };
+
+        // Followed by setCount VkDescriptorSet & dynamicOffsetCount uint32_t
+        struct BindDescriptorSets
+        {
+            static constexpr CommandType Type = CommandType::BindDescriptorSets;
+            CommandHeader header;
+            VkPipelineLayout layout;
+            VkPipelineBindPoint bindPoint;
+            uint32_t firstSet;
+            uint32_t setCount;
+            uint32_t dynamicOffsetCount;
+        };
+
+        // Followed by size bytes of values
+        struct PushConstants
+        {
+            static constexpr CommandType Type = CommandType::PushConstants;
+            CommandHeader header;
+            VkPipelineLayout layout;
+            VkShaderStageFlags stageFlags;
+            uint32_t offset;
+            uint32_t size;
+        };
+
+        struct SetViewport
+        {
+            static constexpr CommandType Type = CommandType::SetViewport;
+            CommandHeader header;
+            VkViewport viewport;
+        };
+
+        struct SetScissor
+        {
+            static constexpr CommandType Type = CommandType::SetScissor;
+            CommandHeader header;
+            VkRect2D scissor;
+        };
+
+        struct DrawIndexed
+        {
+            static constexpr CommandType Type = CommandType::DrawIndexed;
+            CommandHeader header;
+            uint32_t indexCount;
+            uint32_t instanceCount;
+            uint32_t firstIndex;
+            int32_t vertexOffset;
+            uint32_t firstInstance;
+        };
+
+        struct DrawIndexedIndirect
+        {
+            static constexpr CommandType Type = CommandType::DrawIndexedIndirect;
+            CommandHeader header;
+            VkBuffer buffer;
+            VkDeviceSize offset;
+            uint32_t drawCount;
+            uint32_t stride;
+        };
+
+        struct DrawIndexedIndirectCount
+        {
+            static constexpr CommandType Type = CommandType::DrawIndexedIndirectCount;
+            CommandHeader header;
+            VkBuffer buffer;
+            VkDeviceSize offset;
+            VkBuffer countBuffer;
+            VkDeviceSize countOffset;
+            uint32_t maxDrawCount;
+            uint32_t stride;
+        };
+
+        struct Dispatch
+        {
+            static constexpr CommandType Type = CommandType::Dispatch;
+            CommandHeader header;
+            uint32_t groupCountX;
+            uint32_t groupCountY;
+            uint32_t groupCountZ;
+        };
+
+        struct DispatchIndirect
+        {
+            static constexpr CommandType Type = CommandType::DispatchIndirect;
+            CommandHeader header;
+            VkBuffer buffer;
+            VkDeviceSize offset;
+        };
+
+        struct CopyBuffer
+        {
+            static constexpr CommandType Type = CommandType::CopyBuffer;
+            CommandHeader header;
+            VkBuffer srcBuffer;
+            VkBuffer dstBuffer;
+            VkBufferCopy region;
+        };
+
+        struct FillBuffer
+        {
+            static constexpr CommandType Type = CommandType::FillBuffer;
+            CommandHeader header;
+            VkBuffer buffer;
+            VkDeviceSize offset;
+            VkDeviceSize size;
+            uint32_t data;
+        };
+
+        struct PipelineBarrier
+        {
+            static constexpr CommandType Type = CommandType::PipelineBarrier;
+            CommandHeader header;
+            VkPipelineStageFlags srcStageMask;
+            VkPipelineStageFlags dstStageMask;
+            VkMemoryBarrier barrier;
+        };
+
+        struct BufferBarrier
+        {
+            static constexpr CommandType Type = CommandType::BufferBarrier;
+            CommandHeader header;
+            VkPipelineStageFlags srcStageMask;
+            VkPipelineStageFlags dstStageMask;
+            VkBufferMemoryBarrier barrier;
+        };
+
+        struct ImageBarrier
+        {
+            static constexpr CommandType Type = CommandType::ImageBarrier;
+            CommandHeader header;
+            VkPipelineStageFlags srcStageMask;
+            VkPipelineStageFlags dstStageMask;
+            VkImageMemoryBarrier barrier;
+        };
+
+        // Followed by barrierCount VkImageMemoryBarrier, aligned as the barriers hold pointers
+        struct alignas(CommandAlignment) ImageBarriers
+        {
+            static constexpr CommandType Type = CommandType::ImageBarriers;
+            CommandHeader header;
+            VkPipelineStageFlags srcStageMask;
+            VkPipelineStageFlags dstStageMask;
+            uint32_t barrierCount;
+        };
+    }
+
+    /*!
+     @brief Commands packed one after another into a linear arena & replayed into Vulkan command buffers.
+
+     Every command is recorded as plain packet of resolved handles & values, there is no per command allocation,
+     construction nor virtual call. Commands are addressed by byte offset returned by their record function,
+     offsets stay valid until Clear while addresses may change as the arena grows.
+     Replay is templated by device, so the same stream can be replayed against anything exposing VulkanDevice's Cmd functions.
+     */
+    class VulkanCommandStream
+    {
+    public:
+        /*!
+         @brief Drops recorded commands, arena memory is kept for the next recording.
+         */
+        void Clear() noexcept { mSize = 0; }
+
+        NO_DISCARD bool IsEmpty() const noexcept { return mSize == 0; }
+
+        /*!
+         @return Offset one past the last recorded command.
+         */
+        NO_DISCARD uint32_t GetSize() const noexcept { return mSize; }
+        NO_DISCARD uint32_t GetCapacity() const noexcept { return mCapacity; }
+
+        uint32_t BeginCommandBuffer(VkCommandBufferUsageFlags flags);
+        uint32_t EndCommandBuffer();
+        uint32_t BeginRenderPass(VkRenderPass renderPass, VkFramebuffer framebuffer, const VkRect2D& renderArea, const VkClearValue* clearValues, uint32_t clearValueCount, VkSubpassContents contents);
+        uint32_t NextSubpass(VkSubpassContents contents);
+        uint32_t EndRenderPass();
+
+        /*!
+         @brief Executes secondary buffers, vector is read at replay so it may be filled after the command is recorded.
+         */
+        uint32_t ExecuteCommands(const std::vector<VkCommandBuffer>& secondaryBuffers);
+
+        uint32_t BindPipeline(VkPipeline pipeline, VkPipelineBindPoint bindPoint);
+        uint32_t BindVertexBuffers(uint32_t firstBinding, uint32_t bindingCount, const VkBuffer* buffers, const VkDeviceSize* offsets);
+        uint32_t BindIndexBuffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType);
+
+        /*!
+         @param dynamicOffsets Offsets of dynamic uniform buffers of the bound sets in set & binding order.
+         */
+        uint32_t BindDescriptorSets(VkPipelineLayout layout, VkPipelineBindPoint bindPoint, uint32_t firstSet, uint32_t setCount, const VkDescriptorSet* descriptorSets, uint32_t dynamicOffsetCount, const uint32_t* dynamicOffsets);
+
+        /*!
+         @brief Values are copied, command may be replayed on another thread after the caller's data is gone.
+         */
+        uint32_t PushConstants(VkPipelineLayout layout, VkShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* values);
+
+        uint32_t SetViewport(const VkViewport& viewport);
+        uint32_t SetScissor(const VkRect2D& scissor);
+
+        uint32_t DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance);
+        uint32_t DrawIndexedIndirect(VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride);
+
+        /*!
+         @brief Draws number of commands read from count buffer, requires VK_KHR_draw_indirect_count.
+         */
+        uint32_t DrawIndexedIndirectCount(VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countOffset, uint32_t maxDrawCount, uint32_t stride);
+
+        uint32_t Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
+
+        /*!
+         @brief Dispatch of workgroup counts read from VkDispatchIndirectCommand in the buffer.
+         */
+        uint32_t DispatchIndirect(VkBuffer buffer, VkDeviceSize offset);
+
+        uint32_t CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, const VkBufferCopy& region);
+        uint32_t FillBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, uint32_t data);
+
+        /*!
+         @brief Global memory barrier, orders commands recorded before it, including earlier submissions to the queue,
+                against commands recorded after it.
+         */
+        uint32_t PipelineBarrier(VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask);
+
+        /*!
+         @brief Barrier of buffer range, orders only accesses to the range unlike PipelineBarrier.
+         */
+        uint32_t BufferBarrier(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask);
+
+        /*!
+         @brief Barrier of all mip levels & layers of image, transitions the image from old to new layout.
+         */
+        uint32_t ImageBarrier(VkImage image, VkImageAspectFlags aspectMask, VkImageLayout oldLayout, VkImageLayout newLayout, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask);
+
+        /*!
+         @brief Barriers of several images recorded as single pipeline barrier, barriers are copied.
+         */
+        uint32_t ImageBarriers(VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, const VkImageMemoryBarrier* barriers, uint32_t barrierCount);
+
+        /*!
+         @brief Fills barrier of all mip levels & layers of image, used to batch barriers for ImageBarriers.
+         */
+        NO_DISCARD static VkImageMemoryBarrier MakeImageBarrier(VkImage image, VkImageAspectFlags aspectMask, VkImageLayout oldLayout, VkImageLayout newLayout, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask) noexcept;
+
+        /*!
+         @brief Replays commands recorded from offset begin up to offset end.
+         */
+        template<typename Device>
+        void Replay(const Device& device, VkCommandBuffer commandBuffer, uint32_t begin, uint32_t end) const;
+
+        template<typename Device>
+        void Replay(const Device& device, VkCommandBuffer commandBuffer) const { Replay(device, commandBuffer, 0, mSize); }
+
+        /*!
+         @brief Replays single command recorded at offset.
+         */
+        template<typename Device>
+        void ReplayCommand(const Device& device, VkCommandBuffer commandBuffer, uint32_t offset) const
+        {
+            Execute(device, commandBuffer, *reinterpret_cast<const CommandHeader*>(mData.get() + offset));
+        }
+
+    private:
+        /*!
+         @brief Allocates packet followed by trailingSize bytes at the end of the arena & fills its header.
+         */
+        template<typename Packet>
+        Packet& Allocate(size_t trailingSize = 0);
+
+        void Grow(size_t requiredSize);
+
+        template<typename Packet>
+        uint32_t GetOffset(const Packet& packet) const noexcept
+        {
+            return static_cast<uint32_t>(reinterpret_cast<const uint8_t*>(&packet) - mData.get());
+        }
+
+        // Trailing arrays start right after the packet, byteOffset skips the arrays preceding the requested one
+        template<typename T, typename Packet>
+        static T* GetTrailing(Packet& packet, size_t byteOffset = 0) noexcept
+        {
+            return reinterpret_cast<T*>(reinterpret_cast<uint8_t*>(&packet + 1) + byteOffset);
+        }
+
+        template<typename T, typename Packet>
+        static const T* GetTrailing(const Packet& packet, size_t byteOffset = 0) noexcept
+        {
+            return reinterpret_cast<const T*>(reinterpret_cast<const uint8_t*>(&packet + 1) + byteOffset);
+        }
+
+        template<typename Device>
+        static void Execute(const Device& device, VkCommandBuffer commandBuffer, const CommandHeader& header);
+
+    private:
+        std::unique_ptr<uint8_t[]> mData;
+        uint32_t mSize{ 0 };
+        uint32_t mCapacity{ 0 };
+    };
+
+    template<typename Packet>
+    Packet& VulkanCommandStream::Allocate(size_t trailingSize)
+    {
+        static_assert(std::is_trivially_copyable<Packet>::value && std::is_standard_layout<Packet>::value, "Packets are replayed in place");
+        static_assert(alignof(Packet) <= CommandAlignment, "Packet is misaligned in the arena");
+
+        const size_t size = (sizeof(Packet) + trailingSize + CommandAlignment - 1) & ~size_t(CommandAlignment - 1);
+        if(mSize + size > mCapacity)
+        {
+            Grow(mSize + size);
+        }
+
+        auto* packet = new (mData.get() + mSize) Packet;
+        packet->header.type = Packet::Type;
+        packet->header.size = static_cast<uint32_t>(size);
+
+        mSize += static_cast<uint32_t>(size);
+        return *packet;
+    }
+
+    template<typename Device>
+    void VulkanCommandStream::Replay(const Device& device, VkCommandBuffer commandBuffer, uint32_t begin, uint32_t end) const
+    {
+        const uint8_t* it = mData.get() + begin;
+        const uint8_t* last = mData.get() + end;
+
+        while(it < last)
+        {
+            const auto& header = *reinterpret_cast<const CommandHeader*>(it);
+            Execute(device, commandBuffer, header);
+            it += header.size;
+        }
+    }
+
+    template<typename Device>
+    void VulkanCommandStream::Execute(const Device& device, VkCommandBuffer commandBuffer, const CommandHeader& header)
+    {
+        switch(header.type)
+        {
+            case CommandType::BeginCommandBuffer:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::BeginCommandBuffer&>(header);
+
+                VkCommandBufferBeginInfo beginInfo{};
+                beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+                beginInfo.flags = packet.flags;
+
+                device.BeginCommandBuffer(commandBuffer, &beginInfo);
+                break;
+            }
+            case CommandType::EndCommandBuffer:
+                device.EndCommandBuffer(commandBuffer);
+                break;
+            case CommandType::BeginRenderPass:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::BeginRenderPass&>(header);
+
+                VkRenderPassBeginInfo renderPassInfo{};
+                renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+                renderPassInfo.renderPass = packet.renderPass;
+                renderPassInfo.framebuffer = packet.framebuffer;
+                renderPassInfo.renderArea = packet.renderArea;
+                renderPassInfo.clearValueCount = packet.clearValueCount;
+                renderPassInfo.pClearValues = GetTrailing<VkClearValue>(packet);
+
+                device.BeginRenderPass(commandBuffer, &renderPassInfo, packet.contents);
+                break;
+            }
+            case CommandType::NextSubpass:
+                device.NextSubpass(commandBuffer, reinterpret_cast<const CommandPackets::NextSubpass&>(header).contents);
+                break;
+            case CommandType::EndRenderPass:
+                device.EndRenderPass(commandBuffer);
+                break;
+            case CommandType::ExecuteCommands:
+            {
+                const auto& secondaryBuffers = *reinterpret_cast<const CommandPackets::ExecuteCommands&>(header).secondaryBuffers;
+                if(!secondaryBuffers.empty())
+                {
+                    device.CmdExecuteCommands(commandBuffer, static_cast<uint32_t>(secondaryBuffers.size()), secondaryBuffers.data());
+                }
+                break;
+            }
+            case CommandType::BindPipeline:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::BindPipeline&>(header);
+                device.BindPipeline(commandBuffer, packet.bindPoint, packet.pipeline);
+                break;
+            }
+            case CommandType::BindVertexBuffers:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::BindVertexBuffers&>(header);
+                const auto* buffers = GetTrailing<VkBuffer>(packet);
+                const auto* offsets = GetTrailing<VkDeviceSize>(packet, packet.bindingCount * sizeof(VkBuffer));
+
+                device.CmdBindVertexBuffer(commandBuffer, packet.firstBinding, packet.bindingCount, buffers, offsets);
+                break;
+            }
+            case CommandType::BindIndexBuffer:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::BindIndexBuffer&>(header);
+                device.CmdBindIndexBuffer(commandBuffer, packet.buffer, packet.offset, packet.indexType);
+                break;
+            }
+            case CommandType::BindDescriptorSets:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::BindDescriptorSets&>(header);
+                const auto* descriptorSets = GetTrailing<VkDescriptorSet>(packet);
+                const auto* dynamicOffsets = GetTrailing<uint32_t>(packet, packet.setCount * sizeof(VkDescriptorSet));
+
+                device.CmdBindDescriptorSets(commandBuffer, packet.bindPoint, packet.layout, packet.firstSet, packet.setCount, descriptorSets, packet.dynamicOffsetCount, dynamicOffsets);
+                break;
+            }
+            case CommandType::PushConstants:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::PushConstants&>(header);
+                device.CmdPushConstants(commandBuffer, packet.layout, packet.stageFlags, packet.offset, packet.size, GetTrailing<uint8_t>(packet));
+                break;
+            }
+            case CommandType::SetViewport:
+                device.CmdSetViewport(commandBuffer, 0, 1, &reinterpret_cast<const CommandPackets::SetViewport&>(header).viewport);
+                break;
+            case CommandType::SetScissor:
+                device.CmdSetScissor(commandBuffer, 0, 1, &reinterpret_cast<const CommandPackets::SetScissor&>(header).scissor);
+                break;
+            case CommandType::DrawIndexed:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::DrawIndexed&>(header);
+                device.CmdDrawIndexed(commandBuffer, packet.indexCount, packet.instanceCount, packet.firstIndex, packet.vertexOffset, packet.firstInstance);
+                break;
+            }
+            case CommandType::DrawIndexedIndirect:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::DrawIndexedIndirect&>(header);
+                device.CmdDrawIndexedIndirect(commandBuffer, packet.buffer, packet.offset, packet.drawCount, packet.stride);
+                break;
+            }
+            case CommandType::DrawIndexedIndirectCount:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::DrawIndexedIndirectCount&>(header);
+                device.CmdDrawIndexedIndirectCountKHR(commandBuffer, packet.buffer, packet.offset, packet.countBuffer, packet.countOffset, packet.maxDrawCount, packet.stride);
+                break;
+            }
+            case CommandType::Dispatch:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::Dispatch&>(header);
+                device.CmdDispatch(commandBuffer, packet.groupCountX, packet.groupCountY, packet.groupCountZ);
+                break;
+            }
+            case CommandType::DispatchIndirect:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::DispatchIndirect&>(header);
+                device.CmdDispatchIndirect(commandBuffer, packet.buffer, packet.offset);
+                break;
+            }
+            case CommandType::CopyBuffer:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::CopyBuffer&>(header);
+                device.CmdCopyBuffer(commandBuffer, packet.srcBuffer, packet.dstBuffer, 1, &packet.region);
+                break;
+            }
+            case CommandType::FillBuffer:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::FillBuffer&>(header);
+                device.CmdFillBuffer(commandBuffer, packet.buffer, packet.offset, packet.size, packet.data);
+                break;
+            }
+            case CommandType::PipelineBarrier:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::PipelineBarrier&>(header);
+                device.CmdPipelineBarrier(commandBuffer, packet.srcStageMask, packet.dstStageMask, 0, 1, &packet.barrier, 0, nullptr, 0, nullptr);
+                break;
+            }
+            case CommandType::BufferBarrier:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::BufferBarrier&>(header);
+                device.CmdPipelineBarrier(commandBuffer, packet.srcStageMask, packet.dstStageMask, 0, 0, nullptr, 1, &packet.barrier, 0, nullptr);
+                break;
+            }
+            case CommandType::ImageBarrier:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::ImageBarrier&>(header);
+                device.CmdPipelineBarrier(commandBuffer, packet.srcStageMask, packet.dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &packet.barrier);
+                break;
+            }
+            case CommandType::ImageBarriers:
+            {
+                const auto& packet = reinterpret_cast<const CommandPackets::ImageBarriers&>(header);
+                device.CmdPipelineBarrier(commandBuffer, packet.srcStageMask, packet.dstStageMask, 0, 0, nullptr, 0, nullptr, packet.barrierCount, GetTrailing<VkImageMemoryBarrier>(packet));
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#include "VulkanDeletionQueue.h"
+
+#include <Logging/LoggingService.h>
+
+#include <algorithm>
+
+#ifdef LOG_MODULE_ID
+#undef LOG_MODULE_ID
+#endif
+
+#define LOG_MODULE_ID LOG_MODULE_4BYTE('V','K','D','Q')
+
+using namespace Renderer;
+using namespace PAL::RenderAPI;
+
+VulkanDeletionQueue::VulkanDeletionQueue(std::shared_ptr<VulkanDevice> device, std::shared_ptr<VulkanMemoryAllocator> allocator, uint32_t framesInFlight)
+    : mDevice(std::move(device))
+    , mAllocator(std::move(allocator))
+    , mFramesInFlight(std::max(1u, framesInFlight))
+{
+}
+
+VulkanDeletionQueue::~VulkanDeletionQueue()
+{
+    Flush();
+}
+
+void VulkanDeletionQueue::Release(Resource&& resource, uint64_t frameNumber)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // Frame numbers only grow, the queue stays sorted by release frame
+    _ASSERT(mReleased.empty() || mReleased.back().releaseFrame <= frameNumber);
+    mReleased.push_back({ std::move(resource), frameNumber });
+}
+
+void VulkanDeletionQueue::Collect(uint64_t frameNumber)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    while(!mReleased.empty() && frameNumber - mReleased.front().releaseFrame >= mFramesInFlight)
+    {
+        Destroy(mReleased.front().resource);
+        mReleased.pop_front();
+    }
+}
+
+void VulkanDeletionQueue::Flush()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if(!mReleased.empty())
+    {
+        LOG(Information) << "Destroying " << mReleased.size() << " released resources";
+    }
+
+    for(auto& released : mReleased)
+    {
+        Destroy(released.resource);
+    }
+
+    mReleased.clear();
+}
+
+size_t VulkanDeletionQueue::GetPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mReleased.size();
+}
+
+void VulkanDeletionQueue::Destroy(Resource& resource) const
+{
+    const DeviceObjectDestroyer destroyer(mDevice, mAllocator);
+    std::visit([&destroyer](auto& object){ destroyer.Destroy(object); }, resource);
+}
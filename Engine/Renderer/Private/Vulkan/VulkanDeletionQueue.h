@@ -0,0 +1,72 @@
+#pragma once
+
+#include <PAL/RenderAPI/Vulkan/VulkanDevice.h>
+#include <Core/Platform.h>
+
+#include "VulkanDeviceObjects.h"
+#include "VulkanMemoryAllocator.h"
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <variant>
+
+namespace Renderer
+{
+    /*!
+     @brief Defers destruction of resources removed from resource tables until GPU is done with them.
+
+     Resource released during frame may still be referenced by every frame in flight started until then. It's destroyed
+     once the fence of the last such frame signalled, its memory goes back to the allocator. Resources are retired in
+     release order, placed images released with their heap are destroyed before the heap. Queue is thread safe.
+     */
+    class VulkanDeletionQueue
+    {
+    public:
+        using Resource = std::variant<BufferDeviceObject, VulkanAttachmentDeviceObject, TextureDeviceObject, VulkanMemoryHeapDeviceObject>;
+
+        VulkanDeletionQueue(std::shared_ptr<PAL::RenderAPI::VulkanDevice> device, std::shared_ptr<VulkanMemoryAllocator> allocator, uint32_t framesInFlight);
+
+        /*!
+         @brief Destroys all pending resources, device has to be idle.
+         */
+        ~VulkanDeletionQueue();
+
+        DECLARE_NOCOPY_NOMOVE(VulkanDeletionQueue)
+
+        /*!
+         @brief Takes ownership of resource, it's destroyed once frames in flight started until frameNumber are finished.
+         */
+        void Release(Resource&& resource, uint64_t frameNumber);
+
+        /*!
+         @brief Destroys resources of finished frames, has to be called once GPU released the frame slot.
+         @param frameNumber Number of the frame being started.
+         */
+        void Collect(uint64_t frameNumber);
+
+        /*!
+         @brief Destroys all pending resources regardless of their frame, device has to be idle.
+         */
+        void Flush();
+
+        NO_DISCARD size_t GetPendingCount() const;
+
+    private:
+        struct ReleasedResource
+        {
+            Resource resource;
+            uint64_t releaseFrame{ 0 };
+        };
+
+        void Destroy(Resource& resource) const;
+
+    private:
+        std::shared_ptr<PAL::RenderAPI::VulkanDevice> mDevice;
+        std::shared_ptr<VulkanMemoryAllocator> mAllocator;
+        uint32_t mFramesInFlight{ 1 };
+
+        mutable std::mutex mMutex;
+        std::deque<ReleasedResource> mReleased;
+    };
+}
@@ -0,0 +1,435 @@
+#include "VulkanDescriptorAllocator.h"
+
+#include <Logging/LoggingService.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef LOG_MODULE_ID
+#undef LOG_MODULE_ID
+#endif
+
+#define LOG_MODULE_ID LOG_MODULE_4BYTE('V','K','D','A')
+
+using namespace Renderer;
+using namespace PAL::RenderAPI;
+
+namespace
+{
+    // Sets of every pool, descriptors of each type are sized for the average set of few bindings
+    constexpr uint32_t POOL_SET_COUNT = 256;
+    constexpr uint32_t POOL_DESCRIPTORS_PER_SET = 4;
+}
+
+VulkanDescriptorAllocator::VulkanDescriptorAllocator(std::shared_ptr<VulkanDevice> device, uint32_t framesInFlight)
+    : mDevice(std::move(device))
+    , mFramesInFlight(std::max(1u, framesInFlight))
+    , mFramePools(mFramesInFlight)
+    , mFramePoolUsage(mFramesInFlight, 0)
+    , mReleaseCandidates(std::make_shared<ReleaseCandidates>())
+{
+}
+
+VulkanDescriptorAllocator::~VulkanDescriptorAllocator()
+{
+    size_t framePoolCount{ 0 };
+    for(const auto& framePools : mFramePools)
+    {
+        framePoolCount += framePools.size();
+    }
+
+    LOG(Information) << "Descriptor allocator: " << mPools.size() << " pools, " << framePoolCount << " frame pools, "
+                     << mLayouts.size() << " set layouts, " << mSets.size() << " cached sets, " << mHitCount << " sets shared existing content";
+
+    // Destroying pool frees all sets allocated from it
+    for(const auto& pool : mPools)
+    {
+        mDevice->DestroyDescriptorPool(pool.pool, nullptr);
+    }
+
+    for(const auto& framePools : mFramePools)
+    {
+        for(const auto& pool : framePools)
+        {
+            mDevice->DestroyDescriptorPool(pool.pool, nullptr);
+        }
+    }
+
+    for(const auto& [key, layout] : mLayouts)
+    {
+        mDevice->DestroyDescriptorSetLayout(layout, nullptr);
+    }
+}
+
+VkDescriptorSetLayout VulkanDescriptorAllocator::GetLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings)
+{
+    StateKey key;
+    key.Append(bindings.size());
+
+    for(const auto& binding : bindings)
+    {
+        _ASSERT(binding.pImmutableSamplers == nullptr && "Immutable samplers are not supported");
+
+        key.Append(binding.binding);
+        key.Append(binding.descriptorType);
+        key.Append(binding.descriptorCount);
+        key.Append(binding.stageFlags);
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    const auto it = mLayouts.find(key);
+    if(it != mLayouts.end())
+        return it->second;
+
+    DescriptorCounts counts{};
+    for(const auto& binding : bindings)
+    {
+        const auto typeIt = std::find(PoolDescriptorTypes.begin(), PoolDescriptorTypes.end(), binding.descriptorType);
+        _ASSERT(typeIt != PoolDescriptorTypes.end() && "Unsupported descriptor type");
+
+        counts[std::distance(PoolDescriptorTypes.begin(), typeIt)] += binding.descriptorCount;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    VkDescriptorSetLayout layout{ VK_NULL_HANDLE };
+    mDevice->CreateDescriptorSetLayout(&layoutInfo, nullptr, &layout);
+
+    mLayouts.emplace(std::move(key), layout);
+    mLayoutCounts.emplace(layout, counts);
+
+    return layout;
+}
+
+std::shared_ptr<const VulkanDescriptorSet> VulkanDescriptorAllocator::GetSet(VkDescriptorSetLayout layout, std::vector<VkWriteDescriptorSet>& writes)
+{
+    // Set is identified by its layout & every descriptor written into it, key keeps all of them so a hit means equal writes
+    StateKey key;
+    key.Append(reinterpret_cast<uint64_t>(layout));
+    key.Append(writes.size());
+
+    for(const auto& write : writes)
+    {
+        key.Append(write.dstBinding);
+        key.Append(write.dstArrayElement);
+        key.Append(write.descriptorType);
+        key.Append(write.descriptorCount);
+
+        for(uint32_t i = 0; i < write.descriptorCount; ++i)
+        {
+            if(write.pImageInfo)
+            {
+                key.Append(reinterpret_cast<uint64_t>(write.pImageInfo[i].sampler));
+                key.Append(reinterpret_cast<uint64_t>(write.pImageInfo[i].imageView));
+                key.Append(write.pImageInfo[i].imageLayout);
+            }
+            else if(write.pBufferInfo)
+            {
+                key.Append(reinterpret_cast<uint64_t>(write.pBufferInfo[i].buffer));
+                key.Append(write.pBufferInfo[i].offset);
+                key.Append(write.pBufferInfo[i].range);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    const auto it = mSets.find(key);
+    if(it != mSets.end())
+    {
+        if(auto set = it->second.set.lock())
+        {
+            ++mHitCount;
+            return set;
+        }
+
+        // Last holder dropped the set, it's released by the next Collect & can't be handed out again
+        Uncache(it->second.handle);
+    }
+
+    size_t poolIndex{ 0 };
+    const VkDescriptorSet descriptorSet = Allocate(mPools, 0, layout, true, poolIndex);
+
+    for(auto& write : writes)
+    {
+        write.dstSet = descriptorSet;
+    }
+
+    mDevice->UpdateDescriptorSets(static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+    // Deleter only queues the set, it's freed by Collect once frames in flight are finished
+    std::shared_ptr<const VulkanDescriptorSet> set(new VulkanDescriptorSet{ descriptorSet, layout },
+        [candidates = mReleaseCandidates, poolIndex](const VulkanDescriptorSet* released){
+            {
+                std::lock_guard<std::mutex> candidatesLock(candidates->mutex);
+                candidates->sets.push_back({ released->set, released->layout, poolIndex, 0 });
+            }
+
+            delete released;
+        });
+
+    CachedSet cachedSet;
+    cachedSet.set = set;
+    cachedSet.handle = descriptorSet;
+
+    for(const auto& write : writes)
+    {
+        for(uint32_t i = 0; i < write.descriptorCount; ++i)
+        {
+            if(write.pImageInfo)
+                cachedSet.imageViews.push_back(reinterpret_cast<uint64_t>(write.pImageInfo[i].imageView));
+            else if(write.pBufferInfo)
+                cachedSet.buffers.push_back(reinterpret_cast<uint64_t>(write.pBufferInfo[i].buffer));
+        }
+    }
+
+    for(const uint64_t buffer : cachedSet.buffers)
+    {
+        mSetsByBuffer[buffer].push_back(descriptorSet);
+    }
+
+    for(const uint64_t imageView : cachedSet.imageViews)
+    {
+        mSetsByImageView[imageView].push_back(descriptorSet);
+    }
+
+    const auto inserted = mSets.emplace(std::move(key), std::move(cachedSet)).first;
+    mSetKeys.emplace(descriptorSet, &inserted->first);
+
+    return set;
+}
+
+VkDescriptorSet VulkanDescriptorAllocator::AllocateFrameSet(VkDescriptorSetLayout layout)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // Pools before the last used one were already full
+    auto& usage = mFramePoolUsage[mFrameIndex];
+    const size_t firstPool = usage > 0 ? usage - 1 : 0;
+
+    size_t poolIndex{ 0 };
+    const VkDescriptorSet set = Allocate(mFramePools[mFrameIndex], firstPool, layout, false, poolIndex);
+    usage = poolIndex + 1;
+
+    return set;
+}
+
+void VulkanDescriptorAllocator::EvictBuffer(VkBuffer buffer)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    Evict(mSetsByBuffer, reinterpret_cast<uint64_t>(buffer));
+}
+
+void VulkanDescriptorAllocator::EvictImageView(VkImageView imageView)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    Evict(mSetsByImageView, reinterpret_cast<uint64_t>(imageView));
+}
+
+void VulkanDescriptorAllocator::Evict(SetsByResource& setsByResource, uint64_t resource)
+{
+    const auto it = setsByResource.find(resource);
+    if(it == setsByResource.end())
+        return;
+
+    // Uncache edits the index, sets are taken out first
+    const auto sets = std::move(it->second);
+    setsByResource.erase(it);
+
+    for(const VkDescriptorSet set : sets)
+    {
+        Uncache(set);
+    }
+}
+
+void VulkanDescriptorAllocator::Uncache(VkDescriptorSet set)
+{
+    const auto keyIt = mSetKeys.find(set);
+    if(keyIt == mSetKeys.end())
+        return;
+
+    const auto it = mSets.find(*keyIt->second);
+    _ASSERT(it != mSets.end() && it->second.handle == set);
+
+    const auto removeFrom = [set](SetsByResource& setsByResource, uint64_t resource){
+        const auto resourceIt = setsByResource.find(resource);
+        if(resourceIt == setsByResource.end())
+            return;
+
+        auto& sets = resourceIt->second;
+        sets.erase(std::remove(sets.begin(), sets.end(), set), sets.end());
+
+        if(sets.empty())
+            setsByResource.erase(resourceIt);
+    };
+
+    for(const uint64_t buffer : it->second.buffers)
+    {
+        removeFrom(mSetsByBuffer, buffer);
+    }
+
+    for(const uint64_t imageView : it->second.imageViews)
+    {
+        removeFrom(mSetsByImageView, imageView);
+    }
+
+    mSetKeys.erase(keyIt);
+    mSets.erase(it);
+}
+
+void VulkanDescriptorAllocator::BeginFrame(uint32_t frameIndex, uint64_t frameNumber)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    mFrameIndex = frameIndex;
+
+    auto& framePools = mFramePools[frameIndex];
+    for(size_t i = 0; i < mFramePoolUsage[frameIndex]; ++i)
+    {
+        auto& pool = framePools[i];
+
+        mDevice->ResetDescriptorPool(pool.pool, 0);
+        pool.setCount = POOL_SET_COUNT;
+        pool.descriptorCounts = pool.capacity;
+    }
+
+    mFramePoolUsage[frameIndex] = 0;
+
+    Collect(frameNumber);
+}
+
+VkDescriptorSet VulkanDescriptorAllocator::Allocate(std::vector<Pool>& pools, size_t firstPool, VkDescriptorSetLayout layout, bool freeable, size_t& poolIndex)
+{
+    const auto countsIt = mLayoutCounts.find(layout);
+    _ASSERT(countsIt != mLayoutCounts.end() && "Layout wasn't created by the allocator");
+
+    const auto& counts = countsIt->second;
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &layout;
+
+    const auto fits = [&counts](const Pool& pool){
+        if(pool.fragmented || pool.setCount == 0)
+            return false;
+
+        for(size_t i = 0; i < counts.size(); ++i)
+        {
+            if(pool.descriptorCounts[i] < counts[i])
+                return false;
+        }
+
+        return true;
+    };
+
+    for(size_t i = firstPool; i <= pools.size(); ++i)
+    {
+        const bool created = i == pools.size();
+        if(created)
+        {
+            pools.push_back(CreatePool(counts, freeable));
+        }
+
+        auto& pool = pools[i];
+        if(!fits(pool))
+            continue;
+
+        VkDescriptorSet set{ VK_NULL_HANDLE };
+        allocInfo.descriptorPool = pool.pool;
+
+        if(mDevice->AllocateDescriptorSets(&allocInfo, &set) != VK_SUCCESS)
+        {
+            if(created)
+                break;
+
+            // Pool is fragmented by freed sets, it's skipped until more sets are freed back to it
+            pool.fragmented = true;
+            continue;
+        }
+
+        pool.setCount--;
+        for(size_t type = 0; type < counts.size(); ++type)
+        {
+            pool.descriptorCounts[type] -= counts[type];
+        }
+
+        poolIndex = i;
+        return set;
+    }
+
+    throw std::runtime_error("Failed to allocate descriptor set!");
+}
+
+VulkanDescriptorAllocator::Pool VulkanDescriptorAllocator::CreatePool(const DescriptorCounts& minCounts, bool freeable) const
+{
+    Pool pool;
+    pool.setCount = POOL_SET_COUNT;
+
+    std::array<VkDescriptorPoolSize, PoolDescriptorTypes.size()> poolSizes{};
+    for(size_t i = 0; i < PoolDescriptorTypes.size(); ++i)
+    {
+        // Set bigger than the default pool gets pool of its own size
+        pool.capacity[i] = std::max(POOL_SET_COUNT * POOL_DESCRIPTORS_PER_SET, minCounts[i]);
+
+        poolSizes[i].type = PoolDescriptorTypes[i];
+        poolSizes[i].descriptorCount = pool.capacity[i];
+    }
+
+    pool.descriptorCounts = pool.capacity;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = freeable ? VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT : 0;
+    poolInfo.maxSets = POOL_SET_COUNT;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+
+    mDevice->CreateDescriptorPool(&poolInfo, nullptr, &pool.pool);
+
+    return pool;
+}
+
+void VulkanDescriptorAllocator::Collect(uint64_t frameNumber)
+{
+    // Only sets dropped since the last frame are visited, they may still be bound by frames in flight
+    {
+        std::lock_guard<std::mutex> candidatesLock(mReleaseCandidates->mutex);
+        std::swap(mCollectedSets, mReleaseCandidates->sets);
+    }
+
+    for(auto& released : mCollectedSets)
+    {
+        Uncache(released.set);
+
+        released.releaseFrame = frameNumber;
+        mReleasedSets.push_back(released);
+    }
+
+    mCollectedSets.clear();
+
+    const auto releasedEnd = std::remove_if(mReleasedSets.begin(), mReleasedSets.end(), [this, frameNumber](const ReleasedSet& released){
+        if(frameNumber - released.releaseFrame < mFramesInFlight)
+            return false;
+
+        auto& pool = mPools[released.poolIndex];
+        mDevice->FreeDescriptorSets(VK_NULL_HANDLE, pool.pool, 1, &released.set);
+
+        const auto& counts = mLayoutCounts[released.layout];
+
+        pool.setCount++;
+        pool.fragmented = false;
+        for(size_t type = 0; type < counts.size(); ++type)
+        {
+            pool.descriptorCounts[type] += counts[type];
+        }
+
+        return true;
+    });
+
+    mReleasedSets.erase(releasedEnd, mReleasedSets.end());
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <Renderer/Renderer.h>
+#include <PAL/RenderAPI/Vulkan/VulkanDevice.h>
+#include <Core/Platform.h>
+
+#include "VulkanDeviceObjects.h"
+#include "VulkanStateKey.h"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Renderer
+{
+    /*!
+     @brief Allocates descriptor sets out of pools created on demand, the renderer is not limited by single pool size.
+
+     Set layouts & sets are cached by their content. Sets writing the same resources into the same layout are shared,
+     set whose last reference was dropped is freed once all frames in flight which could still bind it are finished.
+     Destroyed resources evict sets writing them from the cache, so resources reusing their handles never get stale sets.
+     Sets allocated for single frame come from per frame pools, those are reset as a whole once the frame slot is reused.
+     Allocator is thread safe.
+     */
+    class VulkanDescriptorAllocator
+    {
+    public:
+        VulkanDescriptorAllocator(std::shared_ptr<PAL::RenderAPI::VulkanDevice> device, uint32_t framesInFlight);
+        ~VulkanDescriptorAllocator();
+
+        DECLARE_NOCOPY_NOMOVE(VulkanDescriptorAllocator)
+
+        /*!
+         @brief Returns layout of the bindings, equal bindings share one layout. Layouts live as long as the allocator.
+         */
+        NO_DISCARD VkDescriptorSetLayout GetLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+
+        /*!
+         @brief Returns set of the layout with all writes applied, creates & writes the set only if no equal set exists.
+         @param writes Writes of the set, their destination set is filled by the allocator.
+         */
+        NO_DISCARD std::shared_ptr<const VulkanDescriptorSet> GetSet(VkDescriptorSetLayout layout, std::vector<VkWriteDescriptorSet>& writes);
+
+        /*!
+         @brief Allocates set valid until the current frame slot is reused, set is never shared nor cached.
+         */
+        NO_DISCARD VkDescriptorSet AllocateFrameSet(VkDescriptorSetLayout layout);
+
+        /*!
+         @brief Removes sets writing the buffer from the cache, has to be called when the buffer is destroyed.
+                Evicted sets stay valid for their holders & are freed once released.
+         */
+        void EvictBuffer(VkBuffer buffer);
+
+        /*!
+         @brief Removes sets writing the image view from the cache, has to be called when the view is destroyed.
+         */
+        void EvictImageView(VkImageView imageView);
+
+        /*!
+         @brief Resets frame pools of the slot & frees unreferenced sets, has to be called once GPU released the frame slot.
+         @param frameNumber Number of the frame being started.
+         */
+        void BeginFrame(uint32_t frameIndex, uint64_t frameNumber);
+
+    private:
+        // Descriptor types pools are sized for, other types are not supported by the renderer
+        static constexpr std::array<VkDescriptorType, 5> PoolDescriptorTypes = {
+            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+        };
+
+        using DescriptorCounts = std::array<uint32_t, PoolDescriptorTypes.size()>;
+
+        struct Pool
+        {
+            VkDescriptorPool pool{ VK_NULL_HANDLE };
+
+            DescriptorCounts capacity{};
+
+            // Remaining capacity, pool is skipped once it can't fit the set
+            uint32_t setCount{ 0 };
+            DescriptorCounts descriptorCounts{};
+
+            // Allocation failed despite remaining capacity, set freed back to the pool clears the flag
+            bool fragmented{ false };
+        };
+
+        struct CachedSet
+        {
+            // Holders own the set, expired set waits in release candidates until the next Collect
+            std::weak_ptr<const VulkanDescriptorSet> set;
+            VkDescriptorSet handle{ VK_NULL_HANDLE };
+
+            // Resources written into the set, destroying any of them evicts the set
+            std::vector<uint64_t> buffers;
+            std::vector<uint64_t> imageViews;
+        };
+
+        struct ReleasedSet
+        {
+            VkDescriptorSet set{ VK_NULL_HANDLE };
+            VkDescriptorSetLayout layout{ VK_NULL_HANDLE };
+            size_t poolIndex{ 0 };
+            uint64_t releaseFrame{ 0 };
+        };
+
+        /*!
+         @brief Sets whose last reference was dropped, filled by deleter of the set on whichever thread dropped it.
+                Shared with the deleters, so sets outliving the allocator don't touch it.
+         */
+        struct ReleaseCandidates
+        {
+            std::mutex mutex;
+            std::vector<ReleasedSet> sets;
+        };
+
+        using SetsByResource = std::unordered_map<uint64_t, std::vector<VkDescriptorSet>>;
+
+        VkDescriptorSet Allocate(std::vector<Pool>& pools, size_t firstPool, VkDescriptorSetLayout layout, bool freeable, size_t& poolIndex);
+        Pool CreatePool(const DescriptorCounts& minCounts, bool freeable) const;
+        void Collect(uint64_t frameNumber);
+
+        /*!
+         @brief Removes set from the cache & from indices of its resources, set of other than cached handle is ignored.
+         */
+        void Uncache(VkDescriptorSet set);
+        void Evict(SetsByResource& setsByResource, uint64_t resource);
+
+    private:
+        std::shared_ptr<PAL::RenderAPI::VulkanDevice> mDevice;
+        uint32_t mFramesInFlight{ 1 };
+        uint32_t mFrameIndex{ 0 };
+
+        mutable std::mutex mMutex;
+
+        std::unordered_map<StateKey, VkDescriptorSetLayout, StateKeyHash> mLayouts;
+        std::unordered_map<VkDescriptorSetLayout, DescriptorCounts> mLayoutCounts;
+
+        std::unordered_map<StateKey, CachedSet, StateKeyHash> mSets;
+        std::unordered_map<VkDescriptorSet, const StateKey*> mSetKeys;     // Keys are stable, map nodes never move
+        SetsByResource mSetsByBuffer;
+        SetsByResource mSetsByImageView;
+
+        std::shared_ptr<ReleaseCandidates> mReleaseCandidates;
+        std::vector<ReleasedSet> mCollectedSets;     // Scratch of candidates taken by Collect
+        std::vector<ReleasedSet> mReleasedSets;      // Waiting for frames in flight
+
+        // Pools of cached sets allow freeing single sets, frame pools are only reset as a whole
+        std::vector<Pool> mPools;
+        std::vector<std::vector<Pool>> mFramePools;
+        std::vector<size_t> mFramePoolUsage;  // Number of leading frame pools sets were allocated from
+
+        uint32_t mHitCount{ 0 };
+    };
+}
@@ -2,12 +2,28 @@
 
 #include <PAL/RenderAPI/Vulkan/VulkanAPI.h>
 #include <PAL/RenderAPI/Vulkan/VulkanDevice.h>
+#include <Renderer/Effect.h>
 #include <Core/Assert.h>
 
+#include "VulkanMemoryAllocator.h"
+#include "VulkanStateKey.h"
+
 #include <array>
+#include <limits>
+#include <memory>
+#include <vector>
 
 namespace Renderer
 {
+    /*!
+     @brief Descriptor set owned by descriptor allocator, shared by all effects binding the same resources.
+     */
+    struct VulkanDescriptorSet
+    {
+        VkDescriptorSet set{ VK_NULL_HANDLE };
+        VkDescriptorSetLayout layout{ VK_NULL_HANDLE };
+    };
+    
     namespace Vulkan
     {
         template<typename T>
@@ -27,12 +43,14 @@ namespace Renderer
         class DescriptorSetDeviceObject
         {
         public:
-            DescriptorSetDeviceObject(const VkDescriptorSet& ds)
-            : descriptorSet(ds)
+            explicit DescriptorSetDeviceObject(std::shared_ptr<const VulkanDescriptorSet> set)
+            : mSet(std::move(set))
             {}
             
-        public:
-            VkDescriptorSet descriptorSet{ VK_NULL_HANDLE };
+            const VkDescriptorSet& GetDescriptorSet() const { return mSet->set; }
+            
+        private:
+            std::shared_ptr<const VulkanDescriptorSet> mSet;
         };
         
         struct FenceDeviceObject
@@ -65,9 +83,6 @@ namespace Renderer
         struct SwapChainDeviceObject
         {
             MovableHandle<VkSwapchainKHR> swapChain;
-            ManagedHandle<VkSemaphore> imageAvailableSemaphore;
-            ManagedHandle<VkSemaphore> renderFinishedSemaphore;
-            ManagedHandle<VkFence> frameFence;
         };
         
         struct SurfaceDeviceObject
@@ -90,378 +105,193 @@ namespace Renderer
         VkShaderModule module{ VK_NULL_HANDLE };
     };
     
+    /*!
+     @brief Device objects of unique pipeline state, shared by all pipelines created with equal PipelineKey.
+     
+     Descriptor set layouts are owned by descriptor allocator.
+     */
+    struct VulkanPipelineState
+    {
+        VkPipeline pipeline{ VK_NULL_HANDLE };
+        VkPipelineLayout layout{ VK_NULL_HANDLE };
+        VkPipelineBindPoint bindPoint{ VK_PIPELINE_BIND_POINT_GRAPHICS };
+        
+        std::array<VkDescriptorSetLayout, Effect::DescriptorSetCount> setLayouts{};
+        uint32_t setCount{ 0 };
+        
+        /*!
+         @brief Push constant ranges followed by set layouts, layouts are compatible for set N if the words up to its layout are equal.
+                Equal set layouts share one handle, see VulkanDescriptorAllocator::GetLayout.
+         */
+        std::vector<uint64_t> compatibility;
+        
+        /*!
+         @brief Appends words of push constant ranges & of the first layoutCount set layouts, zero layouts for push constants.
+         */
+        void AppendCompatibility(StateKey& key, uint32_t layoutCount) const
+        {
+            _ASSERT(layoutCount <= setCount);
+            
+            const size_t wordCount = compatibility.size() - setCount + layoutCount;
+            for(size_t i = 0; i < wordCount; ++i)
+            {
+                key.Append(compatibility[i]);
+            }
+        }
+    };
+    
     class PipelineDeviceObject
     {
     public:
-        PipelineDeviceObject(const VkPipeline& pipeline, const VkPipelineLayout& layout)
-            : mPipeline(pipeline)
-            , mPipelineLayout(layout)
+        explicit PipelineDeviceObject(std::shared_ptr<const VulkanPipelineState> state)
+            : mState(std::move(state))
         {}
         
-        const VkPipeline& GetPipeline() const { return mPipeline; }
-        const VkPipelineLayout& GetPipelineLayout() const { return mPipelineLayout; }
+        const VkPipeline& GetPipeline() const { return mState->pipeline; }
+        const VkPipelineLayout& GetPipelineLayout() const { return mState->layout; }
+        const VulkanPipelineState& GetState() const { return *mState; }
         
     private:
-        VkPipeline mPipeline{ VK_NULL_HANDLE };
-        VkPipelineLayout mPipelineLayout{ VK_NULL_HANDLE };
+        std::shared_ptr<const VulkanPipelineState> mState;
     };
     
     class BufferDeviceObject
     {
     public:
         BufferDeviceObject() = default;
-        BufferDeviceObject(const VkBuffer& b, const VkDeviceMemory& m)
+        BufferDeviceObject(const VkBuffer& b, const VulkanAllocation& a)
             : buffer(b)
-            , memory(m)
+            , allocation(a)
         {}
         
     public:
         VkBuffer buffer{ VK_NULL_HANDLE };
-        VkDeviceMemory memory{ VK_NULL_HANDLE };
-        void* mappedMemory{ nullptr };
+        VulkanAllocation allocation;
     };
     
     class ImageDeviceObject
     {
     public:
         ImageDeviceObject() = default;
-        ImageDeviceObject(const VkImage& img, const VkDeviceMemory& mem) : image(img), memory(mem) {}
+        ImageDeviceObject(const VkImage& img, const VulkanAllocation& alloc) : image(img), allocation(alloc) {}
         
     public:
         VkImage image{ VK_NULL_HANDLE };
-        VkDeviceMemory memory{ VK_NULL_HANDLE };
+        VulkanAllocation allocation;
     };
     
     class VulkanAttachmentDeviceObject
     {
     public:
-        VulkanAttachmentDeviceObject(const VkImage& img, const VkDeviceMemory& mem, const VkImageView& imgView)
-            : image(img), memory(mem), view(imgView)
+        VulkanAttachmentDeviceObject(const VkImage& img, const VulkanAllocation& alloc, const VkImageView& imgView)
+            : image(img), allocation(alloc), view(imgView)
         {}
         
     public:
         VkImage image{ VK_NULL_HANDLE };
-        VkDeviceMemory memory{ VK_NULL_HANDLE };
+        VulkanAllocation allocation;
         VkImageView view{ VK_NULL_HANDLE };
     };
     
-    class TextureDeviceObject
-    {
-    public:
-        TextureDeviceObject() = default;
-        TextureDeviceObject(const VkImage& img, const VkImageView& view, const VkDeviceMemory& mem, const VkSampler& s) : image(img), imageView(view), memory(mem), sampler(s)
-        {
-            
-        }
-        
-    public:
-        VkImage image{ VK_NULL_HANDLE };
-        VkImageView imageView{ VK_NULL_HANDLE };
-        VkDeviceMemory memory{ VK_NULL_HANDLE };
-        VkSampler sampler{ VK_NULL_HANDLE };
-    };
-    
-    class DeviceObjectVisitorBase : public IDeviceObjectVisitor
-    {
-    public:
-        void Visit(const VulkanShaderDeviceObject& object) override {}
-        void Visit(const VulkanRenderPassDeviceObject& object) override {}
-        void Visit(const PipelineDeviceObject& object) override {}
-        void Visit(const BufferDeviceObject& object) override {}
-        void Visit(const TextureDeviceObject& object) override {}
-        void Visit(const VulkanAttachmentDeviceObject& object) override {}
-        void Visit(const Vulkan::FramebufferDeviceObject& object) override {}
-        void Visit(const Vulkan::SurfaceDeviceObject& object) override {}
-        void Visit(const Vulkan::SwapChainDeviceObject& object) override {}
-        void Visit(const Vulkan::DescriptorSetLayoutDeviceObject& object) override{}
-        void Visit(const Vulkan::DescriptorSetDeviceObject& object) override{}
-        void Visit(const Vulkan::SemaphoreDeviceObject& object) override{}
-        void Visit(const Vulkan::FenceDeviceObject& object) override{}
-        void Visit(const Vulkan::EventDeviceObject& object) override{}
-        void Visit(const Vulkan::RenderPassDeviceObject& object) override{}
-        void Visit(const Vulkan::CommandBufferDeviceObject& object) override{}
-        void Visit(const Vulkan::FrameSyncDeviceObject& object) override{}
-    };
-    
-    class MutableDeviceObjectVisitorBase : public IMutableDeviceObjectVisitor
-    {
-    public:
-        void Visit(VulkanShaderDeviceObject& object) override {}
-        void Visit(VulkanRenderPassDeviceObject& object) override {}
-        void Visit(PipelineDeviceObject& object) override {}
-        void Visit(BufferDeviceObject& object) override {}
-        void Visit(TextureDeviceObject& object) override {}
-        void Visit(VulkanAttachmentDeviceObject& object) override {}
-        void Visit(Vulkan::FramebufferDeviceObject& object) override {}
-        void Visit(Vulkan::SurfaceDeviceObject& object) override {}
-        void Visit(Vulkan::SwapChainDeviceObject& object) override {}
-        void Visit(Vulkan::DescriptorSetLayoutDeviceObject& object) override{}
-        void Visit(Vulkan::DescriptorSetDeviceObject& object) override{}
-        void Visit(Vulkan::SemaphoreDeviceObject& object) override{}
-        void Visit(Vulkan::FenceDeviceObject& object) override{}
-        void Visit(Vulkan::EventDeviceObject& object) override{}
-        void Visit(Vulkan::RenderPassDeviceObject& object) override{}
-        void Visit(Vulkan::CommandBufferDeviceObject& object) override{}
-        void Visit(Vulkan::FrameSyncDeviceObject& object) override{}
-    };
-    
-    class DeviceObjectCounterVisitorBase : public IDeviceObjectVisitor
-    {
-    public:
-        void Visit(const VulkanShaderDeviceObject& object) override {}
-        void Visit(const VulkanRenderPassDeviceObject& object) override {}
-        void Visit(const PipelineDeviceObject& object) override { ++buffers; }
-        void Visit(const BufferDeviceObject& object) override { ++pipelines; }
-        void Visit(const TextureDeviceObject& object) override {}
-        void Visit(const VulkanAttachmentDeviceObject& object) override {}
-        void Visit(const Vulkan::FramebufferDeviceObject& object) override {}
-        void Visit(const Vulkan::SurfaceDeviceObject& object) override {}
-        void Visit(const Vulkan::SwapChainDeviceObject& object) override {}
-        void Visit(const Vulkan::DescriptorSetLayoutDeviceObject& object) override{}
-        void Visit(const Vulkan::DescriptorSetDeviceObject& object) override {}
-        void Visit(const Vulkan::SemaphoreDeviceObject& object) override{}
-        void Visit(const Vulkan::FenceDeviceObject& object) override{}
-        void Visit(const Vulkan::EventDeviceObject& object) override{}
-        void Visit(const Vulkan::RenderPassDeviceObject& object) override{}
-        void Visit(const Vulkan::CommandBufferDeviceObject& object) override{}
-        void Visit(const Vulkan::FrameSyncDeviceObject& object) override{}
-        
-    public:
-        uint16_t buffers{ 0 };
-        uint16_t pipelines{ 0 };
-        uint16_t images{ 0 };
-        uint16_t imageViews{ 0 };
-        uint16_t framebuffers{ 0 };
-    };
-    
-    class SurfaceVisitor : public DeviceObjectVisitorBase
-    {
-    public:
-        void Visit(const Vulkan::SurfaceDeviceObject& object) override
-        {
-            surface = object.surface.Get();
-        }
-        
-    public:
-        VkSurfaceKHR surface{ VK_NULL_HANDLE };
-    };
-    
-    class PipelineObjectVisitor : public DeviceObjectVisitorBase
-    {
-    public:
-        void Visit(const PipelineDeviceObject& object) override
-        {
-            pipeline = object.GetPipeline();
-            layout = object.GetPipelineLayout();
-        }
-        
-    public:
-        VkPipeline pipeline{ VK_NULL_HANDLE };
-        VkPipelineLayout layout{ VK_NULL_HANDLE };
-    };
-    
-    class BufferObjectVisitor : public DeviceObjectVisitorBase
-    {
-    public:
-        void Visit(const BufferDeviceObject& object) override
-        {
-            buffer = object.buffer;
-            memory = object.memory;
-        }
-        
-    public:
-        VkBuffer buffer{ VK_NULL_HANDLE };
-        VkDeviceMemory memory{ VK_NULL_HANDLE };
-    };
-    
-    class RenderPassVisitor : public DeviceObjectVisitorBase
-    {
-    public:
-        void Visit(const Vulkan::RenderPassDeviceObject& object) override
-        {
-            renderPass = object.renderPass.Get();
-        }
-        
-    public:
-        VkRenderPass renderPass{ VK_NULL_HANDLE };;
-    };
-    
-    class FramebufferObjectVisitor : public DeviceObjectVisitorBase
-    {
-    public:
-        void Visit(const Vulkan::FramebufferDeviceObject& object) override
-        {
-            framebuffer = object.framebuffer.Get();
-        }
-        
-    public:
-        VkFramebuffer framebuffer{ VK_NULL_HANDLE };
-    };
-    
-    class VulkanSwapChainVisitor : public DeviceObjectVisitorBase
-    {
-    public:
-        void Visit(const Vulkan::SwapChainDeviceObject& object) override
-        {
-            swapChain = object.swapChain.Get();
-            imgAvailableSemaphore = object.imageAvailableSemaphore.Get();
-            renderFinishedSemaphore = object.renderFinishedSemaphore.Get();
-            frameFence = object.frameFence.Get();
-        }
-        
-    public:
-        VkSwapchainKHR swapChain{ VK_NULL_HANDLE };
-        VkSemaphore imgAvailableSemaphore{ VK_NULL_HANDLE };
-        VkSemaphore renderFinishedSemaphore{ VK_NULL_HANDLE };
-        VkFence frameFence{ VK_NULL_HANDLE };
-    };
-    
-    class DescriptorSetVisitor : public DeviceObjectVisitorBase
-    {
-    public:
-        void Visit(const Vulkan::DescriptorSetDeviceObject& object) override
-        {
-            descriptorSet = object.descriptorSet;
-        }
-        
-    public:
-        VkDescriptorSet descriptorSet{ VK_NULL_HANDLE };
-    };
-    
-    class DescriptorSetLayoutVisitor : public DeviceObjectVisitorBase
+    /*!
+     @brief Device memory placed attachments are bound to, images of the heap have to be destroyed first.
+     */
+    struct VulkanMemoryHeapDeviceObject
     {
-    public:
-        void Visit(const Vulkan::DescriptorSetLayoutDeviceObject& object) override
-        {
-            descriptorSetLayout = object.descriptorSetLayout;
-        }
-        
-    public:
-        VkDescriptorSetLayout descriptorSetLayout{ VK_NULL_HANDLE };
-    };
-    
-    class MemoryMapVisitor : public DeviceObjectVisitorBase
-    {
-    public:
-        void Visit(const BufferDeviceObject& object) override
-        {
-            memory = object.memory;
-        }
-        
-        void Visit(const TextureDeviceObject& object) override
-        {
-            memory = object.memory;
-        }
-        
-    public:
-        VkDeviceMemory memory{ VK_NULL_HANDLE };
+        VulkanAllocation allocation;
     };
     
-    class AttachableVisitor : public DeviceObjectVisitorBase
+    class TextureDeviceObject
     {
     public:
-        void Visit(const TextureDeviceObject& object) override
-        {
-            imageView = object.imageView;
-            sampler = object.sampler;
-        }
+        static constexpr uint32_t NoBindlessIndex = std::numeric_limits<uint32_t>::max();
         
-        void Visit(const VulkanAttachmentDeviceObject& object) override
+        TextureDeviceObject() = default;
+        TextureDeviceObject(const VkImage& img, const VkImageView& view, const VulkanAllocation& alloc, const VkSampler& s) : image(img), imageView(view), allocation(alloc), sampler(s)
         {
-            imageView = object.view;
-            sampler = VK_NULL_HANDLE;
+            
         }
         
     public:
+        VkImage image{ VK_NULL_HANDLE };
         VkImageView imageView{ VK_NULL_HANDLE };
+        VulkanAllocation allocation;
         VkSampler sampler{ VK_NULL_HANDLE };
-    };
-    
-    class CommandBufferVisitor : public DeviceObjectVisitorBase
-    {
-    public:
-        void Visit(const Vulkan::CommandBufferDeviceObject& object) override
-        {
-            commandBuffer = object.commandBuffer;
-        }
-        
-    public:
-        VkCommandBuffer commandBuffer{ VK_NULL_HANDLE };
-    };
-    
-    class FrameSyncVisitor : public DeviceObjectVisitorBase
-    {
-    public:
-        void Visit(const Vulkan::FrameSyncDeviceObject& object) override
-        {
-            imgAvailableSemaphore = object.imageAvailableSemaphore.Get();
-            renderFinishedSemaphore = object.renderFinishedSemaphore.Get();
-            frameFence = object.frameFence.Get();
-        }
         
-    public:
-        VkSemaphore imgAvailableSemaphore;
-        VkSemaphore renderFinishedSemaphore;
-        VkFence frameFence;
+        // Slots in the bindless table, texture isn't in the table if the device doesn't support it
+        uint32_t bindlessIndex{ NoBindlessIndex };
+        uint32_t samplerIndex{ NoBindlessIndex };
     };
     
-    class AttachmentVisitor : public DeviceObjectVisitorBase
+    /*!
+     @brief Destroys device objects of resources removed from resource tables.
+     */
+    class DeviceObjectDestroyer
     {
     public:
-        void Visit(const VulkanAttachmentDeviceObject& object) override
-        {
-            image = object.image;
-            memory = object.memory;
-            view = object.view;
-        }
-        
-    public:
-        VkImage image{ VK_NULL_HANDLE };
-        VkDeviceMemory memory{ VK_NULL_HANDLE };
-        VkImageView view{ VK_NULL_HANDLE };
-    };
-    
-    class DestroyVisitor : public MutableDeviceObjectVisitorBase
-    {
-    public:
-        explicit DestroyVisitor(std::shared_ptr<PAL::RenderAPI::VulkanDevice> device)
+        /*!
+         @param allocator Allocator memory of resources was allocated from, may be null for objects without memory.
+         */
+        explicit DeviceObjectDestroyer(std::shared_ptr<PAL::RenderAPI::VulkanDevice> device, std::shared_ptr<VulkanMemoryAllocator> allocator = nullptr)
             : mDevice(std::move(device))
+            , mAllocator(std::move(allocator))
         {}
         
-        void Visit(BufferDeviceObject& object) override
+        void Destroy(BufferDeviceObject& object) const
         {
             _ASSERT(object.buffer != VK_NULL_HANDLE);
-            _ASSERT(object.memory != VK_NULL_HANDLE);
-            
-            if(object.mappedMemory)
-            {
-                mDevice->UnmapMemory(object.memory);
-            }
+            _ASSERT(object.allocation.memory != VK_NULL_HANDLE);
+            _ASSERT(mAllocator);
             
             mDevice->DestroyBuffer(object.buffer, nullptr);
-            mDevice->FreeMemory(object.memory, nullptr);
+            mAllocator->Free(object.allocation);
             
             object.buffer = VK_NULL_HANDLE;
-            object.memory = VK_NULL_HANDLE;
-            object.mappedMemory = nullptr;
         }
         
-        void Visit(VulkanAttachmentDeviceObject& object) override
+        void Destroy(VulkanAttachmentDeviceObject& object) const
         {
             _ASSERT(object.image != VK_NULL_HANDLE);
             _ASSERT(object.view != VK_NULL_HANDLE);
-            _ASSERT(object.memory != VK_NULL_HANDLE);
             
             mDevice->DestroyImage(object.image, nullptr);
             mDevice->DestroyImageView(object.view, nullptr);
-            mDevice->FreeMemory(object.memory, nullptr);
+            
+            // Placed attachments have no allocation, their memory belongs to the heap
+            if(object.allocation.memory != VK_NULL_HANDLE)
+            {
+                _ASSERT(mAllocator);
+                mAllocator->Free(object.allocation);
+            }
             
             object.image = VK_NULL_HANDLE;
             object.view = VK_NULL_HANDLE;
-            object.memory = VK_NULL_HANDLE;
         }
         
-        void Visit(Vulkan::SwapChainDeviceObject& object) override
+        void Destroy(TextureDeviceObject& object) const
+        {
+            _ASSERT(object.image != VK_NULL_HANDLE);
+            _ASSERT(object.imageView != VK_NULL_HANDLE);
+            _ASSERT(mAllocator);
+        
+            // Samplers are shared by textures & owned by the renderer
+            mDevice->DestroyImageView(object.imageView, nullptr);
+            mDevice->DestroyImage(object.image, nullptr);
+            mAllocator->Free(object.allocation);
+        
+            object.image = VK_NULL_HANDLE;
+            object.imageView = VK_NULL_HANDLE;
+        }
+        
+        void Destroy(VulkanMemoryHeapDeviceObject& object) const
+        {
+            _ASSERT(object.allocation.memory != VK_NULL_HANDLE);
+            _ASSERT(mAllocator);
+            
+            mAllocator->Free(object.allocation);
+        }
+        
+        void Destroy(Vulkan::SwapChainDeviceObject& object) const
         {
             auto& swapChainHandle = object.swapChain.Get();
             
@@ -473,5 +303,6 @@ namespace Renderer
         
     private:
         std::shared_ptr<PAL::RenderAPI::VulkanDevice> mDevice;
+        std::shared_ptr<VulkanMemoryAllocator> mAllocator;
     };
 }
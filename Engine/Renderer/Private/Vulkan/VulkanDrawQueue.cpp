@@ -0,0 +1,130 @@
+#include "VulkanDrawQueue.h"
+
+#include <Renderer/Renderer.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+using namespace Renderer;
+
+namespace
+{
+    // Key fields from the most significant bits
+    constexpr uint32_t PASS_BITS = 8;
+    constexpr uint32_t PIPELINE_BITS = 20;
+    constexpr uint32_t MATERIAL_BITS = 20;
+    constexpr uint32_t DEPTH_BITS = 16;
+
+    static_assert(PASS_BITS + PIPELINE_BITS + MATERIAL_BITS + DEPTH_BITS == 64, "Key fields don't fill the key");
+
+    // Keys are sorted one byte per pass, passes over bytes shared by all keys are skipped
+    constexpr uint32_t RADIX_BITS = 8;
+    constexpr uint32_t RADIX_SIZE = 1 << RADIX_BITS;
+    constexpr uint32_t RADIX_PASSES = 64 / RADIX_BITS;
+
+    // Histograms don't pay off for few draws
+    constexpr size_t RADIX_MIN_COUNT = 64;
+
+    uint64_t Fold(uint64_t identity, uint32_t bits)
+    {
+        // Handles & digests differ mostly in low bits, hash spreads them over the kept high bits
+        return PipelineKey::Digest(&identity, sizeof(identity)) >> (64 - bits);
+    }
+
+    uint64_t GetDepthBucket(float depth)
+    {
+        // Bits of non-negative float order as unsigned integer, the top ones are exponent & leading mantissa bits
+        uint32_t bits{ 0 };
+        const float clampedDepth = std::max(depth, 0.0f);
+        std::memcpy(&bits, &clampedDepth, sizeof(bits));
+
+        return bits >> (32 - DEPTH_BITS);
+    }
+
+    uint64_t PackKey(uint32_t pass, uint64_t pipeline, uint64_t material, uint64_t depthBucket)
+    {
+        uint64_t key = pass & ((1u << PASS_BITS) - 1);
+        key = (key << PIPELINE_BITS) | Fold(pipeline, PIPELINE_BITS);
+        key = (key << MATERIAL_BITS) | Fold(material, MATERIAL_BITS);
+        key = (key << DEPTH_BITS) | depthBucket;
+
+        return key;
+    }
+}
+
+uint64_t VulkanDrawQueue::MakeKey(uint32_t pass, uint64_t pipeline, uint64_t material, float depth)
+{
+    return PackKey(pass, pipeline, material, GetDepthBucket(depth));
+}
+
+uint64_t VulkanDrawQueue::MakeInstancedKey(uint32_t pass, uint64_t pipeline, uint64_t material, uint64_t mesh)
+{
+    return PackKey(pass, pipeline, material, Fold(mesh, DEPTH_BITS));
+}
+
+uint32_t VulkanDrawQueue::Push(uint64_t key)
+{
+    const auto index = static_cast<uint32_t>(mEntries.size());
+    mEntries.push_back({ key, index });
+
+    return index;
+}
+
+const std::vector<VulkanDrawQueue::Entry>& VulkanDrawQueue::Sort()
+{
+    const size_t count = mEntries.size();
+
+    if(count < RADIX_MIN_COUNT)
+    {
+        std::stable_sort(mEntries.begin(), mEntries.end(), [](const Entry& a, const Entry& b){
+            return a.key < b.key;
+        });
+
+        return mEntries;
+    }
+
+    // Histograms of all bytes are gathered by single read of the keys
+    std::array<std::array<uint32_t, RADIX_SIZE>, RADIX_PASSES> histograms{};
+    for(const auto& entry : mEntries)
+    {
+        for(uint32_t pass = 0; pass < RADIX_PASSES; ++pass)
+        {
+            ++histograms[pass][(entry.key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)];
+        }
+    }
+
+    mScratch.resize(count);
+
+    // Least significant byte first, every pass is stable so order of the previous passes is kept
+    for(uint32_t pass = 0; pass < RADIX_PASSES; ++pass)
+    {
+        const uint32_t shift = pass * RADIX_BITS;
+        auto& histogram = histograms[pass];
+
+        if(histogram[(mEntries.front().key >> shift) & (RADIX_SIZE - 1)] == count)
+            continue;
+
+        uint32_t offset{ 0 };
+        for(auto& bucket : histogram)
+        {
+            const uint32_t bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+
+        for(const auto& entry : mEntries)
+        {
+            mScratch[histogram[(entry.key >> shift) & (RADIX_SIZE - 1)]++] = entry;
+        }
+
+        mEntries.swap(mScratch);
+    }
+
+    return mEntries;
+}
+
+void VulkanDrawQueue::Clear()
+{
+    mEntries.clear();
+}
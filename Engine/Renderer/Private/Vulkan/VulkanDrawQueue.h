@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Core/Platform.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace Renderer
+{
+    /*!
+     @brief Sort keys of draws submitted to one pass, radix sorted before the draws are recorded.
+
+     Key packs pass, pipeline, material & depth bucket from the most significant bits, so sorted draws are grouped by
+     the state most expensive to change and draws of equal state go front to back. Sort is stable, draws of equal keys
+     keep submission order. Payloads of draws are kept by the caller, queue only orders their indices.
+     */
+    class VulkanDrawQueue
+    {
+    public:
+        struct Entry
+        {
+            uint64_t key{ 0 };
+            uint32_t index{ 0 };
+        };
+
+        /*!
+         @param pass Pass of the draw, only its low bits are kept.
+         @param pipeline Identity of the pipeline, folded into key bits so different pipelines may share a value.
+         @param material Identity of the material, folded into key bits so different materials may share a value.
+         @param depth Distance of the draw from the camera, negative distances share the nearest bucket.
+         */
+        NO_DISCARD static uint64_t MakeKey(uint32_t pass, uint64_t pipeline, uint64_t material, float depth);
+
+        /*!
+         @brief Key of draw merged with draws of the same mesh into one instanced draw, identity of the mesh takes place
+                of the depth bucket so those draws end up next to each other.
+         */
+        NO_DISCARD static uint64_t MakeInstancedKey(uint32_t pass, uint64_t pipeline, uint64_t material, uint64_t mesh);
+
+        /*!
+         @return Index of the draw, caller stores payload of the draw at this index.
+         */
+        uint32_t Push(uint64_t key);
+
+        /*!
+         @brief Sorts draws pushed so far by their keys.
+         @return Entries in key order, valid until next Push or Clear.
+         */
+        const std::vector<Entry>& Sort();
+
+        void Clear();
+
+        NO_DISCARD bool IsEmpty() const noexcept { return mEntries.empty(); }
+
+    private:
+        std::vector<Entry> mEntries;
+        std::vector<Entry> mScratch;
+    };
+}
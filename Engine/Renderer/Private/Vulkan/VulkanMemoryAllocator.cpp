@@ -0,0 +1,377 @@
+#include "VulkanMemoryAllocator.h"
+
+#include <PAL/RenderAPI/Vulkan/VulkanAPI.h>
+#include <Logging/LoggingService.h>
+#include <Core/Assert.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef LOG_MODULE_ID
+#undef LOG_MODULE_ID
+#endif
+
+#define LOG_MODULE_ID LOG_MODULE_4BYTE('V','K','M','A')
+
+using namespace Renderer;
+using namespace PAL::RenderAPI;
+
+namespace
+{
+    constexpr VkDeviceSize BLOCK_SIZE = 64 * 1024 * 1024;
+
+    // Heaps up to this size (integrated GPUs, host visible BAR) are split to more blocks than the block size would give
+    constexpr VkDeviceSize SMALL_HEAP_SIZE = 1024 * 1024 * 1024;
+    constexpr VkDeviceSize SMALL_HEAP_BLOCK_COUNT = 8;
+
+    VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+namespace Renderer
+{
+    struct VulkanMemoryBlock
+    {
+        VulkanMemoryBlock(VkDeviceMemory m, VkDeviceSize size, void* data, uint32_t pool)
+            : memory(m)
+            , mappedData(static_cast<uint8_t*>(data))
+            , allocator(size)
+            , poolIndex(pool)
+        {}
+
+        VkDeviceMemory memory{ VK_NULL_HANDLE };
+        uint8_t* mappedData{ nullptr };
+        TlsfAllocator allocator;
+        uint32_t poolIndex{ 0 };
+    };
+}
+
+VulkanMemoryAllocator::VulkanMemoryAllocator(std::shared_ptr<VulkanDevice> device)
+    : mDevice(std::move(device))
+{
+    const auto& vulkanAPI = VulkanAPI::Service();
+
+    // Properties never change for the device, queried once instead of every allocation
+    vulkanAPI.GetPhysicalDeviceMemoryProperties(mDevice->GetPhysicalDevice(), &mMemoryProperties);
+
+    const auto deviceProperties = vulkanAPI.GetPhysicalDeviceProperties(mDevice->GetPhysicalDevice());
+    mBufferImageGranularity = std::max<VkDeviceSize>(deviceProperties.limits.bufferImageGranularity, 1);
+    mNonCoherentAtomSize = std::max<VkDeviceSize>(deviceProperties.limits.nonCoherentAtomSize, 1);
+
+    mPools.resize(mMemoryProperties.memoryTypeCount * 2);
+    for(uint32_t i = 0; i < mPools.size(); ++i)
+    {
+        mPools[i].memoryTypeIndex = i / 2;
+        mPools[i].kind = static_cast<VulkanResourceKind>(i % 2);
+    }
+
+    LOG(Information) << "Memory allocator: " << mMemoryProperties.memoryTypeCount << " memory types, buffer image granularity: " << mBufferImageGranularity;
+}
+
+VulkanMemoryAllocator::~VulkanMemoryAllocator()
+{
+    const auto statistics = GetStatistics();
+    if(statistics.allocationCount > 0)
+    {
+        LOG(Warning) << "Memory allocator destroyed with " << statistics.allocationCount << " live allocations";
+    }
+
+    for(auto& pool : mPools)
+    {
+        for(auto& block : pool.blocks)
+        {
+            FreeDeviceMemory(block->memory, block->mappedData != nullptr);
+        }
+    }
+}
+
+uint32_t VulkanMemoryAllocator::FindMemoryTypeIndex(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
+{
+    for(uint32_t i = 0; i < mMemoryProperties.memoryTypeCount; ++i)
+    {
+        if((typeFilter & (1 << i)) && (mMemoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+        {
+            return i;
+        }
+    }
+
+    throw std::runtime_error("No memory type matches required properties!");
+}
+
+VulkanAllocation VulkanMemoryAllocator::Allocate(const VkMemoryRequirements& requirements,
+                                                 VkMemoryPropertyFlags properties,
+                                                 VulkanResourceKind kind,
+                                                 void* userData)
+{
+    const uint32_t memoryTypeIndex = FindMemoryTypeIndex(requirements.memoryTypeBits, properties);
+    const VkDeviceSize blockSize = GetBlockSize(memoryTypeIndex);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    VulkanAllocation allocation;
+
+    // Large resources would leave most of a block unusable, they get their own memory
+    if(requirements.size > blockSize / 2)
+    {
+        allocation.memory = AllocateDeviceMemory(requirements.size, memoryTypeIndex, &allocation.mappedData);
+        allocation.size = requirements.size;
+        allocation.memoryTypeIndex = memoryTypeIndex;
+
+        ++mDedicatedAllocationCount;
+        mDedicatedBytes += requirements.size;
+
+        return allocation;
+    }
+
+    auto& pool = GetPool(memoryTypeIndex, kind);
+
+    for(auto& block : pool.blocks)
+    {
+        if(TryAllocate(*block, requirements.size, requirements.alignment, userData, allocation))
+            return allocation;
+    }
+
+    void* mappedData{ nullptr };
+    const VkDeviceMemory memory = AllocateDeviceMemory(blockSize, memoryTypeIndex, &mappedData);
+
+    pool.blocks.push_back(std::make_unique<VulkanMemoryBlock>(memory, blockSize, mappedData, static_cast<uint32_t>(&pool - mPools.data())));
+
+    const bool allocated = TryAllocate(*pool.blocks.back(), requirements.size, requirements.alignment, userData, allocation);
+    _ASSERT(allocated && "Allocation has to fit into empty block");
+
+    return allocation;
+}
+
+void VulkanMemoryAllocator::Free(VulkanAllocation& allocation)
+{
+    if(allocation.memory == VK_NULL_HANDLE)
+        return;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    FreeLocked(allocation);
+}
+
+void VulkanMemoryAllocator::FreeLocked(VulkanAllocation& allocation)
+{
+    if(!allocation.block)
+    {
+        FreeDeviceMemory(allocation.memory, allocation.mappedData != nullptr);
+
+        --mDedicatedAllocationCount;
+        mDedicatedBytes -= allocation.size;
+    }
+    else
+    {
+        auto& block = *allocation.block;
+        block.allocator.Free(allocation.node);
+
+        // One empty block per pool is kept, so resources created & destroyed every frame don't reallocate it
+        auto& blocks = mPools[block.poolIndex].blocks;
+        if(block.allocator.IsEmpty() && blocks.size() > 1)
+        {
+            FreeDeviceMemory(block.memory, block.mappedData != nullptr);
+
+            blocks.erase(std::find_if(blocks.begin(), blocks.end(), [&block](const auto& b) {
+                return b.get() == &block;
+            }));
+        }
+    }
+
+    allocation = VulkanAllocation{};
+}
+
+void VulkanMemoryAllocator::Flush(const VulkanAllocation& allocation, VkDeviceSize offset, VkDeviceSize size) const
+{
+    if(mMemoryProperties.memoryTypes[allocation.memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+        return;
+
+    // Flushed range has to be aligned to atom size, neighbouring ranges are flushed along which is harmless
+    const VkDeviceSize begin = (allocation.offset + offset) / mNonCoherentAtomSize * mNonCoherentAtomSize;
+    const VkDeviceSize end = AlignUp(allocation.offset + offset + size, mNonCoherentAtomSize);
+    const VkDeviceSize memorySize = allocation.block ? allocation.block->allocator.GetSize() : allocation.size;
+
+    VkMappedMemoryRange mappedRange{};
+    mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    mappedRange.memory = allocation.memory;
+    mappedRange.offset = begin;
+    mappedRange.size = end < memorySize ? end - begin : VK_WHOLE_SIZE;
+
+    mDevice->FlushMappedMemoryRanges(1, &mappedRange);
+}
+
+std::vector<VulkanDefragmentationMove> VulkanMemoryAllocator::BeginDefragmentation(VkDeviceSize maxBytes)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    std::vector<VulkanDefragmentationMove> moves;
+    VkDeviceSize movedBytes{ 0 };
+
+    for(auto& pool : mPools)
+    {
+        if(pool.blocks.size() < 2)
+            continue;
+
+        // Empty block kept by the pool has nothing to move
+        const auto sourceIt = std::min_element(pool.blocks.begin(), pool.blocks.end(), [](const auto& a, const auto& b) {
+            return !a->allocator.IsEmpty() && (b->allocator.IsEmpty() || a->allocator.GetUsedSize() < b->allocator.GetUsedSize());
+        });
+
+        auto& source = **sourceIt;
+        if(source.allocator.IsEmpty())
+            continue;
+
+        // Moving only part of the block wouldn't release any memory
+        if(movedBytes + source.allocator.GetUsedSize() > maxBytes)
+            continue;
+
+        const size_t firstMove = moves.size();
+        bool planned = true;
+
+        source.allocator.ForEachAllocation([&](TlsfAllocator::NodeIndex node) {
+            if(!planned)
+                return;
+
+            VulkanDefragmentationMove move;
+            move.source.memory = source.memory;
+            move.source.offset = source.allocator.GetOffset(node);
+            move.source.size = source.allocator.GetSize(node);
+            move.source.mappedData = source.mappedData ? source.mappedData + move.source.offset : nullptr;
+            move.source.block = &source;
+            move.source.node = node;
+            move.source.memoryTypeIndex = pool.memoryTypeIndex;
+            move.userData = source.allocator.GetUserData(node);
+
+            const VkDeviceSize alignment = source.allocator.GetAlignment(node);
+
+            for(auto& block : pool.blocks)
+            {
+                if(block.get() != &source && TryAllocate(*block, move.source.size, alignment, move.userData, move.destination))
+                {
+                    moves.push_back(move);
+                    return;
+                }
+            }
+
+            planned = false;
+        });
+
+        if(!planned)
+        {
+            // Rest of the pool is too full, nothing is moved rather than leaving the block half used
+            for(size_t i = firstMove; i < moves.size(); ++i)
+            {
+                FreeLocked(moves[i].destination);
+            }
+
+            moves.resize(firstMove);
+            continue;
+        }
+
+        movedBytes += source.allocator.GetUsedSize();
+    }
+
+    return moves;
+}
+
+void VulkanMemoryAllocator::EndDefragmentation(const std::vector<VulkanDefragmentationMove>& moves)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    for(auto move : moves)
+    {
+        FreeLocked(move.source);
+    }
+}
+
+MemoryStatistics VulkanMemoryAllocator::GetStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    MemoryStatistics statistics;
+    statistics.dedicatedAllocationCount = mDedicatedAllocationCount;
+    statistics.allocationCount = mDedicatedAllocationCount;
+    statistics.reservedBytes = mDedicatedBytes;
+    statistics.usedBytes = mDedicatedBytes;
+
+    for(const auto& pool : mPools)
+    {
+        for(const auto& block : pool.blocks)
+        {
+            ++statistics.blockCount;
+            statistics.allocationCount += block->allocator.GetAllocationCount();
+            statistics.freeRangeCount += block->allocator.GetFreeRangeCount();
+            statistics.reservedBytes += block->allocator.GetSize();
+            statistics.usedBytes += block->allocator.GetUsedSize();
+        }
+    }
+
+    return statistics;
+}
+
+VulkanMemoryAllocator::Pool& VulkanMemoryAllocator::GetPool(uint32_t memoryTypeIndex, VulkanResourceKind kind)
+{
+    // Without granularity requirement linear & optimal resources may be neighbours
+    if(mBufferImageGranularity == 1)
+        kind = VulkanResourceKind::Linear;
+
+    return mPools[memoryTypeIndex * 2 + static_cast<uint32_t>(kind)];
+}
+
+VkDeviceSize VulkanMemoryAllocator::GetBlockSize(uint32_t memoryTypeIndex) const
+{
+    const auto heapIndex = mMemoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+    const VkDeviceSize heapSize = mMemoryProperties.memoryHeaps[heapIndex].size;
+
+    return heapSize <= SMALL_HEAP_SIZE ? heapSize / SMALL_HEAP_BLOCK_COUNT : BLOCK_SIZE;
+}
+
+VkDeviceMemory VulkanMemoryAllocator::AllocateDeviceMemory(VkDeviceSize size, uint32_t memoryTypeIndex, void** mappedData)
+{
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    VkDeviceMemory memory{ VK_NULL_HANDLE };
+    if(mDevice->AllocateMemory(&allocInfo, nullptr, &memory) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to allocate device memory!");
+    }
+
+    // Host visible memory is mapped once, resources only offset the block address
+    if(mMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        mDevice->MapMemory(memory, 0, VK_WHOLE_SIZE, 0, mappedData);
+    }
+
+    return memory;
+}
+
+void VulkanMemoryAllocator::FreeDeviceMemory(VkDeviceMemory memory, bool mapped)
+{
+    if(mapped)
+    {
+        mDevice->UnmapMemory(memory);
+    }
+
+    mDevice->FreeMemory(memory, nullptr);
+}
+
+bool VulkanMemoryAllocator::TryAllocate(VulkanMemoryBlock& block, VkDeviceSize size, VkDeviceSize alignment, void* userData, VulkanAllocation& allocation)
+{
+    const auto node = block.allocator.Allocate(size, alignment, userData);
+    if(node == TlsfAllocator::InvalidNode)
+        return false;
+
+    allocation.memory = block.memory;
+    allocation.offset = block.allocator.GetOffset(node);
+    allocation.size = size;
+    allocation.mappedData = block.mappedData ? block.mappedData + allocation.offset : nullptr;
+    allocation.block = &block;
+    allocation.node = node;
+    allocation.memoryTypeIndex = mPools[block.poolIndex].memoryTypeIndex;
+
+    return true;
+}
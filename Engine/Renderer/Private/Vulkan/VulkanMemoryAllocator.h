@@ -0,0 +1,140 @@
+#pragma once
+
+#include <PAL/RenderAPI/Vulkan/VulkanDevice.h>
+#include <Renderer/Renderer.h>
+#include <Core/Platform.h>
+
+#include "TlsfAllocator.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Renderer
+{
+    struct VulkanMemoryBlock;
+
+    /*!
+     @brief Range of device memory owned by single resource.
+     */
+    struct VulkanAllocation
+    {
+        VkDeviceMemory memory{ VK_NULL_HANDLE };
+        VkDeviceSize offset{ 0 };
+        VkDeviceSize size{ 0 };
+
+        /*!
+         @brief Host address of the range start, valid for the whole allocation life if memory is host visible.
+         */
+        void* mappedData{ nullptr };
+
+        /*!
+         @brief Block the range was sub-allocated from, null for dedicated allocation.
+         */
+        VulkanMemoryBlock* block{ nullptr };
+        TlsfAllocator::NodeIndex node{ TlsfAllocator::InvalidNode };
+        uint32_t memoryTypeIndex{ 0 };
+    };
+
+    /*!
+     @brief Resources with linear & optimal layout have to keep bufferImageGranularity distance when sharing memory.
+     */
+    enum class VulkanResourceKind : uint8_t
+    {
+        Linear,     // Buffers & linear images
+        Optimal     // Optimal tiling images
+    };
+
+    /*!
+     @brief Allocation which should be moved to defragment memory.
+     */
+    struct VulkanDefragmentationMove
+    {
+        VulkanAllocation source;
+        VulkanAllocation destination;
+
+        /*!
+         @brief Value passed to Allocate by the owner of the source range.
+         */
+        void* userData{ nullptr };
+    };
+
+    /*!
+     @brief Sub-allocates resources from large device memory blocks, one set of blocks per memory type.
+
+     Blocks are split by two level segregated fit allocator, resources bigger than half of a block get their own
+     device memory. Host visible blocks stay mapped for their whole life.
+     When device requires bufferImageGranularity, buffers & optimal images are kept in separate blocks so they never
+     share a granularity page.
+     Thread safe.
+     */
+    class VulkanMemoryAllocator
+    {
+    public:
+        explicit VulkanMemoryAllocator(std::shared_ptr<PAL::RenderAPI::VulkanDevice> device);
+        ~VulkanMemoryAllocator();
+
+        DECLARE_NOCOPY_NOMOVE(VulkanMemoryAllocator)
+
+        /*!
+         @brief Finds first memory type allowed by the filter having all required properties.
+         */
+        NO_DISCARD uint32_t FindMemoryTypeIndex(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+
+        /*!
+         @param userData Identifies the owner of the range for defragmentation.
+         */
+        NO_DISCARD VulkanAllocation Allocate(const VkMemoryRequirements& requirements,
+                                             VkMemoryPropertyFlags properties,
+                                             VulkanResourceKind kind,
+                                             void* userData = nullptr);
+        void Free(VulkanAllocation& allocation);
+
+        /*!
+         @brief Makes host writes to the range visible to device, does nothing for coherent memory.
+         */
+        void Flush(const VulkanAllocation& allocation, VkDeviceSize offset, VkDeviceSize size) const;
+
+        /*!
+         @brief Plans moves emptying the least used block of every memory type, destinations are already allocated.
+
+         Owners have to copy the data, recreate their resources bound to destination ranges & pass the moves
+         to EndDefragmentation once GPU no longer uses the source ranges.
+         @param maxBytes Maximal number of bytes moved by all returned moves.
+         */
+        NO_DISCARD std::vector<VulkanDefragmentationMove> BeginDefragmentation(VkDeviceSize maxBytes);
+        void EndDefragmentation(const std::vector<VulkanDefragmentationMove>& moves);
+
+        NO_DISCARD MemoryStatistics GetStatistics() const;
+
+    private:
+        struct Pool
+        {
+            std::vector<std::unique_ptr<VulkanMemoryBlock>> blocks;
+            uint32_t memoryTypeIndex{ 0 };
+            VulkanResourceKind kind{ VulkanResourceKind::Linear };
+        };
+
+        Pool& GetPool(uint32_t memoryTypeIndex, VulkanResourceKind kind);
+        VkDeviceSize GetBlockSize(uint32_t memoryTypeIndex) const;
+
+        VkDeviceMemory AllocateDeviceMemory(VkDeviceSize size, uint32_t memoryTypeIndex, void** mappedData);
+        void FreeDeviceMemory(VkDeviceMemory memory, bool mapped);
+
+        bool TryAllocate(VulkanMemoryBlock& block, VkDeviceSize size, VkDeviceSize alignment, void* userData, VulkanAllocation& allocation);
+        void FreeLocked(VulkanAllocation& allocation);
+
+    private:
+        std::shared_ptr<PAL::RenderAPI::VulkanDevice> mDevice;
+
+        VkPhysicalDeviceMemoryProperties mMemoryProperties{};
+        VkDeviceSize mBufferImageGranularity{ 1 };
+        VkDeviceSize mNonCoherentAtomSize{ 1 };
+
+        mutable std::mutex mMutex;
+        std::vector<Pool> mPools;
+
+        uint32_t mDedicatedAllocationCount{ 0 };
+        VkDeviceSize mDedicatedBytes{ 0 };
+    };
+}
@@ -0,0 +1,216 @@
+#include "VulkanPipelineCache.h"
+
+#include <Logging/LoggingService.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifdef LOG_MODULE_ID
+#undef LOG_MODULE_ID
+#endif
+
+#define LOG_MODULE_ID LOG_MODULE_4BYTE('V','K','P','C')
+
+using namespace Renderer;
+using namespace PAL::RenderAPI;
+
+namespace
+{
+    constexpr uint32_t CACHE_FILE_MAGIC = 0x48435053;     // "SPCH"
+    constexpr uint32_t CACHE_FILE_VERSION = 1;
+
+    /*!
+     @brief Precedes cache data in the file. Driver version isn't part of Vulkan cache header, so it's stored here.
+     */
+    struct CacheFileHeader
+    {
+        uint32_t magic{ CACHE_FILE_MAGIC };
+        uint32_t version{ CACHE_FILE_VERSION };
+        uint32_t vendorID{ 0 };
+        uint32_t deviceID{ 0 };
+        uint32_t driverVersion{ 0 };
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE]{};
+        float coldPipelineTime{ 0.0f };
+        uint64_t dataSize{ 0 };
+    };
+
+    // Layout of VkPipelineCacheHeaderVersionOne which starts the cache data
+    constexpr size_t VK_CACHE_HEADER_SIZE = 4 * sizeof(uint32_t) + VK_UUID_SIZE;
+
+    CacheFileHeader MakeHeader(const VkPhysicalDeviceProperties& properties)
+    {
+        CacheFileHeader header;
+        header.vendorID = properties.vendorID;
+        header.deviceID = properties.deviceID;
+        header.driverVersion = properties.driverVersion;
+        std::memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+        return header;
+    }
+
+    bool IsDataCompatible(const std::vector<uint8_t>& data, const VkPhysicalDeviceProperties& properties)
+    {
+        if(data.size() < VK_CACHE_HEADER_SIZE)
+            return false;
+
+        uint32_t fields[4];
+        std::memcpy(fields, data.data(), sizeof(fields));
+
+        const uint32_t headerSize = fields[0];
+        const uint32_t headerVersion = fields[1];
+
+        return headerSize >= VK_CACHE_HEADER_SIZE && headerSize <= data.size() &&
+               headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+               fields[2] == properties.vendorID &&
+               fields[3] == properties.deviceID &&
+               std::memcmp(data.data() + sizeof(fields), properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    }
+}
+
+VulkanPipelineCache::VulkanPipelineCache(std::shared_ptr<VulkanDevice> device, std::string filePath)
+    : mDevice(std::move(device))
+    , mFilePath(std::move(filePath))
+{
+    const auto initialData = Load();
+    mWarm = !initialData.empty();
+
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = initialData.size();
+    cacheInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+    mDevice->CreatePipelineCache(&cacheInfo, nullptr, &mCache);
+
+    LOG(Information) << "Pipeline cache: " << (mWarm ? "loaded " : "cold start, ") << (initialData.size() >> 10) << "KB from " << mFilePath;
+}
+
+VulkanPipelineCache::~VulkanPipelineCache()
+{
+    Save();
+
+    const auto statistics = GetStatistics();
+    LOG(Information) << "Pipeline cache: " << statistics.pipelineCount << " pipelines created in " << statistics.creationTime
+                     << "ms, estimated time saved: " << statistics.estimatedTimeSaved << "ms";
+
+    mDevice->DestroyPipelineCache(mCache, nullptr);
+}
+
+std::vector<uint8_t> VulkanPipelineCache::Load()
+{
+    std::ifstream file(mFilePath, std::ios::binary);
+    if(!file)
+        return {};
+
+    const auto& properties = mDevice->GetProperties();
+    const CacheFileHeader expected = MakeHeader(properties);
+
+    CacheFileHeader header;
+    if(!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    {
+        LOG(Warning) << "Pipeline cache file is truncated, cache is dropped";
+        return {};
+    }
+
+    if(header.magic != expected.magic || header.version != expected.version)
+    {
+        LOG(Warning) << "Pipeline cache file has unknown format, cache is dropped";
+        return {};
+    }
+
+    if(header.vendorID != expected.vendorID || header.deviceID != expected.deviceID || header.driverVersion != expected.driverVersion ||
+       std::memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+    {
+        LOG(Information) << "Pipeline cache was produced by other device or driver version, cache is dropped";
+        return {};
+    }
+
+    // Size comes from the file, it's checked before anything is allocated for it
+    std::error_code error;
+    const uintmax_t fileSize = std::filesystem::file_size(mFilePath, error);
+
+    if(error || fileSize < sizeof(header) || header.dataSize != fileSize - sizeof(header))
+    {
+        LOG(Warning) << "Pipeline cache data size doesn't match the file, cache is dropped";
+        return {};
+    }
+
+    std::vector<uint8_t> data(static_cast<size_t>(header.dataSize));
+    if(!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size())) || !IsDataCompatible(data, properties))
+    {
+        LOG(Warning) << "Pipeline cache data are corrupted, cache is dropped";
+        return {};
+    }
+
+    mColdPipelineTime = header.coldPipelineTime;
+
+    return data;
+}
+
+void VulkanPipelineCache::Save()
+{
+    if(!mDirty.exchange(false))
+        return;
+
+    const auto data = mDevice->GetPipelineCacheData(mCache);
+
+    CacheFileHeader header = MakeHeader(mDevice->GetProperties());
+    header.dataSize = data.size();
+
+    // Cold measurement is kept once known, later runs create pipelines from the cache
+    const uint32_t pipelineCount = mPipelineCount.load();
+    header.coldPipelineTime = mWarm || pipelineCount == 0 ? mColdPipelineTime : mCreationTime.load() / 1000.0f / pipelineCount;
+
+    // Data go to temporary file first, rename replaces the old cache in one step
+    const std::string tempPath = mFilePath + ".tmp";
+
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        file.flush();
+
+        if(!file)
+        {
+            LOG(Warning) << "Failed to write pipeline cache to " << tempPath;
+            mDirty = true;
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, mFilePath, error);
+
+    if(error)
+    {
+        LOG(Warning) << "Failed to replace pipeline cache " << mFilePath << ": " << error.message();
+        std::filesystem::remove(tempPath, error);
+        mDirty = true;
+        return;
+    }
+
+    LOG(Information) << "Pipeline cache saved, " << (data.size() >> 10) << "KB";
+}
+
+void VulkanPipelineCache::RecordPipelineCreation(float time)
+{
+    mPipelineCount.fetch_add(1, std::memory_order_relaxed);
+    mCreationTime.fetch_add(static_cast<uint64_t>(time * 1000.0f), std::memory_order_relaxed);
+    mDirty = true;
+}
+
+PipelineCacheStatistics VulkanPipelineCache::GetStatistics() const
+{
+    PipelineCacheStatistics statistics;
+    statistics.warmStart = mWarm;
+    statistics.pipelineCount = mPipelineCount.load(std::memory_order_relaxed);
+    statistics.creationTime = mCreationTime.load(std::memory_order_relaxed) / 1000.0f;
+
+    if(mWarm)
+    {
+        statistics.estimatedTimeSaved = std::max(0.0f, mColdPipelineTime * statistics.pipelineCount - statistics.creationTime);
+    }
+
+    return statistics;
+}
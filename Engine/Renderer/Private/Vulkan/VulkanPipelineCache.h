@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Renderer/Renderer.h>
+#include <PAL/RenderAPI/Vulkan/VulkanDevice.h>
+#include <Core/Platform.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace Renderer
+{
+    /*!
+     @brief Pipeline cache persisted between runs, so the driver doesn't compile shaders of known pipelines again.
+
+     File starts with engine header identifying device & driver the data was produced by, data of other device or
+     driver version is dropped and the cache starts empty. File is replaced atomically, interrupted write never
+     leaves a corrupted cache behind.
+     Pipelines may be created from multiple threads, the cache is synchronized by the driver.
+     */
+    class VulkanPipelineCache
+    {
+    public:
+        VulkanPipelineCache(std::shared_ptr<PAL::RenderAPI::VulkanDevice> device, std::string filePath);
+        ~VulkanPipelineCache();
+
+        DECLARE_NOCOPY_NOMOVE(VulkanPipelineCache)
+
+        /*!
+         @brief Writes cache to disk if any pipeline was created since the last save.
+         */
+        void Save();
+
+        /*!
+         @brief Accounts time of pipeline creation to the statistics.
+         @param time Creation time in miliseconds.
+         */
+        void RecordPipelineCreation(float time);
+
+        /*!
+         @brief Estimate is based on creation time of pipelines measured while the cache was cold.
+         */
+        NO_DISCARD PipelineCacheStatistics GetStatistics() const;
+
+        NO_DISCARD VkPipelineCache GetHandle() const noexcept { return mCache; }
+
+    private:
+        /*!
+         @return Cache data of the file, empty if the file is missing or belongs to other device or driver.
+         */
+        NO_DISCARD std::vector<uint8_t> Load();
+
+    private:
+        std::shared_ptr<PAL::RenderAPI::VulkanDevice> mDevice;
+        std::string mFilePath;
+
+        VkPipelineCache mCache{ VK_NULL_HANDLE };
+
+        bool mWarm{ false };
+        std::atomic<bool> mDirty{ false };
+
+        // Creation times are accumulated as integral microseconds so the counters can stay lock free
+        std::atomic<uint32_t> mPipelineCount{ 0 };
+        std::atomic<uint64_t> mCreationTime{ 0 };
+
+        // Average creation time of a pipeline compiled without cache, carried over in the file header
+        float mColdPipelineTime{ 0.0f };
+    };
+}
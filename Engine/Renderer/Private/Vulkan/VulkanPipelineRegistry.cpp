@@ -0,0 +1,101 @@
+#include "VulkanPipelineRegistry.h"
+
+#include <Logging/LoggingService.h>
+
+#include <algorithm>
+
+#ifdef LOG_MODULE_ID
+#undef LOG_MODULE_ID
+#endif
+
+#define LOG_MODULE_ID LOG_MODULE_4BYTE('V','K','P','R')
+
+using namespace Renderer;
+using namespace PAL::RenderAPI;
+
+VulkanPipelineRegistry::VulkanPipelineRegistry(std::shared_ptr<VulkanDevice> device, uint32_t framesInFlight)
+    : mDevice(std::move(device))
+    , mFramesInFlight(std::max(1u, framesInFlight))
+{
+}
+
+VulkanPipelineRegistry::~VulkanPipelineRegistry()
+{
+    LOG(Information) << "Pipeline registry: " << mEntries.size() << " unique states, " << mHitCount << " pipelines shared existing state";
+
+    for(const auto& entry : mEntries)
+    {
+        Destroy(*entry.second.state);
+    }
+}
+
+std::shared_ptr<const VulkanPipelineState> VulkanPipelineRegistry::Find(const PipelineKey& key)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    const auto it = mEntries.find(key);
+    if(it == mEntries.end())
+        return nullptr;
+
+    ++mHitCount;
+    it->second.releaseFrame = 0;
+
+    return it->second.state;
+}
+
+std::shared_ptr<const VulkanPipelineState> VulkanPipelineRegistry::Add(PipelineKey key, VulkanPipelineState&& state)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto sharedState = std::make_shared<VulkanPipelineState>(std::move(state));
+
+    const auto [it, inserted] = mEntries.emplace(std::move(key), Entry{ sharedState });
+    if(!inserted)
+    {
+        // Other thread created the same state meanwhile, its state wins
+        Destroy(*sharedState);
+        return it->second.state;
+    }
+
+    return sharedState;
+}
+
+void VulkanPipelineRegistry::Collect(uint64_t frameNumber)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    for(auto it = mEntries.begin(); it != mEntries.end();)
+    {
+        auto& entry = it->second;
+
+        // Registry holds the only reference
+        if(entry.state.use_count() > 1)
+        {
+            entry.releaseFrame = 0;
+        }
+        else if(entry.releaseFrame == 0)
+        {
+            entry.releaseFrame = frameNumber;
+        }
+        else if(frameNumber - entry.releaseFrame >= mFramesInFlight)
+        {
+            Destroy(*entry.state);
+            it = mEntries.erase(it);
+            continue;
+        }
+
+        ++it;
+    }
+}
+
+size_t VulkanPipelineRegistry::GetStateCount() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mEntries.size();
+}
+
+void VulkanPipelineRegistry::Destroy(const VulkanPipelineState& state) const
+{
+    mDevice->DestroyPipeline(state.pipeline, nullptr);
+    mDevice->DestroyPipelineLayout(state.layout, nullptr);
+}
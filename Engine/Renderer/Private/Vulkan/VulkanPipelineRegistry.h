@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Renderer/Renderer.h>
+#include <PAL/RenderAPI/Vulkan/VulkanDevice.h>
+#include <Core/Platform.h>
+
+#include "VulkanDeviceObjects.h"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace Renderer
+{
+    /*!
+     @brief Deduplicates pipeline states, pipelines with equal PipelineKey share pipeline & layouts.
+
+     States are reference counted by pipeline device objects. State no pipeline references is destroyed once
+     all frames in flight which could still use it are finished, it's revived if requested again before that.
+     All states are destroyed with the registry regardless of references.
+     */
+    class VulkanPipelineRegistry
+    {
+    public:
+        VulkanPipelineRegistry(std::shared_ptr<PAL::RenderAPI::VulkanDevice> device, uint32_t framesInFlight);
+        ~VulkanPipelineRegistry();
+
+        DECLARE_NOCOPY_NOMOVE(VulkanPipelineRegistry)
+
+        /*!
+         @return Shared state of the key, nullptr if the state doesn't exist.
+         */
+        NO_DISCARD std::shared_ptr<const VulkanPipelineState> Find(const PipelineKey& key);
+
+        /*!
+         @brief Takes ownership of newly created state.
+         @return Shared state to be referenced by pipeline device object.
+         */
+        std::shared_ptr<const VulkanPipelineState> Add(PipelineKey key, VulkanPipelineState&& state);
+
+        /*!
+         @brief Destroys unreferenced states, has to be called once GPU released the frame slot.
+         @param frameNumber Number of the frame being started.
+         */
+        void Collect(uint64_t frameNumber);
+
+        NO_DISCARD size_t GetStateCount() const;
+
+    private:
+        void Destroy(const VulkanPipelineState& state) const;
+
+    private:
+        struct Entry
+        {
+            std::shared_ptr<VulkanPipelineState> state;
+
+            // Frame the last reference was dropped at, zero while referenced
+            uint64_t releaseFrame{ 0 };
+        };
+
+        std::shared_ptr<PAL::RenderAPI::VulkanDevice> mDevice;
+        uint32_t mFramesInFlight{ 1 };
+
+        mutable std::mutex mMutex;
+        std::unordered_map<PipelineKey, Entry, PipelineKeyHash> mEntries;
+
+        uint32_t mHitCount{ 0 };
+    };
+}
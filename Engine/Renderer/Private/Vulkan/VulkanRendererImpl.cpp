@@ -17,13 +17,23 @@
 #include "VulkanTypes.h"
 #include "VulkanSwapChainImpl.h"
 #include "VulkanDeviceObjects.h"
+#include "VulkanResourceTable.h"
 #include "VulkanCommandBuffer.h"
-#include "VulkanCommands.h"
+#include "VulkanCommandStream.h"
+#include "VulkanCommandRecorder.h"
+#include "VulkanAsyncCompute.h"
 
 #include <Math/Matrix4.h>
 #include <Math/Math.h>
+#include <Math/BatchKernels.h>
 
 #include <imgui/imgui.h>
+#include <microprofile/microprofile.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
 
 #ifdef LOG_MODULE_ID
 #undef LOG_MODULE_ID
@@ -38,7 +48,257 @@ using namespace PAL::RenderAPI;
 
 namespace
 {
-    constexpr uint8_t SWAP_CHAIN_IMAGE_COUNT = 2;
+    // Size of persistently mapped ring all device local resources are uploaded through
+    constexpr VkDeviceSize STAGING_RING_SIZE = 32 * 1024 * 1024;
+    
+    // Uniform data written by CPU during single frame, one region per frame in flight
+    constexpr VkDeviceSize UNIFORM_RING_FRAME_SIZE = 4 * 1024 * 1024;
+    
+    // Pipeline cache is persisted in the working directory, newly created pipelines are checkpointed to disk periodically
+    constexpr const char* PIPELINE_CACHE_FILE = "PipelineCache.bin";
+    constexpr uint64_t PIPELINE_CACHE_CHECKPOINT_FRAMES = 1000;
+    
+    // Objects culled by one workgroup of cull.comp, matches its local size
+    constexpr uint32_t CULL_GROUP_SIZE = 64;
+    
+    // Vertex buffer streams bound by single command
+    constexpr uint32_t MAX_VERTEX_STREAMS = 8;
+    
+    /*!
+     @brief Queue families the renderer submits to, family without dedicated queue is the graphics family.
+     */
+    struct QueueFamilies
+    {
+        uint32_t graphics{ 0 };
+        uint32_t compute{ 0 };
+        uint32_t transfer{ 0 };
+    };
+    
+    /*!
+     @return Families of the device, empty if the device has no family able to render.
+     */
+    std::optional<QueueFamilies> FindQueueFamilies(const std::vector<VkQueueFamilyProperties>& familyProps)
+    {
+        const auto familyCount = static_cast<uint32_t>(familyProps.size());
+        
+        // Frame records compute work alongside rendering, so graphics family has to support both
+        const auto graphicsIt = std::find_if(familyProps.begin(), familyProps.end(), [](const VkQueueFamilyProperties& props){
+            return props.queueCount > 0 && (props.queueFlags & VK_QUEUE_GRAPHICS_BIT) && (props.queueFlags & VK_QUEUE_COMPUTE_BIT);
+        });
+        
+        if(graphicsIt == familyProps.end())
+            return std::nullopt;
+        
+        QueueFamilies families;
+        families.graphics = static_cast<uint32_t>(std::distance(familyProps.begin(), graphicsIt));
+        families.compute = families.graphics;
+        families.transfer = families.graphics;
+        
+        // Compute family without graphics is backed by separate hardware queue, its work overlaps rendering
+        for(uint32_t familyIndex = 0; familyIndex < familyCount; ++familyIndex)
+        {
+            const auto& props = familyProps[familyIndex];
+            if(props.queueCount > 0 && (props.queueFlags & VK_QUEUE_COMPUTE_BIT) && !(props.queueFlags & VK_QUEUE_GRAPHICS_BIT))
+            {
+                families.compute = familyIndex;
+                break;
+            }
+        }
+        
+        // Transfer only family is usually backed by DMA engine, uploads then run alongside rendering.
+        // Uploads copy images in row ranges, so the family has to allow copies of any granularity.
+        for(uint32_t familyIndex = 0; familyIndex < familyCount; ++familyIndex)
+        {
+            const auto& props = familyProps[familyIndex];
+            const bool transferOnly = (props.queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+                                      !(props.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT));
+            const auto& granularity = props.minImageTransferGranularity;
+            
+            if(transferOnly && props.queueCount > 0 && granularity.width == 1 && granularity.height == 1 && granularity.depth == 1)
+            {
+                families.transfer = familyIndex;
+                break;
+            }
+        }
+        
+        return families;
+    }
+    
+    /*!
+     @return Preference of physical device, devices of requested type come first, then discrete & integrated ones.
+     */
+    uint32_t GetDeviceScore(VkPhysicalDeviceType deviceType, DeviceType requestedType)
+    {
+        // External GPUs report themselves as discrete ones
+        const VkPhysicalDeviceType requestedVulkanType = (requestedType == DeviceType::Integrated) ? VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU : VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU;
+        
+        if(deviceType == requestedVulkanType)
+            return 3;
+        
+        switch(deviceType)
+        {
+            case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU: return 2;
+            case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: return 1;
+            default: return 0;
+        }
+    }
+    
+    /*!
+     @brief Uniform block of cull.comp.
+     */
+    struct CullConstants
+    {
+        std::array<Vector4f, 6> planes;
+        uint32_t objectCount{ 0 };
+    };
+    
+    /*!
+     @brief Digest of buffers bound from streams of the usage, equal for vertex buffers sharing their device buffers.
+            Only sorts draws, bound state is compared by MakeStreamBinding.
+     */
+    uint64_t GetStreamBinding(const VertexBufferBase& vb, BufferUsage usage)
+    {
+        uint64_t binding{ 0 };
+        for(const auto& streamPtr : vb.mStreams)
+        {
+            if(streamPtr->GetDataType() != usage)
+                continue;
+            
+            // Handle is owned by the stream alone, equal handles mean the same device buffer
+            const uint64_t words[] = { binding, streamPtr->GetDeviceResourcePtr().GetHandle(), streamPtr->GetStride() };
+            binding = PipelineKey::Digest(words, sizeof(words));
+        }
+        
+        return binding;
+    }
+    
+    /*!
+     @brief Fills key with exact identity of buffers bound from streams of the usage, see GetStreamBinding.
+     @return The key.
+     */
+    const StateKey& MakeStreamBinding(StateKey& key, const VertexBufferBase& vb, BufferUsage usage)
+    {
+        key.Clear();
+        for(const auto& streamPtr : vb.mStreams)
+        {
+            if(streamPtr->GetDataType() != usage)
+                continue;
+            
+            key.Append(streamPtr->GetDeviceResourcePtr().GetHandle());
+            key.Append(streamPtr->GetStride());
+        }
+        
+        return key;
+    }
+    
+    /*!
+     @brief Fills key with the pipeline handle.
+     @return The key.
+     */
+    const StateKey& MakePipelineBinding(StateKey& key, VkPipeline pipeline)
+    {
+        key.Clear();
+        key.Append(reinterpret_cast<uint64_t>(pipeline));
+        
+        return key;
+    }
+    
+    /*!
+     @brief True if streams of the usage bind the same device buffers with equal strides, compared without digests.
+     */
+    bool HaveEqualStreams(const VertexBufferBase& left, const VertexBufferBase& right, BufferUsage usage)
+    {
+        auto leftIt = left.mStreams.begin();
+        auto rightIt = right.mStreams.begin();
+        
+        while(true)
+        {
+            leftIt = std::find_if(leftIt, left.mStreams.end(), [usage](const auto& stream){ return stream->GetDataType() == usage; });
+            rightIt = std::find_if(rightIt, right.mStreams.end(), [usage](const auto& stream){ return stream->GetDataType() == usage; });
+            
+            if(leftIt == left.mStreams.end() || rightIt == right.mStreams.end())
+                return leftIt == left.mStreams.end() && rightIt == right.mStreams.end();
+            
+            if((*leftIt)->GetDeviceResourcePtr().GetHandle() != (*rightIt)->GetDeviceResourcePtr().GetHandle() || (*leftIt)->GetStride() != (*rightIt)->GetStride())
+                return false;
+            
+            ++leftIt;
+            ++rightIt;
+        }
+    }
+    
+    /*!
+     @brief Records bind of vertex streams, buffers are resolved once here & replay only reads the packet.
+     */
+    uint32_t RecordVertexBuffers(VulkanCommandStream& commands, const VulkanResourceTables& resources, const VertexBufferBase& vb)
+    {
+        std::array<VkBuffer, MAX_VERTEX_STREAMS> buffers{};
+        std::array<VkDeviceSize, MAX_VERTEX_STREAMS> offsets{};
+        
+        uint32_t bufferCount{ 0 };
+        for(const auto& streamPtr : vb.mStreams)
+        {
+            if(streamPtr->GetDataType() != BufferUsage::VertexBuffer)
+                continue;
+            
+            _ASSERT(bufferCount < MAX_VERTEX_STREAMS && "Too many vertex streams");
+            
+            buffers[bufferCount++] = resources.buffers.Get(streamPtr->GetDeviceResourcePtr()).buffer;
+        }
+        
+        return commands.BindVertexBuffers(0, bufferCount, buffers.data(), offsets.data());
+    }
+    
+    uint32_t RecordIndexBuffer(VulkanCommandStream& commands, const VulkanResourceTables& resources, const VertexBufferBase& vb)
+    {
+        for(const auto& streamPtr : vb.mStreams)
+        {
+            if(streamPtr->GetDataType() != BufferUsage::IndexBuffer)
+                continue;
+            
+            const VkIndexType indexType = (streamPtr->GetStride() == sizeof(uint16_t)) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+            return commands.BindIndexBuffer(resources.buffers.Get(streamPtr->GetDeviceResourcePtr()).buffer, 0, indexType);
+        }
+        
+        throw std::runtime_error("Vertex buffer has no index stream!");
+    }
+    
+    /*!
+     @brief Image & view of texture or attachment, resources bind both kinds of images alike.
+     */
+    struct AttachableObject
+    {
+        VkImage image{ VK_NULL_HANDLE };
+        VkImageView imageView{ VK_NULL_HANDLE };
+        VkSampler sampler{ VK_NULL_HANDLE };
+    };
+    
+    AttachableObject GetAttachable(const VulkanResourceTables& resources, const DeviceObject& image)
+    {
+        if(const auto* texture = resources.textures.Find(image))
+            return AttachableObject{ texture->image, texture->imageView, texture->sampler };
+        
+        const auto& attachment = resources.attachments.Get(image);
+        return AttachableObject{ attachment.image, attachment.view, VK_NULL_HANDLE };
+    }
+    
+    /*!
+     @brief Descriptor of device local attachment image, shared by placed attachments & queries of their memory requirements.
+     */
+    VulkanImageDesc MakeAttachmentImageDesc(const AttachableDescriptor& desc)
+    {
+        VulkanImageDesc imageDesc;
+        imageDesc.width = desc.width;
+        imageDesc.height = desc.height;
+        imageDesc.depth = 1;
+        imageDesc.mipMapLevels = 1;
+        imageDesc.format = ConvertType(desc.format);
+        imageDesc.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageDesc.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageDesc.memoryProps = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        imageDesc.usage = ConvertType(desc.usage);
+        return imageDesc;
+    }
 }
 
 std::unique_ptr<IRenderer> RendererLocator::mService;
@@ -68,71 +328,205 @@ void VulkanRenderer::Initialize()
 		LOG(Information) << layer.layerName;
 	}
 
-	const auto physicalDevices = vulkanAPI.EnumeratePhysicalDevices();
-	const auto deviceExt = vulkanAPI.EnumerateDeviceExtensionProperties(physicalDevices.front());
-
-	LOG(Information) << "---------------Device extensions:--------------";
-	for (const auto& ext : deviceExt)
-	{
-		LOG(Information) << ext.extensionName << ", v: " << VK_VERSION_MAJOR(ext.specVersion) << "."
-			<< VK_VERSION_MAJOR(ext.specVersion) << "."
-			<< VK_VERSION_PATCH(ext.specVersion);
-	}
+    CreateDevice(DeviceType::Integrated);
     
-    const auto deviceLayers = vulkanAPI.EnumerateDeviceLayerProperties(physicalDevices.front());
+    mAllocator = std::make_shared<VulkanMemoryAllocator>(mDevice);
+    mResources = std::make_unique<VulkanResourceTables>();
+    mPipelineCache = std::make_unique<VulkanPipelineCache>(mDevice, PIPELINE_CACHE_FILE);
+    mPipelineRegistry = std::make_unique<VulkanPipelineRegistry>(mDevice, mFramesInFlight);
+    mDeletionQueue = std::make_unique<VulkanDeletionQueue>(mDevice, mAllocator, mFramesInFlight);
+    mShaderLibrary = std::make_unique<VulkanShaderLibrary>(mDevice);
+    mDescriptorAllocator = std::make_unique<VulkanDescriptorAllocator>(mDevice, mFramesInFlight);
     
-    LOG(Information) << "---------------Device layers:--------------";
-    for (const auto& layer : deviceLayers)
-    {
-        LOG(Information) << layer.layerName;
-    }
+    if(mDevice->IsFeatureSupported(DeviceFeature::DescriptorIndexing))
+        mBindlessTable = std::make_unique<VulkanBindlessTable>(mDevice, mFramesInFlight);
+    else
+        LOG(Information) << "Descriptor indexing not supported, textures are bound by descriptor sets of their effects";
     
-    CreateDevice(DeviceType::Integrated);
+    mDevice->GetDeviceQueue(mGraphicsQueueFamilyIndex, 0, &mGraphicsQueue);
+    
+    if(mTransferQueueFamilyIndex != mGraphicsQueueFamilyIndex)
+        mDevice->GetDeviceQueue(mTransferQueueFamilyIndex, 0, &mTransferQueue);
+    else
+        mTransferQueue = mGraphicsQueue;
     
-    mDevice->GetDeviceQueue(0, 0, &mGraphicsQueue);
+    // Without dedicated compute family all compute work is recorded into the frame
+    if(mComputeQueueFamilyIndex != mGraphicsQueueFamilyIndex)
+    {
+        VkQueue computeQueue{ VK_NULL_HANDLE };
+        mDevice->GetDeviceQueue(mComputeQueueFamilyIndex, 0, &computeQueue);
+        
+        mAsyncCompute = std::make_unique<VulkanAsyncCompute>(mDevice, computeQueue, mComputeQueueFamilyIndex, mFramesInFlight);
+        mSharedQueueFamilies = { mGraphicsQueueFamilyIndex, mComputeQueueFamilyIndex };
+    }
     
     VkCommandPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    poolInfo.queueFamilyIndex = 0;
+    poolInfo.queueFamilyIndex = mGraphicsQueueFamilyIndex;
     poolInfo.flags = 0; // Optional
     
     mDevice->CreateCommandPool(&poolInfo, nullptr, &mCommandPool);
     
     mCommandBufferFactory = std::make_shared<CommandBufferFactory>(mDevice, mCommandPool, mGraphicsQueue);
     
-    // Setup descriptor pool  // Pre-allocate this for whole renderer/ per render thread?
+    SamplerDesc samplerDesc;
+    samplerDesc.anisotropy = 0;
+    samplerDesc.minFilter = FilterMode::Linear;
+    samplerDesc.magFilter = FilterMode::Linear;
+    samplerDesc.uAddressMode = AddressMode::Repeat;
+    samplerDesc.vAddressMode = AddressMode::Repeat;
+    samplerDesc.wAddressMode = AddressMode::Repeat;
+    
+    mDefaultSampler = GetSampler(samplerDesc);
+    
+    CreateFrames();
+    CreateUploadManager();
+    CreateUniformRing();
+}
+
+void VulkanRenderer::SetFramesInFlight(uint32_t count)
+{
+    _ASSERT(mFrames.empty() && "Frames in flight can't be changed after initialization");
+    mFramesInFlight = std::max(1u, count);
+}
+
+void VulkanRenderer::CreateFrames()
+{
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    
+    // Created signaled so the first wait on every slot returns immediately
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    
+    // Whole pool is reset once the slot is reused, buffers are never freed one by one
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = mGraphicsQueueFamilyIndex;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    
+    mFrames.reserve(mFramesInFlight);
+    
+    for(uint32_t i = 0; i < mFramesInFlight; ++i)
+    {
+        FrameSyncDeviceObject sync{
+            mDevice->CreateManagedSemaphore(&semaphoreInfo, nullptr),
+            mDevice->CreateManagedSemaphore(&semaphoreInfo, nullptr),
+            mDevice->CreateManagedFence(&fenceInfo, nullptr)
+        };
+        
+        VkCommandPool commandPool{ VK_NULL_HANDLE };
+        mDevice->CreateCommandPool(&poolInfo, nullptr, &commandPool);
+        
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 2;
+        
+        // Second buffer acquires resources uploaded on transfer queue before the frame uses them
+        VkCommandBuffer commandBuffers[2]{ VK_NULL_HANDLE, VK_NULL_HANDLE };
+        mDevice->AllocateCommandBuffers(&allocInfo, commandBuffers);
+        
+        mFrames.push_back(VulkanFrame{
+            std::move(sync),
+            commandPool,
+            commandBuffers[0],
+            commandBuffers[1],
+            std::make_unique<VulkanCommandRecorder>(mDevice, poolInfo.queueFamilyIndex)
+        });
+    }
+    
+    LOG(Information) << "Created " << mFramesInFlight << " frames in flight";
+}
+
+void VulkanRenderer::CreateUploadManager()
+{
+    auto stagingBuffer = CreateBufferImpl(STAGING_RING_SIZE,
+                                          VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                          VK_SHARING_MODE_EXCLUSIVE);
+    
+    // Host visible memory is mapped by the allocator, staging ring stays mapped for the whole life of the renderer
+    mUploadManager = std::make_unique<VulkanUploadManager>(mDevice, mAllocator, stagingBuffer, STAGING_RING_SIZE, mTransferQueue, mTransferQueueFamilyIndex, mGraphicsQueueFamilyIndex);
+}
+
+void VulkanRenderer::CreateUniformRing()
+{
+    const auto properties = VulkanAPI::Service().GetPhysicalDeviceProperties(mDevice->GetPhysicalDevice());
+    const VkDeviceSize alignment = std::max<VkDeviceSize>(properties.limits.minUniformBufferOffsetAlignment, 1);
+    const VkDeviceSize frameSize = (UNIFORM_RING_FRAME_SIZE + alignment - 1) / alignment * alignment;
+    
+    // Instance data of instanced draws are written into the ring as well, GPU scene updates are staged in it & copied out
+    // by culling, which may run on async compute queue
+    auto uniformBuffer = CreateBufferImpl(frameSize * mFramesInFlight,
+                                          VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                          GetComputeSharingMode());
+    
+    mUniformRing = std::make_unique<VulkanUniformRing>(mDevice, mAllocator, uniformBuffer, frameSize, mFramesInFlight, alignment);
+}
+
+VulkanFrame& VulkanRenderer::BeginFrame()
+{
+    auto& frame = mFrames[mFrameIndex];
+    
+    if(mFrameStarted)
+        return frame;
+    
+    MICROPROFILE_SCOPEI("Renderer", "WaitForFrameFence", 0xff8000);
     
-    VkDescriptorPoolSize samplersPool{};
-    samplersPool.descriptorCount = 20;
-    samplersPool.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    const auto waitStart = std::chrono::steady_clock::now();
     
-    VkDescriptorPoolSize ubosPool{};
-    ubosPool.descriptorCount = 20;
-    ubosPool.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    const VkFence frameFence = frame.sync.frameFence.Get();
+    mDevice->WaitForFences(1, &frameFence, VK_TRUE, std::numeric_limits<uint64_t>::max());
     
-    std::vector<VkDescriptorPoolSize> poolSizes{ samplersPool, ubosPool };
+    const std::chrono::duration<float, std::milli> waitTime = std::chrono::steady_clock::now() - waitStart;
+    
+    mFrameStatistics.frameNumber++;
+    mFrameStatistics.frameSlot = mFrameIndex;
+    mFrameStatistics.fenceWaitTime = waitTime.count();
+    mFrameStatistics.bindsIssued = 0;
+    mFrameStatistics.bindsElided = 0;
+    
+    // GPU is done with everything recorded into this slot, recycle it as a whole
+    mDevice->ResetCommandPool(frame.commandPool, 0);
+    mUploadManager->RecycleSemaphores(frame.uploadSemaphores);
+    mUniformRing->BeginFrame(mFrameIndex);
+    
+    // Graphics submission of the slot waited for compute one, so compute work of the slot is finished too
+    if(mAsyncCompute)
+    {
+        mAsyncCompute->RecycleSemaphores(frame.computeSemaphores);
+        mAsyncCompute->BeginFrame(mFrameIndex);
+    }
+
+    mPipelineRegistry->Collect(mFrameStatistics.frameNumber);
+    mDeletionQueue->Collect(mFrameStatistics.frameNumber);
+    mDescriptorAllocator->BeginFrame(mFrameIndex, mFrameStatistics.frameNumber);
     
-    VkDescriptorPoolCreateInfo descPoolInfo{};
-    descPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    descPoolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-    descPoolInfo.pPoolSizes = poolSizes.data();
-    descPoolInfo.maxSets = 10;        // Depends on swap chain images cnt
+    if(mBindlessTable)
+        mBindlessTable->Collect(mFrameStatistics.frameNumber);
     
-    mDevice->CreateDescriptorPool(&descPoolInfo, nullptr, &mDescriptorPool);
+    frame.commandRecorder->Reset();
+    frame.imageAcquired = false;
     
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.commandPool = mCommandPool;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = 1;
+    mFrameStarted = true;
     
-    mDevice->AllocateCommandBuffers(&allocInfo, &mCmdBuff);
+    return frame;
+}
+
+uint64_t VulkanRenderer::GetReleaseFrame() const
+{
+    // Between frames the last frame is already submitted, anything recorded from now on goes into the next one
+    return mFrameStarted ? mFrameStatistics.frameNumber : mFrameStatistics.frameNumber + 1;
 }
 
 DeviceObject VulkanRenderer::CreateSurface(void* nativeViewHandle) const
 {
     VkSurfaceKHR vulkanSurface = VulkanAPI::Service().CreateWindowSurface(nativeViewHandle);
-    return Basify(SurfaceDeviceObject{ vulkanSurface });
+    return mResources->surfaces.Add(SurfaceDeviceObject{ vulkanSurface });
 }
 
 FramebufferDeviceObject VulkanRenderer::CreateFramebufferImpl(const uint32_t width,
@@ -192,9 +586,81 @@ VkSampler VulkanRenderer::CreateSamplerImpl(const SamplerDesc &desc) const
     return samplerHandle;
 }
 
+VkSampler VulkanRenderer::GetSampler(const SamplerDesc& desc)
+{
+    StateKey key;
+    key.Append(static_cast<uint64_t>(desc.minFilter));
+    key.Append(static_cast<uint64_t>(desc.magFilter));
+    key.Append(static_cast<uint64_t>(desc.uAddressMode));
+    key.Append(static_cast<uint64_t>(desc.vAddressMode));
+    key.Append(static_cast<uint64_t>(desc.wAddressMode));
+    key.Append(desc.anisotropy);
+    
+    const auto it = mSamplers.find(key);
+    if(it != mSamplers.end())
+        return it->second;
+    
+    const VkSampler sampler = CreateSamplerImpl(desc);
+    mSamplers.emplace(std::move(key), sampler);
+    
+    return sampler;
+}
+
 void Renderer::VulkanRenderer::Deinitialize()
 {
-    mDevice->~VulkanDevice();
+    mDevice->WaitIdle();
+    
+    for(auto& frame : mFrames)
+    {
+        mUploadManager->RecycleSemaphores(frame.uploadSemaphores);
+        
+        if(mAsyncCompute)
+            mAsyncCompute->RecycleSemaphores(frame.computeSemaphores);
+    }
+    
+    mUploadManager.reset();
+    mAsyncCompute.reset();
+    mUniformRing.reset();
+    mPipelineRegistry.reset();
+    mDescriptorAllocator.reset();
+    mBindlessTable.reset();
+    mShaderLibrary.reset();
+    mDeletionQueue.reset();
+    mPipelineCache.reset();
+    
+    for(const auto& [key, sampler] : mSamplers)
+    {
+        mDevice->DestroySampler(sampler, nullptr);
+    }
+    
+    mSamplers.clear();
+    
+    for(auto& frame : mFrames)
+    {
+        frame.commandRecorder.reset();
+        mDevice->DestroyCommandPool(frame.commandPool, nullptr);
+    }
+    
+    mFrames.clear();
+    
+    mCommandBuffers.clear();
+    mCommandBufferFactory.reset();
+    mDevice->DestroyCommandPool(mCommandPool, nullptr);
+    mCommandPool = VK_NULL_HANDLE;
+    
+    // Objects the application didn't destroy are released with the device, managed handles of the tables run their deleters now
+    const DeviceObjectDestroyer destroyer(mDevice, mAllocator);
+    mResources->swapChains.ForEach([&destroyer](auto& swapChain){ destroyer.Destroy(swapChain); });
+    mResources->buffers.ForEach([&destroyer](auto& buffer){ destroyer.Destroy(buffer); });
+    mResources->textures.ForEach([&destroyer](auto& texture){ destroyer.Destroy(texture); });
+    mResources->attachments.ForEach([&destroyer](auto& attachment){ destroyer.Destroy(attachment); });
+    mResources->heaps.ForEach([&destroyer](auto& heap){ destroyer.Destroy(heap); });
+    mResources.reset();
+    
+    mAllocator.reset();
+    
+    // Swap chains & other holders may still share the device, the last of them destroys it
+    mDevice.reset();
 }
 
 void VulkanRenderer::CreateDevice(DeviceType type)
@@ -202,16 +668,62 @@ void VulkanRenderer::CreateDevice(DeviceType type)
 	const auto& vulkanAPI = VulkanAPI::Service();
 
 	const auto physicalDevices = vulkanAPI.EnumeratePhysicalDevices();
-	const auto& physicalDevice = physicalDevices.front();
-	const auto queueProps = vulkanAPI.GetPhysicalDeviceQueueFamilyProperties(physicalDevice);
+    
+    // Device able to render with the best score wins, ties are resolved by enumeration order
+    VkPhysicalDevice physicalDevice{ VK_NULL_HANDLE };
+    std::optional<QueueFamilies> queueFamilies;
+    VkPhysicalDeviceProperties physicalDeviceProps{};
+    uint32_t bestScore{ 0 };
+    
+    for(const auto& candidate : physicalDevices)
+    {
+        const auto candidateFamilies = FindQueueFamilies(vulkanAPI.GetPhysicalDeviceQueueFamilyProperties(candidate));
+        if(!candidateFamilies)
+            continue;
+        
+        const auto candidateProps = vulkanAPI.GetPhysicalDeviceProperties(candidate);
+        const uint32_t score = GetDeviceScore(candidateProps.deviceType, type) + 1;
+        
+        if(score > bestScore)
+        {
+            physicalDevice = candidate;
+            queueFamilies = candidateFamilies;
+            physicalDeviceProps = candidateProps;
+            bestScore = score;
+        }
+    }
+    
+    if(!queueFamilies)
+    {
+        throw std::runtime_error("No physical device supports graphics & compute queue!");
+    }
+    
+    mGraphicsQueueFamilyIndex = queueFamilies->graphics;
+    mComputeQueueFamilyIndex = queueFamilies->compute;
+    mTransferQueueFamilyIndex = queueFamilies->transfer;
+    
+    LOG(Information) << "Selected device: " << physicalDeviceProps.deviceName << ", queue families graphics: " << mGraphicsQueueFamilyIndex
+                     << ", compute: " << mComputeQueueFamilyIndex << ", transfer: " << mTransferQueueFamilyIndex;
 
 	std::vector<float> queuePriorities{ 1.0f };
 
 	VkDeviceQueueCreateInfo queueCreateInfo{};
 	queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
 	queueCreateInfo.queueCount = static_cast<uint32_t>(queuePriorities.size());
-	queueCreateInfo.queueFamilyIndex = 0;
+	queueCreateInfo.queueFamilyIndex = mGraphicsQueueFamilyIndex;
 	queueCreateInfo.pQueuePriorities = queuePriorities.data();
+    
+    std::vector<VkDeviceQueueCreateInfo> queueCreateInfos{ queueCreateInfo };
+    
+    // Dedicated families get one queue each, families equal to graphics one share its queue
+    for(const uint32_t familyIndex : { mComputeQueueFamilyIndex, mTransferQueueFamilyIndex })
+    {
+        if(familyIndex == mGraphicsQueueFamilyIndex)
+            continue;
+        
+        queueCreateInfo.queueFamilyIndex = familyIndex;
+        queueCreateInfos.push_back(queueCreateInfo);
+    }
 
 	PAL::RenderAPI::DeviceData deviceData;
 	deviceData.device = physicalDevice;
@@ -220,13 +732,58 @@ void VulkanRenderer::CreateDevice(DeviceType type)
 	deviceData.deviceFeatures = vulkanAPI.GetPhysicalDeviceFeatures(physicalDevice);
 	deviceData.deviceProperties = vulkanAPI.GetPhysicalDeviceProperties(physicalDevice);
 
+    // Logged for the selected device only, enumeration order doesn't say which device is used
+    LOG(Information) << "---------------Device extensions:--------------";
+    for (const auto& ext : deviceData.deviceExtensions)
+    {
+        LOG(Information) << ext.extensionName << ", v: " << VK_VERSION_MAJOR(ext.specVersion) << "."
+            << VK_VERSION_MINOR(ext.specVersion) << "."
+            << VK_VERSION_PATCH(ext.specVersion);
+    }
+    
+    const auto deviceLayers = vulkanAPI.EnumerateDeviceLayerProperties(physicalDevice);
+    
+    LOG(Information) << "---------------Device layers:--------------";
+    for (const auto& layer : deviceLayers)
+    {
+        LOG(Information) << layer.layerName;
+    }
+
     std::vector<const char*> mEnabledDeviceExtensions{ VK_KHR_SWAPCHAIN_EXTENSION_NAME};
     std::vector<const char*> mEnabledDeviceValidationLayers{ "VK_LAYER_LUNARG_parameter_validation" };
+    
+    const auto isExtensionAvailable = [&deviceData](const char* extensionName) {
+        return std::any_of(deviceData.deviceExtensions.begin(), deviceData.deviceExtensions.end(), [extensionName](const VkExtensionProperties& props) {
+            return strcmp(extensionName, props.extensionName) == 0;
+        });
+    };
+    
+    // Bindless textures need only subset of descriptor indexing, other features stay disabled
+    const auto indexingFeatures = vulkanAPI.GetPhysicalDeviceDescriptorIndexingFeatures(physicalDevice);
+    
+    auto& enabledIndexingFeatures = deviceData.descriptorIndexingFeatures;
+    enabledIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    
+    if(isExtensionAvailable(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) && isExtensionAvailable(VK_KHR_MAINTENANCE3_EXTENSION_NAME) &&
+       deviceData.deviceFeatures.shaderSampledImageArrayDynamicIndexing && indexingFeatures.runtimeDescriptorArray && indexingFeatures.descriptorBindingPartiallyBound && indexingFeatures.descriptorBindingSampledImageUpdateAfterBind)
+    {
+        enabledIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+        enabledIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+        enabledIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        
+        mEnabledDeviceExtensions.push_back(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+        mEnabledDeviceExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+    }
+
+    // GPU culled scenes draw only the visible commands, without the extension all slots of the scene are drawn
+    if(isExtensionAvailable(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME))
+        mEnabledDeviceExtensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
 
 	VkDeviceCreateInfo deviceCreateInfo{};
 	deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-	deviceCreateInfo.queueCreateInfoCount = 1;
-	deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
+	deviceCreateInfo.pNext = enabledIndexingFeatures.runtimeDescriptorArray ? &enabledIndexingFeatures : nullptr;
+	deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
+	deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
 	deviceCreateInfo.pEnabledFeatures = &deviceData.deviceFeatures;
 	deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(mEnabledDeviceExtensions.size());
 	deviceCreateInfo.ppEnabledExtensionNames = mEnabledDeviceExtensions.data();
@@ -243,11 +800,11 @@ std::unique_ptr<SwapChainBase> VulkanRenderer::CreateSwapChain(const DeviceObjec
     const auto& physicalDevice = mDevice->GetPhysicalDevice();
     
     // Get vulkan surface handle
-    SurfaceVisitor surfaceVisitor;
-    surface.Accept(surfaceVisitor);
+    const VkSurfaceKHR vulkanSurface = mResources->surfaces.Get(surface).surface.Get();
     
     const auto& vulkanAPI = VulkanAPI::Service();
-    if(!vulkanAPI.GetPhysicalDeviceSurfaceSupportKHR(physicalDevice, 0, surfaceVisitor.surface))
+    // Frames are presented by graphics queue
+    if(!vulkanAPI.GetPhysicalDeviceSurfaceSupportKHR(physicalDevice, mGraphicsQueueFamilyIndex, vulkanSurface))
     {
         LOG(Error) << "Failed to create swap chain, unsupported surface";
         return nullptr;
@@ -262,17 +819,13 @@ std::unique_ptr<SwapChainBase> VulkanRenderer::CreateSwapChain(const DeviceObjec
 //            for swap chain recreation it's ok*/
 //        mDevice->WaitIdle();
 //
-//        VulkanSwapChainVisitor visitor;
-//
 //        const auto& swapDeviceObject = swapChain->GetDeviceObject();
-//        swapDeviceObject.Accept(visitor);
-//
-//        oldVulkanSwapchain = visitor.swapChain;
+//        oldVulkanSwapchain = mResources->swapChains.Get(swapDeviceObject).swapChain.Get();
 //    }
     
-    const auto capabilities = vulkanAPI.GetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, surfaceVisitor.surface);
-    const auto formats = vulkanAPI.GetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surfaceVisitor.surface);
-    const auto presentationModes = vulkanAPI.GetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surfaceVisitor.surface);
+    const auto capabilities = vulkanAPI.GetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, vulkanSurface);
+    const auto formats = vulkanAPI.GetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, vulkanSurface);
+    const auto presentationModes = vulkanAPI.GetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, vulkanSurface);
     
     const auto& format = formats.front();      // Get B8G8R8A8_unorm
     const auto& presentMode = presentationModes.front();   // Immeadiate
@@ -293,7 +846,7 @@ std::unique_ptr<SwapChainBase> VulkanRenderer::CreateSwapChain(const DeviceObjec
     
     VkSwapchainCreateInfoKHR createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-    createInfo.surface = surfaceVisitor.surface;
+    createInfo.surface = vulkanSurface;
     createInfo.minImageCount = imagesCount;
     createInfo.imageColorSpace = format.colorSpace;
     createInfo.imageFormat = format.format;
@@ -311,28 +864,13 @@ std::unique_ptr<SwapChainBase> VulkanRenderer::CreateSwapChain(const DeviceObjec
     
     mDevice->CreateSwapchainKHR(&createInfo, nullptr, &newVulkanSwapchain);
     
-    // Create sync primitives
-    VkSemaphoreCreateInfo semaphoreInfo{};
-    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-    
-    auto imgSemaphore = mDevice->CreateManagedSemaphore(&semaphoreInfo, nullptr);
-    auto renderSemaphore = mDevice->CreateManagedSemaphore(&semaphoreInfo, nullptr);
-    
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-    
-    auto frameFence = mDevice->CreateManagedFence(&fenceInfo, nullptr);
-    
-    SwapChainDeviceObject gpuSwapChain{ newVulkanSwapchain,
-        std::move(imgSemaphore),
-        std::move(renderSemaphore),
-        std::move(frameFence)
-    };
+    // Sync primitives are owned by frames in flight, swap chain uses the ones of the current frame
+    SwapChainDeviceObject gpuSwapChain{ newVulkanSwapchain };
     
-    auto swapChain = std::make_unique<VulkanSwapChain>(mDevice, Basify(gpuSwapChain));
+    auto swapChain = std::make_unique<VulkanSwapChain>(mDevice, *this, mResources->swapChains.Add(std::move(gpuSwapChain)));
     
     VulkanAttachmentDeviceObject depthAttachmentDO = CreateAttachment(width, height, Format::D32F, ImageUsage::DepthStencilAttachment);
+    const VkImageView depthView = depthAttachmentDO.view;
     
     AttachableDescriptor depthAttachmentDesc;
     depthAttachmentDesc.width = width;
@@ -341,19 +879,18 @@ std::unique_ptr<SwapChainBase> VulkanRenderer::CreateSwapChain(const DeviceObjec
     depthAttachmentDesc.usage = ImageUsage::DepthStencilAttachment;
     
     auto depthAttachment = std::make_shared<Attachment>(depthAttachmentDesc, Graphics::Color(255, 0, 0, 0));
-    depthAttachment->SetDeviceObject(Basify(std::move(depthAttachmentDO)));
+    depthAttachment->SetDeviceObject(mResources->attachments.Add(std::move(depthAttachmentDO)));
     swapChain->SetDepthAttachment(depthAttachment);
     
     // Create framebuffers & attach them to swap chain
     const auto swapChainImages = mDevice->GetSwapchainImagesKHR(newVulkanSwapchain);
     
-    RenderPassVisitor rpv;
-    renderPass.Accept(rpv);
+    const VkRenderPass vulkanRenderPass = mResources->renderPasses.Get(renderPass).renderPass.Get();
     
     for(const auto& swapImage : swapChainImages)
     {
         auto swapImageView = CreateImageView(swapImage, format.format, VK_IMAGE_ASPECT_COLOR_BIT);
-        VulkanAttachmentDeviceObject attachmentDO{ swapImage, VK_NULL_HANDLE, swapImageView };
+        VulkanAttachmentDeviceObject attachmentDO{ swapImage, VulkanAllocation{}, swapImageView };
         
         AttachableDescriptor attachmentDesc;
         attachmentDesc.width = width;
@@ -364,8 +901,8 @@ std::unique_ptr<SwapChainBase> VulkanRenderer::CreateSwapChain(const DeviceObjec
         Framebuffer framebuffer;
         framebuffer.Resize(width, height);
         framebuffer.AddAttachment(depthAttachment);
-        framebuffer.AddAttachment(std::make_shared<Attachment>(attachmentDesc, Graphics::Color(20, 128, 224, 255), Basify(attachmentDO)));
-        framebuffer.SetDeviceObject(Basify(CreateFramebufferImpl(width, height, { depthAttachmentDO.view, swapImageView,  }, rpv.renderPass)));
+        framebuffer.AddAttachment(std::make_shared<Attachment>(attachmentDesc, Graphics::Color(20, 128, 224, 255), mResources->attachments.Add(std::move(attachmentDO))));
+        framebuffer.SetDeviceObject(mResources->framebuffers.Add(CreateFramebufferImpl(width, height, { depthView, swapImageView,  }, vulkanRenderPass)));
         
         swapChain->AddFramebuffer(std::move(framebuffer));
     }
@@ -383,123 +920,199 @@ void VulkanRenderer::CreateShader(DeviceObject& shader, const std::vector<uint8_
     VkShaderModule module{ VK_NULL_HANDLE };
     mDevice->CreateShaderModule(&createInfo, nullptr, &module);
     
-    shader = VulkanShaderDeviceObject(module);
+    shader = mResources->shaders.Add(VulkanShaderDeviceObject(module));
 }
 
-void VulkanRenderer::CreatePipeline(Pipeline& pipeline, const DeviceObject& renderPass)
+void VulkanRenderer::CreatePipelineLayout(const Effect& effect, VulkanPipelineState& state) const
 {
-    auto& effect = pipeline.effect;
-    
-    // Prepare modules
-    const auto stageInfos = PrepareModules(effect);
-    
-    // Setup attributes
-    const auto bindingCount = effect.GetBindingCount();
-    
-    std::vector<VkVertexInputBindingDescription> bindingDescriptions;
-    bindingDescriptions.reserve(bindingCount);
+    // Setup descriptor set layouts, one per used frequency, layouts are shared through the descriptor allocator
+    state.setCount = effect.GetDescriptorSetCount();
     
-    std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
-    
-    for(uint8_t bindingId{ 0 }; bindingId < bindingCount; ++bindingId)
+    for(uint32_t set{ 0 }; set < state.setCount; ++set)
     {
-        VkVertexInputBindingDescription desc{};
-        desc.binding = bindingId;
-        desc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        if(set == Effect::BindlessSet)
+        {
+            state.setLayouts[set] = mBindlessTable->GetLayout();
+            continue;
+        }
         
-        const auto& attributes = effect.GetBindingDescriptor(bindingId);
-        const auto attributeCount = attributes.size();
+        const auto& bindings = effect.GetUniformBindings(static_cast<DescriptorFrequency>(set));
         
-        for(uint8_t location{ 0 }; location < attributeCount; ++location)
+        std::vector<VkDescriptorSetLayoutBinding> layoutBindings;
+        
+        for(uint32_t bindingId{ 0 }; bindingId < bindings.size(); ++bindingId)
         {
-            const auto attributeFormat = attributes[location];
-            
-            VkVertexInputAttributeDescription attribDesc;
-            attribDesc.binding = bindingId;
-            attribDesc.location = (attributeCount == 1) ? bindingId : location;
-            attribDesc.format = ConvertType(attributeFormat);
-            attribDesc.offset = desc.stride;
-            
-            attributeDescriptions.push_back(std::move(attribDesc));
-            
-            desc.stride += GetSizeFromFormat(attributeFormat);
+            for(const auto& uniform : bindings[bindingId])
+            {
+                VkDescriptorSetLayoutBinding layoutBinding{};
+                layoutBinding.binding = bindingId;
+                layoutBinding.descriptorType = ConvertType(uniform.type);
+                layoutBinding.descriptorCount = uniform.count;
+                layoutBinding.stageFlags = ConvertType(uniform.stage);
+                layoutBinding.pImmutableSamplers = nullptr;
+                
+                layoutBindings.push_back(std::move(layoutBinding));
+            }
         }
         
-        bindingDescriptions.push_back(std::move(desc));
+        state.setLayouts[set] = mDescriptorAllocator->GetLayout(layoutBindings);
     }
     
-    // Vertex input
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(bindingDescriptions.size());
-    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-    vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions.data();
-    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
-    
-    // Input assembly
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    inputAssembly.primitiveRestartEnable = VK_FALSE;
+    // -------- Handle push constants ----------------------
     
-    // Setup descriptor set layout
-    const auto& bindings = effect.GetUniformBindings();
+    std::vector<VkPushConstantRange> pushConstRanges;
+    pushConstRanges.reserve(effect.mConstantRanges.size());
     
-    std::vector<VkDescriptorSetLayoutBinding> layoutBindings;
+    for(const auto& range : effect.mConstantRanges)
+    {
+        VkPushConstantRange vkRange;
+        vkRange.stageFlags = ConvertType(range.stage);
+        vkRange.offset = range.offset;
+        vkRange.size = range.size;
+        
+        pushConstRanges.push_back(std::move(vkRange));
+    }
     
-    std::unordered_map<VkDescriptorType, uint32_t> descriptorPoolSizesMap;
-    for(uint32_t bindingId{ 0 }; bindingId < bindings.size(); ++bindingId)
+    // Bindless indices follow ranges of the effect, single range covers stages of all bindless textures
+    if(effect.UsesBindless())
     {
-        const auto& binding = bindings[bindingId];
-        if(binding.empty())
-            continue;
+        VkPushConstantRange vkRange{};
+        vkRange.offset = effect.GetBindlessConstantOffset();
+        vkRange.size = static_cast<uint32_t>(effect.mBindlessTextures.size() * 2 * sizeof(uint32_t));
         
-        for(const auto& uniform : binding)
+        for(const auto& texture : effect.mBindlessTextures)
         {
-            const VkDescriptorType type = ConvertType(uniform.type);
-            
-            VkDescriptorSetLayoutBinding layoutBinding{};
-            layoutBinding.binding = bindingId;
-            layoutBinding.descriptorType = type;
-            layoutBinding.descriptorCount = uniform.count;
-            layoutBinding.stageFlags = ConvertType(uniform.stage);
-            layoutBinding.pImmutableSamplers = nullptr;
-            
-            layoutBindings.push_back(std::move(layoutBinding));
-            
-            descriptorPoolSizesMap[type]++;
+            vkRange.stageFlags |= ConvertType(texture.stage);
         }
+        
+        _ASSERT(vkRange.offset + vkRange.size <= mDevice->GetProperties().limits.maxPushConstantsSize && "Push constants too big");
+        
+        pushConstRanges.push_back(std::move(vkRange));
+    }
+    
+    // -------- End of push constants handler --------------
+    
+    // Layouts are compatible for set N when push constant ranges & set layouts up to N are identical
+    auto& compatibility = state.compatibility;
+    compatibility.push_back(pushConstRanges.size());
+    for(const auto& range : pushConstRanges)
+    {
+        compatibility.push_back(range.stageFlags);
+        compatibility.push_back(range.offset);
+        compatibility.push_back(range.size);
+    }
+    
+    for(uint32_t set{ 0 }; set < state.setCount; ++set)
+    {
+        compatibility.push_back(reinterpret_cast<uint64_t>(state.setLayouts[set]));
     }
+
+    // Create pipeline layout
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = state.setCount;
+    pipelineLayoutInfo.pSetLayouts = state.setLayouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstRanges.size());
+    pipelineLayoutInfo.pPushConstantRanges = pushConstRanges.data();
+    
+    mDevice->CreatePipelineLayout(&pipelineLayoutInfo, nullptr, &state.layout);
+}
+
+VulkanPipelineState VulkanRenderer::CreatePipelineState(const Pipeline& pipeline, const std::vector<VulkanShaderSource>& modules, VkRenderPass renderPass) const
+{
+    const auto& effect = pipeline.effect;
     
-    VkDescriptorSetLayoutCreateInfo layoutInfo{};
-    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = static_cast<uint32_t>(layoutBindings.size());
-    layoutInfo.pBindings = layoutBindings.data();
+    VulkanPipelineState state;
     
-    VkDescriptorSetLayout descriptorSetLayout{ VK_NULL_HANDLE };
-    mDevice->CreateDescriptorSetLayout(&layoutInfo, nullptr, &descriptorSetLayout);
+    // Setup stages, modules are owned by shader library
+    std::vector<VkPipelineShaderStageCreateInfo> stageInfos;
+    stageInfos.reserve(modules.size());
+    
+    for(const auto& module : modules)
+    {
+        VkPipelineShaderStageCreateInfo shaderStageInfo{};
+        shaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shaderStageInfo.stage = ConvertType(module.stage);
+        shaderStageInfo.module = module.module->module;
+        shaderStageInfo.pName = "main";
+        
+        stageInfos.push_back(std::move(shaderStageInfo));
+    }
     
-    // Create descriptor sets
-    std::vector<VkDescriptorSetLayout> layouts(SWAP_CHAIN_IMAGE_COUNT, descriptorSetLayout); // Depends on swap chain images cnt
+    // Setup attributes
+    const auto bindingCount = effect.GetBindingCount();
     
-    VkDescriptorSetAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = mDescriptorPool;
-    allocInfo.descriptorSetCount = static_cast<uint32_t>(SWAP_CHAIN_IMAGE_COUNT);        // Depends on swap chain images cnt
-    allocInfo.pSetLayouts = layouts.data();
+    std::vector<VkVertexInputBindingDescription> bindingDescriptions;
+    bindingDescriptions.reserve(bindingCount);
     
-    std::vector<VkDescriptorSet> descriptorSets;
-    descriptorSets.resize(SWAP_CHAIN_IMAGE_COUNT);           // Depends on swap chain images cnt
-    mDevice->AllocateDescriptorSets(&allocInfo, descriptorSets.data());
+    std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
     
-    DescriptorSetLayoutDeviceObject dslDeviceObject(descriptorSetLayout);
-    effect.mDescriptorSetLayouts.push_back(Basify(std::move(dslDeviceObject)));
+    for(uint8_t bindingId{ 0 }; bindingId < bindingCount; ++bindingId)
+    {
+        VkVertexInputBindingDescription desc{};
+        desc.binding = bindingId;
+        desc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        
+        const auto& attributes = effect.GetBindingDescriptor(bindingId);
+        const auto attributeCount = attributes.size();
+        
+        for(uint8_t location{ 0 }; location < attributeCount; ++location)
+        {
+            const auto attributeFormat = attributes[location];
+            
+            VkVertexInputAttributeDescription attribDesc;
+            attribDesc.binding = bindingId;
+            attribDesc.location = (attributeCount == 1) ? bindingId : location;
+            attribDesc.format = ConvertType(attributeFormat);
+            attribDesc.offset = desc.stride;
+            
+            attributeDescriptions.push_back(std::move(attribDesc));
+            
+            desc.stride += GetSizeFromFormat(attributeFormat);
+        }
+        
+        bindingDescriptions.push_back(std::move(desc));
+    }
     
-    for (size_t i = 0; i < SWAP_CHAIN_IMAGE_COUNT; ++i)
+    // Instance data follow all vertex bindings, they're sourced from the uniform ring
+    if(effect.IsInstanced())
     {
-        effect.mDescriptorSets.push_back(Basify(DescriptorSetDeviceObject(descriptorSets[i])));
+        VkVertexInputBindingDescription desc{};
+        desc.binding = bindingCount;
+        desc.stride = sizeof(Effect::InstanceData);
+        desc.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+        
+        for(uint32_t attribute{ 0 }; attribute < Effect::InstanceAttributeCount; ++attribute)
+        {
+            VkVertexInputAttributeDescription attribDesc;
+            attribDesc.binding = bindingCount;
+            attribDesc.location = *effect.mInstanceLocation + attribute;
+            attribDesc.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+            attribDesc.offset = attribute * sizeof(Vector4f);
+            
+            attributeDescriptions.push_back(std::move(attribDesc));
+        }
+        
+        bindingDescriptions.push_back(std::move(desc));
     }
     
+    // Vertex input
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(bindingDescriptions.size());
+    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+    vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions.data();
+    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+    
+    // Input assembly
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.primitiveRestartEnable = VK_FALSE;
+    
+    // Set layouts & pipeline layout are built the same way for compute pipelines
+    CreatePipelineLayout(effect, state);
+    
     // Viewport & scissor test
     VkViewport viewport{};
     viewport.x = 0.0f;
@@ -570,39 +1183,6 @@ void VulkanRenderer::CreatePipeline(Pipeline& pipeline, const DeviceObject& rend
     dynamicState.dynamicStateCount = 2;
     dynamicState.pDynamicStates = dynamicStates;
     
-    // -------- Handle push constants ----------------------
-    
-    std::vector<VkPushConstantRange> pushConstRanges;
-    pushConstRanges.reserve(effect.mConstantRanges.size());
-    
-    for(const auto& range : effect.mConstantRanges)
-    {
-        VkPushConstantRange vkRange;
-        vkRange.stageFlags = ConvertType(range.stage);
-        vkRange.offset = range.offset;
-        vkRange.size = range.size;
-        
-        pushConstRanges.push_back(std::move(vkRange));
-    }
-    
-    // -------- End of push constants handler --------------
-
-    // Create pipeline layout
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 0;
-    pipelineLayoutInfo.pSetLayouts = nullptr;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
-    pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstRanges.size());
-    pipelineLayoutInfo.pPushConstantRanges = pushConstRanges.data();
-    
-    VkPipelineLayout layout{ VK_NULL_HANDLE };
-    mDevice->CreatePipelineLayout(&pipelineLayoutInfo, nullptr, &layout);
-    
-    RenderPassVisitor rpv;
-    renderPass.Accept(rpv);
-    
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
     pipelineInfo.stageCount = static_cast<uint32_t>(stageInfos.size());
@@ -613,8 +1193,8 @@ void VulkanRenderer::CreatePipeline(Pipeline& pipeline, const DeviceObject& rend
     pipelineInfo.pRasterizationState = &rasterizer;
     pipelineInfo.pMultisampleState = &multisampling;
     pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.layout = layout;
-    pipelineInfo.renderPass = rpv.renderPass;
+    pipelineInfo.layout = state.layout;
+    pipelineInfo.renderPass = renderPass;
     pipelineInfo.subpass = pipeline.mSubpassIndex;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     pipelineInfo.pDynamicState = &dynamicState;
@@ -636,245 +1216,417 @@ void VulkanRenderer::CreatePipeline(Pipeline& pipeline, const DeviceObject& rend
         pipelineInfo.pDepthStencilState = &depthStencil;
     }
     
-    VkPipeline pipelineHandle{ VK_NULL_HANDLE };
-    mDevice->CreateGraphicsPipeline(VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipelineHandle);
+    const auto creationStart = std::chrono::steady_clock::now();
+    mDevice->CreateGraphicsPipeline(mPipelineCache->GetHandle(), 1, &pipelineInfo, nullptr, &state.pipeline);
+    const std::chrono::duration<float, std::milli> creationTime = std::chrono::steady_clock::now() - creationStart;
+    
+    mPipelineCache->RecordPipelineCreation(creationTime.count());
     
-    pipeline.mDeviceObject = PipelineDeviceObject(pipelineHandle, layout);
+    return state;
+}
+
+PipelineKey VulkanRenderer::MakePipelineKey(const Pipeline& pipeline, const std::vector<VulkanShaderSource>& modules, VkRenderPass renderPass)
+{
+    const auto& effect = pipeline.effect;
     
-    mResourceManager.push_back(&pipeline.mDeviceObject);
+    // Every list is prefixed by its size, so differently split states never produce equal words
+    PipelineKey key;
     
-    for (size_t i = 0; i < SWAP_CHAIN_IMAGE_COUNT; ++i)          // Depends on swap chain images cnt
+    // Library keeps single module per distinct code for its whole life, module identity is identity of the code
+    key.Append(modules.size());
+    for(const auto& module : modules)
     {
-        std::vector<VkWriteDescriptorSet> descriptorWrites(effect.mUniformBuffers.size() + effect.mTextures.size());
-        
-        uint32_t descriptorWriteIdx{ 0 };
-        
-        // TODO: Descriptor writes for ubos, they should bind to unique ubos per frame, do not share them
-        for(const auto ubo : effect.mUniformBuffers)
-        {
-            const Buffer& uboBuffer = *ubo;
-            
-            BufferObjectVisitor bufferVisitor;
-            uboBuffer.deviceObject.Accept(bufferVisitor);
-            
-            VkDescriptorBufferInfo bufferInfo{};
-            bufferInfo.buffer = bufferVisitor.buffer;
-            bufferInfo.offset = uboBuffer.offset;
-            bufferInfo.range = uboBuffer.dataSize;
-            
-            descriptorWrites[descriptorWriteIdx].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptorWrites[descriptorWriteIdx].dstSet = descriptorSets[i];
-            descriptorWrites[descriptorWriteIdx].dstBinding = 0;
-            descriptorWrites[descriptorWriteIdx].dstArrayElement = 0;
-            descriptorWrites[descriptorWriteIdx].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            descriptorWrites[descriptorWriteIdx].descriptorCount = 1;
-            descriptorWrites[descriptorWriteIdx].pBufferInfo = &bufferInfo;
-            
-            ++descriptorWriteIdx;
-        }
+        key.Append(static_cast<uint64_t>(module.stage));
+        key.Append(reinterpret_cast<uint64_t>(module.module.get()));
+    }
+    
+    const auto bindingCount = effect.GetBindingCount();
+    key.Append(bindingCount);
+    for(uint8_t bindingId{ 0 }; bindingId < bindingCount; ++bindingId)
+    {
+        const auto& attributes = effect.GetBindingDescriptor(bindingId);
         
-        // TODO: Descriptor writes for textures, they should bind to unique ubos per frame, do not share them
-        for(const auto texture : effect.mTextures)
+        key.Append(attributes.size());
+        for(const auto attributeFormat : attributes)
         {
-            const Attachable& image = *texture;
-            
-            const auto& texDeviceObject = image.GetDeviceObject();
-            
-            AttachableVisitor attachable;
-            texDeviceObject.Accept(attachable);
-            
-            VkDescriptorImageInfo imageInfo{};
-            imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageInfo.imageView = attachable.imageView;
-            imageInfo.sampler = [this, &attachable](){
-                if(attachable.sampler == VK_NULL_HANDLE)
-                {
-                    SamplerDesc samplerDesc;
-                    samplerDesc.anisotropy = 0;
-                    samplerDesc.minFilter = FilterMode::Linear;
-                    samplerDesc.magFilter = FilterMode::Linear;
-                    samplerDesc.uAddressMode = AddressMode::Repeat;
-                    samplerDesc.vAddressMode = AddressMode::Repeat;
-                    samplerDesc.wAddressMode = AddressMode::Repeat;
-                    
-                    return CreateSamplerImpl(samplerDesc);
-                }
-                
-                return attachable.sampler;
-            }();
-            
-            descriptorWrites[descriptorWriteIdx].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptorWrites[descriptorWriteIdx].dstSet = descriptorSets[i];
-            descriptorWrites[descriptorWriteIdx].dstBinding = 1;
-            descriptorWrites[descriptorWriteIdx].dstArrayElement = 0;
-            descriptorWrites[descriptorWriteIdx].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            descriptorWrites[descriptorWriteIdx].descriptorCount = 1;
-            descriptorWrites[descriptorWriteIdx].pImageInfo = &imageInfo;
-            
-            ++descriptorWriteIdx;
+            key.Append(static_cast<uint64_t>(attributeFormat));
         }
-        
-        mDevice->UpdateDescriptorSets(static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
     }
-}
-
-uint32_t VulkanRenderer::FindMemoryTypeIndex(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
-{
-    VkPhysicalDeviceMemoryProperties memProperties{ VK_NULL_HANDLE };
-    
-    const auto& renderAPI = VulkanAPI::Service();
-    renderAPI.GetPhysicalDeviceMemoryProperties(mDevice->GetPhysicalDevice(), &memProperties);
     
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; ++i)
+    const auto setCount = effect.GetDescriptorSetCount();
+    key.Append(setCount);
+    for(uint32_t set{ 0 }; set < std::min(setCount, Effect::FrequencyCount); ++set)
     {
-        if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
+        const auto& uniformBindings = effect.GetUniformBindings(static_cast<DescriptorFrequency>(set));
+        key.Append(uniformBindings.size());
+        for(const auto& binding : uniformBindings)
         {
-            return i;
+            key.Append(binding.size());
+            for(const auto& uniform : binding)
+            {
+                key.Append(static_cast<uint64_t>(uniform.type));
+                key.Append(static_cast<uint64_t>(uniform.stage));
+                key.Append(uniform.count);
+            }
         }
     }
     
-    return 0;
-}
-
-BufferDeviceObject VulkanRenderer::CreateBufferImpl(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkSharingMode sharingMode) const
-{
-    VkBufferCreateInfo bufferInfo{};
-    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size = size;
-    bufferInfo.usage = usage;
-    bufferInfo.sharingMode = sharingMode;
-    bufferInfo.flags = 0;
+    key.Append(effect.mConstantRanges.size());
+    for(const auto& range : effect.mConstantRanges)
+    {
+        key.Append(static_cast<uint64_t>(range.stage));
+        key.Append(range.offset);
+        key.Append(range.size);
+    }
     
-    VkBuffer buffer{ VK_NULL_HANDLE };
-    mDevice->CreateBuffer(&bufferInfo, nullptr, &buffer);
+    // Only stages of bindless textures matter, textures themselves are selected by pushed indices
+    key.Append(effect.mBindlessTextures.size());
+    for(const auto& texture : effect.mBindlessTextures)
+    {
+        key.Append(static_cast<uint64_t>(texture.stage));
+    }
     
-    VkMemoryRequirements memRequirements{};
-    mDevice->GetBufferMemoryRequirements(buffer, &memRequirements);
+    key.Append(effect.IsInstanced());
+    key.Append(effect.mInstanceLocation.value_or(0));
     
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = FindMemoryTypeIndex(memRequirements.memoryTypeBits, properties);
+    // Rasterizer & blend states are fixed for all pipelines, only depth state is configurable
+    key.Append(pipeline.depthTestEnabled);
+    key.Append(pipeline.depthWriteEnabled);
     
-    VkDeviceMemory memory{ VK_NULL_HANDLE };
-    mDevice->AllocateMemory(&allocInfo, nullptr, &memory);
-    mDevice->BindBufferMemory(buffer, memory, 0);
+    // Pipeline is compatible with render passes compatible with the one it was created for, same handle is the strictest form
+    key.Append(reinterpret_cast<uint64_t>(renderPass));
+    key.Append(pipeline.mSubpassIndex);
     
-    return BufferDeviceObject(buffer, memory);
+    return key;
 }
 
-ImageDeviceObject VulkanRenderer::CreateImageImpl(const VulkanImageDesc& descriptor) const
+VulkanPipelineState VulkanRenderer::CreateComputePipelineState(const Pipeline& pipeline, const VulkanShaderSource& module) const
 {
-    VkImageCreateInfo imageInfo{};
-    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    imageInfo.imageType = descriptor.type;
-    imageInfo.extent.width = descriptor.width;
-    imageInfo.extent.height = descriptor.height;
-    imageInfo.extent.depth = descriptor.depth;
-    imageInfo.mipLevels = descriptor.mipMapLevels;
-    imageInfo.arrayLayers = 1;
-    imageInfo.format = descriptor.format;
-    imageInfo.tiling = descriptor.tiling;
-    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    imageInfo.usage = descriptor.usage;
-    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-    imageInfo.sharingMode = descriptor.sharingMode;
-    imageInfo.flags = 0;
-    
-    VkImage image{ VK_NULL_HANDLE };
-    mDevice->CreateImage(&imageInfo, nullptr, &image);
-    
-    VkMemoryRequirements memRequirements;
-    mDevice->GetImageMemoryRequirements(image, &memRequirements);
+    VulkanPipelineState state;
+    state.bindPoint = VK_PIPELINE_BIND_POINT_COMPUTE;
+    
+    CreatePipelineLayout(pipeline.effect, state);
+    
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = module.module->module;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = state.layout;
+    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = FindMemoryTypeIndex(memRequirements.memoryTypeBits, descriptor.memoryProps);
+    const auto creationStart = std::chrono::steady_clock::now();
+    mDevice->CreateComputePipeline(mPipelineCache->GetHandle(), 1, &pipelineInfo, nullptr, &state.pipeline);
+    const std::chrono::duration<float, std::milli> creationTime = std::chrono::steady_clock::now() - creationStart;
     
-    VkDeviceMemory imageMemory{ VK_NULL_HANDLE };
-    mDevice->AllocateMemory(&allocInfo, nullptr, &imageMemory);
-    mDevice->BindImageMemory(image, imageMemory, 0);
+    mPipelineCache->RecordPipelineCreation(creationTime.count());
     
-    return ImageDeviceObject(image, imageMemory);
+    return state;
 }
 
-void VulkanRenderer::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) const
+void VulkanRenderer::LoadShaderBundle(const std::string& filePath)
 {
-    mCommandBufferFactory->CreateScopeCommandBuffer().CopyBuffer(srcBuffer, dstBuffer, size);
+    File bundleFile(filePath);
+    bundleFile.Open(EFileAccessMode::Read);
+    
+    mShaderLibrary->LoadBundle(ShaderBundle::FromData(bundleFile.Read()));
 }
 
-void VulkanRenderer::CopyBufferToImage(VkBuffer buffer, VkImage image, const uint32_t width, const uint32_t height) const
+void VulkanRenderer::CreatePipeline(Pipeline& pipeline, const DeviceObject& renderPass)
 {
-    mCommandBufferFactory->CreateScopeCommandBuffer().CopyBufferToImage(buffer, image, width, height);
+    auto& effect = pipeline.effect;
+    
+    const VkRenderPass vulkanRenderPass = mResources->renderPasses.Get(renderPass).renderPass.Get();
+    
+    if(effect.UsesBindless() && !mBindlessTable)
+    {
+        throw std::runtime_error("Bindless textures are not supported by the device!");
+    }
+    
+    const auto modules = LoadModules(effect);
+    auto key = MakePipelineKey(pipeline, modules, vulkanRenderPass);
+    
+    auto state = mPipelineRegistry->Find(key);
+    if(!state)
+    {
+        state = mPipelineRegistry->Add(std::move(key), CreatePipelineState(pipeline, modules, vulkanRenderPass));
+    }
+    
+    CreateDescriptorSets(pipeline, *state);
+    
+    // Recreated pipeline releases its previous state
+    mResources->pipelines.Remove(pipeline.mDeviceObject);
+    pipeline.mDeviceObject = mResources->pipelines.Add(PipelineDeviceObject(std::move(state)));
 }
 
-void VulkanRenderer::CreateBuffer(const BufferDesc& desc, DeviceObject& bufferObject)
+void VulkanRenderer::CreateComputePipeline(Pipeline& pipeline)
 {
-    BufferDeviceObject bdo;
+    const auto& effect = pipeline.effect;
     
-    const auto vulkanMemoryType = ConvertType(desc.memoryUsage);
-    const auto vulkanBufferUsage = ConvertType(desc.usage);
+    const auto modules = LoadModules(effect);
+    if(modules.size() != 1 || modules.front().stage != ModuleStage::Compute)
+    {
+        throw std::runtime_error("Compute pipeline requires single compute module!");
+    }
     
-    if(desc.memoryUsage & MemoryType::DeviceLocal)
+    // Bindless table is visible to graphics stages only
+    if(effect.UsesBindless())
     {
-        constexpr auto stagingBufferUsage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        constexpr auto stagingMemoryType = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-        
-        const auto stagingBuffer = CreateBufferImpl(desc.bufferSize, stagingBufferUsage, stagingMemoryType, VK_SHARING_MODE_EXCLUSIVE);
-        
-        void* data{ nullptr };
-        mDevice->MapMemory(stagingBuffer.memory, 0, desc.bufferSize, 0, &data);
-        memcpy(data, desc.data, (size_t)desc.bufferSize);
-        mDevice->UnmapMemory(stagingBuffer.memory);
-        
-        bdo = CreateBufferImpl(desc.bufferSize, vulkanBufferUsage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, vulkanMemoryType, VK_SHARING_MODE_EXCLUSIVE);
-        
-        CopyBuffer(stagingBuffer.buffer, bdo.buffer, desc.bufferSize);
-        
-        mDevice->DestroyBuffer(stagingBuffer.buffer, nullptr);
-        mDevice->FreeMemory(stagingBuffer.memory, nullptr);
+        throw std::runtime_error("Bindless textures are not supported by compute pipelines!");
     }
-    else if(desc.memoryUsage & MemoryType::HostVisible)
+    
+    // Key of graphics state with no render pass & compute stage never equals key of graphics pipeline
+    auto key = MakePipelineKey(pipeline, modules, VK_NULL_HANDLE);
+    
+    auto state = mPipelineRegistry->Find(key);
+    if(!state)
     {
-        bdo = CreateBufferImpl(desc.bufferSize, vulkanBufferUsage, vulkanMemoryType, VK_SHARING_MODE_EXCLUSIVE);
-        if(desc.data)
-        {
-            void* data{ nullptr };
-            mDevice->MapMemory(bdo.memory, 0, desc.bufferSize, 0, &data);
-            memcpy(data, desc.data, (size_t)desc.bufferSize);
-            
-            VkMappedMemoryRange mappedRange{};
-            mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-            mappedRange.memory = bdo.memory;
-            mappedRange.offset = 0;
-            mappedRange.size = VK_WHOLE_SIZE;
-            
-            mDevice->FlushMappedMemoryRanges(1, &mappedRange);
-            
-            bdo.mappedMemory = data;
-        }
+        state = mPipelineRegistry->Add(std::move(key), CreateComputePipelineState(pipeline, modules.front()));
     }
     
-    bufferObject = bdo;
+    CreateDescriptorSets(pipeline, *state);
     
-    mResourceManager.push_back(&bufferObject);
+    // Recreated pipeline releases its previous state
+    mResources->pipelines.Remove(pipeline.mDeviceObject);
+    pipeline.mDeviceObject = mResources->pipelines.Add(PipelineDeviceObject(std::move(state)));
 }
 
-void VulkanRenderer::CreateFramebuffer(Framebuffer& framebuffer, const RenderPass& renderPass)
+void VulkanRenderer::CreateDescriptorSets(Pipeline& pipeline, const VulkanPipelineState& state)
 {
-    std::vector<VkImageView> imageViewAttachments;
-    imageViewAttachments.reserve(framebuffer.mAttachments.size());
+    auto& effect = pipeline.effect;
     
-    for(auto attachment : framebuffer.mAttachments)
+    for(auto& layout : effect.mDescriptorSetLayouts)
     {
-        const bool isDepthAttachment(attachment->GetUsage() & ImageUsage::DepthStencilAttachment);
-        
-        VulkanImageDesc vulkanImageDescriptor;
-        vulkanImageDescriptor.width = attachment->GetWidth();
-        vulkanImageDescriptor.height = attachment->GetHeight();
-        vulkanImageDescriptor.depth = 1;
-        vulkanImageDescriptor.mipMapLevels = 1;
+        mResources->descriptorSetLayouts.Remove(layout);
+    }
+    
+    for(auto& descriptorSet : effect.mDescriptorSets)
+    {
+        mResources->descriptorSets.Remove(descriptorSet);
+    }
+    
+    effect.mDescriptorSetLayouts.clear();
+    effect.mDescriptorSets.clear();
+    effect.mBindlessIndices.clear();
+    
+    for(const auto& texture : effect.mBindlessTextures)
+    {
+        const auto* textureObject = mResources->textures.Find(texture.image->GetDeviceObject());
+        
+        if(!textureObject || textureObject->bindlessIndex == TextureDeviceObject::NoBindlessIndex)
+        {
+            throw std::runtime_error("Bindless texture has to be created by CreateTexture!");
+        }
+        
+        effect.mBindlessIndices.push_back(textureObject->bindlessIndex);
+        effect.mBindlessIndices.push_back(textureObject->samplerIndex);
+    }
+    
+    // Writes of every set, infos are referenced by descriptor writes until the update, their addresses have to stay stable
+    std::array<std::vector<VkWriteDescriptorSet>, Effect::DescriptorSetCount> descriptorWrites;
+    
+    std::vector<VkDescriptorBufferInfo> bufferInfos;
+    bufferInfos.reserve(effect.mUniformBuffers.size() + effect.mDynamicUniformBuffers.size() + effect.mStorageBuffers.size());
+    
+    std::vector<VkDescriptorImageInfo> imageInfos;
+    imageInfos.reserve(effect.mTextures.size() + effect.mStorageImages.size());
+    
+    const auto addWrite = [&descriptorWrites](DescriptorFrequency frequency, uint32_t binding, VkDescriptorType type) -> VkWriteDescriptorSet& {
+        VkWriteDescriptorSet& write = descriptorWrites[static_cast<uint32_t>(frequency)].emplace_back();
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstBinding = binding;
+        write.dstArrayElement = 0;
+        write.descriptorType = type;
+        write.descriptorCount = 1;
+        return write;
+    };
+    
+    for(const auto& ubo : effect.mUniformBuffers)
+    {
+        const Buffer& uboBuffer = *ubo.buffer;
+        
+        VkDescriptorBufferInfo& bufferInfo = bufferInfos.emplace_back();
+        bufferInfo.buffer = mResources->buffers.Get(uboBuffer.deviceObject).buffer;
+        bufferInfo.offset = uboBuffer.offset;
+        bufferInfo.range = uboBuffer.dataSize;
+        
+        addWrite(ubo.frequency, ubo.binding, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER).pBufferInfo = &bufferInfo;
+    }
+    
+    // Dynamic buffers all live in the uniform ring, offset of the data is supplied when the set is bound
+    for(const auto& dynamicBuffer : effect.mDynamicUniformBuffers)
+    {
+        VkDescriptorBufferInfo& bufferInfo = bufferInfos.emplace_back();
+        bufferInfo.buffer = mUniformRing->GetBuffer();
+        bufferInfo.offset = 0;
+        bufferInfo.range = dynamicBuffer.buffer->dataSize;
+        
+        addWrite(dynamicBuffer.frequency, dynamicBuffer.binding, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC).pBufferInfo = &bufferInfo;
+    }
+    
+    for(const auto& storageBuffer : effect.mStorageBuffers)
+    {
+        VkDescriptorBufferInfo& bufferInfo = bufferInfos.emplace_back();
+        bufferInfo.buffer = mResources->buffers.Get(storageBuffer.buffer->deviceObject).buffer;
+        bufferInfo.offset = storageBuffer.buffer->offset;
+        bufferInfo.range = storageBuffer.buffer->dataSize;
+        
+        addWrite(storageBuffer.frequency, storageBuffer.binding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER).pBufferInfo = &bufferInfo;
+    }
+    
+    for(const auto& texture : effect.mTextures)
+    {
+        const auto attachable = GetAttachable(*mResources, texture.image->GetDeviceObject());
+        
+        VkDescriptorImageInfo& imageInfo = imageInfos.emplace_back();
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfo.imageView = attachable.imageView;
+        imageInfo.sampler = attachable.sampler != VK_NULL_HANDLE ? attachable.sampler : mDefaultSampler;
+        
+        addWrite(texture.frequency, texture.binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER).pImageInfo = &imageInfo;
+    }
+    
+    // Storage images are read & written unfiltered in general layout
+    for(const auto& storageImage : effect.mStorageImages)
+    {
+        const auto attachable = GetAttachable(*mResources, storageImage.image->GetDeviceObject());
+        
+        VkDescriptorImageInfo& imageInfo = imageInfos.emplace_back();
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        imageInfo.imageView = attachable.imageView;
+        imageInfo.sampler = VK_NULL_HANDLE;
+        
+        addWrite(storageImage.frequency, storageImage.binding, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE).pImageInfo = &imageInfo;
+    }
+    
+    // Sets are immutable, effects writing the same resources share them. Unused lower sets get the shared empty set
+    for(uint32_t set{ 0 }; set < state.setCount; ++set)
+    {
+        auto descriptorSet = set == Effect::BindlessSet ? mBindlessTable->GetSet() : mDescriptorAllocator->GetSet(state.setLayouts[set], descriptorWrites[set]);
+        
+        effect.mDescriptorSetLayouts.push_back(mResources->descriptorSetLayouts.Add(DescriptorSetLayoutDeviceObject(state.setLayouts[set])));
+        effect.mDescriptorSets.push_back(mResources->descriptorSets.Add(DescriptorSetDeviceObject(std::move(descriptorSet))));
+    }
+}
+
+BufferDeviceObject VulkanRenderer::CreateBufferImpl(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkSharingMode sharingMode) const
+{
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = sharingMode;
+    bufferInfo.flags = 0;
+    
+    // Buffers shared with async compute are accessed by both families without ownership transfers
+    if(sharingMode == VK_SHARING_MODE_CONCURRENT)
+    {
+        bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(mSharedQueueFamilies.size());
+        bufferInfo.pQueueFamilyIndices = mSharedQueueFamilies.data();
+    }
+    
+    VkBuffer buffer{ VK_NULL_HANDLE };
+    mDevice->CreateBuffer(&bufferInfo, nullptr, &buffer);
+    
+    VkMemoryRequirements memRequirements{};
+    mDevice->GetBufferMemoryRequirements(buffer, &memRequirements);
+    
+    const auto allocation = mAllocator->Allocate(memRequirements, properties, VulkanResourceKind::Linear);
+    mDevice->BindBufferMemory(buffer, allocation.memory, allocation.offset);
+    
+    return BufferDeviceObject(buffer, allocation);
+}
+
+VkImage VulkanRenderer::CreateImageHandle(const VulkanImageDesc& descriptor) const
+{
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = descriptor.type;
+    imageInfo.extent.width = descriptor.width;
+    imageInfo.extent.height = descriptor.height;
+    imageInfo.extent.depth = descriptor.depth;
+    imageInfo.mipLevels = descriptor.mipMapLevels;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = descriptor.format;
+    imageInfo.tiling = descriptor.tiling;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = descriptor.usage;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = descriptor.sharingMode;
+    imageInfo.flags = 0;
+    
+    VkImage image{ VK_NULL_HANDLE };
+    mDevice->CreateImage(&imageInfo, nullptr, &image);
+    
+    return image;
+}
+
+ImageDeviceObject VulkanRenderer::CreateImageImpl(const VulkanImageDesc& descriptor) const
+{
+    const VkImage image = CreateImageHandle(descriptor);
+    
+    VkMemoryRequirements memRequirements;
+    mDevice->GetImageMemoryRequirements(image, &memRequirements);
+    
+    const auto kind = descriptor.tiling == VK_IMAGE_TILING_OPTIMAL ? VulkanResourceKind::Optimal : VulkanResourceKind::Linear;
+    
+    const auto allocation = mAllocator->Allocate(memRequirements, descriptor.memoryProps, kind);
+    mDevice->BindImageMemory(image, allocation.memory, allocation.offset);
+    
+    return ImageDeviceObject(image, allocation);
+}
+
+UploadHandle VulkanRenderer::CreateBuffer(const BufferDesc& desc, DeviceObject& bufferObject)
+{
+    BufferDeviceObject bdo;
+    UploadHandle uploadHandle{ 0 };
+    
+    const auto vulkanMemoryType = ConvertType(desc.memoryUsage);
+    const auto vulkanBufferUsage = ConvertType(desc.usage);
+    
+    if(desc.memoryUsage & MemoryType::DeviceLocal)
+    {
+        bdo = CreateBufferImpl(desc.bufferSize, vulkanBufferUsage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, vulkanMemoryType, VK_SHARING_MODE_EXCLUSIVE);
+        
+        uploadHandle = mUploadManager->UploadBuffer(bdo.buffer, desc.data, desc.bufferSize);
+    }
+    else if(desc.memoryUsage & MemoryType::HostVisible)
+    {
+        bdo = CreateBufferImpl(desc.bufferSize, vulkanBufferUsage, vulkanMemoryType, VK_SHARING_MODE_EXCLUSIVE);
+        if(desc.data)
+        {
+            memcpy(bdo.allocation.mappedData, desc.data, (size_t)desc.bufferSize);
+            mAllocator->Flush(bdo.allocation, 0, desc.bufferSize);
+        }
+    }
+    
+    bufferObject = mResources->buffers.Add(std::move(bdo));
+    
+    return uploadHandle;
+}
+
+void VulkanRenderer::CreateFramebuffer(Framebuffer& framebuffer, const RenderPass& renderPass)
+{
+    std::vector<VkImageView> imageViewAttachments;
+    imageViewAttachments.reserve(framebuffer.mAttachments.size());
+    
+    for(auto attachment : framebuffer.mAttachments)
+    {
+        // Attachments created beforehand, e.g. placed by frame graph, are attached as they are
+        if(attachment->GetDeviceObject().IsValid())
+        {
+            imageViewAttachments.push_back(GetAttachable(*mResources, attachment->GetDeviceObject()).imageView);
+            continue;
+        }
+        
+        const bool isDepthAttachment(attachment->GetUsage() & ImageUsage::DepthStencilAttachment);
+        
+        VulkanImageDesc vulkanImageDescriptor;
+        vulkanImageDescriptor.width = attachment->GetWidth();
+        vulkanImageDescriptor.height = attachment->GetHeight();
+        vulkanImageDescriptor.depth = 1;
+        vulkanImageDescriptor.mipMapLevels = 1;
         vulkanImageDescriptor.data = nullptr;
         vulkanImageDescriptor.format = ConvertType(attachment->GetFormat());
         vulkanImageDescriptor.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
@@ -885,207 +1637,916 @@ void VulkanRenderer::CreateFramebuffer(Framebuffer& framebuffer, const RenderPas
         
         const ImageDeviceObject imageDeviceObject = CreateImageImpl(vulkanImageDescriptor);
         
+        const VkImageAspectFlags aspect = isDepthAttachment ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+        
         TransitionImageLayout(imageDeviceObject.image,
-                              vulkanImageDescriptor.format,
+                              aspect,
                               VK_IMAGE_LAYOUT_UNDEFINED,
                               isDepthAttachment ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
         
-        VkImageView imageView = CreateImageView(imageDeviceObject.image,
-                                                vulkanImageDescriptor.format,
-                                                isDepthAttachment ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT);
+        VkImageView imageView = CreateImageView(imageDeviceObject.image, vulkanImageDescriptor.format, aspect);
         
-        attachment->SetDeviceObject(Basify(VulkanAttachmentDeviceObject{ imageDeviceObject.image, imageDeviceObject.memory, imageView }));
+        attachment->SetDeviceObject(mResources->attachments.Add(VulkanAttachmentDeviceObject{ imageDeviceObject.image, imageDeviceObject.allocation, imageView }));
         
         imageViewAttachments.push_back(imageView);
     }
     
-    const auto& renderPassDO = renderPass.GetDeviceObject();
-
-    RenderPassVisitor rpVisitor;
-    renderPassDO.Accept(rpVisitor);
+    const VkRenderPass vulkanRenderPass = mResources->renderPasses.Get(renderPass.GetDeviceObject()).renderPass.Get();
+    
+    framebuffer.SetDeviceObject(mResources->framebuffers.Add(CreateFramebufferImpl(framebuffer.GetWidth(), framebuffer.GetHeight(), imageViewAttachments, vulkanRenderPass)));
+}
+
+DeviceObject VulkanRenderer::CreateImage(const ImageDesc& desc)
+{
+    _ASSERT(!desc.data && "Data of images are uploaded by CreateTexture");
+    
+    VulkanImageDesc vulkanImageDescriptor;
+    vulkanImageDescriptor.width = desc.width;
+    vulkanImageDescriptor.height = std::max(desc.height, 1u);
+    vulkanImageDescriptor.depth = std::max(desc.depth, 1u);
+    vulkanImageDescriptor.mipMapLevels = std::max(desc.mipMapLevels, 1u);
+    vulkanImageDescriptor.format = ConvertType(desc.format);
+    vulkanImageDescriptor.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    vulkanImageDescriptor.tiling = VK_IMAGE_TILING_OPTIMAL;
+    vulkanImageDescriptor.memoryProps = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    vulkanImageDescriptor.usage = ConvertType(desc.usage);
+    
+    const auto imageDeviceObject = CreateImageImpl(vulkanImageDescriptor);
+    
+    const VkImageAspectFlags aspect = Detail::IsDepthFormat(desc.format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+    VkImageView imageView = CreateImageView(imageDeviceObject.image, vulkanImageDescriptor.format, aspect);
+    
+    // Sampled image uses the default sampler, bindless table reads it once it's moved to shader read only layout
+    TextureDeviceObject textureObject(imageDeviceObject.image, imageView, imageDeviceObject.allocation, VK_NULL_HANDLE);
+    
+    if(mBindlessTable && (desc.usage & ImageUsage::Sampled))
+    {
+        textureObject.bindlessIndex = mBindlessTable->AddTexture(imageView);
+        textureObject.samplerIndex = mBindlessTable->AddSampler(mDefaultSampler);
+    }
+    
+    return mResources->textures.Add(std::move(textureObject));
+}
+
+MemoryRequirements VulkanRenderer::GetAttachmentMemoryRequirements(const AttachableDescriptor& desc) const
+{
+    // Requirements depend on the driver's layout of the image, they are read from temporary image without memory
+    const VkImage image = CreateImageHandle(MakeAttachmentImageDesc(desc));
+    
+    VkMemoryRequirements memRequirements{};
+    mDevice->GetImageMemoryRequirements(image, &memRequirements);
+    mDevice->DestroyImage(image, nullptr);
+    
+    return MemoryRequirements{ memRequirements.size, memRequirements.alignment, memRequirements.memoryTypeBits };
+}
+
+DeviceObject VulkanRenderer::CreateMemoryHeap(const MemoryRequirements& requirements)
+{
+    VkMemoryRequirements memRequirements{};
+    memRequirements.size = requirements.size;
+    memRequirements.alignment = requirements.alignment;
+    memRequirements.memoryTypeBits = requirements.memoryTypeBits;
+    
+    // Heap holds optimal images only, so it never shares granularity page with buffers
+    VulkanMemoryHeapDeviceObject heap;
+    heap.allocation = mAllocator->Allocate(memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VulkanResourceKind::Optimal);
+    
+    return mResources->heaps.Add(std::move(heap));
+}
+
+DeviceObject VulkanRenderer::CreatePlacedAttachment(const AttachableDescriptor& desc, const DeviceObject& heap, uint64_t offset)
+{
+    const auto& heapObject = mResources->heaps.Get(heap);
+    const VulkanImageDesc imageDesc = MakeAttachmentImageDesc(desc);
+    
+    const VkImage image = CreateImageHandle(imageDesc);
+    
+    VkMemoryRequirements memRequirements{};
+    mDevice->GetImageMemoryRequirements(image, &memRequirements);
+    
+    _ASSERT(offset % memRequirements.alignment == 0 && "Attachment is misaligned in the heap");
+    _ASSERT(offset + memRequirements.size <= heapObject.allocation.size && "Attachment exceeds the heap");
+    _ASSERT((memRequirements.memoryTypeBits & (1u << heapObject.allocation.memoryTypeIndex)) && "Memory type of the heap isn't allowed for the attachment");
+    
+    mDevice->BindImageMemory(image, heapObject.allocation.memory, heapObject.allocation.offset + offset);
+    
+    const VkImageAspectFlags aspect = Detail::IsDepthFormat(desc.format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+    const VkImageView imageView = CreateImageView(image, imageDesc.format, aspect);
+    
+    // Memory belongs to the heap, the attachment has no allocation of its own
+    return mResources->attachments.Add(VulkanAttachmentDeviceObject{ image, VulkanAllocation{}, imageView });
+}
+
+UploadHandle VulkanRenderer::CreateTexture(const ImageDesc& desc, const SamplerDesc& samplerDesc, DeviceObject& texture)
+{    
+    if(desc.memoryUsage & MemoryType::DeviceLocal)
+    {
+        VulkanImageDesc vulkanImageDescriptor;
+        vulkanImageDescriptor.width = desc.width;
+        vulkanImageDescriptor.height = desc.height;
+        vulkanImageDescriptor.depth = desc.depth;
+        vulkanImageDescriptor.mipMapLevels = desc.mipMapLevels;
+        vulkanImageDescriptor.data = desc.data;
+        vulkanImageDescriptor.format = ConvertType(desc.format);
+        vulkanImageDescriptor.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        vulkanImageDescriptor.tiling = VK_IMAGE_TILING_OPTIMAL;
+        vulkanImageDescriptor.memoryProps = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        vulkanImageDescriptor.usage = ConvertType(desc.usage) | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        
+        const auto imageDeviceObject = CreateImageImpl(vulkanImageDescriptor);
+        
+        // Layout transitions are recorded together with the copy, image ends in shader read only layout
+        const auto uploadHandle = mUploadManager->UploadImage(imageDeviceObject.image, desc.width, desc.height, GetSizeFromFormat(desc.format), desc.data);
+        
+        VkImageView imageView = CreateImageView(imageDeviceObject.image, vulkanImageDescriptor.format, VK_IMAGE_ASPECT_COLOR_BIT);
+        VkSampler sampler = GetSampler(samplerDesc);
+        
+        TextureDeviceObject textureObject(imageDeviceObject.image, imageView, imageDeviceObject.allocation, sampler);
+        
+        if(mBindlessTable)
+        {
+            textureObject.bindlessIndex = mBindlessTable->AddTexture(imageView);
+            textureObject.samplerIndex = mBindlessTable->AddSampler(sampler);
+        }
+        
+        texture = mResources->textures.Add(std::move(textureObject));
+        
+        return uploadHandle;
+    }
+    else
+    {
+        //    // Create target image for copy
+        //    VkImageCreateInfo imageInfo = vks::initializers::imageCreateInfo();
+        //    imageInfo.extent.depth = 1;
+        //    imageInfo.arrayLayers = 1;
+        //    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        //    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        //    imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        //    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        //    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        //
+        //    VK_CHECK_RESULT(vkCreateImage(device->logicalDevice, &imageInfo, nullptr, &fontImage));
+        //
+    }
+    
+    return 0;
+}
+
+DeviceObject VulkanRenderer::CreateSemaphore(const SemaphoreDescriptor& desc) const
+{
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    
+    VkSemaphore smph{ VK_NULL_HANDLE };
+    mDevice->CreateSemaphore(&semaphoreInfo, nullptr, &smph);
+    
+    return mResources->semaphores.Add(SemaphoreDeviceObject{ smph });
+}
+
+DeviceObject VulkanRenderer::CreateFence(const FenceDescriptor& desc) const
+{
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceInfo.flags = desc.signaled ? VK_FENCE_CREATE_SIGNALED_BIT : 0;
+    
+    VkFence f{ VK_NULL_HANDLE };
+    mDevice->CreateFence(&fenceInfo, nullptr, &f);
+    
+    return mResources->fences.Add(FenceDeviceObject{ f });
+}
+
+DeviceObject VulkanRenderer::CreateEvent(const EventDescriptor& desc) const
+{
+    throw std::runtime_error("Unimplemented!");
+    return DeviceObject{};
+}
+
+void VulkanRenderer::MapMemory(const DeviceObject& deviceObject, uint32_t size, void* data)
+{
+    const auto* bufferObject = mResources->buffers.Find(deviceObject);
+    const auto* textureObject = mResources->textures.Find(deviceObject);
+    
+    _ASSERT((bufferObject || textureObject) && "Only buffers & textures can be mapped");
+    
+    const VulkanAllocation& allocation = bufferObject ? bufferObject->allocation : textureObject->allocation;
+    
+    _ASSERT(allocation.mappedData && "Only host visible resources can be mapped");
+    
+    memcpy(allocation.mappedData, data, size);
+    mAllocator->Flush(allocation, 0, size);
+}
+
+void VulkanRenderer::UnmapMemory(const DeviceObject& deviceObject) const
+{
+    // Host visible memory stays mapped by the allocator until the resource is destroyed
+}
+
+void VulkanRenderer::WriteUniformData(Buffer& buffer, const void* data)
+{
+    // Data belong to the frame being recorded, its ring region is rewound once the slot is released
+    BeginFrame();
+    
+    buffer.offset = mUniformRing->Write(data, buffer.dataSize);
+}
+
+template<typename CommandRecorder>
+void VulkanRenderer::Record(CommandRecorder&& record)
+{
+    const uint32_t command = record(GetCommandStream());
+    
+    if(mActiveSubpass)
+        mActiveSubpass->Push(command);
+}
+
+template<typename CommandRecorder>
+void VulkanRenderer::RecordState(BoundState state, const StateKey& binding, CommandRecorder&& record)
+{
+    if(mActiveSubpass && mActiveSubpass->IsBound(state, binding))
+    {
+        mFrameStatistics.bindsElided++;
+        return;
+    }
+    
+    mFrameStatistics.bindsIssued++;
+    
+    const uint32_t command = record(GetCommandStream());
+    
+    if(mActiveSubpass)
+        mActiveSubpass->PushState(state, command, binding);
+}
+
+void VulkanRenderer::Render(const Object3d& object, const Pipeline& pipeline, float viewDepth)
+{
+    const auto& vb = object.GetVertexBuffer();
+    
+    if(!vb.mStreams[0].get())
+        return;
+    
+    const auto& effect = pipeline.effect;
+    
+    const auto& pipelineState = mResources->pipelines.Get(pipeline.mDeviceObject).GetState();
+    
+    // Material is identified by sets & bindless textures of the draw, dynamic offsets change per draw so they're left out
+    std::array<uint64_t, Effect::DescriptorSetCount + 1> material{};
+    for(size_t set = 0; set < effect.mDescriptorSets.size(); ++set)
+    {
+        const VkDescriptorSet descriptorSet = mResources->descriptorSets.Get(effect.mDescriptorSets[set]).GetDescriptorSet();
+        
+        material[set] = reinterpret_cast<uint64_t>(descriptorSet);
+    }
+    
+    material.back() = PipelineKey::Digest(effect.mBindlessIndices.data(), effect.mBindlessIndices.size() * sizeof(uint32_t));
+    
+    VulkanQueuedDraw draw;
+    draw.vertexBuffer = &vb;
+    draw.pipeline = &pipeline;
+    
+    for(size_t i = 0; i < effect.mDynamicUniformBuffers.size(); ++i)
+    {
+        draw.dynamicOffsets[i] = effect.mDynamicUniformBuffers[i].buffer->offset;
+    }
+    
+    const uint64_t materialDigest = PipelineKey::Digest(material.data(), sizeof(material));
+    
+    uint64_t key{ 0 };
+    if(effect.IsInstanced())
+    {
+        draw.transform = object.GetTransform();
+        draw.instanceParameters = object.GetInstanceParameters();
+        
+        // Mesh is identified by the device buffers, objects may share them through distinct vertex buffers
+        const uint64_t meshWords[] = { GetStreamBinding(vb, BufferUsage::VertexBuffer), GetStreamBinding(vb, BufferUsage::IndexBuffer), vb.mStreams[1]->GetCount() };
+        const uint64_t mesh = PipelineKey::Digest(meshWords, sizeof(meshWords));
+        
+        // Instances differ only in their instance data, depth order is lost by drawing them at once
+        const uint64_t instanceWords[] = {
+            reinterpret_cast<uint64_t>(pipelineState.pipeline),
+            materialDigest,
+            mesh,
+            PipelineKey::Digest(draw.dynamicOffsets.data(), sizeof(draw.dynamicOffsets))
+        };
+        
+        draw.instanceKey = PipelineKey::Digest(instanceWords, sizeof(instanceWords));
+        key = VulkanDrawQueue::MakeInstancedKey(mActiveSubpassIndex, reinterpret_cast<uint64_t>(pipelineState.pipeline), materialDigest, mesh);
+    }
+    else
+    {
+        key = VulkanDrawQueue::MakeKey(mActiveSubpassIndex, reinterpret_cast<uint64_t>(pipelineState.pipeline), materialDigest, viewDepth);
+    }
+    
+    mDrawQueue.Push(key);
+    mQueuedDraws.push_back(draw);
+    
+    // Outside of render pass there is nothing to sort the draw with
+    if(!mActiveSubpass)
+        FlushDraws();
+}
+
+void VulkanRenderer::FlushDraws()
+{
+    if(mDrawQueue.IsEmpty())
+        return;
+    
+    MICROPROFILE_SCOPEI("Renderer", "FlushDraws", 0x0080ff);
+    
+    const auto& entries = mDrawQueue.Sort();
+    for(size_t first = 0; first < entries.size();)
+    {
+        const auto& draw = mQueuedDraws[entries[first].index];
+        
+        size_t last = first + 1;
+        if(draw.instanceKey == 0)
+        {
+            RecordDraw(draw, 1, 0);
+            first = last;
+            continue;
+        }
+        
+        // Equal keys only bucket the draws, colliding digests of different meshes or materials mustn't share a draw
+        while(last < entries.size() && mQueuedDraws[entries[last].index].instanceKey == draw.instanceKey && CanDrawAsInstances(draw, mQueuedDraws[entries[last].index]))
+        {
+            ++last;
+        }
+        
+        const uint32_t instanceOffset = WriteInstanceData(&entries[first], last - first);
+        RecordDraw(draw, static_cast<uint32_t>(last - first), instanceOffset);
+        
+        first = last;
+    }
+    
+    mDrawQueue.Clear();
+    mQueuedDraws.clear();
+}
+
+bool VulkanRenderer::CanDrawAsInstances(const VulkanQueuedDraw& first, const VulkanQueuedDraw& draw) const
+{
+    const auto& firstEffect = first.pipeline->effect;
+    const auto& effect = draw.pipeline->effect;
+    
+    if(mResources->pipelines.Get(first.pipeline->mDeviceObject).GetPipeline() != mResources->pipelines.Get(draw.pipeline->mDeviceObject).GetPipeline())
+        return false;
+    
+    if(firstEffect.mDescriptorSets.size() != effect.mDescriptorSets.size() || firstEffect.mBindlessIndices != effect.mBindlessIndices || first.dynamicOffsets != draw.dynamicOffsets)
+        return false;
+    
+    for(size_t set = 0; set < effect.mDescriptorSets.size(); ++set)
+    {
+        if(mResources->descriptorSets.Get(firstEffect.mDescriptorSets[set]).GetDescriptorSet() != mResources->descriptorSets.Get(effect.mDescriptorSets[set]).GetDescriptorSet())
+            return false;
+    }
+    
+    const auto& firstVb = *first.vertexBuffer;
+    const auto& vb = *draw.vertexBuffer;
+    
+    return firstVb.mStreams[1]->GetCount() == vb.mStreams[1]->GetCount() &&
+           HaveEqualStreams(firstVb, vb, BufferUsage::VertexBuffer) &&
+           HaveEqualStreams(firstVb, vb, BufferUsage::IndexBuffer);
+}
+
+uint32_t VulkanRenderer::WriteInstanceData(const VulkanDrawQueue::Entry* entries, size_t count)
+{
+    mInstanceTransforms.clear();
+    for(size_t i = 0; i < count; ++i)
+    {
+        mInstanceTransforms.push_back(mQueuedDraws[entries[i].index].transform);
+    }
+    
+    // Matrices of the whole group are composed by single batch kernel call
+    mInstanceMatrices.resize(count);
+    Math::Batch::ComposeTransforms(MakeTransformStreams(mInstanceTransforms.data()), mInstanceMatrices.data(), count);
+    
+    mInstanceData.resize(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        mInstanceData[i].world = mInstanceMatrices[i];
+        mInstanceData[i].parameters = mQueuedDraws[entries[i].index].instanceParameters;
+    }
+    
+    return mUniformRing->Write(mInstanceData.data(), static_cast<uint32_t>(count * sizeof(Effect::InstanceData)));
+}
+
+void VulkanRenderer::RecordDraw(const VulkanQueuedDraw& draw, uint32_t instanceCount, uint32_t instanceOffset)
+{
+    const auto& vb = *draw.vertexBuffer;
+    const auto& pipeline = *draw.pipeline;
+    
+    // Batch restores state bound before it, so draws may be spread across secondary buffers even though binds are elided
+    if(mActiveSubpass)
+        mActiveSubpass->BeginBatch();
+    
+    const auto& pipelineState = mResources->pipelines.Get(pipeline.mDeviceObject).GetState();
+    
+    RecordState(BoundState::Pipeline, MakePipelineBinding(mBindingKey, pipelineState.pipeline), [&pipelineState](VulkanCommandStream& commands){ return commands.BindPipeline(pipelineState.pipeline, pipelineState.bindPoint); });
+    RecordState(BoundState::VertexBuffer, MakeStreamBinding(mBindingKey, vb, BufferUsage::VertexBuffer), [this, &vb](VulkanCommandStream& commands){ return RecordVertexBuffers(commands, *mResources, vb); });
+    RecordState(BoundState::IndexBuffer, MakeStreamBinding(mBindingKey, vb, BufferUsage::IndexBuffer), [this, &vb](VulkanCommandStream& commands){ return RecordIndexBuffer(commands, *mResources, vb); });
+    RecordDescriptorSets(GetCommandStream(), pipeline, draw.dynamicOffsets.data());
+    RecordBindlessIndices(pipeline);
+    
+    // Every instanced draw reads its own range of the ring, its bind is never redundant
+    if(draw.instanceKey != 0)
+    {
+        mFrameStatistics.bindsIssued++;
+        const VkBuffer instanceBuffer = mUniformRing->GetBuffer();
+        const VkDeviceSize bufferOffset = instanceOffset;
+        
+        Record([&](VulkanCommandStream& commands){ return commands.BindVertexBuffers(pipeline.effect.GetBindingCount(), 1, &instanceBuffer, &bufferOffset); });
+    }
+    
+    const auto indexCount = static_cast<uint32_t>(vb.mStreams[1]->GetCount());
+    Record([indexCount, instanceCount](VulkanCommandStream& commands){ return commands.DrawIndexed(indexCount, instanceCount, 0, 0, 0); });
+}
+
+void VulkanRenderer::FlushUploads()
+{
+    mUploadManager->Flush();
+}
+
+bool VulkanRenderer::IsUploadComplete(UploadHandle handle)
+{
+    return mUploadManager->IsComplete(handle);
+}
+
+void VulkanRenderer::WaitForUpload(UploadHandle handle)
+{
+    mUploadManager->Wait(handle);
+}
+
+void VulkanRenderer::WaitIdle() const
+{
+    mDevice->WaitIdle();
+    
+    // Nothing references released resources anymore
+    mDeletionQueue->Flush();
+}
+
+MemoryStatistics VulkanRenderer::GetMemoryStatistics() const
+{
+    return mAllocator->GetStatistics();
+}
+
+PipelineCacheStatistics VulkanRenderer::GetPipelineCacheStatistics() const
+{
+    return mPipelineCache->GetStatistics();
+}
+
+void VulkanRenderer::DestroyDeviceObject(DeviceObject& deviceObject) const
+{
+    // Frames in flight may still use the resource, its destruction is deferred until they're finished
+    const uint64_t releaseFrame = GetReleaseFrame();
+    
+    // Objects leave their table & the handle becomes null, stale & null handles are ignored
+    switch(deviceObject.GetType())
+    {
+        case DeviceObjectType::Buffer:
+            if(auto buffer = mResources->buffers.Remove(deviceObject))
+            {
+                // New buffer may get the same handle, cached sets writing this one can't be shared with it
+                mDescriptorAllocator->EvictBuffer(buffer->buffer);
+                mDeletionQueue->Release(std::move(*buffer), releaseFrame);
+            }
+            break;
+        case DeviceObjectType::Attachment:
+            if(auto attachment = mResources->attachments.Remove(deviceObject))
+            {
+                mDescriptorAllocator->EvictImageView(attachment->view);
+                mDeletionQueue->Release(std::move(*attachment), releaseFrame);
+            }
+            break;
+        case DeviceObjectType::SwapChain:
+            // Surface can't get new swap chain while the old one exists, it's destroyed right away
+            if(auto swapChain = mResources->swapChains.Remove(deviceObject))
+                DeviceObjectDestroyer(mDevice).Destroy(*swapChain);
+            break;
+        case DeviceObjectType::MemoryHeap:
+            if(auto heap = mResources->heaps.Remove(deviceObject))
+                mDeletionQueue->Release(std::move(*heap), releaseFrame);
+            break;
+        case DeviceObjectType::Texture:
+        {
+            // Table slot may still be sampled by frames in flight, it's reused once they're finished
+            if(auto texture = mResources->textures.Remove(deviceObject))
+            {
+                if(mBindlessTable && texture->bindlessIndex != TextureDeviceObject::NoBindlessIndex)
+                    mBindlessTable->ReleaseTexture(texture->bindlessIndex, releaseFrame);
+                
+                mDescriptorAllocator->EvictImageView(texture->imageView);
+                mDeletionQueue->Release(std::move(*texture), releaseFrame);
+            }
+            break;
+        }
+        case DeviceObjectType::Shader: mResources->shaders.Remove(deviceObject); break;
+        case DeviceObjectType::Pipeline: mResources->pipelines.Remove(deviceObject); break;
+        case DeviceObjectType::Framebuffer: mResources->framebuffers.Remove(deviceObject); break;
+        case DeviceObjectType::RenderPass: mResources->renderPasses.Remove(deviceObject); break;
+        case DeviceObjectType::Surface: mResources->surfaces.Remove(deviceObject); break;
+        case DeviceObjectType::DescriptorSetLayout: mResources->descriptorSetLayouts.Remove(deviceObject); break;
+        case DeviceObjectType::DescriptorSet: mResources->descriptorSets.Remove(deviceObject); break;
+        case DeviceObjectType::Semaphore: mResources->semaphores.Remove(deviceObject); break;
+        case DeviceObjectType::Fence: mResources->fences.Remove(deviceObject); break;
+        case DeviceObjectType::None:
+        case DeviceObjectType::Count:
+            break;
+    }
+}
+
+void VulkanRenderer::RenderGui(const VertexBufferBase& vb, const Pipeline& pipeline)
+{
+    const ImDrawData* imDrawData = ImGui::GetDrawData();
+    
+    if (imDrawData->CmdListsCount == 0)
+        return;
+    
+    const ImVec2& imViewSize = ImGui::GetIO().DisplaySize;
+    
+    struct PushConstantsBlock
+    {
+        Vector2f uiScale;
+        Vector2f translate;
+    };
+    
+    PushConstantsBlock pcb;
+    pcb.uiScale = Vector2f(2.0f / imViewSize.x, 2.0f / imViewSize.y);
+    pcb.translate = Vector2f(-1.0f, -1.0f);
+    
+    // Gui is drawn over objects submitted before it
+    FlushDraws();
+    
+    // Draw lists share vertex & index buffer offsets, whole gui is recorded as single batch
+    if(mActiveSubpass)
+        mActiveSubpass->BeginBatch();
+    
+    std::array<uint32_t, Effect::MaxDynamicUniformBuffers> dynamicOffsets{};
+    for(size_t i = 0; i < pipeline.effect.mDynamicUniformBuffers.size(); ++i)
+    {
+        dynamicOffsets[i] = pipeline.effect.mDynamicUniformBuffers[i].buffer->offset;
+    }
+    
+    const auto& pipelineState = mResources->pipelines.Get(pipeline.mDeviceObject).GetState();
+    
+    RecordDescriptorSets(GetCommandStream(), pipeline, dynamicOffsets.data());
+    RecordState(BoundState::Pipeline, MakePipelineBinding(mBindingKey, pipelineState.pipeline), [&pipelineState](VulkanCommandStream& commands){ return commands.BindPipeline(pipelineState.pipeline, pipelineState.bindPoint); });
+    SetViewport(Rectangle<float>(imViewSize.x, imViewSize.y));
+    // Constants are identified by compatibility of push constant ranges & their values
+    mBindingKey.Clear();
+    pipelineState.AppendCompatibility(mBindingKey, 0);
+    mBindingKey.Append(&pcb, sizeof(pcb));
+    
+    RecordState(BoundState::PushConstants, mBindingKey, [&pipelineState, &pcb](VulkanCommandStream& commands){
+        return commands.PushConstants(pipelineState.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstantsBlock), &pcb);
+    });
+    RecordState(BoundState::VertexBuffer, MakeStreamBinding(mBindingKey, vb, BufferUsage::VertexBuffer), [this, &vb](VulkanCommandStream& commands){ return RecordVertexBuffers(commands, *mResources, vb); });
+    RecordState(BoundState::IndexBuffer, MakeStreamBinding(mBindingKey, vb, BufferUsage::IndexBuffer), [this, &vb](VulkanCommandStream& commands){ return RecordIndexBuffer(commands, *mResources, vb); });
+    
+    int32_t vertexOffset{ 0 }, indexOffset{ 0 };
+    for (int32_t i = 0; i < imDrawData->CmdListsCount; ++i)
+    {
+        const ImDrawList* cmd_list = imDrawData->CmdLists[i];
+        for (int32_t j = 0; j < cmd_list->CmdBuffer.Size; j++)
+        {
+            const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[j];
+            
+            Rectangle<uint32_t> scissorRect;
+            scissorRect.offset.x = std::max((int32_t)(pcmd->ClipRect.x), 0);
+            scissorRect.offset.y = std::max((int32_t)(pcmd->ClipRect.y), 0);
+            scissorRect.width = (uint32_t)(pcmd->ClipRect.z - pcmd->ClipRect.x);
+            scissorRect.height = (uint32_t)(pcmd->ClipRect.w - pcmd->ClipRect.y);
+            
+            SetScissor(scissorRect);
+            Record([pcmd, indexOffset, vertexOffset](VulkanCommandStream& commands){ return commands.DrawIndexed(pcmd->ElemCount, 1, indexOffset, vertexOffset, 0); });
+            
+            indexOffset += pcmd->ElemCount;
+        }
+        vertexOffset += cmd_list->VtxBuffer.Size;
+    }
+}
+
+bool VulkanRenderer::IsGpuCullingSupported() const
+{
+    return mDevice->IsFeatureSupported(DeviceFeature::MultiDrawIndirect);
+}
+
+void VulkanRenderer::CreateGpuScene(GpuScene& scene, uint32_t capacity, const std::string& cullShaderPath)
+{
+    if(!IsGpuCullingSupported())
+    {
+        throw std::runtime_error("GPU culling is not supported by the device!");
+    }
+    
+    _ASSERT(capacity > 0 && "GPU scene has to hold at least one object");
+    
+    // Objects are written by staged copies, commands & their count by culling after they're cleared by fills.
+    // Culling may run on async compute queue, the buffers are shared with it
+    auto objects = CreateBufferImpl(capacity * sizeof(GpuObject),
+                                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                          GetComputeSharingMode());
+    
+    auto commands = CreateBufferImpl(capacity * sizeof(DrawIndexedIndirectCommand),
+                                           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                           GetComputeSharingMode());
+    
+    auto drawCount = CreateBufferImpl(sizeof(uint32_t),
+                                            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                            GetComputeSharingMode());
+    
+    scene.capacity = capacity;
+    scene.objectCount = 0;
+    
+    scene.objects.offset = 0;
+    scene.objects.dataSize = capacity * sizeof(GpuObject);
+    scene.objects.deviceObject = mResources->buffers.Add(std::move(objects));
+    
+    scene.commands.offset = 0;
+    scene.commands.dataSize = capacity * sizeof(DrawIndexedIndirectCommand);
+    scene.commands.deviceObject = mResources->buffers.Add(std::move(commands));
+    
+    scene.drawCount.offset = 0;
+    scene.drawCount.dataSize = sizeof(uint32_t);
+    scene.drawCount.deviceObject = mResources->buffers.Add(std::move(drawCount));
+    
+    // Constants are written per culling into the uniform ring, scenes culled by the same shader share the pipeline state
+    scene.mCullConstants.offset = 0;
+    scene.mCullConstants.dataSize = sizeof(CullConstants);
+    
+    auto& effect = scene.mCullPipeline.effect;
+    effect.AddModule(ModuleStage::Compute, cullShaderPath);
+    effect.AddDynamicUniformBuffer(ModuleStage::Compute, 0, scene.mCullConstants);
+    effect.AddStorageBuffer(ModuleStage::Compute, 1, scene.objects);
+    effect.AddStorageBuffer(ModuleStage::Compute, 2, scene.commands);
+    effect.AddStorageBuffer(ModuleStage::Compute, 3, scene.drawCount);
+    
+    CreateComputePipeline(scene.mCullPipeline);
+}
+
+void VulkanRenderer::UpdateGpuScene(GpuScene& scene, uint32_t first, uint32_t count, const GpuObject* objects)
+{
+    _ASSERT(first + count <= scene.capacity && "Objects don't fit into GPU scene");
+    
+    if(count == 0)
+        return;
+    
+    // Staged data belong to the frame being recorded like any other uniform data
+    BeginFrame();
+    
+    const uint32_t size = count * sizeof(GpuObject);
+    const uint32_t stagingOffset = mUniformRing->Write(objects, size);
+    
+    const VkBuffer objectsBuffer = mResources->buffers.Get(scene.objects.deviceObject).buffer;
+    
+    VkBufferCopy region{};
+    region.srcOffset = stagingOffset;
+    region.dstOffset = first * sizeof(GpuObject);
+    region.size = size;
+    
+    mStagedCopies.push_back({ objectsBuffer, region });
+    
+    scene.objectCount = std::max(scene.objectCount, first + count);
+}
+
+void VulkanRenderer::RecordStagedCopies(VulkanCommandStream& commands, VkPipelineStageFlags readerStages)
+{
+    if(mStagedCopies.empty())
+        return;
+    
+    _ASSERT(!mActiveSubpass && "Copies can't be recorded inside of render pass");
+    
+    // Previous frames may still read the objects, copies wait for them & shaders of this frame wait for the copies
+    commands.PipelineBarrier(readerStages, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, VK_ACCESS_TRANSFER_WRITE_BIT);
+    
+    for(const auto& copy : mStagedCopies)
+    {
+        commands.CopyBuffer(mUniformRing->GetBuffer(), copy.dstBuffer, copy.region);
+    }
+    
+    commands.PipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, readerStages, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
+    
+    mStagedCopies.clear();
+    mComputeDependency = true;
+}
+
+void VulkanRenderer::CullGpuScene(const GpuScene& scene, const FrustumPlanes& frustum)
+{
+    _ASSERT(!mActiveSubpass && "GPU scene has to be culled outside of render pass");
+    
+    if(mStagedCopies.empty() && scene.objectCount == 0)
+        return;
+    
+    // Culling runs on async compute queue if the device has one, graphics submission of the frame waits for it.
+    // Vertex shaders of the frame read the objects after the semaphore, compute queue doesn't support their stage.
+    VulkanCommandStream& commands = mAsyncCompute ? mAsyncCompute->GetCommandStream() : mCmdList;
+    const VkPipelineStageFlags objectReaderStages = mAsyncCompute ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : (VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    
+    RecordStagedCopies(commands, objectReaderStages);
+    
+    if(scene.objectCount == 0)
+        return;
+    
+    mComputeDependency = true;
+    
+    CullConstants constants;
+    constants.planes = frustum.planes;
+    constants.objectCount = scene.objectCount;
+    
+    const uint32_t constantsOffset = mUniformRing->Write(&constants, sizeof(constants));
+    
+    const VkBuffer commandsBuffer = mResources->buffers.Get(scene.commands.deviceObject).buffer;
+    
+    const VkBuffer drawCountBuffer = mResources->buffers.Get(scene.drawCount.deviceObject).buffer;
+    
+    // Draws of previous frames read the commands until culling overwrites them
+    commands.PipelineBarrier(VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, VK_ACCESS_TRANSFER_WRITE_BIT);
+    commands.FillBuffer(drawCountBuffer, 0, sizeof(uint32_t), 0);
+    
+    // Without count buffer all slots are drawn, zero index count makes the unwritten ones no-op
+    if(!mDevice->IsFeatureSupported(DeviceFeature::DrawIndirectCount))
+        commands.FillBuffer(commandsBuffer, 0, scene.objectCount * sizeof(DrawIndexedIndirectCommand), 0);
     
-    auto framebufferDO = CreateFramebufferImpl(framebuffer.GetWidth(), framebuffer.GetHeight(), imageViewAttachments, rpVisitor.renderPass);
-    framebuffer.SetDeviceObject(Basify(std::move(framebufferDO)));
+    commands.PipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    
+    RecordComputeState(commands, scene.mCullPipeline, &constantsOffset);
+    commands.Dispatch((scene.objectCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+    
+    commands.PipelineBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
 }
 
-DeviceObject VulkanRenderer::CreateImage(const ImageDesc& desc)
+void VulkanRenderer::RenderGpuScene(const GpuScene& scene, const VertexBufferBase& vb, const Pipeline& pipeline)
 {
+    if(scene.objectCount == 0)
+        return;
     
-}
-
-void VulkanRenderer::CreateTexture(const ImageDesc& desc, const SamplerDesc& samplerDesc, DeviceObject& texture)
-{    
-    if(desc.memoryUsage & MemoryType::DeviceLocal)
+    // Scene is drawn over objects submitted before it
+    FlushDraws();
+    
+    // Next culling overwrites the commands, it has to wait for the draws
+    mComputeDependency = true;
+    
+    if(mActiveSubpass)
+        mActiveSubpass->BeginBatch();
+    
+    const auto dynamicOffsets = GetDynamicOffsets(pipeline.effect);
+    
+    const auto& pipelineState = mResources->pipelines.Get(pipeline.mDeviceObject).GetState();
+    
+    RecordState(BoundState::Pipeline, MakePipelineBinding(mBindingKey, pipelineState.pipeline), [&pipelineState](VulkanCommandStream& commands){ return commands.BindPipeline(pipelineState.pipeline, pipelineState.bindPoint); });
+    RecordState(BoundState::VertexBuffer, MakeStreamBinding(mBindingKey, vb, BufferUsage::VertexBuffer), [this, &vb](VulkanCommandStream& commands){ return RecordVertexBuffers(commands, *mResources, vb); });
+    RecordState(BoundState::IndexBuffer, MakeStreamBinding(mBindingKey, vb, BufferUsage::IndexBuffer), [this, &vb](VulkanCommandStream& commands){ return RecordIndexBuffer(commands, *mResources, vb); });
+    RecordDescriptorSets(GetCommandStream(), pipeline, dynamicOffsets.data());
+    RecordBindlessIndices(pipeline);
+    
+    const VkBuffer commandsBuffer = mResources->buffers.Get(scene.commands.deviceObject).buffer;
+    
+    const uint32_t maxDrawCount = std::min(scene.objectCount, mDevice->GetProperties().limits.maxDrawIndirectCount);
+    
+    if(mDevice->IsFeatureSupported(DeviceFeature::DrawIndirectCount))
     {
-        constexpr auto stagingBufferUsage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        constexpr auto stagingMemoryType = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-        
-        const auto imageSize = desc.width * desc.height * GetSizeFromFormat(desc.format);
-        const auto stagingBdo = CreateBufferImpl(imageSize, stagingBufferUsage, stagingMemoryType, VK_SHARING_MODE_EXCLUSIVE);
-        
-        void* data{ nullptr };
-        mDevice->MapMemory(stagingBdo.memory, 0, imageSize, 0, &data);
-        memcpy(data, desc.data, (size_t)imageSize);
-        mDevice->UnmapMemory(stagingBdo.memory);
-        
-        VulkanImageDesc vulkanImageDescriptor;
-        vulkanImageDescriptor.width = desc.width;
-        vulkanImageDescriptor.height = desc.height;
-        vulkanImageDescriptor.depth = desc.depth;
-        vulkanImageDescriptor.mipMapLevels = desc.mipMapLevels;
-        vulkanImageDescriptor.data = desc.data;
-        vulkanImageDescriptor.format = ConvertType(desc.format);
-        vulkanImageDescriptor.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        vulkanImageDescriptor.tiling = VK_IMAGE_TILING_OPTIMAL;
-        vulkanImageDescriptor.memoryProps = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-        vulkanImageDescriptor.usage = ConvertType(desc.usage) | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-        
-        const auto imageDeviceObject = CreateImageImpl(vulkanImageDescriptor);
+        const VkBuffer drawCountBuffer = mResources->buffers.Get(scene.drawCount.deviceObject).buffer;
         
-        TransitionImageLayout(imageDeviceObject.image, vulkanImageDescriptor.format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-        CopyBufferToImage(stagingBdo.buffer, imageDeviceObject.image, desc.width, desc.height);
-        TransitionImageLayout(imageDeviceObject.image, vulkanImageDescriptor.format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-        
-        mDevice->DestroyBuffer(stagingBdo.buffer, nullptr);
-        mDevice->FreeMemory(stagingBdo.memory, nullptr);
-        
-        VkImageView imageView = CreateImageView(imageDeviceObject.image, vulkanImageDescriptor.format, VK_IMAGE_ASPECT_COLOR_BIT);
-        VkSampler sampler = CreateSamplerImpl(samplerDesc);
-        
-        texture = TextureDeviceObject(imageDeviceObject.image, imageView, imageDeviceObject.memory, sampler);
+        Record([&](VulkanCommandStream& commands){
+            return commands.DrawIndexedIndirectCount(commandsBuffer, 0, drawCountBuffer, 0, maxDrawCount, sizeof(DrawIndexedIndirectCommand));
+        });
     }
     else
     {
-        //    // Create target image for copy
-        //    VkImageCreateInfo imageInfo = vks::initializers::imageCreateInfo();
-        //    imageInfo.extent.depth = 1;
-        //    imageInfo.arrayLayers = 1;
-        //    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-        //    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-        //    imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-        //    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        //    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        //
-        //    VK_CHECK_RESULT(vkCreateImage(device->logicalDevice, &imageInfo, nullptr, &fontImage));
-        //
+        Record([&](VulkanCommandStream& commands){ return commands.DrawIndexedIndirect(commandsBuffer, 0, maxDrawCount, sizeof(DrawIndexedIndirectCommand)); });
     }
 }
 
-DeviceObject VulkanRenderer::CreateSemaphore(const SemaphoreDescriptor& desc) const
+std::vector<DrawIndexedIndirectCommand> VulkanRenderer::ReadGpuSceneCommands(const GpuScene& scene)
 {
-    VkSemaphoreCreateInfo semaphoreInfo{};
-    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    mDevice->WaitIdle();
     
-    VkSemaphore smph{ VK_NULL_HANDLE };
-    mDevice->CreateSemaphore(&semaphoreInfo, nullptr, &smph);
+    const VkBuffer commandsBuffer = mResources->buffers.Get(scene.commands.deviceObject).buffer;
+    
+    const VkBuffer drawCountBuffer = mResources->buffers.Get(scene.drawCount.deviceObject).buffer;
+    
+    const VkMemoryPropertyFlags readbackMemory = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    auto commandsReadback = CreateBufferImpl(scene.commands.dataSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, readbackMemory, VK_SHARING_MODE_EXCLUSIVE);
+    auto drawCountReadback = CreateBufferImpl(sizeof(uint32_t), VK_BUFFER_USAGE_TRANSFER_DST_BIT, readbackMemory, VK_SHARING_MODE_EXCLUSIVE);
+    
+    {
+        auto cmdBuffer = mCommandBufferFactory->CreateScopeCommandBuffer();
+        cmdBuffer.CopyBuffer(commandsBuffer, commandsReadback.buffer, scene.commands.dataSize);
+        cmdBuffer.CopyBuffer(drawCountBuffer, drawCountReadback.buffer, sizeof(uint32_t));
+        
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        
+        cmdBuffer.PipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, { barrier }, {}, {});
+    }
+    
+    uint32_t drawCount{ 0 };
+    std::memcpy(&drawCount, drawCountReadback.allocation.mappedData, sizeof(drawCount));
+    
+    const auto* commands = static_cast<const DrawIndexedIndirectCommand*>(commandsReadback.allocation.mappedData);
+    std::vector<DrawIndexedIndirectCommand> result(commands, commands + std::min(drawCount, scene.capacity));
+    
+    const DeviceObjectDestroyer destroyer(mDevice, mAllocator);
+    destroyer.Destroy(commandsReadback);
+    destroyer.Destroy(drawCountReadback);
     
-    return Basify(SemaphoreDeviceObject{ smph });
+    return result;
 }
 
-DeviceObject VulkanRenderer::CreateFence(const FenceDescriptor& desc) const
+std::array<uint32_t, Effect::MaxDynamicUniformBuffers> VulkanRenderer::GetDynamicOffsets(const Effect& effect)
 {
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = desc.signaled ? VK_FENCE_CREATE_SIGNALED_BIT : 0;
-    
-    VkFence f{ VK_NULL_HANDLE };
-    mDevice->CreateFence(&fenceInfo, nullptr, &f);
+    std::array<uint32_t, Effect::MaxDynamicUniformBuffers> dynamicOffsets{};
+    for(size_t i = 0; i < effect.mDynamicUniformBuffers.size(); ++i)
+    {
+        dynamicOffsets[i] = effect.mDynamicUniformBuffers[i].buffer->offset;
+    }
     
-    return Basify(FenceDeviceObject{ f });
+    return dynamicOffsets;
 }
 
-DeviceObject VulkanRenderer::CreateEvent(const EventDescriptor& desc) const
+void VulkanRenderer::RecordComputeState(VulkanCommandStream& commands, const Pipeline& pipeline, const uint32_t* dynamicOffsets)
 {
-    throw std::runtime_error("Unimplemented!");
-    return DeviceObject{};
+    _ASSERT(!mActiveSubpass && "Dispatch has to be recorded outside of render pass");
+    
+    const auto& pipelineState = mResources->pipelines.Get(pipeline.mDeviceObject).GetState();
+    
+    _ASSERT(pipelineState.bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE && "Pipeline has to be created by CreateComputePipeline");
+    
+    // Primary buffer doesn't track bound state, every dispatch binds all of it
+    commands.BindPipeline(pipelineState.pipeline, VK_PIPELINE_BIND_POINT_COMPUTE);
+    RecordDescriptorSets(commands, pipeline, dynamicOffsets);
 }
 
-void VulkanRenderer::MapMemory(const DeviceObject& deviceObject, uint32_t size, void* data)
+void VulkanRenderer::Dispatch(const Pipeline& pipeline, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
 {
-    MemoryMapVisitor visitor;
-    deviceObject.Accept(visitor);
+    const auto dynamicOffsets = GetDynamicOffsets(pipeline.effect);
     
-    void* pdata{ nullptr };
-    mDevice->MapMemory(visitor.memory, 0, size, 0, &pdata);
-    memcpy(pdata, data, size);
-    mDevice->UnmapMemory(visitor.memory);
+    RecordComputeState(mCmdList, pipeline, dynamicOffsets.data());
+    mCmdList.Dispatch(groupCountX, groupCountY, groupCountZ);
 }
 
-void VulkanRenderer::UnmapMemory(const DeviceObject& deviceObject) const
+void VulkanRenderer::DispatchIndirect(const Pipeline& pipeline, const Buffer& arguments)
 {
-    MemoryMapVisitor visitor;
-    deviceObject.Accept(visitor);
+    _ASSERT(arguments.offset % sizeof(uint32_t) == 0 && "Dispatch arguments have to be 4 byte aligned");
+    
+    const auto dynamicOffsets = GetDynamicOffsets(pipeline.effect);
     
-    mDevice->UnmapMemory(visitor.memory);
+    const VkBuffer argumentsBuffer = mResources->buffers.Get(arguments.deviceObject).buffer;
+    
+    RecordComputeState(mCmdList, pipeline, dynamicOffsets.data());
+    mCmdList.DispatchIndirect(argumentsBuffer, arguments.offset);
 }
 
-void VulkanRenderer::Render(const Object3d& object, const Pipeline& pipeline)
+void VulkanRenderer::BufferBarrier(const Buffer& buffer, const BarrierDesc& barrier)
 {
-    const auto& vb = object.GetVertexBuffer();
+    _ASSERT(!mActiveSubpass && "Barrier has to be recorded outside of render pass");
     
-    if(!vb.mStreams[0].get())
-        return;
-
-    mCmdList.push_back(BindPipeline(pipeline.mDeviceObject));
-    mCmdList.push_back(BindVertexBuffer(vb));
-    mCmdList.push_back(BindIndexBuffer(vb));
-    mCmdList.push_back(BindDescriptorSets(pipeline.mDeviceObject, pipeline.effect.mDescriptorSets[0]));
-    mCmdList.push_back(DrawIndexed(vb.mStreams[1]->GetCount(), 0, 0));
+    const VkBuffer vulkanBuffer = mResources->buffers.Get(buffer.deviceObject).buffer;
+    
+    mCmdList.BufferBarrier(vulkanBuffer, buffer.offset, buffer.dataSize,
+                           ConvertType(barrier.srcStageMask), ConvertType(barrier.dstStageMask),
+                           ConvertType(barrier.srcAccessMask), ConvertType(barrier.dstAccessMask));
 }
 
-void VulkanRenderer::DestroyDeviceObject(DeviceObject& buffer) const
+void VulkanRenderer::ImageBarrier(const Attachable& image, ImageLayout oldLayout, ImageLayout newLayout, const BarrierDesc& barrier)
 {
-    DestroyVisitor destroyVisitor(mDevice);
-    buffer.Accept(destroyVisitor);
+    _ASSERT(!mActiveSubpass && "Barrier has to be recorded outside of render pass");
+    
+    const auto attachable = GetAttachable(*mResources, image.GetDeviceObject());
+    
+    const VkImageAspectFlags aspect = Detail::IsDepthFormat(image.GetFormat()) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+    
+    mCmdList.ImageBarrier(attachable.image, aspect, ConvertType(oldLayout), ConvertType(newLayout),
+                          ConvertType(barrier.srcStageMask), ConvertType(barrier.dstStageMask),
+                          ConvertType(barrier.srcAccessMask), ConvertType(barrier.dstAccessMask));
 }
 
-void VulkanRenderer::RenderGui(const VertexBufferBase& vb, const Pipeline& pipeline)
+void VulkanRenderer::ImageBarriers(const ImageBarrierDesc* barriers, uint32_t count)
 {
-    const ImDrawData* imDrawData = ImGui::GetDrawData();
+    _ASSERT(!mActiveSubpass && "Barrier has to be recorded outside of render pass");
     
-    if (imDrawData->CmdListsCount == 0)
+    if(count == 0)
         return;
     
-    const ImVec2& imViewSize = ImGui::GetIO().DisplaySize;
-    
-    struct PushConstantsBlock
-    {
-        Vector2f uiScale;
-        Vector2f translate;
-    };
-    
-    PushConstantsBlock pcb;
-    pcb.uiScale = Vector2f(2.0f / imViewSize.x, 2.0f / imViewSize.y);
-    pcb.translate = Vector2f(-1.0f, -1.0f);
+    VkPipelineStageFlags srcStageMask{ 0 };
+    VkPipelineStageFlags dstStageMask{ 0 };
     
-    mCmdList.push_back(BindDescriptorSets(pipeline.mDeviceObject, pipeline.effect.mDescriptorSets[0]));
-    mCmdList.push_back(BindPipeline(pipeline.mDeviceObject));
-    mCmdList.push_back(SetViewportCommand(Rectangle<float>(imViewSize.x, imViewSize.y)));
-    mCmdList.push_back(PushConstants(pipeline.mDeviceObject, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstantsBlock), &pcb));
-    mCmdList.push_back(BindVertexBuffer(vb));
-    mCmdList.push_back(BindIndexBuffer(vb));
+    mImageBarriers.clear();
     
-    int32_t vertexOffset{ 0 }, indexOffset{ 0 };
-    for (int32_t i = 0; i < imDrawData->CmdListsCount; ++i)
+    for(uint32_t i = 0; i < count; ++i)
     {
-        const ImDrawList* cmd_list = imDrawData->CmdLists[i];
-        for (int32_t j = 0; j < cmd_list->CmdBuffer.Size; j++)
-        {
-            const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[j];
-            
-            Rectangle<uint32_t> scissorRect;
-            scissorRect.offset.x = std::max((int32_t)(pcmd->ClipRect.x), 0);
-            scissorRect.offset.y = std::max((int32_t)(pcmd->ClipRect.y), 0);
-            scissorRect.width = (uint32_t)(pcmd->ClipRect.z - pcmd->ClipRect.x);
-            scissorRect.height = (uint32_t)(pcmd->ClipRect.w - pcmd->ClipRect.y);
-            
-            mCmdList.push_back(SetScissorCommand(scissorRect));
-            mCmdList.push_back(DrawIndexed(pcmd->ElemCount, indexOffset, vertexOffset));
-            
-            indexOffset += pcmd->ElemCount;
-        }
-        vertexOffset += cmd_list->VtxBuffer.Size;
+        const auto& desc = barriers[i];
+        const auto attachable = GetAttachable(*mResources, desc.image->GetDeviceObject());
+        
+        const VkImageAspectFlags aspect = Detail::IsDepthFormat(desc.image->GetFormat()) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+        
+        mImageBarriers.push_back(VulkanCommandStream::MakeImageBarrier(attachable.image, aspect, ConvertType(desc.oldLayout), ConvertType(desc.newLayout),
+                                                                       ConvertType(desc.barrier.srcAccessMask), ConvertType(desc.barrier.dstAccessMask)));
+        
+        // Single barrier waits for source stages of all images, they're mostly the same stages anyway
+        srcStageMask |= ConvertType(desc.barrier.srcStageMask);
+        dstStageMask |= ConvertType(desc.barrier.dstStageMask);
     }
+    
+    mCmdList.ImageBarriers(srcStageMask, dstStageMask, mImageBarriers.data(), count);
 }
 
 void VulkanRenderer::CreateRenderPass(RenderPass& renderPass) const
@@ -1103,7 +2564,7 @@ void VulkanRenderer::CreateRenderPass(RenderPass& renderPass) const
         attachment.flags = 0;
         attachment.format = ConvertType(attachmentDesc.format);
         attachment.samples = VK_SAMPLE_COUNT_1_BIT;
-        attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        attachment.loadOp = ConvertType(attachmentDesc.loadOperation);
         attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
         attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
@@ -1193,7 +2654,7 @@ void VulkanRenderer::CreateRenderPass(RenderPass& renderPass) const
     renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
     renderPassInfo.pDependencies = dependencies.data();
     
-    renderPass.SetDeviceObject(Basify(RenderPassDeviceObject{ mDevice->CreateManagedRenderPass(&renderPassInfo, nullptr) }));
+    renderPass.SetDeviceObject(mResources->renderPasses.Add(RenderPassDeviceObject{ mDevice->CreateManagedRenderPass(&renderPassInfo, nullptr) }));
 }
 
 VkImageView VulkanRenderer::CreateImageView(const VkImage& image, const VkFormat& format, const VkImageAspectFlags flags) const
@@ -1236,120 +2697,59 @@ VulkanAttachmentDeviceObject VulkanRenderer::CreateAttachment(const uint32_t wid
     
     auto imageObject = CreateImageImpl(vulkanImageDescriptor);
     auto imageView = CreateImageView(imageObject.image, vulkanImageFormat, VK_IMAGE_ASPECT_DEPTH_BIT);
-    TransitionImageLayout(imageObject.image, vulkanImageFormat, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+    TransitionImageLayout(imageObject.image, VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
     
-    return VulkanAttachmentDeviceObject(imageObject.image, imageObject.memory, imageView);
+    return VulkanAttachmentDeviceObject(imageObject.image, imageObject.allocation, imageView);
 }
 
-void VulkanRenderer::TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout) const
+void VulkanRenderer::TransitionImageLayout(VkImage image, VkImageAspectFlags aspectMask, VkImageLayout oldLayout, VkImageLayout newLayout)
 {
-    auto cmdBuffer = mCommandBufferFactory->CreateScopeCommandBuffer();
-    
-    VkImageMemoryBarrier barrier{};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout = oldLayout;
-    barrier.newLayout = newLayout;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; // Used to transfer ownership between queues
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; // Used to transfer ownership between queues
-    barrier.image = image;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-    
-    VkPipelineStageFlags sourceStage;
-    VkPipelineStageFlags destinationStage;
+    const VulkanLayoutAccess source = GetLayoutAccess(oldLayout);
+    const VulkanLayoutAccess destination = GetLayoutAccess(newLayout);
     
-    if (newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
-    {
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-    }
-    else
-    {
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    }
+    // Image isn't used by any command yet, so the transition may wait for the next recording instead of own submission
+    mPendingTransitions.push_back(VulkanCommandStream::MakeImageBarrier(image, aspectMask, oldLayout, newLayout, source.access, destination.access));
+    mPendingTransitionSrcStages |= source.stages;
+    mPendingTransitionDstStages |= destination.stages;
+}
+
+void VulkanRenderer::RecordPendingTransitions()
+{
+    if(mPendingTransitions.empty())
+        return;
     
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
-    {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    }
-    else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-    {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        
-        sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    }
-    else if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
-    {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-        
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    }
-    else
-    {
-        throw std::invalid_argument("unsupported layout transition!");
-    }
+    mCmdList.ImageBarriers(mPendingTransitionSrcStages, mPendingTransitionDstStages, mPendingTransitions.data(), static_cast<uint32_t>(mPendingTransitions.size()));
     
-    cmdBuffer.PipelineBarrier(sourceStage, destinationStage, 0, {}, {}, { barrier });
+    mPendingTransitions.clear();
+    mPendingTransitionSrcStages = 0;
+    mPendingTransitionDstStages = 0;
 }
 
-std::vector<VkPipelineShaderStageCreateInfo> VulkanRenderer::PrepareModules(Effect& effect) const
+std::vector<VulkanShaderSource> VulkanRenderer::LoadModules(const Effect& effect) const
 {
     const auto& moduleDescriptors = effect.GetModuleDescriptors();
     
-    std::vector<VkPipelineShaderStageCreateInfo> stageInfos;
-    stageInfos.reserve(moduleDescriptors.size());
+    std::vector<VulkanShaderSource> modules;
+    modules.reserve(moduleDescriptors.size());
     
-    // Setup stages
     for(const auto& moduleDescriptor : moduleDescriptors)
     {
-        File shaderFile(moduleDescriptor.filePath);
-        shaderFile.Open(EFileAccessMode::Read);
-        auto shaderSource = shaderFile.Read();
-        
-        VkShaderModuleCreateInfo createInfo{};
-        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        createInfo.codeSize = shaderSource.size();
-        createInfo.pCode = reinterpret_cast<const uint32_t*>(shaderSource.data());
-        
-        VkShaderModule module{ VK_NULL_HANDLE };
-        mDevice->CreateShaderModule(&createInfo, nullptr, &module);
-        
-        VkPipelineShaderStageCreateInfo shaderStageInfo{};
-        shaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        shaderStageInfo.stage = ConvertType(moduleDescriptor.type);
-        shaderStageInfo.module = module;
-        shaderStageInfo.pName = "main";
-        
-        stageInfos.push_back(std::move(shaderStageInfo));
-        effect.mModules.push_back(Basify(VulkanShaderDeviceObject(module)));
+        modules.push_back({ moduleDescriptor.type, mShaderLibrary->Load(moduleDescriptor.filePath) });
     }
     
-    return stageInfos;
+    return modules;
 }
 
 CmdRecordResult VulkanRenderer::BeginCommandRecording()
 {
-    mDevice->FreeCommandBuffers(mCommandPool, 1, &mCmdBuff);
-    
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.commandPool = mCommandPool;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = 1;
+    // Swap chain usually started the frame already when acquiring image, headless rendering starts it here
+    BeginFrame();
     
-    mDevice->AllocateCommandBuffers(&allocInfo, &mCmdBuff);
+    mViewport.reset();
+    mScissor.reset();
     
-    mCmdList.push_back(BeginCommand(VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT));
+    mCmdList.BeginCommandBuffer(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    RecordPendingTransitions();
     
     return CmdRecordResult::Success;
 }
@@ -1360,65 +2760,297 @@ CmdRecordResult VulkanRenderer::BeginRenderPass(const RenderPass& renderPass)
     if(!activeFramebufferPtr)
         return CmdRecordResult::RPFramebufferUnavailable;
     
-    mCmdList.push_back(Vulkan::BeginRenderPass(renderPass));
+    // Attachments created while recording the frame are transitioned before the pass
+    RecordPendingTransitions();
+    
+    mActiveRenderPass = mResources->renderPasses.Get(renderPass.GetDeviceObject()).renderPass.Get();
+    mActiveFramebuffer = mResources->framebuffers.Get(activeFramebufferPtr->GetDeviceObject()).framebuffer.Get();
+    
+    const auto clearColors = activeFramebufferPtr->GetClearValues();
+    
+    std::vector<VkClearValue> clearValues;
+    clearValues.reserve(clearColors.size());
+    
+    for(const auto& clearColor : clearColors)
+    {
+        VkClearValue clearValue;
+        clearValue.color.float32[0] = clearColor.R() / 255.0f;
+        clearValue.color.float32[1] = clearColor.G() / 255.0f;
+        clearValue.color.float32[2] = clearColor.B() / 255.0f;
+        clearValue.color.float32[3] = clearColor.A() / 255.0f;
+        clearValues.push_back(clearValue);
+    }
+    
+    VkRect2D renderArea{};
+    renderArea.extent.width = static_cast<uint32_t>(activeFramebufferPtr->GetWidth());
+    renderArea.extent.height = static_cast<uint32_t>(activeFramebufferPtr->GetHeight());
+    
+    mCmdList.BeginRenderPass(mActiveRenderPass, mActiveFramebuffer, renderArea, clearValues.data(), static_cast<uint32_t>(clearValues.size()), VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    BeginSubpassRecording(0);
     
     return CmdRecordResult::Success;
 }
 
 CmdRecordResult VulkanRenderer::NextSubpass()
 {
-    mCmdList.push_back(NextRenderPassCommand());
+    if(!mActiveSubpass)
+        return CmdRecordResult::Failed;
+    
+    FlushDraws();
+    mCmdList.NextSubpass(VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    BeginSubpassRecording(mActiveSubpassIndex + 1);
+    
+    return CmdRecordResult::Success;
 }
 
 CmdRecordResult VulkanRenderer::SetViewport(const Rectangle<float>& viewport)
 {
-    mCmdList.push_back(SetViewportCommand(viewport));
+    // Draws submitted so far use the previous viewport
+    FlushDraws();
+    mViewport = viewport;
+    
+    const uint32_t command = GetCommandStream().SetViewport(ConvertType(viewport));
+    
+    if(mActiveSubpass)
+        mActiveSubpass->PushViewport(command);
+    
     return CmdRecordResult::Success;
 }
 
 CmdRecordResult VulkanRenderer::SetScissor(const Rectangle<uint32_t>& scissor)
 {
-    mCmdList.push_back(SetScissorCommand(scissor));
+    FlushDraws();
+    mScissor = scissor;
+    
+    const uint32_t command = GetCommandStream().SetScissor(ConvertType(scissor));
+    
+    if(mActiveSubpass)
+        mActiveSubpass->PushScissor(command);
+    
     return CmdRecordResult::Success;
 }
 
 CmdRecordResult VulkanRenderer::EndRenderPass()
 {
-    mCmdList.push_back(Vulkan::EndRenderPass());
+    FlushDraws();
+    mActiveSubpass = nullptr;
+    mCmdList.EndRenderPass();
     return CmdRecordResult::Success;
 }
 
-CmdRecordResult VulkanRenderer::EndCommandRecording(SwapChainBase* swapChain)
+void VulkanRenderer::BeginSubpassRecording(uint32_t subpass)
+{
+    mActiveSubpassIndex = subpass;
+    mActiveSubpass = &mFrames[mFrameIndex].commandRecorder->AddSubpass(mActiveRenderPass, mActiveFramebuffer, subpass);
+    
+    // Secondary buffers are recorded later, command reads them once the primary buffer is replayed
+    mCmdList.ExecuteCommands(mActiveSubpass->GetSecondaryBuffers());
+    
+    auto& commands = mActiveSubpass->GetCommands();
+    
+    if(mViewport)
+        mActiveSubpass->PushViewport(commands.SetViewport(ConvertType(*mViewport)));
+    
+    if(mScissor)
+        mActiveSubpass->PushScissor(commands.SetScissor(ConvertType(*mScissor)));
+}
+
+VulkanCommandStream& VulkanRenderer::GetCommandStream()
+{
+    return mActiveSubpass ? mActiveSubpass->GetCommands() : mCmdList;
+}
+
+void VulkanRenderer::RecordDescriptorSets(VulkanCommandStream& commands, const Pipeline& pipeline, const uint32_t* dynamicOffsets)
+{
+    const auto& effect = pipeline.effect;
+    const auto setCount = static_cast<uint32_t>(effect.mDescriptorSets.size());
+    
+    if(setCount == 0)
+        return;
+    
+    const auto& dynamicBuffers = effect.mDynamicUniformBuffers;
+    _ASSERT(dynamicBuffers.size() <= Effect::MaxDynamicUniformBuffers && "Too many dynamic uniform buffers");
+    
+    const auto& pipelineState = mResources->pipelines.Get(pipeline.mDeviceObject).GetState();
+    
+    // Binding of every set is identified by layout compatibility, the set itself & its dynamic offsets
+    auto& bindings = mSetBindingKeys;
+    std::array<VkDescriptorSet, Effect::DescriptorSetCount> descriptorSets{};
+    std::array<uint32_t, Effect::DescriptorSetCount> firstDynamicOffsets{};
+    
+    uint32_t dynamicOffsetCount{ 0 };
+    for(uint32_t set{ 0 }; set < setCount; ++set)
+    {
+        const VkDescriptorSet descriptorSet = mResources->descriptorSets.Get(effect.mDescriptorSets[set]).GetDescriptorSet();
+        
+        descriptorSets[set] = descriptorSet;
+        
+        auto& binding = bindings[set];
+        binding.Clear();
+        pipelineState.AppendCompatibility(binding, set + 1);
+        binding.Append(reinterpret_cast<uint64_t>(descriptorSet));
+        
+        firstDynamicOffsets[set] = dynamicOffsetCount;
+        while(dynamicOffsetCount < dynamicBuffers.size() && static_cast<uint32_t>(dynamicBuffers[dynamicOffsetCount].frequency) == set)
+        {
+            binding.Append(dynamicOffsets[dynamicOffsetCount++]);
+        }
+    }
+    
+    // Less frequently changing sets come first, the leading ones bound by previous objects are kept
+    const uint32_t firstSet = mActiveSubpass ? mActiveSubpass->GetBoundSetCount(bindings.data(), setCount) : 0;
+    if(firstSet == setCount)
+    {
+        mFrameStatistics.bindsElided++;
+        return;
+    }
+    
+    mFrameStatistics.bindsIssued++;
+    
+    const uint32_t firstOffset = firstDynamicOffsets[firstSet];
+    const uint32_t command = commands.BindDescriptorSets(pipelineState.layout, pipelineState.bindPoint, firstSet, setCount - firstSet,
+                                                         &descriptorSets[firstSet], dynamicOffsetCount - firstOffset, &dynamicOffsets[firstOffset]);
+    
+    if(mActiveSubpass)
+        mActiveSubpass->PushDescriptorSets(command, bindings.data(), firstSet, setCount);
+}
+
+void VulkanRenderer::RecordBindlessIndices(const Pipeline& pipeline)
 {
-    mCmdList.push_back(EndCommand());
+    const auto& effect = pipeline.effect;
+    
+    if(!effect.UsesBindless())
+        return;
     
-    for(const auto& cmd : mCmdList)
+    VkShaderStageFlags stageFlags{ 0 };
+    for(const auto& texture : effect.mBindlessTextures)
     {
-        cmd.Execute(*mDevice, Basify(CommandBufferDeviceObject{ mCmdBuff }));
+        stageFlags |= ConvertType(texture.stage);
     }
     
-    mCmdList.clear();
+    const auto& pipelineState = mResources->pipelines.Get(pipeline.mDeviceObject).GetState();
+    
+    // Pushed constants are identified by compatibility of push constant ranges & the indices, objects of equal material push them once
+    mBindingKey.Clear();
+    pipelineState.AppendCompatibility(mBindingKey, 0);
+    mBindingKey.Append(effect.GetBindlessConstantOffset());
+    mBindingKey.Append(effect.mBindlessIndices.data(), effect.mBindlessIndices.size() * sizeof(uint32_t));
+    
+    // Indices replace per material descriptor sets, objects of different materials keep all sets bound
+    RecordState(BoundState::PushConstants, mBindingKey, [&pipelineState, &effect, stageFlags](VulkanCommandStream& commands){
+        return commands.PushConstants(pipelineState.layout, stageFlags, effect.GetBindlessConstantOffset(),
+                                      static_cast<uint32_t>(effect.mBindlessIndices.size() * sizeof(uint32_t)), effect.mBindlessIndices.data());
+    });
+}
+
+CmdRecordResult VulkanRenderer::EndCommandRecording(SwapChainBase* swapChain)
+{
+    auto& frame = mFrames[mFrameIndex];
+    
+    // Staged data are gone once the frame slot is reused, updates of scenes which weren't culled are copied now
+    RecordStagedCopies(mCmdList, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    
+    mCmdList.EndCommandBuffer();
+    
+    // Subpasses are recorded in parallel, the primary buffer only begins passes & executes secondary buffers
+    frame.commandRecorder->Record();
+    
+    mCmdList.Replay(*mDevice, frame.commandBuffer);
+    mCmdList.Clear();
+    
+    const VkSemaphore imageAvailableSemaphore = frame.sync.imageAvailableSemaphore.Get();
+    const VkSemaphore renderFinishedSemaphore = frame.sync.renderFinishedSemaphore.Get();
+    const VkFence frameFence = frame.sync.frameFence.Get();
+    
+    // Without acquired image (headless rendering) there is nothing to wait for & nothing to present
+    const bool presents = swapChain && frame.imageAcquired;
+    
+    // Uploads recorded so far are submitted ahead of the frame which may already use them
+    mUploadManager->Flush();
+    const bool acquiresUploads = mUploadManager->AcquireResources(frame.uploadAcquireBuffer, frame.uploadSemaphores);
+    
+    std::vector<VkSemaphore> waitSemaphores;
+    std::vector<VkPipelineStageFlags> waitStages;
+    waitSemaphores.reserve(frame.uploadSemaphores.size() + 3);
+    waitStages.reserve(frame.uploadSemaphores.size() + 3);
+    
+    std::array<VkSemaphore, 2> signalSemaphores{};
+    uint32_t signalSemaphoreCount{ 0 };
+    
+    if(presents)
+    {
+        waitSemaphores.push_back(imageAvailableSemaphore);
+        waitStages.push_back(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+        
+        signalSemaphores[signalSemaphoreCount++] = renderFinishedSemaphore;
+    }
     
-    auto* vulkanSwapChain = (VulkanSwapChain*)swapChain;
+    for(const auto uploadSemaphore : frame.uploadSemaphores)
+    {
+        waitSemaphores.push_back(uploadSemaphore);
+        waitStages.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+    }
     
-    const auto& swapChainDeviceObject = vulkanSwapChain->GetDeviceObject();
+    if(mAsyncCompute)
+    {
+        // Compute work of the frame is submitted ahead of it, culled commands are read by indirect draws & objects by vertex shaders
+        const VkSemaphore computeSemaphore = mAsyncCompute->Submit(frame.computeSemaphores);
+        if(computeSemaphore != VK_NULL_HANDLE)
+        {
+            waitSemaphores.push_back(computeSemaphore);
+            waitStages.push_back(VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);
+        }
+        
+        // Next compute work must not overwrite data this frame reads, nor read data it didn't write yet
+        if(mComputeDependency)
+        {
+            VkSemaphore staleSemaphore{ VK_NULL_HANDLE };
+            signalSemaphores[signalSemaphoreCount++] = mAsyncCompute->SignalFromGraphics(staleSemaphore);
+            
+            // Signal of earlier frame no compute waited for is only unsignaled, graphics queue already ran past it
+            if(staleSemaphore != VK_NULL_HANDLE)
+            {
+                waitSemaphores.push_back(staleSemaphore);
+                waitStages.push_back(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+                frame.computeSemaphores.push_back(staleSemaphore);
+            }
+        }
+    }
     
-    VulkanSwapChainVisitor swapChainVisitor;
-    swapChainDeviceObject.Accept(swapChainVisitor);
+    mComputeDependency = false;
     
-    VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+    // Acquire buffer goes first, so the uploaded resources are owned by graphics queue before the frame uses them
+    const VkCommandBuffer commandBuffers[] = { frame.uploadAcquireBuffer, frame.commandBuffer };
     
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = &swapChainVisitor.imgAvailableSemaphore;
-    submitInfo.pWaitDstStageMask = waitStages;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &mCmdBuff;
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = &swapChainVisitor.renderFinishedSemaphore;
-    
-    mDevice->QueueSubmit(mGraphicsQueue, 1, &submitInfo, swapChainVisitor.frameFence);
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
+    submitInfo.commandBufferCount = acquiresUploads ? 2 : 1;
+    submitInfo.pCommandBuffers = acquiresUploads ? &commandBuffers[0] : &commandBuffers[1];
+    submitInfo.signalSemaphoreCount = signalSemaphoreCount;
+    submitInfo.pSignalSemaphores = signalSemaphores.data();
+    
+    // Fence is reset right before submission, so a frame which is never submitted can't deadlock the ring
+    mDevice->ResetFences(1, &frameFence);
+    mDevice->QueueSubmit(mGraphicsQueue, 1, &submitInfo, frameFence);
+    
+    // Pipelines are created during startup, first frame closes it
+    if(mFrameStatistics.frameNumber == 1)
+    {
+        const auto statistics = mPipelineCache->GetStatistics();
+        LOG(Information) << "Startup created " << statistics.pipelineCount << " pipelines in " << statistics.creationTime << "ms, "
+                         << (statistics.warmStart ? "pipeline cache saved ~" + std::to_string(statistics.estimatedTimeSaved) + "ms" : "pipeline cache was cold");
+    }
+    
+    if(mFrameStatistics.frameNumber % PIPELINE_CACHE_CHECKPOINT_FRAMES == 0)
+    {
+        mPipelineCache->Save();
+    }
+    
+    mFrameIndex = (mFrameIndex + 1) % mFramesInFlight;
+    mFrameStarted = false;
     
     return CmdRecordResult::Success;
 }
@@ -3,14 +3,33 @@
 #include <Renderer/Renderer.h>
 #include <Renderer/Resources/Framebuffer.h>
 #include <Renderer/RenderPass.h>
+#include <Renderer/Transform.h>
+#include <Renderer/GpuScene.h>
 #include <PAL/RenderAPI/Vulkan/VulkanDevice.h>
+#include <array>
 #include <memory>
+#include <optional>
+#include <unordered_map>
 
 #include <Renderer/DeviceObject.h>
 #include <Math/Matrix4.h>
 
 #include "VulkanDeviceObjects.h"
-#include "Command.h"
+#include "VulkanResourceTable.h"
+#include "VulkanCommandRecorder.h"
+#include "VulkanUploadManager.h"
+#include "VulkanMemoryAllocator.h"
+#include "VulkanUniformRing.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanPipelineRegistry.h"
+#include "VulkanShaderLibrary.h"
+#include "VulkanDescriptorAllocator.h"
+#include "VulkanBindlessTable.h"
+#include "VulkanDrawQueue.h"
+#include "VulkanCommandStream.h"
+#include "VulkanDeletionQueue.h"
+#include "VulkanAsyncCompute.h"
+#include "VulkanStateKey.h"
 
 namespace Renderer
 {
@@ -18,22 +37,84 @@ namespace Renderer
     
     struct VulkanImageDesc;
     
+    /*!
+     @brief Resources of one slot in the frames in flight ring, reused once GPU signals the slot's fence.
+     */
+    struct VulkanFrame
+    {
+        Vulkan::FrameSyncDeviceObject sync;
+        VkCommandPool commandPool{ VK_NULL_HANDLE };
+        VkCommandBuffer commandBuffer{ VK_NULL_HANDLE };
+        VkCommandBuffer uploadAcquireBuffer{ VK_NULL_HANDLE };
+        std::unique_ptr<VulkanCommandRecorder> commandRecorder;
+        std::vector<VkSemaphore> uploadSemaphores;
+        std::vector<VkSemaphore> computeSemaphores;    // Waited by submissions of the frame, recycled once the slot is reused
+        bool imageAcquired{ false };
+    };
+    
+    /*!
+     @brief Draw waiting in the draw queue until its pass is sorted.
+     */
+    struct VulkanQueuedDraw
+    {
+        const VertexBufferBase* vertexBuffer{ nullptr };
+        const Pipeline* pipeline{ nullptr };
+        
+        // Uniform data are written per draw, so offsets are captured at submission
+        std::array<uint32_t, Effect::MaxDynamicUniformBuffers> dynamicOffsets{};
+        
+        // Digest sorting instanced draws next to each other, adjacent draws of equal non-zero key binding exactly equal state are merged
+        uint64_t instanceKey{ 0 };
+        Transform transform;
+        Vector4f instanceParameters;
+    };
+    
+    /*!
+     @brief Copy of data staged in the uniform ring, recorded in queue order so frames in flight never see partial writes.
+     */
+    struct VulkanStagedCopy
+    {
+        VkBuffer dstBuffer{ VK_NULL_HANDLE };
+        VkBufferCopy region{};
+    };
+    
+    /*!
+     @brief Shader module of one effect stage.
+     */
+    struct VulkanShaderSource
+    {
+        ModuleStage stage{ ModuleStage::Undefined };
+        std::shared_ptr<const VulkanShaderModule> module;
+    };
+    
 	class VulkanRenderer : public IRenderer
 	{
 	public:
 		void Initialize() override;
 		void Deinitialize() override;
+        
+        void SetFramesInFlight(uint32_t count) override;
+        const FrameStatistics& GetFrameStatistics() const override { return mFrameStatistics; }
+        MemoryStatistics GetMemoryStatistics() const override;
+        PipelineCacheStatistics GetPipelineCacheStatistics() const override;
+        bool IsBindlessSupported() const override { return mBindlessTable != nullptr; }
+        bool IsGpuCullingSupported() const override;
 
         DeviceObject CreateSurface(void* nativeViewHandle) const override;
         std::unique_ptr<SwapChainBase> CreateSwapChain(const DeviceObject& surface, const DeviceObject& renderPass, uint32_t width, uint32_t height) override;
         
         void CreateShader(DeviceObject& shader, const std::vector<uint8_t>& code) const override;
+        void LoadShaderBundle(const std::string& filePath) override;
         void CreatePipeline(Pipeline& pipeline, const DeviceObject& renderPass) override;
+        void CreateComputePipeline(Pipeline& pipeline) override;
         void CreateFramebuffer(Framebuffer& desc, const RenderPass& renderPass) override;
-        void CreateBuffer(const BufferDesc& desc, DeviceObject& buffer) override;
+        UploadHandle CreateBuffer(const BufferDesc& desc, DeviceObject& buffer) override;
         DeviceObject CreateImage(const ImageDesc& desc) override;
+        MemoryRequirements GetAttachmentMemoryRequirements(const AttachableDescriptor& desc) const override;
+        DeviceObject CreateMemoryHeap(const MemoryRequirements& requirements) override;
+        DeviceObject CreatePlacedAttachment(const AttachableDescriptor& desc, const DeviceObject& heap, uint64_t offset) override;
         
-        void CreateTexture(const ImageDesc& desc, const SamplerDesc& samplerDesc, DeviceObject& texture) override;
+        UploadHandle CreateTexture(const ImageDesc& desc, const SamplerDesc& samplerDesc, DeviceObject& texture) override;
         
         DeviceObject CreateSemaphore(const SemaphoreDescriptor& desc) const override;
         DeviceObject CreateFence(const FenceDescriptor& desc) const override;
@@ -42,11 +123,29 @@ namespace Renderer
         
         void MapMemory(const DeviceObject& deviceObject, uint32_t size, void* data) override;
         void UnmapMemory(const DeviceObject& deviceObject) const override;
+        void WriteUniformData(Buffer& buffer, const void* data) override;
+        
+        void CreateGpuScene(GpuScene& scene, uint32_t capacity, const std::string& cullShaderPath) override;
+        void UpdateGpuScene(GpuScene& scene, uint32_t first, uint32_t count, const GpuObject* objects) override;
+        std::vector<DrawIndexedIndirectCommand> ReadGpuSceneCommands(const GpuScene& scene) override;
         
-        void Render(const Object3d& vb, const Pipeline& pipeline) override;
+        void Render(const Object3d& vb, const Pipeline& pipeline, float viewDepth = 0.0f) override;
         void RenderGui(const VertexBufferBase& vb, const Pipeline& pipeline) override;
+        void CullGpuScene(const GpuScene& scene, const FrustumPlanes& frustum) override;
+        void RenderGpuScene(const GpuScene& scene, const VertexBufferBase& vb, const Pipeline& pipeline) override;
+        
+        void Dispatch(const Pipeline& pipeline, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override;
+        void DispatchIndirect(const Pipeline& pipeline, const Buffer& arguments) override;
+        void BufferBarrier(const Buffer& buffer, const BarrierDesc& barrier) override;
+        void ImageBarrier(const Attachable& image, ImageLayout oldLayout, ImageLayout newLayout, const BarrierDesc& barrier) override;
+        void ImageBarriers(const ImageBarrierDesc* barriers, uint32_t count) override;
         
-        void DestroyDeviceObject(DeviceObject& buffer) const override;
+        void FlushUploads() override;
+        bool IsUploadComplete(UploadHandle handle) override;
+        void WaitForUpload(UploadHandle handle) override;
+        
+        void WaitIdle() const override;
+        void DestroyDeviceObject(DeviceObject& deviceObject) const override;
         
         CmdRecordResult BeginCommandRecording() override;
         CmdRecordResult BeginRenderPass(const RenderPass& renderPass) override;
@@ -59,42 +158,223 @@ namespace Renderer
         
         const std::vector<DeviceObject>& GetCommandBuffers() const { return mCommandBuffers; }
         const VkQueue GetGraphicsQueue() const { return mGraphicsQueue; }
+        const VulkanResourceTables& GetResources() const { return *mResources; }
         
         [[nodiscard]] VkImageView CreateImageView(const VkImage& image, const VkFormat& format, VkImageAspectFlags flags) const;
         
         VulkanAttachmentDeviceObject CreateAttachment(uint32_t width, uint32_t height, Format format, ImageUsage usage);
 
+        /*!
+         @brief Starts new frame unless already started, blocks until GPU releases the frame slot.
+         @return Current frame slot.
+         */
+        VulkanFrame& BeginFrame();
+        
+        /*!
+         @return Number of the last frame which may reference resource released now.
+         */
+        uint64_t GetReleaseFrame() const;
+
     private:
         void CreateDevice(DeviceType type);
+        void CreateFrames();
+        void CreateUploadManager();
+        void CreateUniformRing();
         
-        uint32_t FindMemoryTypeIndex(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
-        void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) const;
-        void CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height) const;
-        void TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout) const;
+        /*!
+         @brief Queues layout transition of whole image, stage & access masks are derived from the layouts.
+                Queued transitions are recorded as single barrier at the start of the next frame or render pass.
+         */
+        void TransitionImageLayout(VkImage image, VkImageAspectFlags aspectMask, VkImageLayout oldLayout, VkImageLayout newLayout);
+        void RecordPendingTransitions();
         
         // Pipeline
-        std::vector<VkPipelineShaderStageCreateInfo> PrepareModules(Effect& effect) const;  // Non-const because it stores module device objects back to effect. This might not be needed & could be stored in some pipeline manager?
+        std::vector<VulkanShaderSource> LoadModules(const Effect& effect) const;
+        
+        /*!
+         @brief Creates device objects shared by all pipelines with key of the pipeline.
+         */
+        VulkanPipelineState CreatePipelineState(const Pipeline& pipeline, const std::vector<VulkanShaderSource>& modules, VkRenderPass renderPass) const;
+        static PipelineKey MakePipelineKey(const Pipeline& pipeline, const std::vector<VulkanShaderSource>& modules, VkRenderPass renderPass);
+        
+        VulkanPipelineState CreateComputePipelineState(const Pipeline& pipeline, const VulkanShaderSource& module) const;
+        
+        /*!
+         @brief Creates descriptor set layouts & pipeline layout of the effect into state, shared by graphics & compute states.
+         */
+        void CreatePipelineLayout(const Effect& effect, VulkanPipelineState& state) const;
+        
+        /*!
+         @brief Writes resources bound to the effect into descriptor sets of state's layouts.
+         */
+        void CreateDescriptorSets(Pipeline& pipeline, const VulkanPipelineState& state);
         
         
     private:
         [[nodiscard]] BufferDeviceObject        CreateBufferImpl(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkSharingMode sharingMode) const;
         [[nodiscard]] ImageDeviceObject         CreateImageImpl(const VulkanImageDesc& descriptor) const;
+        [[nodiscard]] VkImage                   CreateImageHandle(const VulkanImageDesc& descriptor) const;
         [[nodiscard]] Vulkan::FramebufferDeviceObject CreateFramebufferImpl(uint32_t width, uint32_t height, const std::vector<VkImageView>& attachments, const VkRenderPass& renderPass) const;
         [[nodiscard]] VkSampler             CreateSamplerImpl(const SamplerDesc& descriptor) const;
         
+        /*!
+         @brief Returns sampler of the descriptor, equal descriptors share one sampler owned by the renderer.
+         */
+        [[nodiscard]] VkSampler GetSampler(const SamplerDesc& descriptor);
+        
+        void BeginSubpassRecording(uint32_t subpass);
+        
+        /*!
+         @return Commands of the active subpass, primary buffer commands outside of render passes.
+         */
+        VulkanCommandStream& GetCommandStream();
+        
+        /*!
+         @brief Records command written by recorder into the command stream & pushes it into the active subpass.
+         @param record Callable taking VulkanCommandStream& & returning offset of the recorded command.
+         */
+        template<typename CommandRecorder>
+        void Record(CommandRecorder&& record);
+        
+        /*!
+         @brief Records queued draws sorted by their keys, has to be called before anything else is recorded into the pass.
+         */
+        void FlushDraws();
+        
+        /*!
+         @param instanceCount Number of merged draws of instanced effect, their data were written at instanceOffset of the uniform ring.
+         */
+        void RecordDraw(const VulkanQueuedDraw& draw, uint32_t instanceCount, uint32_t instanceOffset);
+        
+        /*!
+         @brief True if draw binds exactly the state of first, i.e. pipeline, descriptor sets, bindless indices, mesh buffers
+                & dynamic offsets, so both may be recorded as instances of one draw regardless of their instance keys.
+         */
+        bool CanDrawAsInstances(const VulkanQueuedDraw& first, const VulkanQueuedDraw& draw) const;
+        
+        /*!
+         @brief Writes instance data of queued draws into the uniform ring.
+         @return Offset of the data in the ring buffer.
+         */
+        uint32_t WriteInstanceData(const VulkanDrawQueue::Entry* entries, size_t count);
+        
+        /*!
+         @brief Records command written by recorder unless the active subpass already bound the state with equal identity.
+         */
+        template<typename CommandRecorder>
+        void RecordState(BoundState state, const StateKey& binding, CommandRecorder&& record);
+        
+        /*!
+         @brief Records bind of effect's descriptor sets, sets the active subpass has already bound are skipped.
+         @param dynamicOffsets Offsets of effect's dynamic uniform buffers.
+         */
+        void RecordDescriptorSets(VulkanCommandStream& commands, const Pipeline& pipeline, const uint32_t* dynamicOffsets);
+        
+        /*!
+         @brief Records push of table indices of effect's bindless textures, skipped if the same indices are pushed already.
+         */
+        void RecordBindlessIndices(const Pipeline& pipeline);
+        
+        /*!
+         @brief Records copies of GPU scene updates staged so far, has to be recorded outside of render passes.
+         @param readerStages Stages reading the objects, supported by queue the commands are submitted to.
+         */
+        void RecordStagedCopies(VulkanCommandStream& commands, VkPipelineStageFlags readerStages);
+        
+        /*!
+         @brief Records bind of compute pipeline & its descriptor sets, dispatch is recorded into primary buffer right after.
+         @param dynamicOffsets Offsets of effect's dynamic uniform buffers.
+         */
+        void RecordComputeState(VulkanCommandStream& commands, const Pipeline& pipeline, const uint32_t* dynamicOffsets);
+        
+        /*!
+         @return Offsets of effect's dynamic uniform buffers written by their last WriteUniformData.
+         */
+        static std::array<uint32_t, Effect::MaxDynamicUniformBuffers> GetDynamicOffsets(const Effect& effect);
+        
+        /*!
+         @return Sharing mode of buffers accessed by async compute, concurrent if compute runs on its own queue family.
+         */
+        VkSharingMode GetComputeSharingMode() const { return mAsyncCompute ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE; }
+        
 	private:
 		std::shared_ptr<PAL::RenderAPI::VulkanDevice> mDevice;
         VkCommandPool mCommandPool{ VK_NULL_HANDLE };
         std::vector<DeviceObject> mCommandBuffers;
-        VkDescriptorPool mDescriptorPool;
         
+        // Sampler of textures created without one, shared so equal textures produce equal descriptor sets
+        VkSampler mDefaultSampler{ VK_NULL_HANDLE };
+        
+        // Samplers by their descriptor, owned by the renderer
+        std::unordered_map<StateKey, VkSampler, StateKeyHash> mSamplers;
+        
+        // Families without dedicated queue are equal to graphics family & share its queue
         VkQueue mGraphicsQueue{ VK_NULL_HANDLE };
+        VkQueue mTransferQueue{ VK_NULL_HANDLE };
+        uint32_t mGraphicsQueueFamilyIndex{ 0 };
+        uint32_t mComputeQueueFamilyIndex{ 0 };
+        uint32_t mTransferQueueFamilyIndex{ 0 };
         
-        std::vector<DeviceObject*> mResourceManager;
+        // Families accessing buffers created with concurrent sharing
+        std::vector<uint32_t> mSharedQueueFamilies;
         
         std::shared_ptr<CommandBufferFactory> mCommandBufferFactory;
+        std::shared_ptr<VulkanMemoryAllocator> mAllocator;
+        std::unique_ptr<VulkanResourceTables> mResources;
+        std::unique_ptr<VulkanUploadManager> mUploadManager;
+        std::unique_ptr<VulkanUniformRing> mUniformRing;
+        std::unique_ptr<VulkanPipelineCache> mPipelineCache;
+        std::unique_ptr<VulkanPipelineRegistry> mPipelineRegistry;
+        std::unique_ptr<VulkanShaderLibrary> mShaderLibrary;
+        std::unique_ptr<VulkanDescriptorAllocator> mDescriptorAllocator;
+        std::unique_ptr<VulkanBindlessTable> mBindlessTable;    // Null if the device doesn't support descriptor indexing
+        std::unique_ptr<VulkanDeletionQueue> mDeletionQueue;
+        std::unique_ptr<VulkanAsyncCompute> mAsyncCompute;      // Null if the device has no dedicated compute family
 
-        VkCommandBuffer mCmdBuff;
-        std::vector<Command> mCmdList;
+        // Commands of the primary buffer, arena is kept between frames
+        VulkanCommandStream mCmdList;
+        
+        // Draws of the active pass, recorded sorted once anything else is recorded into the pass
+        VulkanDrawQueue mDrawQueue;
+        std::vector<VulkanQueuedDraw> mQueuedDraws;
+        
+        // Scratch of instance data composition, kept to avoid per-frame allocations
+        std::vector<Transform> mInstanceTransforms;
+        std::vector<Matrix4> mInstanceMatrices;
+        std::vector<Effect::InstanceData> mInstanceData;
+        
+        // Updates of GPU scenes waiting for the next culling or end of the frame
+        std::vector<VulkanStagedCopy> mStagedCopies;
+        
+        // Frame accessed data shared with async compute, its submission signals the next compute submission
+        bool mComputeDependency{ false };
+        
+        // Scratch of exact identities of bound state, compared against the state the active subpass bound last
+        StateKey mBindingKey;
+        std::array<StateKey, Effect::DescriptorSetCount> mSetBindingKeys;
+        
+        // Scratch of batched image barriers
+        std::vector<VkImageMemoryBarrier> mImageBarriers;
+        
+        // Layout transitions of created images waiting for the next command recording
+        std::vector<VkImageMemoryBarrier> mPendingTransitions;
+        VkPipelineStageFlags mPendingTransitionSrcStages{ 0 };
+        VkPipelineStageFlags mPendingTransitionDstStages{ 0 };
+        
+        std::vector<VulkanFrame> mFrames;
+        uint32_t mFramesInFlight{ DefaultFramesInFlight };
+        uint32_t mFrameIndex{ 0 };
+        bool mFrameStarted{ false };
+        FrameStatistics mFrameStatistics;
+        
+        // Render pass contents are recorded into secondary buffers, primary buffer only begins passes & executes them
+        SubpassRecording* mActiveSubpass{ nullptr };
+        VkRenderPass mActiveRenderPass{ VK_NULL_HANDLE };
+        VkFramebuffer mActiveFramebuffer{ VK_NULL_HANDLE };
+        uint32_t mActiveSubpassIndex{ 0 };
+        
+        // Dynamic state isn't inherited by secondary buffers, last values are replayed into every new subpass
+        std::optional<Rectangle<float>> mViewport;
+        std::optional<Rectangle<uint32_t>> mScissor;
 	};
 }
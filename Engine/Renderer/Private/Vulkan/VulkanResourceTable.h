@@ -0,0 +1,193 @@
+#pragma once
+
+#include <Renderer/DeviceObject.h>
+#include <Core/Platform.h>
+#include <Core/Assert.h>
+
+#include "VulkanDeviceObjects.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace Renderer
+{
+    /*!
+     @brief Objects of one device object type addressed by generational DeviceObject handles.
+
+     Slots are allocated in pages which never move, so handles resolve without locking while other threads add objects.
+     Objects & generations of a page are kept in separate arrays, lookup reads the generation byte & the object only.
+     Slot of removed object gets next generation & is reused by following adds. Add & Remove are thread safe.
+     */
+    template<DeviceObjectType Type, typename T>
+    class VulkanResourceTable
+    {
+        static constexpr uint32_t PageSize = 1024;
+        static constexpr uint32_t MaxPages = (DeviceObject::MaxIndex + 1) / PageSize;
+
+    public:
+        VulkanResourceTable() { mPages.reserve(MaxPages); }
+
+        DECLARE_NOCOPY_NOMOVE(VulkanResourceTable)
+
+        /*!
+         @brief Moves object into free slot.
+         @return Handle of the object, valid until the object is removed.
+         */
+        NO_DISCARD DeviceObject Add(T&& object)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+
+            uint32_t index{ 0 };
+            if(!mFreeSlots.empty())
+            {
+                index = mFreeSlots.back();
+                mFreeSlots.pop_back();
+            }
+            else
+            {
+                index = mSlotCount.load(std::memory_order_relaxed);
+                if(index == MaxPages * PageSize)
+                    throw std::runtime_error("Device object table is full!");
+
+                // Reserved capacity is never exceeded, pointers to pages stay in place for concurrent lookups
+                if(index % PageSize == 0)
+                    mPages.push_back(std::make_unique<Page>());
+
+                mSlotCount.store(index + 1, std::memory_order_release);
+            }
+
+            auto& page = *mPages[index / PageSize];
+            page.objects[index % PageSize].emplace(std::move(object));
+            ++mSize;
+
+            return DeviceObject(Type, index, page.generations[index % PageSize]);
+        }
+
+        /*!
+         @return Object of the handle, null if the handle is null, stale or of other type.
+         */
+        NO_DISCARD T* Find(const DeviceObject& handle) noexcept
+        {
+            return const_cast<T*>(static_cast<const VulkanResourceTable*>(this)->Find(handle));
+        }
+
+        NO_DISCARD const T* Find(const DeviceObject& handle) const noexcept
+        {
+            if(handle.GetType() != Type)
+                return nullptr;
+
+            const uint32_t index = handle.GetIndex();
+            if(index >= mSlotCount.load(std::memory_order_acquire))
+                return nullptr;
+
+            const auto& page = *mPages[index / PageSize];
+            if(page.generations[index % PageSize] != handle.GetGeneration())
+                return nullptr;
+
+            const auto& object = page.objects[index % PageSize];
+            return object ? &*object : nullptr;
+        }
+
+        /*!
+         @return Object of the handle, throws if the handle doesn't resolve to object of the table.
+         */
+        NO_DISCARD T& Get(const DeviceObject& handle)
+        {
+            return const_cast<T&>(static_cast<const VulkanResourceTable*>(this)->Get(handle));
+        }
+
+        NO_DISCARD const T& Get(const DeviceObject& handle) const
+        {
+            const T* object = Find(handle);
+            if(!object)
+                throw std::invalid_argument("Stale device object handle!");
+
+            return *object;
+        }
+
+        /*!
+         @brief Moves object out of its slot & makes the handle null, the slot is reused with next generation.
+         @return Removed object, empty if the handle doesn't resolve to object of the table.
+         */
+        std::optional<T> Remove(DeviceObject& handle)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+
+            T* object = Find(handle);
+            if(!object)
+                return std::nullopt;
+
+            const uint32_t index = handle.GetIndex();
+            auto& page = *mPages[index / PageSize];
+
+            std::optional<T> removed(std::move(*object));
+            page.objects[index % PageSize].reset();
+            page.generations[index % PageSize] = static_cast<uint8_t>((page.generations[index % PageSize] + 1) & DeviceObject::GenerationMask);
+
+            mFreeSlots.push_back(index);
+            --mSize;
+
+            handle.Reset();
+            return removed;
+        }
+
+        /*!
+         @brief Calls function with every object in the table, not thread safe against adds & removes.
+         */
+        template<typename Function>
+        void ForEach(Function&& function)
+        {
+            const uint32_t slotCount = mSlotCount.load(std::memory_order_acquire);
+
+            for(uint32_t index = 0; index < slotCount; ++index)
+            {
+                auto& object = mPages[index / PageSize]->objects[index % PageSize];
+                if(object)
+                    function(*object);
+            }
+        }
+
+        NO_DISCARD uint32_t GetSize() const noexcept { return mSize; }
+
+    private:
+        struct Page
+        {
+            std::array<std::optional<T>, PageSize> objects;
+            std::array<uint8_t, PageSize> generations{};
+        };
+
+    private:
+        std::vector<std::unique_ptr<Page>> mPages;
+        std::vector<uint32_t> mFreeSlots;
+        std::atomic<uint32_t> mSlotCount{ 0 };
+        uint32_t mSize{ 0 };
+
+        std::mutex mMutex;
+    };
+
+    /*!
+     @brief Tables of all device objects created by the renderer, handles are resolved by table of their type.
+     */
+    struct VulkanResourceTables
+    {
+        VulkanResourceTable<DeviceObjectType::Shader, VulkanShaderDeviceObject> shaders;
+        VulkanResourceTable<DeviceObjectType::Pipeline, PipelineDeviceObject> pipelines;
+        VulkanResourceTable<DeviceObjectType::Buffer, BufferDeviceObject> buffers;
+        VulkanResourceTable<DeviceObjectType::Texture, TextureDeviceObject> textures;
+        VulkanResourceTable<DeviceObjectType::Attachment, VulkanAttachmentDeviceObject> attachments;
+        VulkanResourceTable<DeviceObjectType::Framebuffer, Vulkan::FramebufferDeviceObject> framebuffers;
+        VulkanResourceTable<DeviceObjectType::RenderPass, Vulkan::RenderPassDeviceObject> renderPasses;
+        VulkanResourceTable<DeviceObjectType::Surface, Vulkan::SurfaceDeviceObject> surfaces;
+        VulkanResourceTable<DeviceObjectType::SwapChain, Vulkan::SwapChainDeviceObject> swapChains;
+        VulkanResourceTable<DeviceObjectType::DescriptorSetLayout, Vulkan::DescriptorSetLayoutDeviceObject> descriptorSetLayouts;
+        VulkanResourceTable<DeviceObjectType::DescriptorSet, Vulkan::DescriptorSetDeviceObject> descriptorSets;
+        VulkanResourceTable<DeviceObjectType::Semaphore, Vulkan::SemaphoreDeviceObject> semaphores;
+        VulkanResourceTable<DeviceObjectType::Fence, Vulkan::FenceDeviceObject> fences;
+        VulkanResourceTable<DeviceObjectType::MemoryHeap, VulkanMemoryHeapDeviceObject> heaps;
+    };
+}
@@ -0,0 +1,107 @@
+#include "VulkanShaderLibrary.h"
+
+#include <Renderer/Renderer.h>
+#include <PAL/FileSystem/File.h>
+#include <Logging/LoggingService.h>
+
+#include <cstring>
+
+#ifdef LOG_MODULE_ID
+#undef LOG_MODULE_ID
+#endif
+
+#define LOG_MODULE_ID LOG_MODULE_4BYTE('V','K','S','L')
+
+using namespace Renderer;
+using namespace PAL::RenderAPI;
+using namespace PAL::FileSystem;
+
+VulkanShaderLibrary::VulkanShaderLibrary(std::shared_ptr<VulkanDevice> device)
+    : mDevice(std::move(device))
+{
+}
+
+VulkanShaderLibrary::~VulkanShaderLibrary()
+{
+    LOG(Information) << "Shader library: " << mModuleCount << " modules of " << mModulesByPath.size() << " paths, "
+                     << mFileReadCount << " files read";
+
+    for(const auto& [key, entries] : mModulesByCode)
+    {
+        for(const auto& entry : entries)
+        {
+            mDevice->DestroyShaderModule(entry.module->module, nullptr);
+        }
+    }
+}
+
+std::shared_ptr<const VulkanShaderModule> VulkanShaderLibrary::Load(const std::string& filePath)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        const auto it = mModulesByPath.find(filePath);
+        if(it != mModulesByPath.end())
+            return it->second;
+
+        ++mFileReadCount;
+    }
+
+    // File is read outside of the lock, other threads may load other modules meanwhile
+    File shaderFile(filePath);
+    shaderFile.Open(EFileAccessMode::Read);
+    const auto& code = shaderFile.Read();
+
+    return Add(filePath, code.data(), code.size());
+}
+
+size_t VulkanShaderLibrary::LoadBundle(const ShaderBundle& bundle)
+{
+    const auto& entries = bundle.GetEntries();
+    for(const auto& entry : entries)
+    {
+        Add(entry.path, bundle.GetCode(entry), entry.size);
+    }
+
+    LOG(Information) << "Loaded shader bundle of " << entries.size() << " modules";
+
+    return entries.size();
+}
+
+std::shared_ptr<const VulkanShaderModule> VulkanShaderLibrary::Add(const std::string& filePath, const uint8_t* code, size_t codeSize)
+{
+    const uint64_t hash = PipelineKey::Digest(code, codeSize);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // Path may have been added by other thread while the file was read
+    const auto pathIt = mModulesByPath.find(filePath);
+    if(pathIt != mModulesByPath.end())
+        return pathIt->second;
+
+    auto& entries = mModulesByCode[{ hash, codeSize }];
+    for(const auto& entry : entries)
+    {
+        if(std::memcmp(entry.code.data(), code, codeSize) == 0)
+        {
+            mModulesByPath.emplace(filePath, entry.module);
+            return entry.module;
+        }
+    }
+
+    VkShaderModuleCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = codeSize;
+    createInfo.pCode = reinterpret_cast<const uint32_t*>(code);
+
+    auto module = std::make_shared<VulkanShaderModule>();
+    module->hash = hash;
+    module->codeSize = codeSize;
+    mDevice->CreateShaderModule(&createInfo, nullptr, &module->module);
+
+    entries.push_back({ std::vector<uint8_t>(code, code + codeSize), module });
+    mModulesByPath.emplace(filePath, module);
+    ++mModuleCount;
+
+    return module;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Renderer/ShaderBundle.h>
+#include <PAL/RenderAPI/Vulkan/VulkanDevice.h>
+#include <Core/Platform.h>
+#include <Core/TupleHash.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Renderer
+{
+    /*!
+     @brief Shader module shared by all pipelines using the same SPIR-V code.
+     */
+    struct VulkanShaderModule
+    {
+        VkShaderModule module{ VK_NULL_HANDLE };
+
+        /*!
+         @brief Digest of the SPIR-V code, pipeline keys identify the module by its address.
+         */
+        uint64_t hash{ 0 };
+        size_t codeSize{ 0 };
+    };
+
+    /*!
+     @brief Loads every shader module once for the whole life of the renderer.
+
+     Modules are looked up by file path first, file of known path is never read again. Modules of different paths
+     with identical code share one VkShaderModule. Modules are destroyed with the library.
+     Library is thread safe.
+     */
+    class VulkanShaderLibrary
+    {
+    public:
+        explicit VulkanShaderLibrary(std::shared_ptr<PAL::RenderAPI::VulkanDevice> device);
+        ~VulkanShaderLibrary();
+
+        DECLARE_NOCOPY_NOMOVE(VulkanShaderLibrary)
+
+        /*!
+         @brief Returns module of SPIR-V file, reads the file if the path wasn't loaded yet.
+         */
+        NO_DISCARD std::shared_ptr<const VulkanShaderModule> Load(const std::string& filePath);
+
+        /*!
+         @brief Creates modules of all bundle entries, their paths are then loaded without file access.
+         @return Number of modules added to the library.
+         */
+        size_t LoadBundle(const ShaderBundle& bundle);
+
+    private:
+        struct CodeEntry
+        {
+            std::vector<uint8_t> code;
+            std::shared_ptr<const VulkanShaderModule> module;
+        };
+
+        std::shared_ptr<const VulkanShaderModule> Add(const std::string& filePath, const uint8_t* code, size_t codeSize);
+
+    private:
+        std::shared_ptr<PAL::RenderAPI::VulkanDevice> mDevice;
+
+        std::mutex mMutex;
+        std::unordered_map<std::string, std::shared_ptr<const VulkanShaderModule>> mModulesByPath;
+
+        // Code is looked up by its digest & size, entries of equally sized code with colliding digest are told apart by the code itself
+        std::unordered_map<std::pair<uint64_t, size_t>, std::vector<CodeEntry>> mModulesByCode;
+        size_t mModuleCount{ 0 };
+
+        uint32_t mFileReadCount{ 0 };
+    };
+}
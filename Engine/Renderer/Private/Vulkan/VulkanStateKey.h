@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Renderer
+{
+    /*!
+     @brief Exact key of device object caches & bound state, e.g. samplers, descriptor set layouts & sets.
+
+     Every appended value is kept as word & compared on lookup, hash only selects the bucket. Unlike PipelineKey no blob is
+     reduced to its digest, keys are equal only if all their values are equal.
+     */
+    struct StateKey
+    {
+        void Append(uint64_t value)
+        {
+            words.push_back(value);
+
+            // FNV-1a over bytes of the word
+            for(uint32_t i = 0; i < sizeof(value); ++i)
+            {
+                hash ^= (value >> (i * 8)) & 0xff;
+                hash *= 1099511628211ull;
+            }
+        }
+
+        /*!
+         @brief Appends size of data & its bytes packed into words, the last word is padded by zeros.
+         */
+        void Append(const void* data, size_t size)
+        {
+            Append(size);
+
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            for(size_t offset = 0; offset < size; offset += sizeof(uint64_t))
+            {
+                uint64_t word{ 0 };
+                std::memcpy(&word, bytes + offset, std::min(sizeof(uint64_t), size - offset));
+                Append(word);
+            }
+        }
+
+        /*!
+         @brief Empties the key, capacity of words is kept so scratch keys don't allocate once they grew.
+         */
+        void Clear()
+        {
+            hash = 14695981039346656037ull;
+            words.clear();
+        }
+
+        bool IsEmpty() const { return words.empty(); }
+
+        bool operator==(const StateKey& other) const
+        {
+            return hash == other.hash && words == other.words;
+        }
+
+        bool operator!=(const StateKey& other) const
+        {
+            return !(*this == other);
+        }
+
+        uint64_t hash{ 14695981039346656037ull };
+        std::vector<uint64_t> words;
+    };
+
+    struct StateKeyHash
+    {
+        size_t operator()(const StateKey& key) const noexcept
+        {
+            return static_cast<size_t>(key.hash);
+        }
+    };
+}
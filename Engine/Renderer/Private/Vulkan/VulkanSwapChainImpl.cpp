@@ -9,9 +9,10 @@ using namespace Renderer;
 using namespace PAL::RenderAPI;
 
 
-VulkanSwapChain::VulkanSwapChain(std::shared_ptr<PAL::RenderAPI::VulkanDevice>device, DeviceObject&& swapChain)
+VulkanSwapChain::VulkanSwapChain(std::shared_ptr<PAL::RenderAPI::VulkanDevice>device, VulkanRenderer& renderer, DeviceObject&& swapChain)
     : SwapChainBase(std::move(swapChain))
     , mDevice(std::move(device))
+    , mRenderer(renderer)
 {}
 
 VulkanSwapChain::~VulkanSwapChain()
@@ -21,45 +22,39 @@ VulkanSwapChain::~VulkanSwapChain()
 
 void VulkanSwapChain::Destroy()
 {
-    DestroyVisitor visitor(mDevice);
-    
-    auto& swapDeviceObject = GetDeviceObject();
-    swapDeviceObject.Accept(visitor);
+    mRenderer.DestroyDeviceObject(GetDeviceObject());
 }
 
 bool VulkanSwapChain::AcquireImage()
 {
-    const auto& swapChainDeviceObject = GetDeviceObject();
+    const VkSwapchainKHR swapChain = mRenderer.GetResources().swapChains.Get(GetDeviceObject()).swapChain.Get();
     
-    VulkanSwapChainVisitor visitor;
-    swapChainDeviceObject.Accept(visitor);
+    // Blocks only until GPU releases the oldest frame in flight
+    auto& frame = mRenderer.BeginFrame();
     
-    const auto status = mDevice->AcquireNextImageKHR(visitor.swapChain,
+    const auto status = mDevice->AcquireNextImageKHR(swapChain,
                                                      std::numeric_limits<uint64_t>::max(),
-                                                     visitor.imgAvailableSemaphore,
+                                                     frame.sync.imageAvailableSemaphore.Get(),
                                                      VK_NULL_HANDLE,
                                                      &mAcquiredImageIndex);
     
-    mDevice->WaitForFences(1, &visitor.frameFence, VK_TRUE, std::numeric_limits<uint64_t>::max());
-    mDevice->ResetFences(1, &visitor.frameFence);
+    frame.imageAcquired = (status == VK_SUCCESS || status == VK_SUBOPTIMAL_KHR);
+    mRenderFinishedSemaphore = frame.sync.renderFinishedSemaphore.Get();
     
     return (status != VK_SUCCESS) ? false : true;
 }
 
 void VulkanSwapChain::SwapBuffers()
 {
-    const auto& swapChainDeviceObject = GetDeviceObject();
-    
-    VulkanSwapChainVisitor visitor;
-    swapChainDeviceObject.Accept(visitor);
+    const VkSwapchainKHR swapChain = mRenderer.GetResources().swapChains.Get(GetDeviceObject()).swapChain.Get();
     
     // Present
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores = &visitor.renderFinishedSemaphore;
+    presentInfo.pWaitSemaphores = &mRenderFinishedSemaphore;
     presentInfo.swapchainCount = 1;
-    presentInfo.pSwapchains = &visitor.swapChain;
+    presentInfo.pSwapchains = &swapChain;
     presentInfo.pImageIndices = &mAcquiredImageIndex;
     presentInfo.pResults = nullptr; // Optional
     
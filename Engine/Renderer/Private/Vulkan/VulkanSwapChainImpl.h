@@ -13,12 +13,14 @@ namespace PAL::RenderAPI
 
 namespace Renderer
 {
+    class VulkanRenderer;
+    
     class VulkanSwapChain : public SwapChainBase
     {
         friend class VulkanRenderer;
         
     public:
-        VulkanSwapChain(std::shared_ptr<PAL::RenderAPI::VulkanDevice>device, DeviceObject&& swapChain);
+        VulkanSwapChain(std::shared_ptr<PAL::RenderAPI::VulkanDevice>device, VulkanRenderer& renderer, DeviceObject&& swapChain);
         virtual ~VulkanSwapChain();
 
         // SwapChainBase interface
@@ -28,5 +30,9 @@ namespace Renderer
 
     private:
         std::shared_ptr<PAL::RenderAPI::VulkanDevice> mDevice;
+        VulkanRenderer& mRenderer;
+        
+        // Semaphore of the frame which rendered into the acquired image, frame ring may advance before present
+        VkSemaphore mRenderFinishedSemaphore{ VK_NULL_HANDLE };
     };
 }
@@ -2,6 +2,7 @@
 
 #include <Renderer/VertexBuffer.h>
 #include <Renderer/Image.h>
+#include <Renderer/RenderPass.h>
 #include <Renderer/Effect.h>
 #include <Renderer/SharedDeviceTypes.h>
 #include <Renderer/Resources/Texture.h>
@@ -15,6 +16,8 @@ auto TypeLinkerTempl<Renderer::BufferUsage, VkBufferUsageFlagBits>::operator()(c
         case Renderer::BufferUsage::VertexBuffer: return to_t{ VK_BUFFER_USAGE_VERTEX_BUFFER_BIT };
         case Renderer::BufferUsage::UniformBuffer: return to_t{ VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT };
         case Renderer::BufferUsage::IndexBuffer: return to_t{ VK_BUFFER_USAGE_INDEX_BUFFER_BIT };
+        case Renderer::BufferUsage::StorageBuffer: return to_t{ VK_BUFFER_USAGE_STORAGE_BUFFER_BIT };
+        case Renderer::BufferUsage::IndirectBuffer: return static_cast<to_t>(VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
     }
 }
 
@@ -37,15 +40,18 @@ auto TypeLinkerTempl<Renderer::ImageUsage, VkImageUsageFlags>::operator()(const
     if(imageUsage == Renderer::ImageUsage::Undefined)
         throw std::runtime_error("Undefined image usage");
     
-    if(imageUsage == Renderer::ImageUsage::Sampled)
+    if(imageUsage & Renderer::ImageUsage::Sampled)
         usageFlags |= VK_IMAGE_USAGE_SAMPLED_BIT;
         
-    if(imageUsage == Renderer::ImageUsage::ColorAttachment)
+    if(imageUsage & Renderer::ImageUsage::ColorAttachment)
         usageFlags |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
         
-    if(imageUsage == Renderer::ImageUsage::DepthStencilAttachment)
+    if(imageUsage & Renderer::ImageUsage::DepthStencilAttachment)
         usageFlags |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
     
+    if(imageUsage & Renderer::ImageUsage::Storage)
+        usageFlags |= VK_IMAGE_USAGE_STORAGE_BIT;
+    
     return usageFlags;
 }
 
@@ -60,6 +66,20 @@ auto TypeLinkerTempl<Renderer::ImageLayout, VkImageLayout>::operator()(const fro
         case Renderer::ImageLayout::DepthAttachment: return VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
         case Renderer::ImageLayout::ShaderReadOnly: return VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         case Renderer::ImageLayout::DepthStencilReadOnly: return VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        case Renderer::ImageLayout::General: return VK_IMAGE_LAYOUT_GENERAL;
+        case Renderer::ImageLayout::TransferSource: return VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        case Renderer::ImageLayout::TransferDestination: return VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    }
+}
+
+template<>
+auto TypeLinkerTempl<Renderer::LoadOperation, VkAttachmentLoadOp>::operator()(const from_t& operation) -> to_t
+{
+    switch(operation)
+    {
+        case Renderer::LoadOperation::Clear: return VK_ATTACHMENT_LOAD_OP_CLEAR;
+        case Renderer::LoadOperation::Load: return VK_ATTACHMENT_LOAD_OP_LOAD;
+        case Renderer::LoadOperation::DontCare: return VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     }
 }
 
@@ -129,6 +149,7 @@ auto TypeLinkerTempl<Renderer::ModuleStage, VkShaderStageFlagBits>::operator()(c
         case Renderer::ModuleStage::Undefined: throw std::runtime_error("Undefined shader stage");
         case Renderer::ModuleStage::Vertex: return to_t{ VK_SHADER_STAGE_VERTEX_BIT };
         case Renderer::ModuleStage::Fragment: return to_t{ VK_SHADER_STAGE_FRAGMENT_BIT };
+        case Renderer::ModuleStage::Compute: return to_t{ VK_SHADER_STAGE_COMPUTE_BIT };
     }
 }
 
@@ -140,7 +161,10 @@ auto TypeLinkerTempl<Renderer::UniformType, VkDescriptorType>::operator()(const
     {
         case Renderer::UniformType::Undefined: throw std::runtime_error("Undefined uniform type");
         case Renderer::UniformType::Buffer: return to_t{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER };
+        case Renderer::UniformType::DynamicBuffer: return to_t{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC };
         case Renderer::UniformType::Sampler: return to_t{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER };
+        case Renderer::UniformType::StorageBuffer: return to_t{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER };
+        case Renderer::UniformType::StorageImage: return to_t{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE };
     }
 }
 
@@ -177,16 +201,28 @@ auto TypeLinkerTempl<Renderer::StageMask, VkPipelineStageFlags>::operator()(cons
     
     if(mask == Renderer::StageMask::Undefined)
         throw std::runtime_error("Undefined stage mask flag");
-    if(mask == Renderer::StageMask::EarlyFragmentTest)
+    if(mask & Renderer::StageMask::EarlyFragmentTest)
         stageFlags |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    if(mask == Renderer::StageMask::LateFragmentTest)
+    if(mask & Renderer::StageMask::LateFragmentTest)
         stageFlags |= VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-    if(mask == Renderer::StageMask::ColorAttachment)
+    if(mask & Renderer::StageMask::ColorAttachment)
         stageFlags |= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    if(mask == Renderer::StageMask::FragmentShader)
+    if(mask & Renderer::StageMask::FragmentShader)
         stageFlags |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    if(mask == Renderer::StageMask::BottomOfPipe)
+    if(mask & Renderer::StageMask::BottomOfPipe)
         stageFlags |= VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    if(mask & Renderer::StageMask::TopOfPipe)
+        stageFlags |= VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    if(mask & Renderer::StageMask::DrawIndirect)
+        stageFlags |= VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+    if(mask & Renderer::StageMask::VertexInput)
+        stageFlags |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+    if(mask & Renderer::StageMask::VertexShader)
+        stageFlags |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+    if(mask & Renderer::StageMask::ComputeShader)
+        stageFlags |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    if(mask & Renderer::StageMask::Transfer)
+        stageFlags |= VK_PIPELINE_STAGE_TRANSFER_BIT;
         
     return stageFlags;
 }
@@ -196,23 +232,64 @@ auto TypeLinkerTempl<Renderer::AccessMask, VkAccessFlags>::operator()(const from
 {
     VkAccessFlags accessFlags{ 0 };
     
-    if(mask == Renderer::AccessMask::Undefined)
-        throw std::runtime_error("Undefined access mask flag");
-    if(mask == Renderer::AccessMask::DepthStencilRead)
+    // Undefined access is valid source of barriers whose earlier accesses don't need to be made visible
+    if(mask & Renderer::AccessMask::DepthStencilRead)
         accessFlags |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
-    if(mask == Renderer::AccessMask::DepthStencilWrite)
+    if(mask & Renderer::AccessMask::DepthStencilWrite)
         accessFlags |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-    if(mask == Renderer::AccessMask::ColorRead)
+    if(mask & Renderer::AccessMask::ColorRead)
         accessFlags |= VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
-    if(mask == Renderer::AccessMask::ColorWrite)
+    if(mask & Renderer::AccessMask::ColorWrite)
         accessFlags |= VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-    if(mask == Renderer::AccessMask::InputRead)
+    if(mask & Renderer::AccessMask::InputRead)
         accessFlags |= VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
-    if(mask == Renderer::AccessMask::MemoryRead)
+    if(mask & Renderer::AccessMask::MemoryRead)
         accessFlags |= VK_ACCESS_MEMORY_READ_BIT;
-    if(mask == Renderer::AccessMask::ShaderRead)
+    if(mask & Renderer::AccessMask::ShaderRead)
         accessFlags |= VK_ACCESS_SHADER_READ_BIT;
+    if(mask & Renderer::AccessMask::ShaderWrite)
+        accessFlags |= VK_ACCESS_SHADER_WRITE_BIT;
+    if(mask & Renderer::AccessMask::IndirectCommandRead)
+        accessFlags |= VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+    if(mask & Renderer::AccessMask::VertexAttributeRead)
+        accessFlags |= VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+    if(mask & Renderer::AccessMask::IndexRead)
+        accessFlags |= VK_ACCESS_INDEX_READ_BIT;
+    if(mask & Renderer::AccessMask::UniformRead)
+        accessFlags |= VK_ACCESS_UNIFORM_READ_BIT;
+    if(mask & Renderer::AccessMask::TransferRead)
+        accessFlags |= VK_ACCESS_TRANSFER_READ_BIT;
+    if(mask & Renderer::AccessMask::TransferWrite)
+        accessFlags |= VK_ACCESS_TRANSFER_WRITE_BIT;
                     
     return accessFlags;
 }
 
+Renderer::VulkanLayoutAccess Renderer::GetLayoutAccess(VkImageLayout layout)
+{
+    switch(layout)
+    {
+        case VK_IMAGE_LAYOUT_UNDEFINED:
+            return { VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0 };
+        case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+            return { VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT };
+        case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+            return { VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT };
+        case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+            return { VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT };
+        case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+            return { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT };
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+            return { VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                     VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT };
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+            return { VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                     VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_SHADER_READ_BIT };
+        case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+            // Presentation engine waits on semaphore, no stage of the queue accesses the image
+            return { VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0 };
+        default:
+            // General layout may be used by anything
+            return { VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT };
+    }
+}
@@ -16,6 +16,7 @@ namespace Renderer
     enum class ImageType;
     enum class ImageUsage : uint32_t;
     enum class ImageLayout;
+    enum class LoadOperation;
     enum class Format;
     enum class AddressMode;
     enum class FilterMode;
@@ -31,6 +32,7 @@ template<> struct TypeLinkerAuto<Renderer::BufferUsage> : public TypeLinkerTempl
 template<> struct TypeLinkerAuto<Renderer::ImageType> : public TypeLinkerTempl<Renderer::ImageType, VkImageType> {};
 template<> struct TypeLinkerAuto<Renderer::ImageUsage> : public TypeLinkerTempl<Renderer::ImageUsage, VkImageUsageFlags> {};
 template<> struct TypeLinkerAuto<Renderer::ImageLayout> : public TypeLinkerTempl<Renderer::ImageLayout, VkImageLayout> {};
+template<> struct TypeLinkerAuto<Renderer::LoadOperation> : public TypeLinkerTempl<Renderer::LoadOperation, VkAttachmentLoadOp> {};
 template<> struct TypeLinkerAuto<Renderer::Format> : public TypeLinkerTempl<Renderer::Format, VkFormat> {};
 template<> struct TypeLinkerAuto<Renderer::MemoryType> : public TypeLinkerTempl<Renderer::MemoryType, VkMemoryPropertyFlags> {};
 template<> struct TypeLinkerAuto<Renderer::AddressMode> : public TypeLinkerTempl<Renderer::AddressMode, VkSamplerAddressMode> {};
@@ -66,4 +68,15 @@ namespace Renderer
         std::vector<VkImageView> attachments;
         VkRenderPass renderPass{ VK_NULL_HANDLE };
     };
+    
+    /*!
+     @brief Pipeline stages & memory accesses using image in its layout, scope of barrier transitioning image from or to the layout.
+     */
+    struct VulkanLayoutAccess
+    {
+        VkPipelineStageFlags stages{ VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT };
+        VkAccessFlags access{ 0 };
+    };
+    
+    VulkanLayoutAccess GetLayoutAccess(VkImageLayout layout);
 }
@@ -0,0 +1,63 @@
+#include "VulkanUniformRing.h"
+
+#include <Logging/LoggingService.h>
+#include <Core/Assert.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef LOG_MODULE_ID
+#undef LOG_MODULE_ID
+#endif
+
+#define LOG_MODULE_ID LOG_MODULE_4BYTE('V','K','U','R')
+
+using namespace Renderer;
+using namespace PAL::RenderAPI;
+
+VulkanUniformRing::VulkanUniformRing(std::shared_ptr<VulkanDevice> device,
+                                     std::shared_ptr<VulkanMemoryAllocator> allocator,
+                                     const BufferDeviceObject& buffer,
+                                     VkDeviceSize frameSize,
+                                     uint32_t frameCount,
+                                     VkDeviceSize alignment)
+    : mDevice(std::move(device))
+    , mAllocator(std::move(allocator))
+    , mBuffer(buffer)
+    , mData(static_cast<uint8_t*>(buffer.allocation.mappedData))
+    , mFrameSize(frameSize)
+    , mAlignment(std::max<VkDeviceSize>(alignment, 1))
+{
+    _ASSERT(mData && "Uniform ring buffer has to be host visible");
+    _ASSERT(mFrameSize % mAlignment == 0 && "Frame regions have to start aligned");
+
+    LOG(Information) << "Uniform ring: " << frameCount << " x " << (mFrameSize >> 10) << "KB, offset alignment: " << mAlignment;
+}
+
+VulkanUniformRing::~VulkanUniformRing()
+{
+    mDevice->DestroyBuffer(mBuffer.buffer, nullptr);
+    mAllocator->Free(mBuffer.allocation);
+}
+
+void VulkanUniformRing::BeginFrame(uint32_t frameIndex)
+{
+    mFrameBase = frameIndex * mFrameSize;
+    mHead.store(0, std::memory_order_relaxed);
+}
+
+uint32_t VulkanUniformRing::Write(const void* data, uint32_t size)
+{
+    const VkDeviceSize alignedSize = (size + mAlignment - 1) / mAlignment * mAlignment;
+    const VkDeviceSize offset = mHead.fetch_add(alignedSize, std::memory_order_relaxed);
+
+    if(offset + size > mFrameSize)
+    {
+        throw std::runtime_error("Uniform data of the frame don't fit into uniform ring!");
+    }
+
+    std::memcpy(mData + mFrameBase + offset, data, size);
+
+    return static_cast<uint32_t>(mFrameBase + offset);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <PAL/RenderAPI/Vulkan/VulkanDevice.h>
+#include <Core/Platform.h>
+
+#include "VulkanDeviceObjects.h"
+#include "VulkanMemoryAllocator.h"
+
+#include <atomic>
+#include <memory>
+
+namespace Renderer
+{
+    /*!
+     @brief Persistently mapped buffer of uniform data written by CPU every frame.
+
+     Buffer is split into one region per frame in flight, data of a frame is sub-allocated linearly from its region
+     & bound by dynamic offsets. Region is rewound once GPU released the frame slot, so no data is overwritten while
+     GPU may still read it.
+     Writes are thread safe, BeginFrame must not run concurrently with them.
+     */
+    class VulkanUniformRing
+    {
+    public:
+        /*!
+         @param buffer Host visible & coherent buffer of frameSize * frameCount bytes, ownership is taken by the ring.
+         @param alignment Minimal uniform buffer offset alignment of the device.
+         */
+        VulkanUniformRing(std::shared_ptr<PAL::RenderAPI::VulkanDevice> device,
+                          std::shared_ptr<VulkanMemoryAllocator> allocator,
+                          const BufferDeviceObject& buffer,
+                          VkDeviceSize frameSize,
+                          uint32_t frameCount,
+                          VkDeviceSize alignment);
+        ~VulkanUniformRing();
+
+        DECLARE_NOCOPY_NOMOVE(VulkanUniformRing)
+
+        /*!
+         @brief Rewinds region of the frame slot, GPU has to be done with the slot.
+         */
+        void BeginFrame(uint32_t frameIndex);
+
+        /*!
+         @brief Copies data into region of the current frame.
+         @return Offset of the data in the buffer.
+         */
+        NO_DISCARD uint32_t Write(const void* data, uint32_t size);
+
+        NO_DISCARD VkBuffer GetBuffer() const noexcept { return mBuffer.buffer; }
+
+    private:
+        std::shared_ptr<PAL::RenderAPI::VulkanDevice> mDevice;
+        std::shared_ptr<VulkanMemoryAllocator> mAllocator;
+
+        BufferDeviceObject mBuffer;
+        uint8_t* mData{ nullptr };
+
+        VkDeviceSize mFrameSize{ 0 };
+        VkDeviceSize mAlignment{ 1 };
+        VkDeviceSize mFrameBase{ 0 };
+
+        std::atomic<VkDeviceSize> mHead{ 0 };
+    };
+}
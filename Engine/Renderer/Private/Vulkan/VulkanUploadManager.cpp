@@ -0,0 +1,567 @@
+#include "VulkanUploadManager.h"
+#include "VulkanTypes.h"
+
+#include <Logging/LoggingService.h>
+#include <Core/Assert.h>
+#include <microprofile/microprofile.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#ifdef LOG_MODULE_ID
+#undef LOG_MODULE_ID
+#endif
+
+#define LOG_MODULE_ID LOG_MODULE_4BYTE('V','K','U','P')
+
+using namespace Renderer;
+using namespace PAL::RenderAPI;
+
+namespace
+{
+    // Number of batches which may be submitted at once, recording another one waits for the oldest
+    constexpr uint32_t UPLOAD_BATCH_COUNT = 4;
+
+    // Bigger uploads are split into chunks, so single upload never needs more than a part of the ring
+    constexpr VkDeviceSize MAX_CHUNK_RING_FRACTION = 4;
+
+    // Multiple of 4 required by image copies, also keeps copies source aligned for DMA engines
+    constexpr VkDeviceSize COPY_ALIGNMENT = 16;
+
+    VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+VulkanUploadManager::VulkanUploadManager(std::shared_ptr<VulkanDevice> device,
+                                         std::shared_ptr<VulkanMemoryAllocator> allocator,
+                                         const BufferDeviceObject& stagingBuffer,
+                                         VkDeviceSize stagingSize,
+                                         VkQueue queue,
+                                         uint32_t queueFamilyIndex,
+                                         uint32_t graphicsQueueFamilyIndex)
+    : mDevice(std::move(device))
+    , mAllocator(std::move(allocator))
+    , mStagingBuffer(stagingBuffer)
+    , mStagingData(static_cast<uint8_t*>(stagingBuffer.allocation.mappedData))
+    , mStagingSize(stagingSize)
+    , mQueue(queue)
+    , mQueueFamilyIndex(queueFamilyIndex)
+    , mGraphicsQueueFamilyIndex(graphicsQueueFamilyIndex)
+{
+    _ASSERT(mStagingData && "Staging buffer has to be host visible");
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = mQueueFamilyIndex;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    mBatches.resize(UPLOAD_BATCH_COUNT);
+
+    for(auto& batch : mBatches)
+    {
+        mDevice->CreateCommandPool(&poolInfo, nullptr, &batch.commandPool);
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = batch.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        mDevice->AllocateCommandBuffers(&allocInfo, &batch.commandBuffer);
+        mDevice->CreateFence(&fenceInfo, nullptr, &batch.fence);
+    }
+
+    LOG(Information) << "Uploads use " << (UsesDedicatedQueue() ? "dedicated transfer" : "graphics") << " queue, staging ring size: " << (mStagingSize >> 20) << "MB";
+}
+
+VulkanUploadManager::~VulkanUploadManager()
+{
+    while(mInFlightCount > 0)
+    {
+        RetireOldest();
+    }
+
+    for(auto& batch : mBatches)
+    {
+        mDevice->DestroyFence(batch.fence, nullptr);
+        mDevice->DestroyCommandPool(batch.commandPool, nullptr);
+    }
+
+    for(const auto semaphore : mPendingWaits)
+    {
+        mDevice->DestroySemaphore(semaphore, nullptr);
+    }
+
+    for(const auto semaphore : mFreeSemaphores)
+    {
+        mDevice->DestroySemaphore(semaphore, nullptr);
+    }
+
+    mDevice->DestroyBuffer(mStagingBuffer.buffer, nullptr);
+    mAllocator->Free(mStagingBuffer.allocation);
+}
+
+UploadHandle VulkanUploadManager::UploadBuffer(VkBuffer buffer, const void* data, VkDeviceSize size)
+{
+    if(!data || size == 0)
+        return 0;
+
+    const auto* source = static_cast<const uint8_t*>(data);
+    const VkDeviceSize maxChunkSize = mStagingSize / MAX_CHUNK_RING_FRACTION;
+
+    for(VkDeviceSize copied{ 0 }; copied < size;)
+    {
+        const VkDeviceSize chunkSize = std::min(size - copied, maxChunkSize);
+
+        // Allocation may submit the recorded batch, so the batch is queried after it
+        const VkDeviceSize offset = Allocate(chunkSize, COPY_ALIGNMENT);
+        memcpy(mStagingData + offset, source + copied, static_cast<size_t>(chunkSize));
+
+        auto& batch = GetRecordingBatch();
+
+        VkBufferCopy region{};
+        region.srcOffset = offset;
+        region.dstOffset = copied;
+        region.size = chunkSize;
+
+        mDevice->CmdCopyBuffer(batch.commandBuffer, mStagingBuffer.buffer, buffer, 1, &region);
+        batch.hasBufferCopies = true;
+
+        copied += chunkSize;
+    }
+
+    auto& batch = GetRecordingBatch();
+
+    if(UsesDedicatedQueue())
+    {
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        barrier.srcQueueFamilyIndex = mQueueFamilyIndex;
+        barrier.dstQueueFamilyIndex = mGraphicsQueueFamilyIndex;
+        barrier.buffer = buffer;
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+
+        batch.bufferReleases.push_back(barrier);
+
+        // Acquire has to match the release, only access masks differ
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+        batch.bufferAcquires.push_back(barrier);
+    }
+
+    return batch.handle;
+}
+
+UploadHandle VulkanUploadManager::UploadImage(VkImage image, uint32_t width, uint32_t height, uint32_t texelSize, const void* data)
+{
+    if(!data || width == 0 || height == 0)
+        return 0;
+
+    const auto* source = static_cast<const uint8_t*>(data);
+    const VkDeviceSize rowPitch = VkDeviceSize(width) * texelSize;
+    const VkDeviceSize maxChunkSize = mStagingSize / MAX_CHUNK_RING_FRACTION;
+    const auto rowsPerChunk = static_cast<uint32_t>(std::clamp<VkDeviceSize>(maxChunkSize / rowPitch, 1, height));
+
+    // Buffer offset of image copy has to be multiple of texel size
+    const VkDeviceSize alignment = std::lcm<VkDeviceSize>(texelSize, COPY_ALIGNMENT);
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+
+    for(uint32_t row{ 0 }; row < height;)
+    {
+        const uint32_t rowCount = std::min(rowsPerChunk, height - row);
+        const VkDeviceSize chunkSize = rowPitch * rowCount;
+
+        const VkDeviceSize offset = Allocate(chunkSize, alignment);
+        memcpy(mStagingData + offset, source + row * rowPitch, static_cast<size_t>(chunkSize));
+
+        auto& batch = GetRecordingBatch();
+
+        // Batch holding the first chunk transitions the image, the following batches are submitted after it
+        if(row == 0)
+        {
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+            batch.imageTransitions.push_back(barrier);
+        }
+
+        ImageCopy copy;
+        copy.image = image;
+
+        VkBufferImageCopy& region = copy.region;
+        region.bufferOffset = offset;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = { 0, static_cast<int32_t>(row), 0 };
+        region.imageExtent = { width, rowCount, 1 };
+
+        batch.imageCopies.push_back(copy);
+
+        row += rowCount;
+    }
+
+    auto& batch = GetRecordingBatch();
+
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    if(UsesDedicatedQueue())
+    {
+        // Release, transfer queue can't reference graphics stages & the layout change is shared with the acquire
+        barrier.dstAccessMask = 0;
+        barrier.srcQueueFamilyIndex = mQueueFamilyIndex;
+        barrier.dstQueueFamilyIndex = mGraphicsQueueFamilyIndex;
+
+        batch.imageReleases.push_back(barrier);
+
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = GetLayoutAccess(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL).access;
+        batch.imageAcquires.push_back(barrier);
+    }
+    else
+    {
+        barrier.dstAccessMask = GetLayoutAccess(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL).access;
+
+        batch.imageReleases.push_back(barrier);
+    }
+
+    return batch.handle;
+}
+
+UploadHandle VulkanUploadManager::Flush()
+{
+    if(!mRecording)
+        return mLastHandle;
+
+    MICROPROFILE_SCOPEI("Renderer", "FlushUploads", 0x0080ff);
+
+    auto& batch = mBatches[mRecordingIndex];
+
+    RecordImageCopies(batch);
+    RecordReleases(batch);
+
+    mDevice->EndCommandBuffer(batch.commandBuffer);
+
+    VkSemaphore signalSemaphore{ VK_NULL_HANDLE };
+
+    if(!batch.bufferAcquires.empty() || !batch.imageAcquires.empty())
+    {
+        if(mFreeSemaphores.empty())
+        {
+            VkSemaphoreCreateInfo semaphoreInfo{};
+            semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+            mDevice->CreateSemaphore(&semaphoreInfo, nullptr, &signalSemaphore);
+        }
+        else
+        {
+            signalSemaphore = mFreeSemaphores.back();
+            mFreeSemaphores.pop_back();
+        }
+
+        mPendingWaits.push_back(signalSemaphore);
+
+        mBufferAcquires.insert(mBufferAcquires.end(), batch.bufferAcquires.begin(), batch.bufferAcquires.end());
+        mImageAcquires.insert(mImageAcquires.end(), batch.imageAcquires.begin(), batch.imageAcquires.end());
+        batch.bufferAcquires.clear();
+        batch.imageAcquires.clear();
+    }
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &batch.commandBuffer;
+    submitInfo.signalSemaphoreCount = signalSemaphore != VK_NULL_HANDLE ? 1 : 0;
+    submitInfo.pSignalSemaphores = &signalSemaphore;
+
+    mDevice->ResetFences(1, &batch.fence);
+    mDevice->QueueSubmit(mQueue, 1, &submitInfo, batch.fence);
+
+    batch.ringEnd = mHead;
+
+    mRecording = false;
+    mRecordingIndex = (mRecordingIndex + 1) % UPLOAD_BATCH_COUNT;
+    ++mInFlightCount;
+
+    return batch.handle;
+}
+
+bool VulkanUploadManager::IsComplete(UploadHandle handle)
+{
+    if(handle <= mCompletedHandle)
+        return true;
+
+    RetireCompleted();
+
+    return handle <= mCompletedHandle;
+}
+
+void VulkanUploadManager::Wait(UploadHandle handle)
+{
+    if(mRecording && handle >= mBatches[mRecordingIndex].handle)
+    {
+        Flush();
+    }
+
+    while(mCompletedHandle < handle && mInFlightCount > 0)
+    {
+        RetireOldest();
+    }
+}
+
+bool VulkanUploadManager::AcquireResources(VkCommandBuffer commandBuffer, std::vector<VkSemaphore>& waitSemaphores)
+{
+    if(mBufferAcquires.empty() && mImageAcquires.empty())
+        return false;
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    // Source stage matches the semaphore wait stage, so acquire is chained after the release
+    mDevice->BeginCommandBuffer(commandBuffer, &beginInfo);
+    mDevice->CmdPipelineBarrier(commandBuffer,
+                                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                0,
+                                0, nullptr,
+                                static_cast<uint32_t>(mBufferAcquires.size()), mBufferAcquires.data(),
+                                static_cast<uint32_t>(mImageAcquires.size()), mImageAcquires.data());
+    mDevice->EndCommandBuffer(commandBuffer);
+
+    waitSemaphores.insert(waitSemaphores.end(), mPendingWaits.begin(), mPendingWaits.end());
+
+    mPendingWaits.clear();
+    mBufferAcquires.clear();
+    mImageAcquires.clear();
+
+    return true;
+}
+
+void VulkanUploadManager::RecycleSemaphores(std::vector<VkSemaphore>& semaphores)
+{
+    mFreeSemaphores.insert(mFreeSemaphores.end(), semaphores.begin(), semaphores.end());
+    semaphores.clear();
+}
+
+VulkanUploadManager::Batch& VulkanUploadManager::GetRecordingBatch()
+{
+    auto& batch = mBatches[mRecordingIndex];
+
+    if(mRecording)
+        return batch;
+
+    // Batches are reused in submission order, all of them are in flight so this one is the oldest
+    if(mInFlightCount == UPLOAD_BATCH_COUNT)
+    {
+        RetireOldest();
+    }
+
+    mDevice->ResetCommandPool(batch.commandPool, 0);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    mDevice->BeginCommandBuffer(batch.commandBuffer, &beginInfo);
+
+    batch.handle = ++mLastHandle;
+    batch.hasBufferCopies = false;
+    mRecording = true;
+
+    return batch;
+}
+
+VkDeviceSize VulkanUploadManager::Allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+    VkDeviceSize offset{ 0 };
+
+    while(!TryAllocate(size, alignment, offset))
+    {
+        // Space used by recorded batch is released only once the batch is submitted & finished
+        Flush();
+
+        if(mInFlightCount == 0)
+        {
+            throw std::runtime_error("Upload doesn't fit into staging ring");
+        }
+
+        MICROPROFILE_SCOPEI("Renderer", "WaitForStagingSpace", 0xff8000);
+        RetireOldest();
+    }
+
+    return offset;
+}
+
+bool VulkanUploadManager::TryAllocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset)
+{
+    const VkDeviceSize alignedHead = AlignUp(mHead, alignment);
+
+    if(mHead >= mTail)
+    {
+        // Free space is [head, end) and [0, tail), wrapped allocation abandons the rest of the ring
+        if(alignedHead + size <= mStagingSize)
+        {
+            offset = alignedHead;
+        }
+        else if(size < mTail)
+        {
+            offset = 0;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    else if(alignedHead + size < mTail)
+    {
+        offset = alignedHead;
+    }
+    else
+    {
+        return false;
+    }
+
+    mHead = offset + size;
+    return true;
+}
+
+void VulkanUploadManager::RecordImageCopies(Batch& batch)
+{
+    if(!batch.imageTransitions.empty())
+    {
+        mDevice->CmdPipelineBarrier(batch.commandBuffer,
+                                    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                    0,
+                                    0, nullptr,
+                                    0, nullptr,
+                                    static_cast<uint32_t>(batch.imageTransitions.size()), batch.imageTransitions.data());
+    }
+
+    // Chunks of one image follow each other, they're copied by single command
+    for(size_t first = 0; first < batch.imageCopies.size();)
+    {
+        const VkImage image = batch.imageCopies[first].image;
+
+        mRegionScratch.clear();
+
+        size_t last = first;
+        for(; last < batch.imageCopies.size() && batch.imageCopies[last].image == image; ++last)
+        {
+            mRegionScratch.push_back(batch.imageCopies[last].region);
+        }
+
+        mDevice->CmdCopyBufferToImage(batch.commandBuffer, mStagingBuffer.buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                      static_cast<uint32_t>(mRegionScratch.size()), mRegionScratch.data());
+
+        first = last;
+    }
+
+    batch.imageTransitions.clear();
+    batch.imageCopies.clear();
+}
+
+void VulkanUploadManager::RecordReleases(Batch& batch)
+{
+    VkMemoryBarrier bufferBarrier{};
+    bufferBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    bufferBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+
+    // Buffers uploaded on graphics queue are made visible by one memory barrier for the whole batch
+    const bool hasBufferBarrier = batch.hasBufferCopies && !UsesDedicatedQueue();
+
+    if(!hasBufferBarrier && batch.bufferReleases.empty() && batch.imageReleases.empty())
+        return;
+
+    VkPipelineStageFlags dstStageMask{ 0 };
+
+    if(UsesDedicatedQueue())
+    {
+        // Transfer queue can't reference graphics stages, acquire waits for the release by semaphore
+        dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    }
+    else
+    {
+        if(hasBufferBarrier)
+            dstStageMask |= VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        if(!batch.imageReleases.empty())
+            dstStageMask |= GetLayoutAccess(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL).stages;
+    }
+
+    mDevice->CmdPipelineBarrier(batch.commandBuffer,
+                                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                dstStageMask,
+                                0,
+                                hasBufferBarrier ? 1 : 0, &bufferBarrier,
+                                static_cast<uint32_t>(batch.bufferReleases.size()), batch.bufferReleases.data(),
+                                static_cast<uint32_t>(batch.imageReleases.size()), batch.imageReleases.data());
+
+    batch.bufferReleases.clear();
+    batch.imageReleases.clear();
+}
+
+void VulkanUploadManager::RetireCompleted()
+{
+    while(mInFlightCount > 0)
+    {
+        auto& batch = mBatches[(mRecordingIndex + UPLOAD_BATCH_COUNT - mInFlightCount) % UPLOAD_BATCH_COUNT];
+
+        if(mDevice->GetFenceStatus(batch.fence) != VK_SUCCESS)
+            break;
+
+        Retire(batch);
+    }
+}
+
+void VulkanUploadManager::RetireOldest()
+{
+    auto& batch = mBatches[(mRecordingIndex + UPLOAD_BATCH_COUNT - mInFlightCount) % UPLOAD_BATCH_COUNT];
+
+    mDevice->WaitForFences(1, &batch.fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+
+    Retire(batch);
+}
+
+void VulkanUploadManager::Retire(Batch& batch)
+{
+    mTail = batch.ringEnd;
+    mCompletedHandle = batch.handle;
+    --mInFlightCount;
+
+    // Empty ring starts from the beginning again, so big allocations don't need to wrap
+    if(mHead == mTail)
+    {
+        mHead = 0;
+        mTail = 0;
+    }
+}
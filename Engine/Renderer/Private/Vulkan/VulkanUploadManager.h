@@ -0,0 +1,155 @@
+#pragma once
+
+#include <PAL/RenderAPI/Vulkan/VulkanDevice.h>
+#include <Renderer/Renderer.h>
+#include <Core/Platform.h>
+
+#include "VulkanDeviceObjects.h"
+
+#include <memory>
+#include <vector>
+
+namespace Renderer
+{
+    /*!
+     @brief Streams resource data to device local memory through persistently mapped staging ring.
+
+     Copies are recorded into batches, every batch is one submission signaling its own fence, staging space
+     used by the batch is recycled once the fence is signaled. Returned handles grow monotonically with batches,
+     so a handle is complete once every batch up to it retired.
+     Layout transitions & releases of all images of the batch are coalesced, the batch records one barrier before
+     its image copies & one barrier after all its copies.
+     When uploads run on dedicated transfer queue, resources are released by the transfer queue and have to be
+     acquired by graphics queue before they are used, see AcquireResources.
+     Not thread safe, uploads are expected from the thread owning the renderer.
+     */
+    class VulkanUploadManager
+    {
+    public:
+        /*!
+         @param allocator Allocator staging buffer memory was allocated from.
+         @param stagingBuffer Host visible & coherent buffer, ownership is taken by upload manager.
+         @param queueFamilyIndex Family of queue used for uploads.
+         @param graphicsQueueFamilyIndex Family of queue using uploaded resources.
+         */
+        VulkanUploadManager(std::shared_ptr<PAL::RenderAPI::VulkanDevice> device,
+                            std::shared_ptr<VulkanMemoryAllocator> allocator,
+                            const BufferDeviceObject& stagingBuffer,
+                            VkDeviceSize stagingSize,
+                            VkQueue queue,
+                            uint32_t queueFamilyIndex,
+                            uint32_t graphicsQueueFamilyIndex);
+        ~VulkanUploadManager();
+
+        DECLARE_NOCOPY_NOMOVE(VulkanUploadManager)
+
+        /*!
+         @brief Copies data into staging ring & records its copy to the buffer. Data may be released once the call returns.
+         */
+        UploadHandle UploadBuffer(VkBuffer buffer, const void* data, VkDeviceSize size);
+
+        /*!
+         @brief Copies tightly packed texels of 2D image, image ends in shader read only layout.
+         */
+        UploadHandle UploadImage(VkImage image, uint32_t width, uint32_t height, uint32_t texelSize, const void* data);
+
+        /*!
+         @brief Submits batch being recorded, doesn't wait for its completion.
+         @return Handle of the most recent upload.
+         */
+        UploadHandle Flush();
+
+        NO_DISCARD bool IsComplete(UploadHandle handle);
+
+        /*!
+         @brief Blocks until upload finished, submits it first if necessary.
+         */
+        void Wait(UploadHandle handle);
+
+        /*!
+         @brief Records acquire of resources released by transfer queue since the last call.
+         @param commandBuffer Graphics command buffer submitted before any command using the resources.
+         @param waitSemaphores Semaphores graphics submission has to wait for on all commands stage, they have to be
+                recycled once the submission finished.
+         @return False if there was nothing to acquire and command buffer wasn't recorded.
+         */
+        bool AcquireResources(VkCommandBuffer commandBuffer, std::vector<VkSemaphore>& waitSemaphores);
+
+        /*!
+         @brief Returns semaphores waited by finished graphics submission back to the pool, clears the vector.
+         */
+        void RecycleSemaphores(std::vector<VkSemaphore>& semaphores);
+
+        NO_DISCARD bool UsesDedicatedQueue() const noexcept { return mQueueFamilyIndex != mGraphicsQueueFamilyIndex; }
+
+    private:
+        struct ImageCopy
+        {
+            VkImage image{ VK_NULL_HANDLE };
+            VkBufferImageCopy region{};
+        };
+
+        struct Batch
+        {
+            VkCommandPool commandPool{ VK_NULL_HANDLE };
+            VkCommandBuffer commandBuffer{ VK_NULL_HANDLE };
+            VkFence fence{ VK_NULL_HANDLE };
+
+            UploadHandle handle{ 0 };
+            VkDeviceSize ringEnd{ 0 };
+            bool hasBufferCopies{ false };
+
+            // Image copies are recorded on submission, between transitions to & from transfer layout
+            std::vector<VkImageMemoryBarrier> imageTransitions;
+            std::vector<ImageCopy> imageCopies;
+            std::vector<VkBufferMemoryBarrier> bufferReleases;
+            std::vector<VkImageMemoryBarrier> imageReleases;
+
+            std::vector<VkBufferMemoryBarrier> bufferAcquires;
+            std::vector<VkImageMemoryBarrier> imageAcquires;
+        };
+
+        Batch& GetRecordingBatch();
+        void RecordImageCopies(Batch& batch);
+        void RecordReleases(Batch& batch);
+        VkDeviceSize Allocate(VkDeviceSize size, VkDeviceSize alignment);
+        bool TryAllocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset);
+
+        void RetireCompleted();
+        void RetireOldest();
+        void Retire(Batch& batch);
+
+    private:
+        std::shared_ptr<PAL::RenderAPI::VulkanDevice> mDevice;
+        std::shared_ptr<VulkanMemoryAllocator> mAllocator;
+
+        BufferDeviceObject mStagingBuffer;
+        uint8_t* mStagingData{ nullptr };
+        VkDeviceSize mStagingSize{ 0 };
+
+        // Allocations live in [tail, head), head never catches tail from behind, so head == tail means empty ring
+        VkDeviceSize mHead{ 0 };
+        VkDeviceSize mTail{ 0 };
+
+        VkQueue mQueue{ VK_NULL_HANDLE };
+        uint32_t mQueueFamilyIndex{ 0 };
+        uint32_t mGraphicsQueueFamilyIndex{ 0 };
+
+        std::vector<Batch> mBatches;
+        uint32_t mRecordingIndex{ 0 };
+        uint32_t mInFlightCount{ 0 };
+        bool mRecording{ false };
+
+        UploadHandle mLastHandle{ 0 };
+        UploadHandle mCompletedHandle{ 0 };
+
+        // Released by transfer queue, waiting to be acquired by graphics queue
+        std::vector<VkBufferMemoryBarrier> mBufferAcquires;
+        std::vector<VkImageMemoryBarrier> mImageAcquires;
+        std::vector<VkSemaphore> mPendingWaits;
+        std::vector<VkSemaphore> mFreeSemaphores;
+
+        // Regions of consecutive copies to the same image, kept to avoid allocation per submission
+        std::vector<VkBufferImageCopy> mRegionScratch;
+    };
+}
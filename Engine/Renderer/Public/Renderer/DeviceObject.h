@@ -1,158 +1,77 @@
 #pragma once
 
 #include <Renderer/RendererBase.h>
-#include <type_traits>
-#include <stdexcept>
-#include <memory>
+#include <Core/Platform.h>
+
+#include <cstdint>
 
 namespace Renderer
 {
-    class PipelineDeviceObject;
-    class BufferDeviceObject;
-    class VulkanShaderDeviceObject;
-    class TextureDeviceObject;
-    class VulkanRenderPassDeviceObject;
-    class VulkanAttachmentDeviceObject;
-    
-    namespace Vulkan
-    {
-        struct SurfaceDeviceObject;
-        class DescriptorSetLayoutDeviceObject;
-        class DescriptorSetDeviceObject;
-        struct SemaphoreDeviceObject;
-        struct FenceDeviceObject;
-        struct EventDeviceObject;
-        struct RenderPassDeviceObject;
-        struct CommandBufferDeviceObject;
-        struct FrameSyncDeviceObject;
-        struct SwapChainDeviceObject;
-        struct FramebufferDeviceObject;
-    }
-    
-    class IDeviceObjectVisitor
-    {
-    public:
-        virtual void Visit(const VulkanShaderDeviceObject& object) = 0;
-        virtual void Visit(const VulkanRenderPassDeviceObject& object) = 0;
-        virtual void Visit(const PipelineDeviceObject& object) = 0;
-        virtual void Visit(const BufferDeviceObject& object) = 0;
-        virtual void Visit(const TextureDeviceObject& object) = 0;
-        virtual void Visit(const VulkanAttachmentDeviceObject& object) = 0;
-        virtual void Visit(const Vulkan::FramebufferDeviceObject& object) = 0;
-        virtual void Visit(const Vulkan::SurfaceDeviceObject& object) = 0;
-        virtual void Visit(const Vulkan::SwapChainDeviceObject& object) = 0;
-        virtual void Visit(const Vulkan::DescriptorSetLayoutDeviceObject& object) = 0;
-        virtual void Visit(const Vulkan::DescriptorSetDeviceObject& object) = 0;
-        virtual void Visit(const Vulkan::SemaphoreDeviceObject& object) = 0;
-        virtual void Visit(const Vulkan::FenceDeviceObject& object) = 0;
-        virtual void Visit(const Vulkan::EventDeviceObject& object) = 0;
-        virtual void Visit(const Vulkan::RenderPassDeviceObject& object) = 0;
-        virtual void Visit(const Vulkan::CommandBufferDeviceObject& object) = 0;
-        virtual void Visit(const Vulkan::FrameSyncDeviceObject& object) = 0;
-    };
-    
-    class IMutableDeviceObjectVisitor
+    /*!
+     @brief Type of device object, selects table of the backend the object lives in.
+     */
+    enum class DeviceObjectType : uint8_t
     {
-    public:
-        virtual void Visit(VulkanShaderDeviceObject& object) = 0;
-        virtual void Visit(VulkanRenderPassDeviceObject& object) = 0;
-        virtual void Visit(PipelineDeviceObject& object) = 0;
-        virtual void Visit(BufferDeviceObject& object) = 0;
-        virtual void Visit(TextureDeviceObject& object) = 0;
-        virtual void Visit(VulkanAttachmentDeviceObject& object) = 0;
-        virtual void Visit(Vulkan::FramebufferDeviceObject& object) = 0;
-        virtual void Visit(Vulkan::SurfaceDeviceObject& object) = 0;
-        virtual void Visit(Vulkan::SwapChainDeviceObject& object) = 0;
-        virtual void Visit(Vulkan::DescriptorSetLayoutDeviceObject& object) = 0;
-        virtual void Visit(Vulkan::DescriptorSetDeviceObject& object) = 0;
-        virtual void Visit(Vulkan::SemaphoreDeviceObject& object) = 0;
-        virtual void Visit(Vulkan::FenceDeviceObject& object) = 0;
-        virtual void Visit(Vulkan::EventDeviceObject& object) = 0;
-        virtual void Visit(Vulkan::RenderPassDeviceObject& object) = 0;
-        virtual void Visit(Vulkan::CommandBufferDeviceObject& object) = 0;
-        virtual void Visit(Vulkan::FrameSyncDeviceObject& object) = 0;
+        None,
+        Shader,
+        Pipeline,
+        Buffer,
+        Texture,
+        Attachment,
+        Framebuffer,
+        RenderPass,
+        Surface,
+        SwapChain,
+        DescriptorSetLayout,
+        DescriptorSet,
+        Semaphore,
+        Fence,
+        MemoryHeap,
+        Count
     };
-    
-    class IDeviceObjectImpl
-    {
-    public:
-        virtual ~IDeviceObjectImpl() = default;
-        virtual IDeviceObjectImpl* Move(void* address) = 0;
-        virtual void Accept(IDeviceObjectVisitor& visitor) const = 0;
-        virtual void Accept(IMutableDeviceObjectVisitor& visitor) = 0;
-    };
-    
+
+    /*!
+     @brief Generational handle of object owned by the renderer backend, packs type, generation & slot index into 32 bits.
+
+     Backend keeps objects in tables per type, handle is resolved by indexing the table of its type. Generation of the slot
+     changes once its object is destroyed, so handles of destroyed objects are detected as stale instead of resolving
+     objects created later in the same slot. Handle has single owner, moving it leaves the source null.
+     */
     class RENDERER_API DeviceObject
     {
-        template<typename T>
-        class DeviceObjectImpl final : public IDeviceObjectImpl
-        {
-        public:
-            DeviceObjectImpl() = default;
-            DeviceObjectImpl(const T& v) : data(v) {}
-            DeviceObjectImpl(T&& v) : data(std::move(v)) {}
-            
-            IDeviceObjectImpl* Move(void* addr) override
-            {
-                return new (addr) DeviceObjectImpl(std::move(*this));
-            }
-            
-            void Accept(IDeviceObjectVisitor& visitor) const override
-            {
-                visitor.Visit(data);
-            }
-            
-            void Accept(IMutableDeviceObjectVisitor& visitor) override
-            {
-                visitor.Visit(data);
-            }
-            
-        public:
-            T data;
-        };
-    
     public:
-        DeviceObject();
+        static constexpr uint32_t IndexBits = 20;
+        static constexpr uint32_t GenerationBits = 8;
+        static constexpr uint32_t TypeBits = 4;
+
+        static constexpr uint32_t MaxIndex = (1u << IndexBits) - 1;
+        static constexpr uint32_t GenerationMask = (1u << GenerationBits) - 1;
+
+    public:
+        DeviceObject() = default;
+        DeviceObject(DeviceObjectType type, uint32_t index, uint32_t generation);
         DeviceObject(DeviceObject&& other) noexcept;
-        ~DeviceObject();
-        
+
         DeviceObject(const DeviceObject& other) = delete;
         DeviceObject& operator=(const DeviceObject& other) = delete;
         DeviceObject& operator=(DeviceObject&& other) noexcept;
-        
-        template <typename T, typename = std::enable_if_t<!std::is_same<std::decay_t<T>, DeviceObject>::value>>
-        DeviceObject& operator=(T&& impl) noexcept;
-        
-        void Accept(IDeviceObjectVisitor& visitor) const;
-        void Accept(IMutableDeviceObjectVisitor& visitor);
-        
-    private:
-        enum
-        {
-            c_max_id_sizeof_vtable = 288,
-            c_max_id_sizeof = c_max_id_sizeof_vtable - sizeof(IDeviceObjectImpl*),
-            c_alignment = 8
-        };
-        
+
+        NO_DISCARD bool IsValid() const noexcept { return mHandle != 0; }
+        NO_DISCARD DeviceObjectType GetType() const noexcept { return static_cast<DeviceObjectType>(mHandle >> (IndexBits + GenerationBits)); }
+        NO_DISCARD uint32_t GetIndex() const noexcept { return mHandle & MaxIndex; }
+        NO_DISCARD uint32_t GetGeneration() const noexcept { return (mHandle >> IndexBits) & GenerationMask; }
+        NO_DISCARD uint32_t GetHandle() const noexcept { return mHandle; }
+
+        /*!
+         @brief Makes the handle null without destroying the object, used by backend once the object is removed from its table.
+         */
+        void Reset() noexcept { mHandle = 0; }
+
     private:
-        std::aligned_storage<c_max_id_sizeof_vtable>::type mStorage;
-        IDeviceObjectImpl* mImpl{ nullptr };
+        // Null handle has type None, handles of all objects are non-zero
+        uint32_t mHandle{ 0 };
     };
-    
-    template <typename T, typename F>
-    DeviceObject& DeviceObject::operator=(T&& impl) noexcept
-    {        
-        static_assert(sizeof(T) <= c_max_id_sizeof, "Object too big");
-        mImpl->~IDeviceObjectImpl();
-        mImpl = new (&mStorage) DeviceObjectImpl<std::decay_t<T>>(std::forward<T>(impl));
-        return *this;
-    }
-    
-    template<typename T>
-    DeviceObject Basify(T&& impl)
-    {
-        DeviceObject obj;
-        obj = std::move(impl);
-        return obj;
-    }
+
+    static_assert(sizeof(DeviceObject) == sizeof(uint32_t), "Device object is a plain 32 bit handle");
+    static_assert(static_cast<uint32_t>(DeviceObjectType::Count) <= (1u << DeviceObject::TypeBits), "Types don't fit into handle");
 }
@@ -4,6 +4,11 @@
 #include "SharedDeviceTypes.h"
 #include "DeviceObject.h"
 
+#include <Math/Matrix4.h>
+#include <Math/Vector4.h>
+
+#include <array>
+#include <optional>
 #include <string>
 #include <vector>
 #include <cstdint>
@@ -18,14 +23,33 @@ namespace Renderer
     {
         Undefined,
         Vertex,
-        Fragment
+        Fragment,
+        Compute
     };
     
     enum class UniformType
     {
         Undefined,
         Buffer,
-        Sampler
+        DynamicBuffer,
+        Sampler,
+        StorageBuffer,
+        StorageImage
+    };
+    
+    /*!
+     @brief How often resources of a binding change, every frequency is bound as its own descriptor set.
+     
+     Set index equals the frequency, least frequently changing sets come first so pipelines with compatible layouts
+     keep them bound while only the more frequent sets are switched. Shaders declare set index of every binding accordingly,
+     bindings without explicit frequency live in set 0.
+     */
+    enum class DescriptorFrequency : uint8_t
+    {
+        PerFrame,
+        PerPass,
+        PerMaterial,
+        PerDraw
     };
     
     class RENDERER_API Effect
@@ -33,6 +57,23 @@ namespace Renderer
         friend class VulkanRenderer;
         
     public:
+        static constexpr uint32_t FrequencyCount = 4;
+        
+        /*!
+         @brief Set of the renderer's bindless table, follows sets of all frequencies so bindings of existing shaders keep their sets.
+         
+         Shaders declare textures as `layout(set = 4, binding = 0) uniform texture2D textures[]` and samplers as
+         `layout(set = 4, binding = 1) uniform sampler samplers[]`.
+         */
+        static constexpr uint32_t BindlessSet = FrequencyCount;
+        static constexpr uint32_t DescriptorSetCount = BindlessSet + 1;
+        
+        // Indices are pushed per draw as push constants, whose guaranteed size is small
+        static constexpr uint32_t MaxBindlessTextures = 4;
+        
+        // Offsets of dynamic buffers are captured with every draw
+        static constexpr uint32_t MaxDynamicUniformBuffers = 4;
+        
         struct ModuleDescriptor
         {
             ModuleStage type;
@@ -53,6 +94,41 @@ namespace Renderer
             uint32_t size{ 0 };
         };
         
+        struct BufferBinding
+        {
+            DescriptorFrequency frequency{ DescriptorFrequency::PerFrame };
+            uint32_t binding{ 0 };
+            const Buffer* buffer{ nullptr };
+        };
+        
+        using DynamicBufferBinding = BufferBinding;
+        
+        struct TextureBinding
+        {
+            DescriptorFrequency frequency{ DescriptorFrequency::PerFrame };
+            uint32_t binding{ 0 };
+            const Attachable* image{ nullptr };
+        };
+        
+        struct BindlessTextureBinding
+        {
+            ModuleStage stage{ ModuleStage::Undefined };
+            const Attachable* image{ nullptr };
+        };
+        
+        /*!
+         @brief Data of one instance of instanced effect, rows of object's world matrix followed by its instance parameters.
+         */
+        struct InstanceData
+        {
+            Matrix4 world;
+            Vector4f parameters;
+        };
+        
+        // Every row of the matrix & the parameters take one vec4 attribute
+        static constexpr uint32_t InstanceAttributeCount = 5;
+        static_assert(sizeof(InstanceData) == InstanceAttributeCount * sizeof(Vector4f), "Instance data are read as vec4 attributes");
+        
         using UniformBindingDesc = std::vector<UniformDescriptor>;
         
     public:
@@ -69,28 +145,83 @@ namespace Renderer
         void AddAttributeExplicit(Format f, uint32_t stride, uint32_t location, uint32_t binding, uint32_t offset);
         void AddAttribute(Format f, uint32_t binding);
         
-        void AddUniform(UniformType f, ModuleStage stage, uint32_t binding, uint32_t count);
+        void AddUniform(UniformType f, ModuleStage stage, uint32_t binding, uint32_t count, DescriptorFrequency frequency = DescriptorFrequency::PerFrame);
         void AddConstantRange(ModuleStage stage, uint32_t offset, uint32_t size);
         
-        void AddUniformBuffer(ModuleStage stage, uint32_t binding, const Buffer& buffer);
-        void AddTexture(ModuleStage stage, uint32_t binding, const Attachable& image);
+        void AddUniformBuffer(ModuleStage stage, uint32_t binding, const Buffer& buffer, DescriptorFrequency frequency = DescriptorFrequency::PerFrame);
+        
+        /*!
+         @brief Binds buffer written every frame by IRenderer::WriteUniformData, its offset is read when object is rendered.
+         */
+        void AddDynamicUniformBuffer(ModuleStage stage, uint32_t binding, const Buffer& buffer, DescriptorFrequency frequency = DescriptorFrequency::PerFrame);
+        void AddTexture(ModuleStage stage, uint32_t binding, const Attachable& image, DescriptorFrequency frequency = DescriptorFrequency::PerFrame);
+        
+        /*!
+         @brief Binds buffer as std430 storage buffer, e.g. GpuScene::objects read by vertex shaders of GPU culled scene.
+         */
+        void AddStorageBuffer(ModuleStage stage, uint32_t binding, const Buffer& buffer, DescriptorFrequency frequency = DescriptorFrequency::PerFrame);
+        
+        /*!
+         @brief Binds image created with ImageUsage::Storage for unfiltered loads & stores. Image is accessed in general layout,
+                IRenderer::ImageBarrier moves it there before the first dispatch accessing it.
+         */
+        void AddStorageImage(ModuleStage stage, uint32_t binding, const Attachable& image, DescriptorFrequency frequency = DescriptorFrequency::PerFrame);
+        
+        /*!
+         @brief References texture through the bindless table instead of own binding, requires IRenderer::IsBindlessSupported.
+         
+         Table indices of the texture & its sampler are pushed as uvec2 at GetBindlessConstantOffset before every draw,
+         one element per bindless texture in the order they were added. Effects differing only in their bindless textures
+         share pipeline state & descriptor sets.
+         */
+        void AddBindlessTexture(ModuleStage stage, const Attachable& image);
+        
+        /*!
+         @brief Draws objects sharing vertex buffer & material as instances of one draw.
+         
+         Vertex shader reads InstanceData from instance rate binding following all vertex bindings, rows of the world matrix
+         from locations firstLocation to firstLocation + 3 & instance parameters from firstLocation + 4.
+         */
+        void EnableInstancing(uint32_t firstLocation);
+        
+        bool IsInstanced() const { return mInstanceLocation.has_value(); }
         
         uint8_t GetBindingCount() const;
         const std::vector<Format>& GetBindingDescriptor(uint8_t binding) const;
         const std::vector<ModuleDescriptor>& GetModuleDescriptors() const;
-        const std::vector<UniformBindingDesc>& GetUniformBindings() const;
+        const std::vector<UniformBindingDesc>& GetUniformBindings(DescriptorFrequency frequency) const;
+        
+        /*!
+         @return Number of descriptor sets of the effect, highest used frequency + 1. Unused lower sets are empty.
+         */
+        uint32_t GetDescriptorSetCount() const;
+        
+        /*!
+         @return Offset of bindless indices in push constants, they follow all constant ranges of the effect.
+         */
+        uint32_t GetBindlessConstantOffset() const;
+        
+        bool UsesBindless() const { return !mBindlessTextures.empty(); }
         
     private:
         std::vector<ModuleDescriptor> mModuleDescriptors;
         std::unordered_map<uint8_t, std::vector<Format>> mAttribBindings;
-        std::vector<UniformBindingDesc> mUniformBindings;
+        std::array<std::vector<UniformBindingDesc>, FrequencyCount> mUniformBindings;
         std::vector<ConstantRangeDescriptor> mConstantRanges;
         
         std::vector<DeviceObject> mModules;
         std::vector<DeviceObject> mDescriptorSetLayouts;
-        std::vector<DeviceObject> mDescriptorSets;
+        std::vector<DeviceObject> mDescriptorSets;      // Indexed by set
+        
+        std::vector<BufferBinding> mUniformBuffers;
+        std::vector<DynamicBufferBinding> mDynamicUniformBuffers;   // Sorted by set & binding, order of dynamic offsets
+        std::vector<TextureBinding> mTextures;
+        std::vector<BufferBinding> mStorageBuffers;
+        std::vector<TextureBinding> mStorageImages;
+        
+        std::vector<BindlessTextureBinding> mBindlessTextures;
+        std::vector<uint32_t> mBindlessIndices;     // Texture & sampler index pairs resolved at pipeline creation
         
-        std::vector<const Buffer*> mUniformBuffers;
-        std::vector<const Attachable*> mTextures;
+        std::optional<uint32_t> mInstanceLocation;
     };
 }
@@ -0,0 +1,296 @@
+#pragma once
+
+#include "RendererBase.h"
+#include "Renderer.h"
+#include "RenderPass.h"
+#include "DeviceObject.h"
+#include "Resources/Framebuffer.h"
+
+#include <Core/Platform.h>
+
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Renderer
+{
+    /*!
+     @brief Virtual image of frame graph, index of the image in the graph.
+     */
+    using FrameGraphResource = uint32_t;
+
+    /*!
+     @brief Pass of frame graph, index of the pass in the graph.
+     */
+    using FrameGraphPass = uint32_t;
+
+    constexpr uint32_t InvalidFrameGraphIndex = std::numeric_limits<uint32_t>::max();
+
+    /*!
+     @brief How pass accesses image, the access implies layout of the image, pipeline stages & memory accesses of the pass.
+     */
+    enum class FrameGraphAccess : uint8_t
+    {
+        ColorAttachment,    // Written as color attachment of the pass
+        DepthAttachment,    // Depth tested & written as depth attachment of the pass
+        DepthRead,          // Depth tested without writes, attached to the pass read only
+        FragmentSampled,    // Sampled by fragment shaders
+        ComputeSampled,     // Sampled by compute shaders
+        ComputeStorage      // Read & written by compute shaders as storage image
+    };
+
+    enum class FrameGraphPassType : uint8_t
+    {
+        Graphics,   // Graph records render pass of the attachments declared by the pass around its commands
+        Compute,    // Commands are recorded outside of render passes
+        External    // Pass records its own render passes, graph only orders it & transitions its declared images
+    };
+
+    /*!
+     @brief Statistics of the last compilation of frame graph.
+     */
+    struct FrameGraphStatistics
+    {
+        /*!
+         @brief Number of passes recorded every frame.
+         */
+        uint32_t passCount{ 0 };
+
+        /*!
+         @brief Number of passes removed, because nothing reads their results.
+         */
+        uint32_t culledPassCount{ 0 };
+
+        /*!
+         @brief Number of image barriers recorded every frame & number of pipeline barriers they are batched into.
+         */
+        uint32_t imageBarrierCount{ 0 };
+        uint32_t barrierBatchCount{ 0 };
+
+        /*!
+         @brief Bytes of device memory transient images would occupy without aliasing.
+         */
+        uint64_t transientBytes{ 0 };
+
+        /*!
+         @brief Bytes of device memory heap transient images are placed into.
+         */
+        uint64_t heapBytes{ 0 };
+    };
+
+    class FrameGraph;
+
+    /*!
+     @brief Declares images pass creates & accesses, valid only within setup of the pass.
+     */
+    class RENDERER_API FrameGraphBuilder
+    {
+        friend class FrameGraph;
+
+    public:
+        /*!
+         @brief Creates transient image, device memory of the image is shared with images not used by the same passes.
+                Contents of transient image are undefined until the first pass writing it.
+         */
+        FrameGraphResource CreateImage(const std::string& name, const AttachableDescriptor& desc);
+
+        FrameGraphResource Read(FrameGraphResource resource, FrameGraphAccess access);
+        FrameGraphResource Write(FrameGraphResource resource, FrameGraphAccess access);
+
+        /*!
+         @brief Keeps the pass even if none of its results are read, e.g. pass presenting or reading back data.
+         */
+        void SetSideEffects() noexcept;
+
+    private:
+        FrameGraphBuilder(FrameGraph& graph, FrameGraphPass pass) noexcept : mGraph(graph), mPass(pass) {}
+
+    private:
+        FrameGraph& mGraph;
+        FrameGraphPass mPass;
+    };
+
+    /*!
+     @brief Records commands of pass, images of the graph are resolved by FrameGraph::GetImage.
+     */
+    using FrameGraphSetup = std::function<void(FrameGraphBuilder& builder)>;
+    using FrameGraphExecute = std::function<void(IRenderer& renderer)>;
+
+    /*!
+     @brief Frame rendering declared as passes reading & writing virtual images.
+
+     Passes are recorded in order they are added, pass has to be added after passes writing images it reads.
+     Compile removes passes whose results are never read, places transient images of disjoint lifetimes to the same device
+     memory & derives barriers of every image access from the previous access of the image, barriers preceding a pass are
+     recorded as single batch. Graphics passes get render pass of their attachments whose contents are loaded or cleared
+     by the first write of the frame.
+     Graph is compiled once & executed every frame, imported images may be swapped between frames, e.g. swap chain images.
+     Only declared images are synchronized, images External pass uses without declaring them are left to its own render passes.
+     */
+    class RENDERER_API FrameGraph
+    {
+        friend class FrameGraphBuilder;
+
+    public:
+        FrameGraph() = default;
+        ~FrameGraph() = default;
+
+        DECLARE_NOCOPY_NOMOVE(FrameGraph)
+
+        /*!
+         @brief Adds pass, setup declaring images of the pass is called right away.
+         */
+        FrameGraphPass AddPass(const std::string& name, FrameGraphPassType type, const FrameGraphSetup& setup, FrameGraphExecute execute);
+
+        /*!
+         @brief Imports image owned by the application, the image has to stay alive while the graph is executed.
+         @param initialLayout Layout of the image at the beginning of every frame, Undefined discards its contents.
+         @param finalLayout Layout the image is transitioned to at the end of every frame, Undefined keeps the last one.
+         */
+        FrameGraphResource Import(const std::string& name, Attachment& image, ImageLayout initialLayout, ImageLayout finalLayout);
+
+        /*!
+         @brief Replaces imported image by another one of equal descriptor, framebuffers of every image are kept.
+         */
+        void SetImportedImage(FrameGraphResource resource, Attachment& image);
+
+        /*!
+         @brief Culls passes, allocates transient images, creates render passes & plans barriers.
+                Destroys objects of the previous compilation, GPU must not use them anymore.
+         */
+        void Compile(IRenderer& renderer);
+
+        /*!
+         @brief Records passes & their barriers, has to be called between BeginCommandRecording & EndCommandRecording.
+         */
+        void Execute(IRenderer& renderer);
+
+        /*!
+         @brief Destroys device objects of the graph & removes all passes & images, GPU must not use them anymore.
+         */
+        void Destroy(IRenderer& renderer);
+
+        NO_DISCARD bool IsCompiled() const noexcept { return mCompiled; }
+
+        /*!
+         @brief Returns image of the resource, transient images exist once the graph is compiled.
+         */
+        NO_DISCARD const Attachment& GetImage(FrameGraphResource resource) const;
+
+        /*!
+         @brief Returns render pass of graphics pass, pipelines drawn by the pass are created against it once the graph is compiled.
+         */
+        NO_DISCARD const RenderPass& GetRenderPass(FrameGraphPass pass) const;
+
+        NO_DISCARD const FrameGraphStatistics& GetStatistics() const noexcept { return mStatistics; }
+
+        /*!
+         @brief Returns whether the last compilation removed the pass.
+         */
+        NO_DISCARD bool IsPassCulled(FrameGraphPass pass) const;
+
+        /*!
+         @brief Returns barriers recorded before the pass, planned by the last compilation. Culled pass has none.
+         */
+        NO_DISCARD std::vector<ImageBarrierDesc> GetPassBarriers(FrameGraphPass pass) const;
+
+    private:
+        struct ResourceNode
+        {
+            std::string name;
+            AttachableDescriptor desc;
+
+            // Transient images are placed to the heap, imported are owned by the application
+            std::shared_ptr<Attachment> image;
+            Attachment* importedImage{ nullptr };
+            ImageLayout initialLayout{ ImageLayout::Undefined };
+            ImageLayout finalLayout{ ImageLayout::Undefined };
+
+            uint32_t refCount{ 0 };
+            uint32_t firstUse{ InvalidFrameGraphIndex };
+            uint32_t lastUse{ 0 };
+            uint64_t heapOffset{ 0 };
+
+            // Transient image occupying the same memory before this one, the last one of the frame for the first image
+            FrameGraphResource aliasedResource{ InvalidFrameGraphIndex };
+        };
+
+        struct ResourceAccess
+        {
+            FrameGraphResource resource{ InvalidFrameGraphIndex };
+            FrameGraphAccess access{ FrameGraphAccess::ColorAttachment };
+            bool read{ false };
+            bool write{ false };
+        };
+
+        struct CachedFramebuffer
+        {
+            std::vector<uint32_t> importedHandles;
+            Framebuffer framebuffer;
+        };
+
+        struct PassNode
+        {
+            std::string name;
+            FrameGraphPassType type{ FrameGraphPassType::Compute };
+            FrameGraphExecute execute;
+            std::vector<ResourceAccess> accesses;
+            bool sideEffects{ false };
+
+            uint32_t refCount{ 0 };
+            bool culled{ false };
+
+            // Barriers recorded before the pass
+            uint32_t firstBarrier{ 0 };
+            uint32_t barrierCount{ 0 };
+
+            std::unique_ptr<RenderPass> renderPass;
+            std::vector<CachedFramebuffer> framebuffers;
+        };
+
+        struct Barrier
+        {
+            FrameGraphResource resource{ InvalidFrameGraphIndex };
+            ImageLayout oldLayout{ ImageLayout::Undefined };
+            ImageLayout newLayout{ ImageLayout::Undefined };
+            BarrierDesc barrier;
+        };
+
+    private:
+        void AddAccess(FrameGraphPass pass, FrameGraphResource resource, FrameGraphAccess access, bool write);
+
+        void CullPasses();
+        void AllocateTransientImages(IRenderer& renderer);
+        void CreateRenderPasses(IRenderer& renderer);
+        void PlanBarriers();
+
+        const Attachment& GetPhysicalImage(const ResourceNode& resource) const noexcept;
+        ImageBarrierDesc MakeImageBarrier(const Barrier& barrier) const noexcept;
+        Framebuffer& GetFramebuffer(IRenderer& renderer, PassNode& pass);
+        void RecordBarriers(IRenderer& renderer, uint32_t firstBarrier, uint32_t barrierCount);
+
+        void DestroyDeviceObjects(IRenderer& renderer);
+
+    private:
+        std::vector<PassNode> mPasses;
+        std::vector<ResourceNode> mResources;
+
+        // Live passes in recording order
+        std::vector<FrameGraphPass> mOrder;
+
+        // Barriers of all passes, barriers of imported images to their final layouts are the last ones
+        std::vector<Barrier> mBarriers;
+        uint32_t mFinalBarrier{ 0 };
+
+        DeviceObject mHeap;
+
+        // Scratch of barrier recording & framebuffer lookup, kept to avoid per-frame allocations
+        std::vector<ImageBarrierDesc> mBarrierScratch;
+        std::vector<uint32_t> mHandleScratch;
+
+        FrameGraphStatistics mStatistics;
+        bool mCompiled{ false };
+    };
+}
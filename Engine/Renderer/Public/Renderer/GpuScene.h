@@ -0,0 +1,112 @@
+#pragma once
+
+#include "RendererBase.h"
+#include "Renderer.h"
+#include "Resources/Buffer.h"
+
+#include <Math/Matrix4.h>
+#include <Math/Vector3.h>
+#include <Math/Vector4.h>
+
+#include <array>
+#include <cstdint>
+
+namespace Renderer
+{
+    /*!
+     @brief Object of GPU driven scene, layout matches std430 GpuObject struct of cull.comp.
+
+     Culling stores index of the object as first instance of its draw, vertex shaders read the object from
+     GpuScene::objects bound as storage buffer by gl_InstanceIndex.
+     */
+    struct GpuObject
+    {
+        Matrix4 world;
+
+        /*!
+         @brief Center of the sphere in object space & its radius in w.
+         */
+        Vector4f boundingSphere;
+
+        // Index range of the object's mesh in the bound index buffer
+        uint32_t indexCount{ 0 };
+        uint32_t firstIndex{ 0 };
+        int32_t vertexOffset{ 0 };
+        uint32_t padding{ 0 };
+    };
+
+    static_assert(sizeof(GpuObject) == 96, "Objects are read as std430 structs by shaders");
+
+    /*!
+     @brief Indirect draw written by culling, layout matches VkDrawIndexedIndirectCommand.
+     */
+    struct DrawIndexedIndirectCommand
+    {
+        uint32_t indexCount{ 0 };
+        uint32_t instanceCount{ 0 };
+        uint32_t firstIndex{ 0 };
+        int32_t vertexOffset{ 0 };
+        uint32_t firstInstance{ 0 };
+    };
+
+    static_assert(sizeof(DrawIndexedIndirectCommand) == 5 * sizeof(uint32_t), "Commands are read by indirect draws as they are");
+
+    /*!
+     @brief Planes bounding view volume, normals point inside & xyz of every plane is unit length.
+     */
+    struct RENDERER_API FrustumPlanes
+    {
+        /*!
+         @brief Extracts planes from matrix transforming row vectors to clip space of depth range 0 to 1.
+         */
+        static FrustumPlanes FromViewProjection(const Matrix4& viewProjection);
+
+        bool IntersectsSphere(const Vector3f& center, float radius) const;
+
+        // Left, right, bottom, top, near & far
+        std::array<Vector4f, 6> planes;
+    };
+
+    /*!
+     @brief Reference of GPU culling, writes commands of objects intersecting the frustum in object order.
+
+     GPU writes the same commands in arbitrary order, results have to be compared regardless of their order.
+     Objects touching a plane within float rounding may be classified differently.
+     @return Number of written commands, commands has to fit count commands.
+     */
+    RENDERER_API uint32_t CullObjects(const GpuObject* objects, uint32_t count, const FrustumPlanes& frustum, DrawIndexedIndirectCommand* commands);
+
+    /*!
+     @brief Objects culled & drawn by GPU, CPU cost of culling & drawing doesn't depend on number of objects.
+
+     Created by IRenderer::CreateGpuScene, objects are written by IRenderer::UpdateGpuScene. Scene is culled by compute pass
+     recorded by IRenderer::CullGpuScene & drawn by single indirect draw of IRenderer::RenderGpuScene.
+     Buffers are destroyed by IRenderer::DestroyDeviceObject. Culling effect binds the buffers by address, scene can't be moved.
+     */
+    class RENDERER_API GpuScene
+    {
+    public:
+        /*!
+         @brief Maximal number of objects, buffers are sized at creation.
+         */
+        uint32_t capacity{ 0 };
+
+        /*!
+         @brief Number of objects culled & drawn, grows as objects are added by updates.
+         */
+        uint32_t objectCount{ 0 };
+
+        /*!
+         @brief Storage buffer of GpuObject array, bound by Effect::AddStorageBuffer to effects drawing the scene.
+         */
+        Buffer objects;
+
+        // Written by culling, DrawIndexedIndirectCommand array & number of its valid commands
+        Buffer commands;
+        Buffer drawCount;
+
+        // Compute pipeline of cull.comp, its constants are written into the uniform ring per culling
+        Pipeline mCullPipeline;
+        Buffer mCullConstants;
+    };
+}
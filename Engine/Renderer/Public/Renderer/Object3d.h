@@ -4,6 +4,8 @@
 #include "Transform.h"
 #include "VertexBuffer.h"
 
+#include <Math/Vector4.h>
+
 namespace Renderer
 {
     class RENDERER_API Object3d
@@ -12,9 +14,17 @@ namespace Renderer
         Object3d() = default;
         
         const VertexBufferBase& GetVertexBuffer() const { return *mVertexBuffer.get(); }
+        const Transform& GetTransform() const { return mTransform; }
+        
+        /*!
+         @brief Parameters passed to instanced effects next to the world matrix, their meaning is up to the shader.
+         */
+        void SetInstanceParameters(const Vector4f& parameters) { mInstanceParameters = parameters; }
+        const Vector4f& GetInstanceParameters() const { return mInstanceParameters; }
         
     protected:
         Transform mTransform;
+        Vector4f mInstanceParameters;
         std::unique_ptr<VertexBufferBase> mVertexBuffer;
     };
 }
@@ -12,11 +12,22 @@ namespace Renderer
 {
     using AttachmentId = uint32_t;
     
+    /*!
+     @brief What happens to contents of attachment at the beginning of render pass.
+     */
+    enum class LoadOperation
+    {
+        Clear,      // Cleared to clear value of the framebuffer's attachment
+        Load,       // Contents written before the render pass are kept
+        DontCare    // Contents are undefined, every pixel is written by the pass
+    };
+    
     struct AttachmentDesc
     {
         Format format;
         ImageLayout initialLayout{ ImageLayout::Undefined };
         ImageLayout finalLayout{ ImageLayout::Undefined };
+        LoadOperation loadOperation{ LoadOperation::Clear };
     };
     
     struct DependencyDesc
@@ -11,6 +11,7 @@
 #include <Math/Vector2.h>
 
 #include <string>
+#include <vector>
 
 namespace Renderer
 {
@@ -33,6 +34,11 @@ namespace Renderer
     class Object3d;
     class RenderPass;
     class Framebuffer;
+    class Attachable;
+    class GpuScene;
+    struct GpuObject;
+    struct FrustumPlanes;
+    struct DrawIndexedIndirectCommand;
     struct SemaphoreDescriptor;
     struct FenceDescriptor;
     struct EventDescriptor;
@@ -45,6 +51,146 @@ namespace Renderer
         RPFramebufferUnavailable,
         Failed,
     };
+    
+    /*!
+     @brief Number of frames CPU may record ahead of GPU by default.
+     */
+    constexpr uint32_t DefaultFramesInFlight = 2;
+    
+    /*!
+     @brief Statistics of the most recently started frame.
+     */
+    struct FrameStatistics
+    {
+        /*!
+         @brief Number of frames started so far.
+         */
+        uint64_t frameNumber{ 0 };
+        
+        /*!
+         @brief Index of the frame slot in the frames in flight ring.
+         */
+        uint32_t frameSlot{ 0 };
+        
+        /*!
+         @brief Time in miliseconds CPU was blocked waiting for GPU to release the frame slot.
+         */
+        float fenceWaitTime{ 0.0f };
+        
+        /*!
+         @brief Number of pipeline, buffer, descriptor set & push constant binds recorded into the frame so far.
+         */
+        uint32_t bindsIssued{ 0 };
+        
+        /*!
+         @brief Number of binds skipped so far, because the recorded state was already bound.
+         */
+        uint32_t bindsElided{ 0 };
+    };
+
+    /*!
+     @brief Device memory usage of all resources created by the renderer.
+     */
+    struct MemoryStatistics
+    {
+        /*!
+         @brief Number of device memory blocks resources are sub-allocated from.
+         */
+        uint32_t blockCount{ 0 };
+        
+        /*!
+         @brief Number of resources with own device memory, they count to allocationCount as well.
+         */
+        uint32_t dedicatedAllocationCount{ 0 };
+        
+        /*!
+         @brief Number of live resource allocations.
+         */
+        uint32_t allocationCount{ 0 };
+        
+        /*!
+         @brief Number of free ranges between allocations within blocks, grows with fragmentation.
+         */
+        uint32_t freeRangeCount{ 0 };
+        
+        /*!
+         @brief Bytes of device memory allocated from the driver.
+         */
+        uint64_t reservedBytes{ 0 };
+        
+        /*!
+         @brief Bytes of device memory used by resources.
+         */
+        uint64_t usedBytes{ 0 };
+    };
+
+    /*!
+     @brief Pipeline creation times of the current run & benefit of the pipeline cache loaded from disk.
+     */
+    struct PipelineCacheStatistics
+    {
+        /*!
+         @brief True if valid cache of the device & driver was loaded at initialization.
+         */
+        bool warmStart{ false };
+        
+        /*!
+         @brief Number of pipelines created so far.
+         */
+        uint32_t pipelineCount{ 0 };
+        
+        /*!
+         @brief Total time in miliseconds spent creating pipelines.
+         */
+        float creationTime{ 0.0f };
+        
+        /*!
+         @brief Time in miliseconds the same pipelines took to create with cold cache minus creationTime, zero on cold start.
+         */
+        float estimatedTimeSaved{ 0.0f };
+    };
+
+    /*!
+     @brief Dependency of barrier, accesses of the source stages are made visible to accesses of the destination stages.
+     */
+    struct BarrierDesc
+    {
+        StageMask srcStageMask{ StageMask::Undefined };
+        StageMask dstStageMask{ StageMask::Undefined };
+        AccessMask srcAccessMask{ AccessMask::Undefined };
+        AccessMask dstAccessMask{ AccessMask::Undefined };
+    };
+
+    /*!
+     @brief Barrier of whole image transitioning it from old to new layout.
+     */
+    struct ImageBarrierDesc
+    {
+        const Attachable* image{ nullptr };
+        ImageLayout oldLayout{ ImageLayout::Undefined };
+        ImageLayout newLayout{ ImageLayout::Undefined };
+        BarrierDesc barrier;
+    };
+
+    /*!
+     @brief Device memory resource needs, resources of compatible requirements may share single memory heap.
+     */
+    struct MemoryRequirements
+    {
+        uint64_t size{ 0 };
+        uint64_t alignment{ 1 };
+        
+        /*!
+         @brief Bit per device memory type the resource may be placed in.
+         */
+        uint32_t memoryTypeBits{ 0 };
+    };
+
+    /*!
+     @brief Identifies asynchronous upload of resource data, handles of later uploads are always greater.
+            Zero handle means there was nothing to upload and is always complete.
+     */
+    using UploadHandle = uint64_t;
 
 	class RENDERER_API IRenderer
 	{
@@ -53,25 +199,174 @@ namespace Renderer
         
 		virtual void Initialize() = 0;
 		virtual void Deinitialize() = 0;
+        
+        /*!
+         @brief Sets number of frames CPU may record while GPU still executes the previous ones. Has to be called before Initialize.
+         */
+        virtual void SetFramesInFlight(uint32_t count) = 0;
+        virtual const FrameStatistics& GetFrameStatistics() const = 0;
+        virtual MemoryStatistics GetMemoryStatistics() const = 0;
+        virtual PipelineCacheStatistics GetPipelineCacheStatistics() const = 0;
+        
+        /*!
+         @brief True if effects may reference textures by Effect::AddBindlessTexture, otherwise textures have to be bound by Effect::AddTexture.
+         */
+        virtual bool IsBindlessSupported() const = 0;
+        
+        /*!
+         @brief True if scenes may be culled & drawn by GPU, see GpuScene.
+         */
+        virtual bool IsGpuCullingSupported() const = 0;
 
         virtual DeviceObject CreateSurface(void* nativeViewHandle) const = 0;
         virtual std::unique_ptr<SwapChainBase> CreateSwapChain(const DeviceObject& surface, const DeviceObject& renderPass, uint32_t width, uint32_t height) = 0;
         virtual void CreateShader(DeviceObject& shader, const std::vector<uint8_t>& code) const = 0;
+        
+        /*!
+         @brief Loads all modules of shader bundle by single file read, effects referencing their paths then skip file access.
+         */
+        virtual void LoadShaderBundle(const std::string& filePath) = 0;
         virtual void CreatePipeline(Pipeline& pipeline, const DeviceObject& renderPass) = 0;
-        virtual void CreateBuffer(const BufferDesc& desc, DeviceObject& buffer) = 0;
+        
+        /*!
+         @brief Creates pipeline of effect with single ModuleStage::Compute module, vertex attributes & depth state are ignored.
+         */
+        virtual void CreateComputePipeline(Pipeline& pipeline) = 0;
+        
+        /*!
+         @brief Creates buffer, data of device local buffer is uploaded asynchronously.
+         @return Handle of the data upload. Buffer may be used by commands recorded right away, uploads are submitted ahead of them.
+         */
+        virtual UploadHandle CreateBuffer(const BufferDesc& desc, DeviceObject& buffer) = 0;
         virtual void CreateFramebuffer(Framebuffer& desc, const RenderPass& renderPass) = 0;
+        
+        /*!
+         @brief Creates device local image without data, e.g. storage image written by compute. Image starts in undefined layout,
+                ImageBarrier moves it to the layout of its first use.
+         */
         virtual DeviceObject CreateImage(const ImageDesc& desc) = 0;
-        virtual void CreateTexture(const ImageDesc& desc, const SamplerDesc& samplerDesc, DeviceObject& texture) = 0;
+        
+        /*!
+         @brief Returns memory requirements of image of the descriptor created by CreatePlacedAttachment.
+         */
+        virtual MemoryRequirements GetAttachmentMemoryRequirements(const AttachableDescriptor& desc) const = 0;
+        
+        /*!
+         @brief Allocates device local memory attachments are placed into by CreatePlacedAttachment, requirements have to be
+                compatible with all of them.
+         */
+        virtual DeviceObject CreateMemoryHeap(const MemoryRequirements& requirements) = 0;
+        
+        /*!
+         @brief Creates attachment image in memory of the heap at offset, images whose uses don't overlap may share memory.
+                Image starts in undefined layout, destroying it leaves the heap memory allocated.
+         */
+        virtual DeviceObject CreatePlacedAttachment(const AttachableDescriptor& desc, const DeviceObject& heap, uint64_t offset) = 0;
+        virtual UploadHandle CreateTexture(const ImageDesc& desc, const SamplerDesc& samplerDesc, DeviceObject& texture) = 0;
         virtual DeviceObject CreateSemaphore(const SemaphoreDescriptor& desc) const = 0;
         virtual DeviceObject CreateFence(const FenceDescriptor& desc) const = 0;
         virtual DeviceObject CreateEvent(const EventDescriptor& desc) const = 0;
         virtual void MapMemory(const DeviceObject& deviceObject, uint32_t size, void* data) = 0;
         virtual void UnmapMemory(const DeviceObject& deviceObject) const = 0;
+        
+        /*!
+         @brief Creates buffers of scene of capacity objects & pipeline of its culling, requires IsGpuCullingSupported.
+         @param cullShaderPath SPIR-V of cull.comp.
+         */
+        virtual void CreateGpuScene(GpuScene& scene, uint32_t capacity, const std::string& cullShaderPath) = 0;
+        
+        /*!
+         @brief Writes objects from index first on, scene grows to cover them. Data are staged in uniform memory of the current
+                frame & copied in queue order before the next culling, frames in flight keep drawing the previous objects.
+         */
+        virtual void UpdateGpuScene(GpuScene& scene, uint32_t first, uint32_t count, const GpuObject* objects) = 0;
+        
+        /*!
+         @brief Waits for the device & reads back commands written by the last culling of the scene, meant for validation
+                against CullObjects.
+         */
+        virtual std::vector<DrawIndexedIndirectCommand> ReadGpuSceneCommands(const GpuScene& scene) = 0;
+
+        /*!
+         @brief Copies buffer.dataSize bytes of data to uniform memory of the current frame & stores their location to buffer.offset.
+                Buffer has to be bound by Effect::AddDynamicUniformBuffer, data stay valid until the frame slot is reused.
+         */
+        virtual void WriteUniformData(Buffer& buffer, const void* data) = 0;
         virtual void CreateRenderPass(RenderPass& renderPass) const = 0;
-        virtual void Render(const Object3d& vb, const Pipeline& pipeline) = 0;
+        
+        /*!
+         @brief Submits draw of the object, draws of a pass are recorded sorted by pipeline, material & depth once the pass,
+                its viewport or scissor changes. Object & pipeline have to stay alive until then. Objects of instanced
+                effect sharing mesh & material are drawn as instances of one draw, see Effect::EnableInstancing.
+         @param viewDepth Distance of the object from the camera, objects of equal state are drawn front to back.
+         */
+        virtual void Render(const Object3d& vb, const Pipeline& pipeline, float viewDepth = 0.0f) = 0;
         virtual void RenderGui(const VertexBufferBase& vb, const Pipeline& pipeline) = 0;
         
+        /*!
+         @brief Records compute pass writing draws of objects intersecting the frustum, has to be recorded outside of render passes
+                before the scene is rendered. Pass runs on async compute queue if the device has one.
+         */
+        virtual void CullGpuScene(const GpuScene& scene, const FrustumPlanes& frustum) = 0;
+        
+        /*!
+         @brief Draws objects of the last culling by single indirect draw. Vertex buffer holds meshes of all objects, effect of
+                the pipeline reads GpuScene::objects by gl_InstanceIndex.
+         */
+        virtual void RenderGpuScene(const GpuScene& scene, const VertexBufferBase& vb, const Pipeline& pipeline) = 0;
+        
+        // Compute
+        /*!
+         @brief Records dispatch of compute pipeline, has to be recorded outside of render passes. Resources of the effect are
+                bound as for draws, dynamic uniform buffers at offsets of their last WriteUniformData.
+         */
+        virtual void Dispatch(const Pipeline& pipeline, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) = 0;
+        
+        /*!
+         @brief Records dispatch of workgroup counts read by GPU from three uint32 at arguments.offset, e.g. written by previous
+                dispatch. Buffer has to be created with BufferUsage::IndirectBuffer.
+         */
+        virtual void DispatchIndirect(const Pipeline& pipeline, const Buffer& arguments) = 0;
+        
+        /*!
+         @brief Records barrier of buffer range from buffer.offset of buffer.dataSize bytes, has to be recorded outside of render
+                passes. Orders e.g. compute writes before vertex or indirect reads of the following draws.
+         */
+        virtual void BufferBarrier(const Buffer& buffer, const BarrierDesc& barrier) = 0;
+        
+        /*!
+         @brief Records barrier of whole image transitioning it from old to new layout, has to be recorded outside of render passes.
+                Old layout may be ImageLayout::Undefined if previous contents of the image are discarded.
+         */
+        virtual void ImageBarrier(const Attachable& image, ImageLayout oldLayout, ImageLayout newLayout, const BarrierDesc& barrier) = 0;
+        
+        /*!
+         @brief Records barriers of several images as single pipeline barrier waiting for all their source stages, has to be
+                recorded outside of render passes.
+         */
+        virtual void ImageBarriers(const ImageBarrierDesc* barriers, uint32_t count) = 0;
+        
+        // Uploads
+        /*!
+         @brief Submits all pending uploads without waiting for them, command recording flushes them on its own.
+         */
+        virtual void FlushUploads() = 0;
+        virtual bool IsUploadComplete(UploadHandle handle) = 0;
+        
+        /*!
+         @brief Blocks until upload is finished, submits it if it wasn't flushed yet.
+         */
+        virtual void WaitForUpload(UploadHandle handle) = 0;
+        
+        /*!
+         @brief Blocks until device finishes all submitted work.
+         */
+        virtual void WaitIdle() const = 0;
+        
         // Release
+        /*!
+         @brief Releases device object & makes the handle null. Memory is reclaimed once frames in flight which could use the object are finished.
+         */
         virtual void DestroyDeviceObject(DeviceObject& buffer) const = 0;
         
         
@@ -103,7 +398,8 @@ namespace Renderer
         virtual CmdRecordResult EndRenderPass() = 0;
         
         /*!
-         @brief Disables recording of commands to primary command buffer.
+         @brief Disables recording of commands to primary command buffer and submits it.
+         @param swapChain Swap chain whose acquired image is rendered, nullptr for headless rendering.
          @return Result code of command recording.
          */
         virtual CmdRecordResult EndCommandRecording(SwapChainBase* swapChain) = 0;
@@ -138,9 +434,72 @@ namespace Renderer
         static std::unique_ptr<IRenderer> mService;
     };
     
+    /*!
+     @brief Hash of complete pipeline state, pipelines created with equal keys share their device objects.
+            Hashed state words are kept in the key as well, so collision of the hash alone never merges different states.
+            Blobs appended by Append(data, size) are kept as digest only, state which mustn't be merged on digest collision
+            has to append identity of the blob too.
+     */
     struct PipelineKey
     {
+        void Append(uint64_t value)
+        {
+            state.push_back(value);
+            
+            // FNV-1a over bytes of the word
+            for(uint32_t i = 0; i < sizeof(value); ++i)
+            {
+                hash ^= (value >> (i * 8)) & 0xff;
+                hash *= 1099511628211ull;
+            }
+        }
         
+        /*!
+         @brief Appends digest & size of data, used for large blobs. Different blobs with colliding digest give equal words.
+         */
+        void Append(const void* data, size_t size)
+        {
+            Append(Digest(data, size));
+            Append(size);
+        }
+        
+        /*!
+         @brief 64 bit FNV-1a hash of data.
+         */
+        static uint64_t Digest(const void* data, size_t size)
+        {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            
+            uint64_t digest{ 14695981039346656037ull };
+            for(size_t i = 0; i < size; ++i)
+            {
+                digest ^= bytes[i];
+                digest *= 1099511628211ull;
+            }
+            
+            return digest;
+        }
+        
+        bool operator==(const PipelineKey& other) const
+        {
+            return hash == other.hash && state == other.state;
+        }
+        
+        bool operator!=(const PipelineKey& other) const
+        {
+            return !(*this == other);
+        }
+        
+        uint64_t hash{ 14695981039346656037ull };
+        std::vector<uint64_t> state;
+    };
+    
+    struct PipelineKeyHash
+    {
+        size_t operator()(const PipelineKey& key) const noexcept
+        {
+            return static_cast<size_t>(key.hash);
+        }
     };
     
     /*!
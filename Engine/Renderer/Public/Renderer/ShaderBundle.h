@@ -0,0 +1,48 @@
+#pragma once
+
+#include <Renderer/RendererBase.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Renderer
+{
+    /*!
+     @brief SPIR-V modules packed into single blob, so all shaders of the content are loaded by one file read.
+
+     Layout: magic, version & entry count followed by entries. Every entry is path size, code size, path and code,
+     code is aligned to 4 bytes. Serialized form is the in-memory form, GetData may be written to file as it is.
+     */
+    class RENDERER_API ShaderBundle
+    {
+    public:
+        struct Entry
+        {
+            std::string path;
+            uint32_t offset{ 0 };
+            uint32_t size{ 0 };
+        };
+
+    public:
+        ShaderBundle();
+
+        /*!
+         @brief Wraps data of serialized bundle, throws if the data aren't valid bundle.
+         */
+        static ShaderBundle FromData(std::vector<uint8_t> data);
+
+        /*!
+         @param path Path the module is referenced by in Effect::AddModule.
+         */
+        void Add(const std::string& path, const std::vector<uint8_t>& code);
+
+        const std::vector<uint8_t>& GetData() const { return mData; }
+        const std::vector<Entry>& GetEntries() const { return mEntries; }
+        const uint8_t* GetCode(const Entry& entry) const { return mData.data() + entry.offset; }
+
+    private:
+        std::vector<uint8_t> mData;
+        std::vector<Entry> mEntries;
+    };
+}
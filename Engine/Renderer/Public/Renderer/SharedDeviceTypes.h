@@ -71,7 +71,8 @@ namespace Renderer
         Undefined = 0x00000000,
         Sampled = 0x00000001,
         ColorAttachment = 0x00000010,
-        DepthStencilAttachment = 0x00000100
+        DepthStencilAttachment = 0x00000100,
+        Storage = 0x00001000
     };
     
     enum class AccessMask : uint32_t
@@ -83,7 +84,14 @@ namespace Renderer
         ColorWrite          = 0x00000008,
         InputRead           = 0x00000010,
         MemoryRead          = 0x00000020,
-        ShaderRead          = 0x00000040
+        ShaderRead          = 0x00000040,
+        ShaderWrite         = 0x00000080,
+        IndirectCommandRead = 0x00000100,
+        VertexAttributeRead = 0x00000200,
+        IndexRead           = 0x00000400,
+        UniformRead         = 0x00000800,
+        TransferRead        = 0x00001000,
+        TransferWrite       = 0x00002000
     };
     
     enum class StageMask : uint32_t
@@ -94,6 +102,12 @@ namespace Renderer
         ColorAttachment     = 0x00000004,
         FragmentShader      = 0x00000008,
         BottomOfPipe        = 0x00000010,
+        TopOfPipe           = 0x00000020,
+        DrawIndirect        = 0x00000040,
+        VertexInput         = 0x00000080,
+        VertexShader        = 0x00000100,
+        ComputeShader       = 0x00000200,
+        Transfer            = 0x00000400,
     };
     
     enum class ImageLayout
@@ -104,6 +118,9 @@ namespace Renderer
         DepthAttachment,
         ShaderReadOnly,
         DepthStencilReadOnly,
+        General,
+        TransferSource,
+        TransferDestination,
     };
     
     enum MemoryType : uint32_t
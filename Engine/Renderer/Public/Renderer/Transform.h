@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Math/Vector3.h>
+#include <Math/BatchKernels.h>
 
 namespace Renderer
 {
@@ -10,4 +11,25 @@ namespace Renderer
         Vector3f rotation;
         Vector3f scale;
     };
+    
+    /*!
+     @brief Views components of transform array as streams for Math::Batch::ComposeTransforms.
+     */
+    inline Math::TransformStreams MakeTransformStreams(const Transform* transforms)
+    {
+        constexpr size_t stride = sizeof(Transform) / sizeof(float);
+        
+        Math::TransformStreams streams;
+        streams.positionX = { &transforms->position.x, stride };
+        streams.positionY = { &transforms->position.y, stride };
+        streams.positionZ = { &transforms->position.z, stride };
+        streams.rotationX = { &transforms->rotation.x, stride };
+        streams.rotationY = { &transforms->rotation.y, stride };
+        streams.rotationZ = { &transforms->rotation.z, stride };
+        streams.scaleX = { &transforms->scale.x, stride };
+        streams.scaleY = { &transforms->scale.y, stride };
+        streams.scaleZ = { &transforms->scale.z, stride };
+        
+        return streams;
+    }
 }
@@ -18,7 +18,11 @@ namespace Renderer
         Undefined,
         VertexBuffer,
         UniformBuffer,
-        IndexBuffer
+        IndexBuffer,
+        StorageBuffer,
+        
+        // Arguments of indirect dispatches & draws, also bindable as storage buffer so compute can write them
+        IndirectBuffer
     };
     
     enum class VertexDataInputRate
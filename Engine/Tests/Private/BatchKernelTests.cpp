@@ -0,0 +1,365 @@
+#include <Math/BatchKernels.h>
+#include <Math/Matrix4.h>
+
+#include <doctest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Counts around SSE & AVX widths, each but the multiples leaves a tail after the kernels' wide loop
+    constexpr size_t BATCH_COUNTS[] = { 1, 3, 4, 5, 7, 8, 9, 15, 17, 37 };
+    constexpr size_t ALIASING_COUNT = 37;
+    constexpr uint32_t ITERATIONS = 20;
+
+    // SIMD paths use FMA & different summation order, results differ by rounding only
+    constexpr double EPSILON = 1.0e-4;
+
+    class RandomData
+    {
+    public:
+        explicit RandomData(uint32_t seed) : mGenerator(seed) {}
+
+        std::vector<float> MakeFloats(size_t count, float min = -2.0f, float max = 2.0f)
+        {
+            std::uniform_real_distribution<float> distribution(min, max);
+
+            std::vector<float> data(count);
+            std::generate(data.begin(), data.end(), [&](){ return distribution(mGenerator); });
+
+            return data;
+        }
+
+        std::vector<Matrix4> MakeMatrices(size_t count)
+        {
+            const auto data = MakeFloats(count * 16);
+
+            std::vector<Matrix4> matrices(count);
+            for(size_t i = 0; i < count; ++i)
+            {
+                std::copy(data.begin() + i * 16, data.begin() + (i + 1) * 16, matrices[i].GetData());
+            }
+
+            return matrices;
+        }
+
+    private:
+        std::mt19937 mGenerator;
+    };
+
+    /*!
+     @brief Streams of separate x, y & z arrays.
+     */
+    struct Vectors
+    {
+        explicit Vectors(size_t count) : x(count), y(count), z(count) {}
+        Vectors(RandomData& random, size_t count) : x(random.MakeFloats(count)), y(random.MakeFloats(count)), z(random.MakeFloats(count)) {}
+
+        Math::Vector3Streams<const float> In() const { return { x.data(), y.data(), z.data() }; }
+        Math::Vector3Streams<float> Out() { return { x.data(), y.data(), z.data() }; }
+
+        Vector3f Get(size_t i) const { return Vector3f(x[i], y[i], z[i]); }
+
+        void Set(size_t i, const Vector3f& v)
+        {
+            x[i] = v.x;
+            y[i] = v.y;
+            z[i] = v.z;
+        }
+
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+    };
+
+    void CheckEqual(const std::vector<float>& expected, const std::vector<float>& actual)
+    {
+        REQUIRE(expected.size() == actual.size());
+
+        for(size_t i = 0; i < expected.size(); ++i)
+        {
+            CAPTURE(i);
+            CHECK(actual[i] == doctest::Approx(expected[i]).epsilon(EPSILON));
+        }
+    }
+
+    void CheckEqual(const std::vector<Matrix4>& expected, const std::vector<Matrix4>& actual)
+    {
+        REQUIRE(expected.size() == actual.size());
+
+        for(size_t i = 0; i < expected.size(); ++i)
+        {
+            CAPTURE(i);
+            CheckEqual(std::vector<float>(expected[i].GetData(), expected[i].GetData() + 16),
+                       std::vector<float>(actual[i].GetData(), actual[i].GetData() + 16));
+        }
+    }
+
+    void CheckEqual(const Vectors& expected, const Vectors& actual)
+    {
+        CheckEqual(expected.x, actual.x);
+        CheckEqual(expected.y, actual.y);
+        CheckEqual(expected.z, actual.z);
+    }
+
+    /*!
+     @brief Largest length of basis rows, scale of the matrix along its longest axis.
+     */
+    float GetMaxScale(const Matrix4& m)
+    {
+        float maxScale = 0.0f;
+
+        for(size_t row = 0; row < 3; ++row)
+        {
+            const float* basis = m.GetData() + row * 4;
+            maxScale = std::max(maxScale, std::sqrt(basis[0] * basis[0] + basis[1] * basis[1] + basis[2] * basis[2]));
+        }
+
+        return maxScale;
+    }
+}
+
+TEST_CASE("Batch kernels match scalar Matrix4")
+{
+    RandomData random(42);
+
+    for(uint32_t iteration = 0; iteration < ITERATIONS; ++iteration)
+    {
+        for(const size_t count : BATCH_COUNTS)
+        {
+            CAPTURE(iteration);
+            CAPTURE(count);
+
+            const auto a = random.MakeMatrices(count);
+            const auto b = random.MakeMatrices(count);
+            const auto single = random.MakeMatrices(1)[0];
+            const Vectors points(random, count);
+
+            std::vector<Matrix4> expected(count);
+            std::vector<Matrix4> actual(count);
+
+            INFO("MultiplyMatrices");
+            for(size_t i = 0; i < count; ++i)
+            {
+                expected[i] = a[i] * b[i];
+            }
+
+            Math::Batch::MultiplyMatrices(a.data(), b.data(), actual.data(), count);
+            CheckEqual(expected, actual);
+
+            INFO("MultiplyMatrices by single matrix");
+            for(size_t i = 0; i < count; ++i)
+            {
+                expected[i] = a[i] * single;
+            }
+
+            Math::Batch::MultiplyMatrices(a.data(), single, actual.data(), count);
+            CheckEqual(expected, actual);
+
+            INFO("TransformPoints");
+            Vectors expectedPoints(count);
+            Vectors actualPoints(count);
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                expectedPoints.Set(i, single.TransformPoint(points.Get(i)));
+            }
+
+            Math::Batch::TransformPoints(single, points.In(), actualPoints.Out(), count);
+            CheckEqual(expectedPoints, actualPoints);
+        }
+    }
+}
+
+TEST_CASE("Batch transform composition matches scalar Matrix4")
+{
+    RandomData random(11);
+
+    // Transforms as array of structs, kernel reads their members as strided streams
+    struct Transform
+    {
+        float position[3];
+        float rotation[3];
+        float scale[3];
+        float padding;
+    };
+
+    constexpr size_t stride = sizeof(Transform) / sizeof(float);
+
+    for(const size_t count : BATCH_COUNTS)
+    {
+        CAPTURE(count);
+
+        const auto positions = random.MakeFloats(count * 3, -10.0f, 10.0f);
+        const auto rotations = random.MakeFloats(count * 3, -3.14f, 3.14f);
+        const auto scales = random.MakeFloats(count * 3, 0.1f, 4.0f);
+
+        std::vector<Transform> transforms(count);
+        std::vector<Matrix4> expected(count);
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            auto& transform = transforms[i];
+            std::copy(positions.begin() + i * 3, positions.begin() + (i + 1) * 3, transform.position);
+            std::copy(rotations.begin() + i * 3, rotations.begin() + (i + 1) * 3, transform.rotation);
+            std::copy(scales.begin() + i * 3, scales.begin() + (i + 1) * 3, transform.scale);
+
+            auto& m = expected[i];
+            m = Matrix4::MakeScale(Vector3f(transform.scale[0], transform.scale[1], transform.scale[2]));
+            m.RotateX(transform.rotation[0]);
+            m.RotateY(transform.rotation[1]);
+            m.RotateZ(transform.rotation[2]);
+            m.SetTranslation(transform.position[0], transform.position[1], transform.position[2]);
+        }
+
+        const auto stream = [](const float* member){
+            return Math::FloatStream{ member, stride };
+        };
+
+        const Transform& first = transforms[0];
+
+        Math::TransformStreams streams;
+        streams.positionX = stream(&first.position[0]);
+        streams.positionY = stream(&first.position[1]);
+        streams.positionZ = stream(&first.position[2]);
+        streams.rotationX = stream(&first.rotation[0]);
+        streams.rotationY = stream(&first.rotation[1]);
+        streams.rotationZ = stream(&first.rotation[2]);
+        streams.scaleX = stream(&first.scale[0]);
+        streams.scaleY = stream(&first.scale[1]);
+        streams.scaleZ = stream(&first.scale[2]);
+
+        std::vector<Matrix4> actual(count);
+        Math::Batch::ComposeTransforms(streams, actual.data(), count);
+        CheckEqual(expected, actual);
+    }
+}
+
+TEST_CASE("Batch bounding spheres match transformed scalar spheres")
+{
+    RandomData random(5);
+
+    for(const size_t count : BATCH_COUNTS)
+    {
+        CAPTURE(count);
+
+        const auto matrices = random.MakeMatrices(count);
+        const Vectors centers(random, count);
+        const auto radii = random.MakeFloats(count, 0.1f, 3.0f);
+
+        Vectors expectedCenters(count);
+        std::vector<float> expectedRadii(count);
+
+        for(size_t i = 0; i < count; ++i)
+        {
+            expectedCenters.Set(i, matrices[i].TransformPoint(centers.Get(i)));
+            expectedRadii[i] = radii[i] * GetMaxScale(matrices[i]);
+        }
+
+        Vectors actualCenters(count);
+        std::vector<float> actualRadii(count);
+
+        Math::Batch::TransformBoundingSpheres(matrices.data(), centers.In(), radii.data(), actualCenters.Out(), actualRadii.data(), count);
+        CheckEqual(expectedCenters, actualCenters);
+        CheckEqual(expectedRadii, actualRadii);
+    }
+}
+
+TEST_CASE("Batch bounding boxes match transformed scalar boxes")
+{
+    RandomData random(6);
+
+    for(const size_t count : BATCH_COUNTS)
+    {
+        CAPTURE(count);
+
+        const auto matrices = random.MakeMatrices(count);
+        const Vectors centers(random, count);
+
+        Vectors extents(count);
+        extents.x = random.MakeFloats(count, 0.1f, 3.0f);
+        extents.y = random.MakeFloats(count, 0.1f, 3.0f);
+        extents.z = random.MakeFloats(count, 0.1f, 3.0f);
+
+        Vectors expectedCenters(count);
+        Vectors expectedExtents(count);
+
+        // Reference box encloses all eight transformed corners
+        for(size_t i = 0; i < count; ++i)
+        {
+            const Vector3f center = centers.Get(i);
+            const Vector3f extent = extents.Get(i);
+
+            Vector3f min(INFINITY, INFINITY, INFINITY);
+            Vector3f max(-INFINITY, -INFINITY, -INFINITY);
+
+            for(uint32_t corner = 0; corner < 8; ++corner)
+            {
+                const Vector3f local(center.x + (corner & 1 ? extent.x : -extent.x),
+                                     center.y + (corner & 2 ? extent.y : -extent.y),
+                                     center.z + (corner & 4 ? extent.z : -extent.z));
+                const Vector3f world = matrices[i].TransformPoint(local);
+
+                min = Vector3f(std::min(min.x, world.x), std::min(min.y, world.y), std::min(min.z, world.z));
+                max = Vector3f(std::max(max.x, world.x), std::max(max.y, world.y), std::max(max.z, world.z));
+            }
+
+            expectedCenters.Set(i, Vector3f((min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f));
+            expectedExtents.Set(i, Vector3f((max.x - min.x) * 0.5f, (max.y - min.y) * 0.5f, (max.z - min.z) * 0.5f));
+        }
+
+        Vectors actualCenters(count);
+        Vectors actualExtents(count);
+
+        Math::Batch::TransformBoundingBoxes(matrices.data(), centers.In(), extents.In(), actualCenters.Out(), actualExtents.Out(), count);
+        CheckEqual(expectedCenters, actualCenters);
+        CheckEqual(expectedExtents, actualExtents);
+    }
+}
+
+TEST_CASE("Batch kernels allow results aliasing inputs")
+{
+    RandomData random(7);
+
+    const size_t count = ALIASING_COUNT;
+    const auto a = random.MakeMatrices(count);
+    const auto b = random.MakeMatrices(count);
+    const Vectors points(random, count);
+    const auto radii = random.MakeFloats(count, 0.1f, 3.0f);
+
+    SUBCASE("MultiplyMatrices into left operands")
+    {
+        std::vector<Matrix4> expected(count);
+        Math::Batch::MultiplyMatrices(a.data(), b.data(), expected.data(), count);
+
+        auto aliased = a;
+        Math::Batch::MultiplyMatrices(aliased.data(), b.data(), aliased.data(), count);
+        CheckEqual(expected, aliased);
+    }
+
+    SUBCASE("TransformPoints in place")
+    {
+        Vectors expected(count);
+        Math::Batch::TransformPoints(a[0], points.In(), expected.Out(), count);
+
+        auto aliased = points;
+        Math::Batch::TransformPoints(a[0], aliased.In(), aliased.Out(), count);
+        CheckEqual(expected, aliased);
+    }
+
+    SUBCASE("TransformBoundingSpheres in place")
+    {
+        Vectors expectedCenters(count);
+        std::vector<float> expectedRadii(count);
+        Math::Batch::TransformBoundingSpheres(a.data(), points.In(), radii.data(), expectedCenters.Out(), expectedRadii.data(), count);
+
+        auto aliasedCenters = points;
+        auto aliasedRadii = radii;
+        Math::Batch::TransformBoundingSpheres(a.data(), aliasedCenters.In(), aliasedRadii.data(), aliasedCenters.Out(), aliasedRadii.data(), count);
+        CheckEqual(expectedCenters, aliasedCenters);
+        CheckEqual(expectedRadii, aliasedRadii);
+    }
+}
@@ -0,0 +1,233 @@
+#include "HeadlessRenderer.h"
+
+#include <Renderer/FrameGraph.h>
+
+#include <doctest.h>
+
+#include <vector>
+
+using namespace Renderer;
+
+namespace
+{
+    AttachableDescriptor MakeImageDesc()
+    {
+        AttachableDescriptor desc;
+        desc.width = 64;
+        desc.height = 64;
+        desc.format = Format::R8G8B8A8;
+
+        return desc;
+    }
+
+    /*!
+     @brief Compute pass writing new storage image.
+     */
+    FrameGraphPass AddProducer(FrameGraph& graph, const std::string& name, FrameGraphResource& output)
+    {
+        return graph.AddPass(name, FrameGraphPassType::Compute, [&output, &name](FrameGraphBuilder& builder){
+            output = builder.Write(builder.CreateImage(name + "Image", MakeImageDesc()), FrameGraphAccess::ComputeStorage);
+        }, nullptr);
+    }
+
+    /*!
+     @brief Compute pass sampling the inputs, pass with side effects is kept even if nothing reads its output.
+     */
+    FrameGraphPass AddConsumer(FrameGraph& graph, const std::string& name, const std::vector<FrameGraphResource>& inputs,
+                               FrameGraphResource* output, bool sideEffects)
+    {
+        return graph.AddPass(name, FrameGraphPassType::Compute, [&](FrameGraphBuilder& builder){
+            for(const FrameGraphResource input : inputs)
+            {
+                builder.Read(input, FrameGraphAccess::ComputeSampled);
+            }
+
+            if(output)
+                *output = builder.Write(builder.CreateImage(name + "Image", MakeImageDesc()), FrameGraphAccess::ComputeStorage);
+
+            if(sideEffects)
+                builder.SetSideEffects();
+        }, nullptr);
+    }
+
+    const Attachable* GetImage(const FrameGraph& graph, FrameGraphResource resource)
+    {
+        return &graph.GetImage(resource);
+    }
+}
+
+TEST_CASE("Frame graph culls passes whose results are never read")
+{
+    HeadlessRenderer renderer;
+    FrameGraph graph;
+
+    FrameGraphResource used = InvalidFrameGraphIndex;
+    FrameGraphResource unread = InvalidFrameGraphIndex;
+    FrameGraphResource feeding = InvalidFrameGraphIndex;
+    FrameGraphResource fed = InvalidFrameGraphIndex;
+
+    const auto usedPass = AddProducer(graph, "Used", used);
+    const auto unreadPass = AddProducer(graph, "Unread", unread);
+
+    // Pass read only by culled pass is culled with it
+    const auto feedingPass = AddProducer(graph, "Feeding", feeding);
+    const auto fedPass = AddConsumer(graph, "Fed", { feeding }, &fed, false);
+
+    const auto outputPass = AddConsumer(graph, "Output", { used }, nullptr, true);
+    const auto sideEffectPass = AddConsumer(graph, "SideEffect", {}, nullptr, true);
+
+    graph.Compile(*renderer);
+
+    CHECK(!graph.IsPassCulled(usedPass));
+    CHECK(graph.IsPassCulled(unreadPass));
+    CHECK(graph.IsPassCulled(feedingPass));
+    CHECK(graph.IsPassCulled(fedPass));
+    CHECK(!graph.IsPassCulled(outputPass));
+    CHECK(!graph.IsPassCulled(sideEffectPass));
+
+    const auto& statistics = graph.GetStatistics();
+    CHECK(statistics.passCount == 3);
+    CHECK(statistics.culledPassCount == 3);
+    CHECK(graph.GetPassBarriers(unreadPass).empty());
+
+    // Images of culled passes aren't allocated
+    CHECK_THROWS((void)graph.GetImage(unread));
+    CHECK_THROWS((void)graph.GetImage(fed));
+
+    graph.Destroy(*renderer);
+}
+
+TEST_CASE("Frame graph aliases transient images of disjoint lifetimes only")
+{
+    HeadlessRenderer renderer;
+    FrameGraph graph;
+
+    SUBCASE("Disjoint lifetimes")
+    {
+        // First image is dead once the third one is written, the second one overlaps both
+        FrameGraphResource first = InvalidFrameGraphIndex;
+        FrameGraphResource second = InvalidFrameGraphIndex;
+        FrameGraphResource third = InvalidFrameGraphIndex;
+
+        AddProducer(graph, "First", first);
+        AddConsumer(graph, "Second", { first }, &second, false);
+        const auto thirdPass = AddConsumer(graph, "Third", { second }, &third, false);
+        AddConsumer(graph, "Output", { third }, nullptr, true);
+
+        graph.Compile(*renderer);
+
+        const auto& statistics = graph.GetStatistics();
+        REQUIRE(statistics.transientBytes > 0);
+        CHECK(statistics.heapBytes < statistics.transientBytes);
+        CHECK(statistics.heapBytes * 3 >= statistics.transientBytes * 2);
+
+        // Write to the aliased memory waits for the last access of the previous image, sampling of the first one
+        bool found = false;
+        for(const auto& barrier : graph.GetPassBarriers(thirdPass))
+        {
+            if(barrier.image != GetImage(graph, third))
+                continue;
+
+            found = true;
+            CHECK(barrier.oldLayout == ImageLayout::Undefined);
+            CHECK(barrier.newLayout == ImageLayout::General);
+            CHECK(barrier.barrier.srcStageMask == StageMask::ComputeShader);
+            CHECK(barrier.barrier.srcAccessMask == AccessMask::Undefined);
+        }
+
+        CHECK(found);
+    }
+
+    SUBCASE("Overlapping lifetimes")
+    {
+        FrameGraphResource first = InvalidFrameGraphIndex;
+        FrameGraphResource second = InvalidFrameGraphIndex;
+
+        AddProducer(graph, "First", first);
+        AddProducer(graph, "Second", second);
+        AddConsumer(graph, "Output", { first, second }, nullptr, true);
+
+        graph.Compile(*renderer);
+
+        const auto& statistics = graph.GetStatistics();
+        REQUIRE(statistics.transientBytes > 0);
+        CHECK(statistics.heapBytes >= statistics.transientBytes);
+        CHECK(GetImage(graph, first) != GetImage(graph, second));
+    }
+
+    graph.Destroy(*renderer);
+}
+
+TEST_CASE("Frame graph synchronizes read after write")
+{
+    HeadlessRenderer renderer;
+    FrameGraph graph;
+
+    FrameGraphResource color = InvalidFrameGraphIndex;
+
+    const auto drawPass = graph.AddPass("Draw", FrameGraphPassType::Graphics, [&color](FrameGraphBuilder& builder){
+        color = builder.Write(builder.CreateImage("Color", MakeImageDesc()), FrameGraphAccess::ColorAttachment);
+    }, nullptr);
+
+    const auto firstRead = AddConsumer(graph, "FirstRead", { color }, nullptr, true);
+    const auto secondRead = AddConsumer(graph, "SecondRead", { color }, nullptr, true);
+
+    graph.Compile(*renderer);
+
+    const auto drawBarriers = graph.GetPassBarriers(drawPass);
+    REQUIRE(drawBarriers.size() == 1);
+    CHECK(drawBarriers[0].newLayout == ImageLayout::ColorAttachment);
+    CHECK(drawBarriers[0].barrier.dstAccessMask == AccessMask::ColorWrite);
+
+    const auto readBarriers = graph.GetPassBarriers(firstRead);
+    REQUIRE(readBarriers.size() == 1);
+
+    const auto& barrier = readBarriers[0];
+    CHECK(barrier.image == GetImage(graph, color));
+    CHECK(barrier.oldLayout == ImageLayout::ColorAttachment);
+    CHECK(barrier.newLayout == ImageLayout::ShaderReadOnly);
+    CHECK(barrier.barrier.srcStageMask == StageMask::ColorAttachment);
+    CHECK(barrier.barrier.srcAccessMask == AccessMask::ColorWrite);
+    CHECK(barrier.barrier.dstStageMask == StageMask::ComputeShader);
+    CHECK(barrier.barrier.dstAccessMask == AccessMask::ShaderRead);
+
+    // Read of the same stages already waits for the write
+    CHECK(graph.GetPassBarriers(secondRead).empty());
+
+    graph.Destroy(*renderer);
+}
+
+TEST_CASE("Frame graph synchronizes write after write")
+{
+    HeadlessRenderer renderer;
+    FrameGraph graph;
+
+    FrameGraphResource storage = InvalidFrameGraphIndex;
+
+    AddProducer(graph, "FirstWrite", storage);
+
+    const auto secondWrite = graph.AddPass("SecondWrite", FrameGraphPassType::Compute, [&storage](FrameGraphBuilder& builder){
+        builder.Write(storage, FrameGraphAccess::ComputeStorage);
+    }, nullptr);
+
+    AddConsumer(graph, "Output", { storage }, nullptr, true);
+
+    graph.Compile(*renderer);
+
+    CHECK(graph.GetStatistics().passCount == 3);
+
+    // Layout stays, the second write still has to wait for the first one
+    const auto barriers = graph.GetPassBarriers(secondWrite);
+    REQUIRE(barriers.size() == 1);
+
+    const auto& barrier = barriers[0];
+    CHECK(barrier.image == GetImage(graph, storage));
+    CHECK(barrier.oldLayout == ImageLayout::General);
+    CHECK(barrier.newLayout == ImageLayout::General);
+    CHECK(barrier.barrier.srcStageMask == StageMask::ComputeShader);
+    CHECK(barrier.barrier.srcAccessMask == (AccessMask::ShaderRead | AccessMask::ShaderWrite));
+    CHECK(barrier.barrier.dstStageMask == StageMask::ComputeShader);
+    CHECK(barrier.barrier.dstAccessMask == (AccessMask::ShaderRead | AccessMask::ShaderWrite));
+
+    graph.Destroy(*renderer);
+}
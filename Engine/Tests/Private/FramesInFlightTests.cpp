@@ -0,0 +1,49 @@
+#include "HeadlessRenderer.h"
+
+#include <doctest.h>
+
+namespace
+{
+    // Fences of idle frame slots are already signaled, waiting for them has to return right away
+    constexpr float IDLE_FENCE_WAIT_LIMIT = 50.0f;
+}
+
+TEST_CASE("Headless frames cycle through frames in flight ring")
+{
+    for(const uint32_t framesInFlight : { 2u, 3u })
+    {
+        CAPTURE(framesInFlight);
+
+        HeadlessRenderer renderer(framesInFlight);
+        CHECK(renderer->GetFrameStatistics().frameNumber == 0);
+
+        const uint32_t frameCount = framesInFlight * 4;
+
+        for(uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            CAPTURE(frame);
+
+            renderer.RenderEmptyFrame();
+
+            const auto& statistics = renderer->GetFrameStatistics();
+            CHECK(statistics.frameNumber == frame + 1);
+            CHECK(statistics.frameSlot == frame % framesInFlight);
+            CHECK(statistics.fenceWaitTime >= 0.0f);
+
+            // Slots are created signaled, nothing was submitted to them yet
+            if(frame < framesInFlight)
+            {
+                CHECK(statistics.fenceWaitTime < IDLE_FENCE_WAIT_LIMIT);
+            }
+        }
+
+        // Once the device is idle every slot is released, the next frame doesn't wait either
+        renderer->WaitIdle();
+        renderer.RenderEmptyFrame();
+
+        const auto& statistics = renderer->GetFrameStatistics();
+        CHECK(statistics.frameNumber == frameCount + 1);
+        CHECK(statistics.frameSlot == frameCount % framesInFlight);
+        CHECK(statistics.fenceWaitTime < IDLE_FENCE_WAIT_LIMIT);
+    }
+}
@@ -0,0 +1,142 @@
+#include "HeadlessRenderer.h"
+
+#include <Renderer/GpuScene.h>
+
+#include <doctest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Renderer;
+
+namespace
+{
+    // Two workgroups of cull.comp & a partial third one
+    constexpr uint32_t OBJECT_COUNT = 150;
+
+    // Radius scale of objects treated as touching a plane, see CullObjects
+    constexpr float BOUNDARY_MARGIN = 0.01f;
+
+    std::vector<GpuObject> MakeObjects(uint32_t seed, uint32_t count)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<float> position(-40.0f, 40.0f);
+        std::uniform_real_distribution<float> scale(0.5f, 3.0f);
+        std::uniform_real_distribution<float> radius(0.1f, 2.0f);
+
+        std::vector<GpuObject> objects(count);
+
+        for(uint32_t i = 0; i < count; ++i)
+        {
+            auto& object = objects[i];
+            object.world = Matrix4::MakeScale(Vector3f(scale(generator))) * Matrix4::MakeTranslation(Vector3f(position(generator), position(generator), position(generator)));
+            object.boundingSphere = Vector4f(position(generator) * 0.05f, position(generator) * 0.05f, position(generator) * 0.05f, radius(generator));
+            object.indexCount = 3 * (i + 1);
+            object.firstIndex = 7 * i;
+            object.vertexOffset = static_cast<int32_t>(i) - 20;
+        }
+
+        return objects;
+    }
+
+    std::vector<uint32_t> GetVisibleObjects(std::vector<GpuObject> objects, const FrustumPlanes& frustum, float radiusScale)
+    {
+        for(auto& object : objects)
+        {
+            object.boundingSphere.w *= radiusScale;
+        }
+
+        std::vector<DrawIndexedIndirectCommand> commands(objects.size());
+        commands.resize(CullObjects(objects.data(), static_cast<uint32_t>(objects.size()), frustum, commands.data()));
+
+        std::vector<uint32_t> visible;
+        for(const auto& command : commands)
+        {
+            visible.push_back(command.firstInstance);
+        }
+
+        return visible;
+    }
+
+    /*!
+     @brief Removes objects whose visibility changes within the margin, their classification depends on float rounding.
+     */
+    std::vector<GpuObject> RemoveBoundaryObjects(const std::vector<GpuObject>& objects, const FrustumPlanes& frustum)
+    {
+        const auto inner = GetVisibleObjects(objects, frustum, 1.0f - BOUNDARY_MARGIN);
+        const auto outer = GetVisibleObjects(objects, frustum, 1.0f + BOUNDARY_MARGIN);
+
+        std::vector<GpuObject> result;
+        for(uint32_t i = 0; i < objects.size(); ++i)
+        {
+            const bool innerVisible = std::binary_search(inner.begin(), inner.end(), i);
+            const bool outerVisible = std::binary_search(outer.begin(), outer.end(), i);
+
+            if(innerVisible == outerVisible)
+            {
+                result.push_back(objects[i]);
+            }
+        }
+
+        return result;
+    }
+
+    bool CompareByObject(const DrawIndexedIndirectCommand& left, const DrawIndexedIndirectCommand& right)
+    {
+        return left.firstInstance < right.firstInstance;
+    }
+}
+
+TEST_CASE("GPU culling matches CullObjects reference")
+{
+    HeadlessRenderer renderer;
+
+    if(!renderer->IsGpuCullingSupported())
+    {
+        WARN_MESSAGE(false, "GPU culling is not supported by the device, test is skipped");
+        return;
+    }
+
+    const Matrix4 view = Matrix4::MakeTranslation(Vector3f(0.0f, 0.0f, -30.0f));
+    const Matrix4 projection = Matrix4::MakePerspective(1.0f, 16.0f / 9.0f, 0.1f, 60.0f);
+    const auto frustum = FrustumPlanes::FromViewProjection(view * projection);
+
+    const auto objects = RemoveBoundaryObjects(MakeObjects(3, OBJECT_COUNT), frustum);
+    const auto objectCount = static_cast<uint32_t>(objects.size());
+
+    std::vector<DrawIndexedIndirectCommand> expected(objectCount);
+    expected.resize(CullObjects(objects.data(), objectCount, frustum, expected.data()));
+
+    // Random scene has to exercise both outcomes
+    REQUIRE(!expected.empty());
+    REQUIRE(expected.size() < objectCount);
+
+    GpuScene scene;
+    renderer->CreateGpuScene(scene, objectCount, CULL_SHADER_PATH);
+
+    renderer->BeginCommandRecording();
+    renderer->UpdateGpuScene(scene, 0, objectCount, objects.data());
+    renderer->CullGpuScene(scene, frustum);
+    renderer->EndCommandRecording(nullptr);
+
+    // Commands are appended by atomic counter, their order is arbitrary
+    auto actual = renderer->ReadGpuSceneCommands(scene);
+    std::sort(actual.begin(), actual.end(), CompareByObject);
+
+    REQUIRE(actual.size() == expected.size());
+
+    for(size_t i = 0; i < expected.size(); ++i)
+    {
+        CAPTURE(i);
+        CHECK(actual[i].firstInstance == expected[i].firstInstance);
+        CHECK(actual[i].indexCount == expected[i].indexCount);
+        CHECK(actual[i].instanceCount == expected[i].instanceCount);
+        CHECK(actual[i].firstIndex == expected[i].firstIndex);
+        CHECK(actual[i].vertexOffset == expected[i].vertexOffset);
+    }
+
+    renderer->DestroyDeviceObject(scene.objects.deviceObject);
+    renderer->DestroyDeviceObject(scene.commands.deviceObject);
+    renderer->DestroyDeviceObject(scene.drawCount.deviceObject);
+}
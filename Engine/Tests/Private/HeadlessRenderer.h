@@ -0,0 +1,64 @@
+#pragma once
+
+#include "TestServices.h"
+
+#include <PAL/RenderAPI/Vulkan/VulkanAPI.h>
+#include <Renderer/Renderer.h>
+
+#include <memory>
+
+/*!
+ @brief Renderer without swap chain, frames are submitted by EndCommandRecording(nullptr).
+
+ Services the renderer depends on are provided by the first instance & kept for the rest of the test run.
+ */
+class HeadlessRenderer
+{
+public:
+    explicit HeadlessRenderer(uint32_t framesInFlight = Renderer::DefaultFramesInFlight)
+    {
+        ProvideServices();
+
+        mRenderer = Renderer::CreateRenderer();
+        mRenderer->SetFramesInFlight(framesInFlight);
+        mRenderer->Initialize();
+    }
+
+    ~HeadlessRenderer()
+    {
+        mRenderer->WaitIdle();
+        mRenderer->Deinitialize();
+    }
+
+    HeadlessRenderer(const HeadlessRenderer&) = delete;
+    HeadlessRenderer& operator=(const HeadlessRenderer&) = delete;
+
+    Renderer::IRenderer& operator*() const { return *mRenderer; }
+    Renderer::IRenderer* operator->() const { return mRenderer.get(); }
+
+    /*!
+     @brief Records & submits frame without any commands.
+     */
+    void RenderEmptyFrame() const
+    {
+        mRenderer->BeginCommandRecording();
+        mRenderer->EndCommandRecording(nullptr);
+    }
+
+private:
+    static void ProvideServices()
+    {
+        static const bool provided = [](){
+            ProvideCoreServices();
+
+            PAL::RenderAPI::VulkanAPI::Provide(PAL::RenderAPI::CreateVulkanRenderAPI());
+            PAL::RenderAPI::VulkanAPI::Service().Initialize();
+            return true;
+        }();
+
+        (void)provided;
+    }
+
+private:
+    std::unique_ptr<Renderer::IRenderer> mRenderer;
+};
@@ -0,0 +1,332 @@
+#include "TestServices.h"
+
+#include <Dispatcher/JobSystem.h>
+#include <Dispatcher/WorkStealingQueue.h>
+
+#include <doctest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Core;
+
+namespace
+{
+    // Fixed worker count, so stealing is exercised regardless of hardware concurrency
+    constexpr uint32_t WORKER_COUNT = 4;
+
+    constexpr uint32_t RACE_ROUND_COUNT = 20000;
+    constexpr uint32_t THIEF_COUNT = 3;
+
+    /*!
+     @brief Items of the race tests, counts how many times each was taken out of the queue.
+     */
+    class TakenItems
+    {
+    public:
+        explicit TakenItems(uint32_t count)
+            : mItems(count)
+            , mTakenCounts(std::make_unique<std::atomic<uint32_t>[]>(count))
+        {
+            for(uint32_t i = 0; i < count; ++i)
+            {
+                mTakenCounts[i] = 0;
+            }
+        }
+
+        uint32_t* Get(uint32_t index) { return &mItems[index]; }
+
+        void Take(uint32_t* item)
+        {
+            mTakenCounts[item - mItems.data()].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        uint32_t GetTakenCount(uint32_t index) const { return mTakenCounts[index].load(); }
+
+    private:
+        std::vector<uint32_t> mItems;
+        std::unique_ptr<std::atomic<uint32_t>[]> mTakenCounts;
+    };
+}
+
+TEST_CASE("Work stealing queue pops LIFO & steals FIFO")
+{
+    WorkStealingQueue<uint32_t, 8> queue;
+    std::vector<uint32_t> items = { 0, 1, 2, 3, 4, 5, 6, 7 };
+
+    CHECK(queue.Empty());
+    CHECK(queue.Pop() == nullptr);
+    CHECK(queue.Steal() == nullptr);
+
+    for(auto& item : items)
+    {
+        CHECK(queue.Push(&item));
+    }
+
+    uint32_t overflow = 8;
+    CHECK(!queue.Push(&overflow));
+
+    CHECK(queue.Steal() == &items[0]);
+    CHECK(queue.Pop() == &items[7]);
+    CHECK(queue.Steal() == &items[1]);
+    CHECK(queue.Pop() == &items[6]);
+
+    // Stolen slots are free again, bottom wraps around the ring
+    std::vector<uint32_t> wrapped = { 8, 9, 10, 11 };
+    for(auto& item : wrapped)
+    {
+        CHECK(queue.Push(&item));
+    }
+
+    CHECK(!queue.Push(&overflow));
+
+    for(uint32_t i = 4; i > 0; --i)
+    {
+        CHECK(queue.Pop() == &wrapped[i - 1]);
+    }
+
+    for(uint32_t i = 5; i >= 2; --i)
+    {
+        CHECK(queue.Pop() == &items[i]);
+    }
+
+    CHECK(queue.Empty());
+}
+
+TEST_CASE("Work stealing queue hands out the last item once")
+{
+    WorkStealingQueue<uint32_t, 8> queue;
+    uint32_t item = 0;
+
+    SUBCASE("Popped by owner")
+    {
+        CHECK(queue.Push(&item));
+        CHECK(queue.Pop() == &item);
+        CHECK(queue.Steal() == nullptr);
+        CHECK(queue.Pop() == nullptr);
+    }
+
+    SUBCASE("Stolen by thief")
+    {
+        CHECK(queue.Push(&item));
+        CHECK(queue.Steal() == &item);
+        CHECK(queue.Pop() == nullptr);
+        CHECK(queue.Steal() == nullptr);
+    }
+
+    // Failed pop of the empty queue leaves it usable
+    CHECK(queue.Empty());
+    CHECK(queue.Push(&item));
+    CHECK(queue.Pop() == &item);
+}
+
+TEST_CASE("Work stealing queue races owner & thieves for the last item")
+{
+    WorkStealingQueue<uint32_t, 8> queue;
+    TakenItems items(RACE_ROUND_COUNT);
+
+    std::atomic<bool> running{ true };
+    std::vector<std::thread> thieves;
+
+    for(uint32_t i = 0; i < THIEF_COUNT; ++i)
+    {
+        thieves.emplace_back([&queue, &items, &running](){
+            while(running.load(std::memory_order_acquire))
+            {
+                if(uint32_t* item = queue.Steal())
+                {
+                    items.Take(item);
+                }
+            }
+        });
+    }
+
+    // Every round queue holds single item, owner's pop always competes with the thieves
+    for(uint32_t round = 0; round < RACE_ROUND_COUNT; ++round)
+    {
+        CHECK(queue.Push(items.Get(round)));
+
+        if(uint32_t* item = queue.Pop())
+        {
+            items.Take(item);
+        }
+
+        // Wait for the thief which won, so the next round starts with empty queue
+        while(!queue.Empty())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    running.store(false, std::memory_order_release);
+    for(auto& thief : thieves)
+    {
+        thief.join();
+    }
+
+    // Thief increments after its steal succeeded, all steals are done once the threads joined
+    for(uint32_t i = 0; i < RACE_ROUND_COUNT; ++i)
+    {
+        CAPTURE(i);
+        CHECK(items.GetTakenCount(i) == 1);
+    }
+}
+
+TEST_CASE("Job system runs jobs after their dependencies")
+{
+    ProvideCoreServices();
+    JobSystem jobSystem(WORKER_COUNT);
+
+    std::atomic<uint32_t> sequence{ 0 };
+    uint32_t firstOrder = 0;
+    uint32_t secondOrder = 0;
+    uint32_t joinOrder = 0;
+    uint32_t lastOrder = 0;
+
+    const auto first = jobSystem.Run([&sequence, &firstOrder](){
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        firstOrder = ++sequence;
+    });
+    const auto second = jobSystem.Run([&sequence, &secondOrder](){ secondOrder = ++sequence; });
+
+    // Empty handles & finished dependencies don't hold the job back
+    const auto join = jobSystem.Run([&sequence, &joinOrder](){ joinOrder = ++sequence; }, { first, JobHandle(), second });
+    const auto last = jobSystem.Run([&sequence, &lastOrder](){ lastOrder = ++sequence; }, { join });
+
+    jobSystem.Wait(last);
+
+    CHECK(first->IsFinished());
+    CHECK(second->IsFinished());
+    CHECK(join->IsFinished());
+
+    CHECK(joinOrder > firstOrder);
+    CHECK(joinOrder > secondOrder);
+    CHECK(lastOrder == 4);
+
+    uint32_t finishedOrder = 0;
+    const auto finished = jobSystem.Run([&sequence, &finishedOrder](){ finishedOrder = ++sequence; }, { first, last });
+    jobSystem.Wait(finished);
+
+    CHECK(finishedOrder == 5);
+}
+
+TEST_CASE("Job system counter waits for all its jobs")
+{
+    ProvideCoreServices();
+    JobSystem jobSystem(WORKER_COUNT);
+
+    constexpr uint32_t jobCount = 200;
+
+    JobCounter counter;
+    std::atomic<uint32_t> finishedCount{ 0 };
+    std::vector<JobHandle> jobs;
+
+    for(uint32_t i = 0; i < jobCount; ++i)
+    {
+        // Half of the jobs wait for the previous one, counter covers jobs released by dependencies too
+        const JobHandle dependency = i % 2 == 1 ? jobs.back() : JobHandle();
+        jobs.push_back(jobSystem.Run([&finishedCount](){ ++finishedCount; }, { dependency }, &counter));
+    }
+
+    CHECK(counter.GetValue() <= jobCount);
+
+    jobSystem.Wait(counter);
+
+    CHECK(counter.IsDone());
+    CHECK(counter.GetValue() == 0);
+    CHECK(finishedCount == jobCount);
+}
+
+TEST_CASE("Job system parallel for covers every index once")
+{
+    ProvideCoreServices();
+    JobSystem jobSystem(WORKER_COUNT);
+
+    for(const uint32_t count : { 0u, 1u, 7u, 1000u, 1001u })
+    {
+        for(const uint32_t batchSize : { 0u, 1u, 7u, 64u, 2000u })
+        {
+            CAPTURE(count);
+            CAPTURE(batchSize);
+
+            const auto visits = std::make_unique<std::atomic<uint32_t>[]>(std::max(count, 1u));
+            for(uint32_t i = 0; i < count; ++i)
+            {
+                visits[i] = 0;
+            }
+
+            // Batches run on workers, they're validated here
+            std::atomic<uint32_t> wrongBatchCount{ 0 };
+
+            jobSystem.ParallelFor(count, batchSize, [&visits, &wrongBatchCount, count, batchSize](uint32_t begin, uint32_t end){
+                if(begin >= end || end > count || end - begin > std::max(batchSize, 1u))
+                {
+                    ++wrongBatchCount;
+                    return;
+                }
+
+                for(uint32_t i = begin; i < end; ++i)
+                {
+                    ++visits[i];
+                }
+            });
+
+            CHECK(wrongBatchCount == 0);
+
+            uint32_t wrongCount = 0;
+            for(uint32_t i = 0; i < count; ++i)
+            {
+                wrongCount += visits[i] != 1 ? 1 : 0;
+            }
+
+            CHECK(wrongCount == 0);
+        }
+    }
+}
+
+TEST_CASE("Job system workers steal jobs spawned by other worker")
+{
+    ProvideCoreServices();
+    JobSystem jobSystem(WORKER_COUNT);
+
+    constexpr uint32_t childCount = 64;
+
+    JobCounter counter;
+    std::atomic<int32_t> parentWorker{ -1 };
+    std::vector<int32_t> childWorkers(childCount, -1);
+
+    jobSystem.Run([&jobSystem, &counter, &parentWorker, &childWorkers](){
+        parentWorker = jobSystem.GetCurrentWorkerIndex();
+
+        // Children go to the local deque of this worker, the others can only get them by stealing
+        for(uint32_t i = 0; i < childCount; ++i)
+        {
+            jobSystem.Run([&jobSystem, &childWorkers, i](){
+                childWorkers[i] = jobSystem.GetCurrentWorkerIndex();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }, {}, &counter);
+        }
+    }, {}, &counter);
+
+    // Test thread doesn't help, it would steal the children itself
+    while(!counter.IsDone())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    REQUIRE(parentWorker >= 0);
+
+    uint32_t stolenCount = 0;
+    for(const int32_t worker : childWorkers)
+    {
+        CHECK(worker >= 0);
+        CHECK(worker < static_cast<int32_t>(WORKER_COUNT));
+        stolenCount += worker != parentWorker ? 1 : 0;
+    }
+
+    CHECK(stolenCount > 0);
+}
@@ -0,0 +1,213 @@
+#include <Math/MatrixKernels.h>
+
+#include <doctest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Odd count leaves a tail after the kernels' wide loops
+    constexpr size_t BATCH_COUNT = 37;
+    constexpr uint32_t ITERATIONS = 100;
+
+    // SIMD paths use FMA & different summation order, results differ by rounding only
+    constexpr double EPSILON = 1.0e-4;
+
+    class RandomData
+    {
+    public:
+        explicit RandomData(uint32_t seed) : mGenerator(seed) {}
+
+        std::vector<float> MakeFloats(size_t count)
+        {
+            std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+            std::vector<float> data(count);
+            std::generate(data.begin(), data.end(), [&](){ return distribution(mGenerator); });
+
+            return data;
+        }
+
+        /*!
+         @brief Diagonally dominant matrices, they are always invertible.
+         */
+        std::vector<float> MakeInvertibleMatrices(size_t count)
+        {
+            auto data = MakeFloats(count * 16);
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                for(size_t d = 0; d < 4; ++d)
+                {
+                    data[i * 16 + d * 5] += 8.0f;
+                }
+            }
+
+            return data;
+        }
+
+    private:
+        std::mt19937 mGenerator;
+    };
+
+    void CheckEqual(const std::vector<float>& expected, const std::vector<float>& actual)
+    {
+        REQUIRE(expected.size() == actual.size());
+
+        for(size_t i = 0; i < expected.size(); ++i)
+        {
+            CAPTURE(i);
+            CHECK(actual[i] == doctest::Approx(expected[i]).epsilon(EPSILON));
+        }
+    }
+}
+
+TEST_CASE("Matrix kernels match scalar reference")
+{
+    RandomData random(42);
+
+    for(uint32_t iteration = 0; iteration < ITERATIONS; ++iteration)
+    {
+        CAPTURE(iteration);
+
+        const auto a = random.MakeFloats(BATCH_COUNT * 16);
+        const auto b = random.MakeFloats(BATCH_COUNT * 16);
+        const auto m = random.MakeInvertibleMatrices(1);
+        const auto vectors = random.MakeFloats(BATCH_COUNT * 4);
+
+        std::vector<float> expected(16);
+        std::vector<float> actual(16);
+
+        INFO("MultiplyMatrix");
+        Math::Reference::MultiplyMatrix(a.data(), b.data(), expected.data());
+        Math::Kernels::MultiplyMatrix(a.data(), b.data(), actual.data());
+        CheckEqual(expected, actual);
+
+        INFO("TransposeMatrix");
+        Math::Reference::TransposeMatrix(a.data(), expected.data());
+        Math::Kernels::TransposeMatrix(a.data(), actual.data());
+        CheckEqual(expected, actual);
+
+        INFO("InvertMatrix");
+        REQUIRE(Math::Reference::InvertMatrix(m.data(), expected.data()));
+        REQUIRE(Math::Kernels::InvertMatrix(m.data(), actual.data()));
+        CheckEqual(expected, actual);
+
+        INFO("MultiplyMatrices");
+        expected.resize(a.size());
+        actual.resize(a.size());
+        Math::Reference::MultiplyMatrices(a.data(), b.data(), expected.data(), BATCH_COUNT);
+        Math::Kernels::MultiplyMatrices(a.data(), b.data(), actual.data(), BATCH_COUNT);
+        CheckEqual(expected, actual);
+
+        INFO("TransformVectors");
+        expected.resize(vectors.size());
+        actual.resize(vectors.size());
+        Math::Reference::TransformVectors(a.data(), vectors.data(), expected.data(), BATCH_COUNT);
+        Math::Kernels::TransformVectors(a.data(), vectors.data(), actual.data(), BATCH_COUNT);
+        CheckEqual(expected, actual);
+    }
+}
+
+TEST_CASE("Matrix kernels allow result aliasing inputs")
+{
+    RandomData random(7);
+
+    const auto a = random.MakeInvertibleMatrices(BATCH_COUNT);
+    const auto b = random.MakeFloats(BATCH_COUNT * 16);
+    const auto vectors = random.MakeFloats(BATCH_COUNT * 4);
+
+    std::vector<float> expected(a.size());
+
+    SUBCASE("MultiplyMatrix into left operand")
+    {
+        std::vector<float> aliased(a.begin(), a.begin() + 16);
+        expected.resize(16);
+
+        Math::Reference::MultiplyMatrix(a.data(), b.data(), expected.data());
+        Math::Kernels::MultiplyMatrix(aliased.data(), b.data(), aliased.data());
+        CheckEqual(expected, aliased);
+    }
+
+    SUBCASE("MultiplyMatrix into right operand")
+    {
+        std::vector<float> aliased(b.begin(), b.begin() + 16);
+        expected.resize(16);
+
+        Math::Reference::MultiplyMatrix(a.data(), b.data(), expected.data());
+        Math::Kernels::MultiplyMatrix(a.data(), aliased.data(), aliased.data());
+        CheckEqual(expected, aliased);
+    }
+
+    SUBCASE("MultiplyMatrix squaring in place")
+    {
+        std::vector<float> aliased(a.begin(), a.begin() + 16);
+        expected.resize(16);
+
+        Math::Reference::MultiplyMatrix(a.data(), a.data(), expected.data());
+        Math::Kernels::MultiplyMatrix(aliased.data(), aliased.data(), aliased.data());
+        CheckEqual(expected, aliased);
+    }
+
+    SUBCASE("MultiplyMatrices into left operands")
+    {
+        auto aliased = a;
+
+        Math::Reference::MultiplyMatrices(a.data(), b.data(), expected.data(), BATCH_COUNT);
+        Math::Kernels::MultiplyMatrices(aliased.data(), b.data(), aliased.data(), BATCH_COUNT);
+        CheckEqual(expected, aliased);
+    }
+
+    SUBCASE("TransposeMatrix in place")
+    {
+        std::vector<float> aliased(a.begin(), a.begin() + 16);
+        expected.resize(16);
+
+        Math::Reference::TransposeMatrix(a.data(), expected.data());
+        Math::Kernels::TransposeMatrix(aliased.data(), aliased.data());
+        CheckEqual(expected, aliased);
+    }
+
+    SUBCASE("InvertMatrix in place")
+    {
+        std::vector<float> aliased(a.begin(), a.begin() + 16);
+        expected.resize(16);
+
+        REQUIRE(Math::Reference::InvertMatrix(a.data(), expected.data()));
+        REQUIRE(Math::Kernels::InvertMatrix(aliased.data(), aliased.data()));
+        CheckEqual(expected, aliased);
+    }
+
+    SUBCASE("TransformVectors in place")
+    {
+        auto aliased = vectors;
+        expected.resize(vectors.size());
+
+        Math::Reference::TransformVectors(a.data(), vectors.data(), expected.data(), BATCH_COUNT);
+        Math::Kernels::TransformVectors(a.data(), aliased.data(), aliased.data(), BATCH_COUNT);
+        CheckEqual(expected, aliased);
+    }
+}
+
+TEST_CASE("Singular matrix is left untouched by inversion")
+{
+    // Last row repeats the first one
+    const std::vector<float> singular = {
+        1.0f, 2.0f, 3.0f, 4.0f,
+        0.0f, 1.0f, 5.0f, 2.0f,
+        3.0f, 0.0f, 1.0f, 1.0f,
+        1.0f, 2.0f, 3.0f, 4.0f
+    };
+
+    const std::vector<float> untouched(16, -1.0f);
+
+    auto expected = untouched;
+    auto actual = untouched;
+
+    CHECK_FALSE(Math::Reference::InvertMatrix(singular.data(), expected.data()));
+    CHECK_FALSE(Math::Kernels::InvertMatrix(singular.data(), actual.data()));
+    CheckEqual(untouched, expected);
+    CheckEqual(untouched, actual);
+}
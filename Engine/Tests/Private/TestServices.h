@@ -0,0 +1,22 @@
+#pragma once
+
+#include <Dispatcher/SummitDispatcher.h>
+#include <Logging/LoggingService.h>
+#include <PAL/FileSystem/FileSystemService.h>
+
+/*!
+ @brief Provides services engine modules log & dispatch through, the first call provides them for the rest of the test run.
+ */
+inline void ProvideCoreServices()
+{
+    static const bool provided = [](){
+        PAL::FileSystem::FileSystemServiceLocator::Provide(PAL::FileSystem::CreateFileSystemService());
+        PAL::FileSystem::FileSystemServiceLocator::Service().Initialize();
+        Logging::LoggingServiceLocator::Provide(Logging::CreateLoggingService());
+        Logging::LoggingServiceLocator::Service().Initialize();
+        Core::DispatcherService::Provide(Core::CreateSummitDispatcher());
+        return true;
+    }();
+
+    (void)provided;
+}
@@ -0,0 +1,370 @@
+#include "TestServices.h"
+
+#include <Dispatcher/SummitDispatcher.h>
+#include <Dispatcher/TimerWheel.h>
+
+#include <doctest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace Core;
+
+namespace
+{
+    // Real time waits of dispatcher tests give up after this, so a broken timer fails instead of hanging
+    constexpr std::chrono::seconds WAIT_LIMIT{ 5 };
+
+    /*!
+     @brief Turns the wheel from one wake tick to the next & runs expired one-shot tasks.
+     @return Ids of expired timers in expiration order.
+     */
+    std::vector<TimerId> AdvanceToNextWake(TimerWheel& wheel)
+    {
+        std::vector<TimerWheel::Expired> expired;
+
+        if(const auto wakeTick = wheel.GetNextWakeTick())
+        {
+            wheel.Advance(*wakeTick, expired);
+            CHECK(wheel.GetCurrentTick() == *wakeTick);
+        }
+
+        std::vector<TimerId> ids;
+        for(auto& timer : expired)
+        {
+            if(timer.task)
+            {
+                timer.task();
+            }
+
+            ids.push_back(timer.id);
+        }
+
+        return ids;
+    }
+
+    template<typename Predicate>
+    bool WaitFor(Predicate&& predicate)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + WAIT_LIMIT;
+
+        while(!predicate())
+        {
+            if(std::chrono::steady_clock::now() > deadline)
+                return false;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return true;
+    }
+}
+
+TEST_CASE("Timer wheel expires timers at their deadlines across levels")
+{
+    // Delays straddle slot group boundaries of the first three levels, so the timers have to cascade down
+    const std::vector<uint64_t> delays = { 70000, 1, 65536, 255, 300, 256, 5, 65535, (uint64_t(1) << 24) + 3, 511 };
+
+    TimerWheel wheel;
+    CHECK(!wheel.GetNextWakeTick());
+
+    std::vector<uint64_t> fired;
+    for(const uint64_t delay : delays)
+    {
+        wheel.Add(delay, 0, [&wheel, &fired, delay](){
+            CHECK(wheel.GetCurrentTick() == delay);
+            fired.push_back(delay);
+        });
+    }
+
+    CHECK(wheel.GetActiveCount() == delays.size());
+
+    while(wheel.GetNextWakeTick())
+    {
+        AdvanceToNextWake(wheel);
+    }
+
+    auto expected = delays;
+    std::sort(expected.begin(), expected.end());
+
+    CHECK(fired == expected);
+    CHECK(wheel.GetActiveCount() == 0);
+}
+
+TEST_CASE("Timer wheel cancels pending one-shot timer")
+{
+    TimerWheel wheel;
+
+    bool fired = false;
+    const TimerId cancelled = wheel.Add(300, 0, [&fired](){ fired = true; });
+    const TimerId kept = wheel.Add(400, 0, [](){});
+
+    CHECK(wheel.Cancel(cancelled));
+    CHECK(!wheel.Cancel(cancelled));
+    CHECK(wheel.GetActiveCount() == 1);
+
+    std::vector<TimerWheel::Expired> expired;
+    wheel.Advance(1000, expired);
+
+    REQUIRE(expired.size() == 1);
+    CHECK(expired[0].id == kept);
+    CHECK(!fired);
+
+    // Expired one-shot timer isn't active anymore
+    CHECK(!wheel.Cancel(kept));
+    CHECK(!wheel.Cancel(InvalidTimerId));
+}
+
+TEST_CASE("Timer wheel cancels repeating timer")
+{
+    TimerWheel wheel;
+
+    uint32_t runCount = 0;
+    const TimerId id = wheel.Add(10, 10, [&runCount](){ ++runCount; });
+
+    std::vector<TimerWheel::Expired> expired;
+    wheel.Advance(10, expired);
+
+    REQUIRE(expired.size() == 1);
+    CHECK(expired[0].id == id);
+    CHECK(!expired[0].task);
+
+    SUBCASE("Between expirations")
+    {
+        auto task = wheel.TakeTask(id);
+        REQUIRE(task);
+        task();
+        wheel.ReturnTask(id, task);
+        CHECK(!task);
+
+        CHECK(wheel.Cancel(id));
+    }
+
+    SUBCASE("While its task is lent out")
+    {
+        auto task = wheel.TakeTask(id);
+        REQUIRE(task);
+        CHECK(!wheel.TakeTask(id));
+
+        CHECK(wheel.Cancel(id));
+        task();
+
+        // Task of cancelled timer stays with the caller
+        wheel.ReturnTask(id, task);
+        CHECK(task);
+    }
+
+    CHECK(!wheel.Cancel(id));
+    CHECK(!wheel.TakeTask(id));
+    CHECK(wheel.GetActiveCount() == 0);
+
+    expired.clear();
+    wheel.Advance(1000, expired);
+
+    CHECK(expired.empty());
+    CHECK(runCount == 1);
+}
+
+TEST_CASE("Timer wheel rejects stale ids of reused nodes")
+{
+    TimerWheel wheel;
+
+    const TimerId first = wheel.Add(10, 5, [](){});
+    REQUIRE(wheel.Cancel(first));
+
+    // Node of the cancelled timer is reused with the next generation
+    const TimerId second = wheel.Add(10, 5, [](){});
+    CHECK(second != first);
+    CHECK(second != InvalidTimerId);
+
+    CHECK(!wheel.Cancel(first));
+    CHECK(!wheel.TakeTask(first));
+    CHECK(wheel.GetActiveCount() == 1);
+
+    std::vector<TimerWheel::Expired> expired;
+    wheel.Advance(10, expired);
+
+    REQUIRE(expired.size() == 1);
+    CHECK(expired[0].id == second);
+
+    // Returning task under the stale id must not clear pending expiration of the new timer
+    InlineTask stale([](){});
+    wheel.ReturnTask(first, stale);
+    CHECK(stale);
+
+    expired.clear();
+    wheel.Advance(15, expired);
+    CHECK(expired.empty());
+
+    auto task = wheel.TakeTask(second);
+    REQUIRE(task);
+    wheel.ReturnTask(second, task);
+
+    expired.clear();
+    wheel.Advance(20, expired);
+    REQUIRE(expired.size() == 1);
+    CHECK(expired[0].id == second);
+
+    CHECK(wheel.Cancel(second));
+}
+
+TEST_CASE("Timer wheel keeps phase of repeating timer")
+{
+    constexpr uint64_t delay = 7;
+    constexpr uint64_t period = 10;
+
+    // Every third expiration keeps its task for a few wakes, as a slow task would
+    constexpr uint32_t heldWakeCount = 4;
+
+    TimerWheel wheel;
+    const TimerId id = wheel.Add(delay, period, [](){});
+
+    std::vector<uint64_t> expirations;
+    uint32_t heldWakes = 0;
+    bool held = false;
+
+    while(wheel.GetCurrentTick() < 3000)
+    {
+        const auto expired = AdvanceToNextWake(wheel);
+
+        for(const TimerId expiredId : expired)
+        {
+            CHECK(expiredId == id);
+            expirations.push_back(wheel.GetCurrentTick());
+        }
+
+        if(held)
+        {
+            // Expirations aren't reported until the task is returned
+            CHECK(expired.empty());
+
+            if(++heldWakes == heldWakeCount)
+            {
+                auto task = wheel.TakeTask(id);
+                REQUIRE(task);
+                wheel.ReturnTask(id, task);
+                held = false;
+            }
+        }
+        else if(!expired.empty())
+        {
+            if(expirations.size() % 3 == 0)
+            {
+                held = true;
+                heldWakes = 0;
+            }
+            else
+            {
+                auto task = wheel.TakeTask(id);
+                REQUIRE(task);
+                wheel.ReturnTask(id, task);
+            }
+        }
+    }
+
+    // Held expirations skipped some occurrences
+    REQUIRE(expirations.size() > 3);
+    CHECK(expirations.size() < (3000 - delay) / period + 1);
+
+    for(const uint64_t tick : expirations)
+    {
+        CAPTURE(tick);
+        CHECK(tick % period == delay);
+    }
+
+    CHECK(wheel.Cancel(id));
+}
+
+TEST_CASE("Dispatcher runs scheduled tasks in deadline order")
+{
+    ProvideCoreServices();
+    SummitDispatcher dispatcher;
+
+    std::mutex mutex;
+    std::vector<uint32_t> order;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration firstElapsed{};
+
+    for(const uint32_t delay : { 30000u, 10000u, 20000u })
+    {
+        dispatcher.Schedule(delay, [&mutex, &order, &firstElapsed, start, delay](){
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if(order.empty())
+            {
+                firstElapsed = std::chrono::steady_clock::now() - start;
+            }
+
+            order.push_back(delay);
+        }, false);
+    }
+
+    REQUIRE(WaitFor([&mutex, &order](){
+        std::lock_guard<std::mutex> lock(mutex);
+        return order.size() == 3;
+    }));
+
+    dispatcher.WaitIdle();
+
+    const std::vector<uint32_t> expected = { 10000u, 20000u, 30000u };
+    CHECK(order == expected);
+
+    // Delay is rounded to whole timer ticks of 100us
+    CHECK(firstElapsed >= std::chrono::microseconds(10000 - 100));
+}
+
+TEST_CASE("Dispatcher cancels scheduled tasks")
+{
+    ProvideCoreServices();
+    SummitDispatcher dispatcher;
+
+    SUBCASE("Pending one-shot task")
+    {
+        std::atomic<bool> fired{ false };
+        const TimerId id = dispatcher.Schedule(20000, [&fired](){ fired = true; }, false);
+
+        CHECK(dispatcher.Cancel(id));
+        CHECK(!dispatcher.Cancel(id));
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        dispatcher.WaitIdle();
+
+        CHECK(!fired);
+    }
+
+    SUBCASE("Expired one-shot task")
+    {
+        std::atomic<bool> fired{ false };
+        const TimerId id = dispatcher.Schedule(1000, [&fired](){ fired = true; }, false);
+
+        REQUIRE(WaitFor([&fired](){ return fired.load(); }));
+        dispatcher.WaitIdle();
+
+        CHECK(!dispatcher.Cancel(id));
+    }
+
+    SUBCASE("Repeating task")
+    {
+        std::atomic<uint32_t> runCount{ 0 };
+        const TimerId id = dispatcher.Schedule(1000, [&runCount](){ ++runCount; }, true);
+
+        REQUIRE(WaitFor([&runCount](){ return runCount >= 3; }));
+
+        CHECK(dispatcher.Cancel(id));
+        CHECK(!dispatcher.Cancel(id));
+
+        // Occurrence already running finishes, nothing runs after it
+        dispatcher.WaitIdle();
+        const uint32_t cancelledCount = runCount;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        dispatcher.WaitIdle();
+
+        CHECK(runCount == cancelledCount);
+    }
+}